@@ -0,0 +1,123 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2013 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/**
+ *  \file SDL_archive.h
+ *
+ *  Read-only access to the files packed in an archive.
+ *
+ *  An archive is opened once and its directory is indexed in a hash table,
+ *  so opening a file inside it doesn't touch the filesystem.  Two formats
+ *  are supported:
+ *   - Zip files whose entries are stored without compression.
+ *   - SDL pack files, which start with the 8 bytes "SDLPACK1" and a
+ *     little endian Uint32 file count, followed for each file by a Uint64
+ *     offset, a Uint64 size, a Uint16 name length and the UTF-8 name, all
+ *     little endian.  Offsets are from the start of the pack file.
+ *
+ *  Streams opened from an archive may be used from different threads at
+ *  the same time.  The archive must stay open until they are all closed.
+ */
+
+#ifndef _SDL_archive_h
+#define _SDL_archive_h
+
+#include "SDL_stdinc.h"
+#include "SDL_error.h"
+#include "SDL_rwops.h"
+
+#include "begin_code.h"
+/* Set up for C function definitions, even when using C++ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The SDL archive structure, defined in SDL_archive.c */
+struct SDL_Archive;
+typedef struct SDL_Archive SDL_Archive;
+
+/**
+ *  Open an archive file, memory mapping it if possible.
+ *
+ *  \return The archive, or NULL on error.
+ */
+extern DECLSPEC SDL_Archive *SDLCALL SDL_OpenArchive(const char *file);
+
+/**
+ *  Open an archive from a seekable stream.
+ *
+ *  If the stream is in memory, files are read directly from it, otherwise
+ *  reads from the files inside it are serialized on the stream.
+ *
+ *  \param src The stream containing the archive.
+ *  \param freesrc Non-zero to close the stream when the archive is closed.
+ *
+ *  \return The archive, or NULL on error.
+ */
+extern DECLSPEC SDL_Archive *SDLCALL SDL_OpenArchiveRW(SDL_RWops * src,
+                                                       int freesrc);
+
+/**
+ *  Get the number of files in an archive.
+ */
+extern DECLSPEC int SDLCALL SDL_GetNumArchiveFiles(SDL_Archive * archive);
+
+/**
+ *  Get the name of a file in an archive, or NULL if the index is invalid.
+ */
+extern DECLSPEC const char *SDLCALL SDL_GetArchiveFileName(SDL_Archive * archive,
+                                                           int index);
+
+/**
+ *  Get the size of a file in an archive.
+ *
+ *  \return The size in bytes, or -1 if the file isn't in the archive.
+ */
+extern DECLSPEC Sint64 SDLCALL SDL_GetArchiveFileSize(SDL_Archive * archive,
+                                                      const char *name);
+
+/**
+ *  Open a file in an archive for reading.
+ *
+ *  \param archive The archive containing the file.
+ *  \param name The path of the file in the archive, using '/' as the
+ *              directory separator.  Names are case sensitive.
+ *
+ *  \return A read-only stream, or NULL on error.
+ */
+extern DECLSPEC SDL_RWops *SDLCALL SDL_RWFromArchive(SDL_Archive * archive,
+                                                     const char *name);
+
+/**
+ *  Close an archive.
+ */
+extern DECLSPEC void SDLCALL SDL_CloseArchive(SDL_Archive * archive);
+
+
+/* Ends C function definitions when using C++ */
+#ifdef __cplusplus
+}
+#endif
+#include "close_code.h"
+
+#endif /* _SDL_archive_h */
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -0,0 +1,144 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2013 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/**
+ *  \file SDL_asyncio.h
+ *
+ *  Asynchronous reads from SDL_RWops streams.
+ *
+ *  Read requests are queued by priority and run on a small pool of I/O
+ *  threads, which is started on first use and shut down by SDL_Quit().
+ *  Requests on the same stream run one at a time, and pending requests
+ *  that continue where another one ends are read together without seeking.
+ *
+ *  While a stream has requests pending, it must not be used by any other
+ *  code, and must not be closed.
+ */
+
+#ifndef _SDL_asyncio_h
+#define _SDL_asyncio_h
+
+#include "SDL_stdinc.h"
+#include "SDL_error.h"
+#include "SDL_rwops.h"
+
+#include "begin_code.h"
+/* Set up for C function definitions, even when using C++ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The SDL asynchronous I/O request structure, defined in SDL_asyncio.c */
+struct SDL_AsyncIO;
+typedef struct SDL_AsyncIO SDL_AsyncIO;
+
+/**
+ *  The state of an asynchronous I/O request.
+ */
+typedef enum
+{
+    SDL_ASYNCIO_PENDING,    /**< The request is queued or running */
+    SDL_ASYNCIO_COMPLETE,   /**< Data was read, possibly less than requested at end of file */
+    SDL_ASYNCIO_FAILED,     /**< Nothing could be read */
+    SDL_ASYNCIO_CANCELED    /**< The request was canceled before it started */
+} SDL_AsyncIOStatus;
+
+/**
+ *  The function called when an asynchronous I/O request finishes.
+ *
+ *  This is called on an I/O thread, or on the thread that canceled the
+ *  request, and must not free the request.
+ */
+typedef void (SDLCALL * SDL_AsyncIOCallback) (void *userdata,
+                                              SDL_AsyncIO * request,
+                                              SDL_AsyncIOStatus status,
+                                              size_t bytes);
+
+/**
+ *  Queue a read from a stream.
+ *
+ *  \param src The stream to read from.
+ *  \param offset The position in the stream to read from.
+ *  \param ptr The memory to read into, which must stay valid until the
+ *             request finishes.
+ *  \param size The number of bytes to read.
+ *  \param priority Requests with a higher priority are started first.
+ *  \param callback The function to call when the request finishes, or NULL
+ *                  to push an ::SDL_ASYNCIOCOMPLETE event instead.
+ *  \param userdata A pointer passed to the callback or stored in the event.
+ *
+ *  \return A request handle that must be freed with SDL_FreeAsyncIO(),
+ *          or NULL on error.
+ */
+extern DECLSPEC SDL_AsyncIO *SDLCALL SDL_ReadAsync(SDL_RWops * src,
+                                                   Sint64 offset,
+                                                   void *ptr, size_t size,
+                                                   int priority,
+                                                   SDL_AsyncIOCallback callback,
+                                                   void *userdata);
+
+/**
+ *  Get the state of a request without waiting.
+ *
+ *  \param request The request to check.
+ *  \param bytes Filled in with the number of bytes read, may be NULL.
+ */
+extern DECLSPEC SDL_AsyncIOStatus SDLCALL SDL_GetAsyncIOStatus(SDL_AsyncIO * request,
+                                                               size_t * bytes);
+
+/**
+ *  Wait for a request to finish.
+ *
+ *  \param request The request to wait for.
+ *  \param bytes Filled in with the number of bytes read, may be NULL.
+ *
+ *  \return The final state of the request.
+ */
+extern DECLSPEC SDL_AsyncIOStatus SDLCALL SDL_WaitAsyncIO(SDL_AsyncIO * request,
+                                                          size_t * bytes);
+
+/**
+ *  Cancel a request that hasn't started yet.
+ *
+ *  The callback or event is delivered with ::SDL_ASYNCIO_CANCELED.
+ *
+ *  \return 0 if the request was canceled, or -1 if it had already started.
+ */
+extern DECLSPEC int SDLCALL SDL_CancelAsyncIO(SDL_AsyncIO * request);
+
+/**
+ *  Free a request.
+ *
+ *  A request that hasn't started yet is canceled without calling its
+ *  callback, and a running request is waited for.
+ */
+extern DECLSPEC void SDLCALL SDL_FreeAsyncIO(SDL_AsyncIO * request);
+
+
+/* Ends C function definitions when using C++ */
+#ifdef __cplusplus
+}
+#endif
+#include "close_code.h"
+
+#endif /* _SDL_asyncio_h */
+
+/* vi: set ts=4 sw=4 expandtab: */
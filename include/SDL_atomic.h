@@ -136,6 +136,21 @@ void _ReadWriteBarrier(void);
 { SDL_SpinLock _tmp = 0; SDL_AtomicLock(&_tmp); SDL_AtomicUnlock(&_tmp); }
 #endif
 
+/**
+ * The pause instruction tells the CPU that the calling thread is spinning
+ * on a lock, which saves power and frees up pipeline resources for a
+ * hyperthreaded sibling.  It is a no-op where no such hint exists.
+ */
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#define SDL_CPUPauseInstruction()   __asm__ __volatile__ ("pause\n")
+#elif defined(__GNUC__) && (defined(__aarch64__) || defined(__ARM_ARCH_7__) || defined(__ARM_ARCH_7A__) || defined(__ARM_ARCH_7R__) || defined(__ARM_ARCH_7S__))
+#define SDL_CPUPauseInstruction()   __asm__ __volatile__ ("yield" : : : "memory")
+#elif defined(HAVE_MSC_ATOMICS) && (defined(_M_IX86) || defined(_M_X64))
+#define SDL_CPUPauseInstruction()   _mm_pause()
+#else
+#define SDL_CPUPauseInstruction()   SDL_CompilerBarrier()
+#endif
+
 /**
  * Memory barriers are designed to prevent reads and writes from being
  * reordered by the compiler and being seen out of order on multi-core CPUs.
@@ -347,6 +362,101 @@ SDL_FORCE_INLINE void* SDL_AtomicGetPtr(void* *a)
 #endif
 
 
+/**
+ * \name 64-bit atomic operations
+ *
+ * These are always real functions, implemented with processor specific
+ * 64-bit operations where they exist and with the spin lock emulation
+ * otherwise.
+ */
+/* @{ */
+
+/**
+ * \brief A type representing an atomic 64-bit integer value.  It must be
+ *        naturally aligned, which the declaration takes care of for you.
+ */
+#if defined(__GNUC__)
+typedef struct { Sint64 value __attribute__((aligned(8))); } SDL_atomic64_t;
+#elif defined(_MSC_VER)
+typedef struct { __declspec(align(8)) Sint64 value; } SDL_atomic64_t;
+#else
+typedef struct { Sint64 value; } SDL_atomic64_t;
+#endif
+
+/**
+ * \brief Memory ordering constraints for the explicit atomic operations.
+ *
+ * These have the same meaning as the C11 memory orders.  Platforms which
+ * can't express a weaker ordering use a stronger one.
+ */
+typedef enum
+{
+    SDL_MEMORY_ORDER_RELAXED,
+    SDL_MEMORY_ORDER_ACQUIRE,
+    SDL_MEMORY_ORDER_RELEASE,
+    SDL_MEMORY_ORDER_ACQ_REL,
+    SDL_MEMORY_ORDER_SEQ_CST
+} SDL_MemoryOrder;
+
+/**
+ * \brief Set a 64-bit atomic variable to a new value if it is currently an
+ *        old value.  This is a full memory barrier.
+ *
+ * \return SDL_TRUE if the atomic variable was set, SDL_FALSE otherwise.
+ */
+extern DECLSPEC SDL_bool SDLCALL SDL_AtomicCAS64(SDL_atomic64_t *a, Sint64 oldval, Sint64 newval);
+
+/**
+ * \brief Set a 64-bit atomic variable to a new value if it is currently an
+ *        old value, with the given ordering on success.
+ */
+extern DECLSPEC SDL_bool SDLCALL SDL_AtomicCAS64Explicit(SDL_atomic64_t *a, Sint64 oldval, Sint64 newval, SDL_MemoryOrder order);
+
+/**
+ * \brief Set a 64-bit atomic variable to a value.  This is a full memory barrier.
+ *
+ * \return The previous value of the atomic variable.
+ */
+extern DECLSPEC Sint64 SDLCALL SDL_AtomicSet64(SDL_atomic64_t *a, Sint64 v);
+
+/**
+ * \brief Get the value of a 64-bit atomic variable.  This is a full memory barrier.
+ */
+extern DECLSPEC Sint64 SDLCALL SDL_AtomicGet64(SDL_atomic64_t *a);
+
+/**
+ * \brief Add to a 64-bit atomic variable.  This is a full memory barrier.
+ *
+ * \return The previous value of the atomic variable.
+ */
+extern DECLSPEC Sint64 SDLCALL SDL_AtomicAdd64(SDL_atomic64_t *a, Sint64 v);
+
+/**
+ * \brief Add to a 64-bit atomic variable with the given ordering.
+ *
+ * \return The previous value of the atomic variable.
+ */
+extern DECLSPEC Sint64 SDLCALL SDL_AtomicAdd64Explicit(SDL_atomic64_t *a, Sint64 v, SDL_MemoryOrder order);
+
+/**
+ * \brief Load a 64-bit atomic variable with the given ordering.
+ *
+ * \note SDL_MEMORY_ORDER_RELEASE is not meaningful for a load and is
+ *       treated as SDL_MEMORY_ORDER_SEQ_CST.
+ */
+extern DECLSPEC Sint64 SDLCALL SDL_AtomicLoad64(SDL_atomic64_t *a, SDL_MemoryOrder order);
+
+/**
+ * \brief Store to a 64-bit atomic variable with the given ordering.
+ *
+ * \note SDL_MEMORY_ORDER_ACQUIRE is not meaningful for a store and is
+ *       treated as SDL_MEMORY_ORDER_SEQ_CST.
+ */
+extern DECLSPEC void SDLCALL SDL_AtomicStore64(SDL_atomic64_t *a, Sint64 v, SDL_MemoryOrder order);
+
+/* @} *//* 64-bit atomic operations */
+
+
 /* Ends C function definitions when using C++ */
 #ifdef __cplusplus
 }
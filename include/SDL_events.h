@@ -134,6 +134,9 @@ typedef enum
     /* Drag and drop events */
     SDL_DROPFILE        = 0x1000, /**< The system requests a file open */
 
+    /* Asynchronous I/O events */
+    SDL_ASYNCIOCOMPLETE = 0x1100, /**< An asynchronous I/O request finished */
+
     /** Events ::SDL_USEREVENT through ::SDL_LASTEVENT are for your use,
      *  and should be allocated with SDL_RegisterEvents()
      */
@@ -441,6 +444,22 @@ typedef struct SDL_DropEvent
 } SDL_DropEvent;
 
 
+struct SDL_AsyncIO;
+
+/**
+ *  \brief An event used to report a finished asynchronous I/O request (event.asyncio.*)
+ */
+typedef struct SDL_AsyncIOEvent
+{
+    Uint32 type;        /**< ::SDL_ASYNCIOCOMPLETE */
+    Uint32 timestamp;
+    struct SDL_AsyncIO *request; /**< The request, which should be freed with SDL_FreeAsyncIO() */
+    void *userdata;     /**< The userdata passed to SDL_ReadAsync() */
+    int status;         /**< The ::SDL_AsyncIOStatus of the request */
+    size_t bytes;       /**< The number of bytes read */
+} SDL_AsyncIOEvent;
+
+
 /**
  *  \brief The "quit requested" event
  */
@@ -518,6 +537,7 @@ typedef union SDL_Event
     SDL_MultiGestureEvent mgesture; /**< Gesture event data */
     SDL_DollarGestureEvent dgesture; /**< Gesture event data */
     SDL_DropEvent drop;             /**< Drag and drop event data */
+    SDL_AsyncIOEvent asyncio;       /**< Asynchronous I/O event data */
 
     /* This is necessary for ABI compatibility between Visual C++ and GCC
        Visual C++ will respect the push pack pragma and use 52 bytes for
@@ -284,6 +284,79 @@ extern "C" {
 #define SDL_HINT_VIDEO_HIGHDPI_DISABLED "SDL_VIDEO_HIGHDPI_DISABLED"
 
 
+/**
+ *  \brief A variable controlling how many times SDL_LockMutex() polls a
+ *         contended mutex before blocking in the kernel.
+ *
+ *  Spinning briefly avoids a pair of context switches when the lock is only
+ *  held for a short time, which is the common case for SDL's internal locks.
+ *
+ *  If this variable is set to "0", mutexes block immediately on contention.
+ *
+ *  The default is "100" on multi-core systems and "0" otherwise.  This hint
+ *  is read when a mutex is created.
+ */
+#define SDL_HINT_MUTEX_SPIN_COUNT "SDL_MUTEX_SPIN_COUNT"
+
+
+/**
+ *  \brief A variable setting the stack size, in bytes, of threads created
+ *         with SDL_CreateThread().
+ *
+ *  Threads that do little work can get away with a much smaller stack than
+ *  the system default, which saves address space when many are created.
+ *
+ *  The default is "0", which uses the system default stack size.  This hint
+ *  is read when a thread is created.
+ */
+#define SDL_HINT_THREAD_STACK_SIZE "SDL_THREAD_STACK_SIZE"
+
+/**
+ *  \brief  A variable controlling whether SDL_RWFromFile() memory maps files opened for reading.
+ *
+ *  This variable can be set to the following values:
+ *    "0"       - Files are only mapped if the mode string contains 'm' (default)
+ *    "1"       - All files opened read-only are mapped when possible
+ *
+ *  If a file can't be mapped, it is read through the normal file functions.
+ */
+#define SDL_HINT_RWOPS_MMAP "SDL_RWOPS_MMAP"
+
+/**
+ *  \brief  A variable setting the number of threads that run asynchronous I/O requests.
+ *
+ *  The default is "2".  This hint is read when the first request is queued.
+ */
+#define SDL_HINT_ASYNCIO_THREADS "SDL_ASYNCIO_THREADS"
+
+/**
+ *  \brief  A variable controlling whether RGB surfaces blitted onto palettized surfaces are dithered.
+ *
+ *  This variable can be set to the following values:
+ *    "0"       - Each pixel gets the nearest palette color (default)
+ *    "1"       - Opaque blits use a 4x4 ordered dither, which trades a fine
+ *                pattern for smoother gradients with small palettes
+ *
+ *  This hint is read when the blit between two surfaces is set up, so it
+ *  applies to surfaces mapped to a new destination after it is changed.
+ *  Blits are cached until a hint changes, so to change this at runtime use
+ *  SDL_SetHint() rather than the environment variable.
+ */
+#define SDL_HINT_PALETTE_DITHER "SDL_PALETTE_DITHER"
+
+/**
+ *  \brief  A variable setting the most memory, in bytes, that freed surface pixels may hold for reuse.
+ *
+ *  Surfaces created and freed every frame get their pixels back from this
+ *  pool instead of allocating them again.  The default is "16777216", and
+ *  "0" frees surface pixels right away.
+ *
+ *  Lowering the limit doesn't free memory already in the pool, call
+ *  SDL_FlushSurfacePool() for that.
+ */
+#define SDL_HINT_SURFACE_POOL_SIZE "SDL_SURFACE_POOL_SIZE"
+
+
 /**
  *  \brief  An enumeration of hint priorities
  */
@@ -323,6 +396,46 @@ extern DECLSPEC SDL_bool SDLCALL SDL_SetHint(const char *name,
  */
 extern DECLSPEC const char * SDLCALL SDL_GetHint(const char *name);
 
+/**
+ *  \brief A handle to a hint, for reading it without looking up its name
+ */
+struct SDL_HintHandle;
+typedef struct SDL_HintHandle SDL_HintHandle;
+
+/**
+ *  \brief Get a handle to a hint
+ *
+ *  Handles stay valid until the program exits, even across SDL_Quit(),
+ *  so they can be kept in static variables.
+ *
+ *  \return The handle, or NULL if out of memory
+ */
+extern DECLSPEC SDL_HintHandle * SDLCALL SDL_RegisterHint(const char *name);
+
+/**
+ *  \brief Get the value of a hint from its handle
+ *
+ *  This returns the same value as SDL_GetHint(), except that the
+ *  environment is only read again after a hint has changed.  Changing an
+ *  environment variable while the program runs doesn't change the hint
+ *  generation, so set it before starting or use SDL_SetHint() instead.
+ *
+ *  \return The string value of a hint variable.
+ */
+extern DECLSPEC const char * SDLCALL SDL_GetHintValue(SDL_HintHandle *handle);
+
+/**
+ *  \brief Get the hint generation
+ *
+ *  The generation changes whenever the value or priority of any hint
+ *  changes, so a value parsed from a hint only needs to be parsed again if
+ *  the generation is different from when it was parsed.  Only SDL_SetHint()
+ *  and friends change the generation; changes to the environment don't.
+ *
+ *  \return The current hint generation, which is never 0
+ */
+extern DECLSPEC Uint32 SDLCALL SDL_GetHintGeneration(void);
+
 /**
  *  \brief Add a function to watch a particular hint
  *
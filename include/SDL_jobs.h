@@ -0,0 +1,178 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2013 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/**
+ *  \file SDL_jobs.h
+ *
+ *  Header for the SDL job system.
+ *
+ *  A job pool runs many small functions across a fixed set of worker
+ *  threads.  Each worker keeps its own queue of jobs and steals from the
+ *  other workers when it runs dry, so submitting work is cheap and the
+ *  load balances itself.
+ *
+ *  Jobs are submitted to a job group, which lets you wait for a batch of
+ *  jobs to complete.  The waiting thread runs queued jobs while it waits,
+ *  so it is safe to wait on a group from inside a job.
+ */
+
+#ifndef _SDL_jobs_h
+#define _SDL_jobs_h
+
+#include "SDL_stdinc.h"
+#include "SDL_error.h"
+
+#include "begin_code.h"
+/* Set up for C function definitions, even when using C++ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The SDL job pool structure, defined in SDL_jobs.c */
+struct SDL_JobPool;
+typedef struct SDL_JobPool SDL_JobPool;
+
+/* The SDL job group structure, defined in SDL_jobs.c */
+struct SDL_JobGroup;
+typedef struct SDL_JobGroup SDL_JobGroup;
+
+/**
+ *  The function passed to SDL_SubmitJob().
+ */
+typedef void (SDLCALL * SDL_JobFunction) (void *data);
+
+/**
+ *  The function passed to SDL_ParallelFor().
+ *  It is called with a half-open range of indices [start, end) to process.
+ */
+typedef void (SDLCALL * SDL_ParallelForFunction) (void *data, int start, int end);
+
+/**
+ *  Create a job pool.
+ *
+ *  \param num_threads The number of worker threads to start, or 0 to use
+ *                     one worker per CPU core.
+ *
+ *  \return The new job pool, or NULL on error.
+ */
+extern DECLSPEC SDL_JobPool *SDLCALL SDL_CreateJobPool(int num_threads);
+
+/**
+ *  Get the job pool shared by the application and SDL itself.
+ *
+ *  The shared pool is created on first use with one worker per CPU core,
+ *  and is destroyed by SDL_Quit().  It may also be passed as NULL to any
+ *  function taking a job pool.
+ */
+extern DECLSPEC SDL_JobPool *SDLCALL SDL_GetSharedJobPool(void);
+
+/**
+ *  Get the number of worker threads in a job pool.
+ */
+extern DECLSPEC int SDLCALL SDL_GetJobPoolThreadCount(SDL_JobPool * pool);
+
+/**
+ *  Wait for all queued jobs to finish and destroy a job pool.
+ */
+extern DECLSPEC void SDLCALL SDL_DestroyJobPool(SDL_JobPool * pool);
+
+/**
+ *  Create a job group for submitting jobs to a job pool.
+ *
+ *  \return The new job group, or NULL on error.
+ */
+extern DECLSPEC SDL_JobGroup *SDLCALL SDL_CreateJobGroup(SDL_JobPool * pool);
+
+/**
+ *  Queue a job to be run on a worker thread.
+ *
+ *  If the job can't be queued it is run immediately on the calling thread.
+ *
+ *  \return 0, or -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_SubmitJob(SDL_JobGroup * group,
+                                          SDL_JobFunction fn, void *data);
+
+/**
+ *  Wait for all jobs submitted to a group to finish.
+ *
+ *  The calling thread runs queued jobs while it waits.
+ *
+ *  \return 0, or -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_WaitJobGroup(SDL_JobGroup * group);
+
+/**
+ *  Wait for all jobs submitted to a group to finish, and destroy it.
+ */
+extern DECLSPEC void SDLCALL SDL_DestroyJobGroup(SDL_JobGroup * group);
+
+/**
+ *  Run a function over the index range [start, end) across a job pool,
+ *  returning when the whole range has been processed.
+ *
+ *  \param pool The job pool to use, or NULL for the shared pool.
+ *  \param start The first index to process.
+ *  \param end One past the last index to process.
+ *  \param grain The smallest number of indices given to one call, or 0 to
+ *               split the range evenly across the workers.
+ *  \param fn The function to call for each sub-range.
+ *  \param data A pointer passed to each call of \c fn.
+ *
+ *  \return 0, or -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_ParallelFor(SDL_JobPool * pool,
+                                            int start, int end, int grain,
+                                            SDL_ParallelForFunction fn,
+                                            void *data);
+
+
+/**
+ *  Sort an array across a job pool, like SDL_qsort().
+ *
+ *  The array is split into a chunk per worker, which are sorted in
+ *  parallel and then merged in parallel.  Small arrays are sorted on the
+ *  calling thread.  The comparison function is called from several
+ *  threads at once.
+ *
+ *  \param pool The job pool to use, or NULL for the shared pool.
+ *  \param base The array to sort.
+ *  \param nmemb The number of elements in the array.
+ *  \param size The size of each element, in bytes.
+ *  \param compare The comparison function, as for SDL_qsort().
+ *
+ *  \return 0, or -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_ParallelSort(SDL_JobPool * pool,
+                                             void *base, size_t nmemb,
+                                             size_t size,
+                                             int (*compare) (const void *,
+                                                             const void *));
+
+/* Ends C function definitions when using C++ */
+#ifdef __cplusplus
+}
+#endif
+#include "close_code.h"
+
+#endif /* _SDL_jobs_h */
+
+/* vi: set ts=4 sw=4 expandtab: */
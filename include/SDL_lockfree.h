@@ -0,0 +1,191 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2013 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/**
+ *  \file SDL_lockfree.h
+ *
+ *  Lock-free containers built on the SDL atomic operations.
+ *
+ *  All of these have a fixed capacity chosen when they are created, and
+ *  never allocate memory or block after that.  Operations that would
+ *  overflow or underflow the container fail immediately instead.
+ */
+
+#ifndef _SDL_lockfree_h
+#define _SDL_lockfree_h
+
+#include "SDL_stdinc.h"
+#include "SDL_error.h"
+
+#include "begin_code.h"
+/* Set up for C function definitions, even when using C++ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ *  \name Single producer, single consumer byte ring buffer
+ *
+ *  Exactly one thread may write to the ring buffer and exactly one thread
+ *  may read from it at any time.  This is the right tool for streaming
+ *  audio or other bytes from one thread to another.
+ */
+/* @{ */
+
+/* The SDL ring buffer structure, defined in SDL_lockfree.c */
+struct SDL_RingBuffer;
+typedef struct SDL_RingBuffer SDL_RingBuffer;
+
+/**
+ *  Create a ring buffer that holds at least \c size bytes.
+ *  The size is rounded up to a power of two.
+ */
+extern DECLSPEC SDL_RingBuffer *SDLCALL SDL_CreateRingBuffer(Uint32 size);
+
+/**
+ *  Destroy a ring buffer.
+ */
+extern DECLSPEC void SDLCALL SDL_DestroyRingBuffer(SDL_RingBuffer * rb);
+
+/**
+ *  Write up to \c len bytes into the ring buffer.
+ *
+ *  \return The number of bytes written, which is less than \c len if the
+ *          ring buffer is full.
+ */
+extern DECLSPEC Uint32 SDLCALL SDL_RingBufferWrite(SDL_RingBuffer * rb,
+                                                   const void *data, Uint32 len);
+
+/**
+ *  Read up to \c len bytes from the ring buffer.
+ *
+ *  \return The number of bytes read, which is less than \c len if the
+ *          ring buffer ran out of data.
+ */
+extern DECLSPEC Uint32 SDLCALL SDL_RingBufferRead(SDL_RingBuffer * rb,
+                                                  void *data, Uint32 len);
+
+/**
+ *  Get the number of bytes that can currently be read.
+ */
+extern DECLSPEC Uint32 SDLCALL SDL_RingBufferAvailable(SDL_RingBuffer * rb);
+
+/**
+ *  Get the number of bytes that can currently be written.
+ */
+extern DECLSPEC Uint32 SDLCALL SDL_RingBufferSpace(SDL_RingBuffer * rb);
+
+/* @} *//* Ring buffer functions */
+
+
+/**
+ *  \name Multiple producer, multiple consumer bounded queue
+ *
+ *  Any number of threads may push and pop fixed size elements, which come
+ *  out in the order they went in.
+ */
+/* @{ */
+
+/* The SDL lock-free queue structure, defined in SDL_lockfree.c */
+struct SDL_LockFreeQueue;
+typedef struct SDL_LockFreeQueue SDL_LockFreeQueue;
+
+/**
+ *  Create a queue holding at least \c capacity elements of
+ *  \c element_size bytes.  The capacity is rounded up to a power of two.
+ */
+extern DECLSPEC SDL_LockFreeQueue *SDLCALL SDL_CreateLockFreeQueue(Uint32 capacity, Uint32 element_size);
+
+/**
+ *  Destroy a lock-free queue.
+ */
+extern DECLSPEC void SDLCALL SDL_DestroyLockFreeQueue(SDL_LockFreeQueue * queue);
+
+/**
+ *  Copy an element onto the end of the queue.
+ *
+ *  \return SDL_TRUE if the element was queued, SDL_FALSE if the queue is full.
+ */
+extern DECLSPEC SDL_bool SDLCALL SDL_LockFreeQueuePush(SDL_LockFreeQueue * queue,
+                                                       const void *element);
+
+/**
+ *  Copy the element at the front of the queue into \c element and remove it.
+ *
+ *  \return SDL_TRUE if an element was dequeued, SDL_FALSE if the queue is empty.
+ */
+extern DECLSPEC SDL_bool SDLCALL SDL_LockFreeQueuePop(SDL_LockFreeQueue * queue,
+                                                      void *element);
+
+/* @} *//* Lock-free queue functions */
+
+
+/**
+ *  \name Multiple producer, multiple consumer bounded stack
+ *
+ *  Any number of threads may push and pop fixed size elements, which come
+ *  out in the reverse order they went in.  Each link is tagged with a
+ *  counter, so the stack is safe from the ABA problem.
+ */
+/* @{ */
+
+/* The SDL lock-free stack structure, defined in SDL_lockfree.c */
+struct SDL_LockFreeStack;
+typedef struct SDL_LockFreeStack SDL_LockFreeStack;
+
+/**
+ *  Create a stack holding up to \c capacity elements of \c element_size bytes.
+ */
+extern DECLSPEC SDL_LockFreeStack *SDLCALL SDL_CreateLockFreeStack(Uint32 capacity, Uint32 element_size);
+
+/**
+ *  Destroy a lock-free stack.
+ */
+extern DECLSPEC void SDLCALL SDL_DestroyLockFreeStack(SDL_LockFreeStack * stack);
+
+/**
+ *  Copy an element onto the top of the stack.
+ *
+ *  \return SDL_TRUE if the element was pushed, SDL_FALSE if the stack is full.
+ */
+extern DECLSPEC SDL_bool SDLCALL SDL_LockFreeStackPush(SDL_LockFreeStack * stack,
+                                                       const void *element);
+
+/**
+ *  Copy the element on the top of the stack into \c element and remove it.
+ *
+ *  \return SDL_TRUE if an element was popped, SDL_FALSE if the stack is empty.
+ */
+extern DECLSPEC SDL_bool SDLCALL SDL_LockFreeStackPop(SDL_LockFreeStack * stack,
+                                                      void *element);
+
+/* @} *//* Lock-free stack functions */
+
+
+/* Ends C function definitions when using C++ */
+#ifdef __cplusplus
+}
+#endif
+#include "close_code.h"
+
+#endif /* _SDL_lockfree_h */
+
+/* vi: set ts=4 sw=4 expandtab: */
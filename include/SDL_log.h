@@ -199,6 +199,34 @@ extern DECLSPEC void SDLCALL SDL_LogGetOutputFunction(SDL_LogOutputFunction *cal
  */
 extern DECLSPEC void SDLCALL SDL_LogSetOutputFunction(SDL_LogOutputFunction callback, void *userdata);
 
+/**
+ *  \brief Turn asynchronous logging on or off.
+ *
+ *  When logging is asynchronous, messages are formatted into a queue
+ *  without taking any locks, and a background thread passes them to the
+ *  log output function.  If the queue is full, messages are dropped and
+ *  counted, and a warning with the number dropped is logged once there is
+ *  room again.
+ *
+ *  Turning asynchronous logging off, or calling SDL_Quit(), waits for the
+ *  queued messages to be output.
+ *
+ *  \return 0 on success, or -1 if the background thread couldn't be started.
+ */
+extern DECLSPEC int SDLCALL SDL_LogSetAsync(SDL_bool enabled);
+
+/**
+ *  \brief Wait for all queued log messages to be output.
+ *
+ *  This does nothing if logging isn't asynchronous.
+ */
+extern DECLSPEC void SDLCALL SDL_LogFlush(void);
+
+/**
+ *  \brief Get the number of log messages dropped because the queue was full.
+ */
+extern DECLSPEC int SDLCALL SDL_LogGetDropped(void);
+
 
 /* Ends C function definitions when using C++ */
 #ifdef __cplusplus
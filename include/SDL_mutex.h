@@ -240,6 +240,112 @@ extern DECLSPEC int SDLCALL SDL_CondWaitTimeout(SDL_cond * cond,
 /* @} *//* Condition variable functions */
 
 
+/**
+ *  \name Read/write lock functions
+ *
+ *  A read/write lock lets any number of readers hold it at once, or a
+ *  single writer.  It is a better fit than a mutex for data that is read
+ *  far more often than it is changed.
+ *
+ *  Read/write locks are not recursive.  A thread holding the lock for
+ *  reading must not try to lock it for writing, or it will deadlock.
+ */
+/* @{ */
+
+/* The SDL read/write lock structure, defined in SDL_sysrwlock.c */
+struct SDL_rwlock;
+typedef struct SDL_rwlock SDL_rwlock;
+
+/**
+ *  Create a read/write lock.
+ */
+extern DECLSPEC SDL_rwlock *SDLCALL SDL_CreateRWLock(void);
+
+/**
+ *  Lock for shared read access, blocking while a writer holds the lock.
+ *
+ *  \return 0, or -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_LockRWLockForReading(SDL_rwlock * rwlock);
+
+/**
+ *  Lock for exclusive write access, blocking while any thread holds the lock.
+ *
+ *  \return 0, or -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_LockRWLockForWriting(SDL_rwlock * rwlock);
+
+/**
+ *  Try to lock for reading without blocking.
+ *
+ *  \return 0, ::SDL_MUTEX_TIMEDOUT, or -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_TryLockRWLockForReading(SDL_rwlock * rwlock);
+
+/**
+ *  Try to lock for writing without blocking.
+ *
+ *  \return 0, ::SDL_MUTEX_TIMEDOUT, or -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_TryLockRWLockForWriting(SDL_rwlock * rwlock);
+
+/**
+ *  Unlock a read/write lock held for reading or writing.
+ *
+ *  \return 0, or -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_UnlockRWLock(SDL_rwlock * rwlock);
+
+/**
+ *  Destroy a read/write lock.
+ */
+extern DECLSPEC void SDLCALL SDL_DestroyRWLock(SDL_rwlock * rwlock);
+
+/* @} *//* Read/write lock functions */
+
+
+/**
+ *  \name Lock statistics
+ */
+/* @{ */
+
+/**
+ *  Contention counters for a lock, see SDL_GetMutexStats() and
+ *  SDL_GetSpinLockStats().
+ */
+typedef struct SDL_LockStats
+{
+    Uint32 locks;       /**< Number of times the lock was acquired */
+    Uint32 contended;   /**< Acquisitions that found the lock already held */
+    Uint32 spins;       /**< Busy-wait iterations spent on contended acquisitions */
+    Uint32 sleeps;      /**< Times a waiter yielded or blocked in the kernel */
+} SDL_LockStats;
+
+/**
+ *  Get the contention counters for a mutex.
+ *
+ *  The counters are updated while the mutex is held, so they are cheap to
+ *  maintain, but only approximate if read while other threads hold the lock.
+ *
+ *  \return 0, or -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_GetMutexStats(SDL_mutex * mutex,
+                                              SDL_LockStats * stats);
+
+/**
+ *  Get the contention counters accumulated by all SDL_AtomicLock() calls.
+ *
+ *  Only contended acquisitions are counted, so \c locks is always equal to
+ *  \c contended.  The counters are not maintained on platforms without
+ *  native atomic operations.
+ *
+ *  \return 0, or -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_GetSpinLockStats(SDL_LockStats * stats);
+
+/* @} *//* Lock statistics */
+
+
 /* Ends C function definitions when using C++ */
 #ifdef __cplusplus
 }
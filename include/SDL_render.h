@@ -645,6 +645,47 @@ extern DECLSPEC int SDLCALL SDL_SetRenderDrawBlendMode(SDL_Renderer * renderer,
 extern DECLSPEC int SDLCALL SDL_GetRenderDrawBlendMode(SDL_Renderer * renderer,
                                                        SDL_BlendMode *blendMode);
 
+/**
+ *  \brief Set the width and anti-aliasing used for line drawing operations.
+ *
+ *  \param renderer The renderer for which the line style should be set.
+ *  \param width The line width in pixels, before render scaling. The
+ *               default is 1.0.
+ *  \param antialias SDL_TRUE to blend the line edges by pixel coverage,
+ *                   SDL_FALSE (the default) for hard edges.
+ *
+ *  \return 0 on success, or -1 on error
+ *
+ *  \note Wide and anti-aliased lines are drawn by the software, OpenGL and
+ *        OpenGL ES 2.0 renderers. Other renderers keep drawing 1 pixel lines
+ *        with hard edges. The exact shape of joints and line ends may differ
+ *        slightly between renderers.
+ *
+ *  \note With ::SDL_BLENDMODE_NONE, the anti-aliased edges are blended.
+ *
+ *  \sa SDL_GetRenderDrawLineStyle()
+ *  \sa SDL_RenderDrawLines()
+ */
+extern DECLSPEC int SDLCALL SDL_SetRenderDrawLineStyle(SDL_Renderer * renderer,
+                                                       float width,
+                                                       SDL_bool antialias);
+
+/**
+ *  \brief Get the width and anti-aliasing used for line drawing operations.
+ *
+ *  \param renderer The renderer from which the line style should be queried.
+ *  \param width A pointer filled in with the line width, may be NULL.
+ *  \param antialias A pointer filled in with whether lines are anti-aliased,
+ *                   may be NULL.
+ *
+ *  \return 0 on success, or -1 on error
+ *
+ *  \sa SDL_SetRenderDrawLineStyle()
+ */
+extern DECLSPEC int SDLCALL SDL_GetRenderDrawLineStyle(SDL_Renderer * renderer,
+                                                       float *width,
+                                                       SDL_bool *antialias);
+
 /**
  *  \brief Clear the current rendering target with the drawing color
  *
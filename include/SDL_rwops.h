@@ -45,6 +45,9 @@ extern "C" {
 #define SDL_RWOPS_JNIFILE   3   /* Android asset */
 #define SDL_RWOPS_MEMORY    4   /* Memory stream */
 #define SDL_RWOPS_MEMORY_RO 5   /* Read-Only memory stream */
+#define SDL_RWOPS_MAPPED    6   /* Read-Only memory mapped file */
+#define SDL_RWOPS_BUFFERED  7   /* Buffered stream wrapping another one */
+#define SDL_RWOPS_ARCHIVE   8   /* File inside an archive */
 
 /**
  * This is the read/write operation structure -- very basic.
@@ -150,6 +153,12 @@ typedef struct SDL_RWops
  */
 /* @{ */
 
+/**
+ *  Open a file.  The mode string is the same as for fopen(), and may also
+ *  contain 'm' to memory map a file that is opened read-only.
+ *
+ *  \sa SDL_HINT_RWOPS_MMAP
+ */
 extern DECLSPEC SDL_RWops *SDLCALL SDL_RWFromFile(const char *file,
                                                   const char *mode);
 
@@ -165,9 +174,46 @@ extern DECLSPEC SDL_RWops *SDLCALL SDL_RWFromMem(void *mem, int size);
 extern DECLSPEC SDL_RWops *SDLCALL SDL_RWFromConstMem(const void *mem,
                                                       int size);
 
+/**
+ *  Create a stream that reads and writes another stream through a buffer,
+ *  turning many small reads and writes into a few large ones.
+ *
+ *  Seeks within the buffered data don't touch the wrapped stream.  When the
+ *  buffered stream is closed, pending writes are flushed and the wrapped
+ *  stream is left at the position the buffered stream had reached.
+ *
+ *  \param src The stream to wrap, which must not be used directly while
+ *             the buffered stream is open.
+ *  \param buffer_size The size of the buffer in bytes, or 0 for the default.
+ *  \param autoclose Close \c src when the buffered stream is closed.
+ */
+extern DECLSPEC SDL_RWops *SDLCALL SDL_RWFromBuffered(SDL_RWops * src,
+                                                      int buffer_size,
+                                                      SDL_bool autoclose);
+
 /* @} *//* RWFrom functions */
 
 
+/**
+ *  Get a pointer to the data at the current position of a stream backed by
+ *  memory, so it can be parsed in place without copying.
+ *
+ *  This works with streams from SDL_RWFromMem(), SDL_RWFromConstMem() and
+ *  files that SDL_RWFromFile() memory mapped.  The pointer stays valid
+ *  until the stream is closed; use SDL_RWseek() to move past the data
+ *  you've used.
+ *
+ *  \param context The stream to access.
+ *  \param available Filled in with the number of bytes from the current
+ *                   position to the end of the stream, may be NULL.
+ *
+ *  \return A read-only pointer to the data, or NULL if the stream isn't
+ *          backed by memory.
+ */
+extern DECLSPEC const void *SDLCALL SDL_RWGetPointer(SDL_RWops * context,
+                                                     size_t * available);
+
+
 extern DECLSPEC SDL_RWops *SDLCALL SDL_AllocRW(void);
 extern DECLSPEC void SDLCALL SDL_FreeRW(SDL_RWops * area);
 
@@ -232,11 +232,127 @@ extern DECLSPEC void *SDLCALL SDL_calloc(size_t nmemb, size_t size);
 extern DECLSPEC void *SDLCALL SDL_realloc(void *mem, size_t size);
 extern DECLSPEC void SDLCALL SDL_free(void *mem);
 
+typedef void *(SDLCALL *SDL_malloc_func)(size_t size);
+typedef void *(SDLCALL *SDL_calloc_func)(size_t nmemb, size_t size);
+typedef void *(SDLCALL *SDL_realloc_func)(void *mem, size_t size);
+typedef void (SDLCALL *SDL_free_func)(void *mem);
+
+/**
+ *  Get the current set of SDL memory functions.
+ */
+extern DECLSPEC void SDLCALL SDL_GetMemoryFunctions(SDL_malloc_func *malloc_func,
+                                                    SDL_calloc_func *calloc_func,
+                                                    SDL_realloc_func *realloc_func,
+                                                    SDL_free_func *free_func);
+
+/**
+ *  Replace SDL's memory allocation functions with a custom set.
+ *
+ *  \note This should be called before any other SDL function, while no
+ *        other threads are running.  Memory allocated with the previous
+ *        functions must not be passed to the new ones.
+ *
+ *  \return 0, or -1 if any of the functions are NULL.
+ */
+extern DECLSPEC int SDLCALL SDL_SetMemoryFunctions(SDL_malloc_func malloc_func,
+                                                   SDL_calloc_func calloc_func,
+                                                   SDL_realloc_func realloc_func,
+                                                   SDL_free_func free_func);
+
+/**
+ *  The subsystems whose memory use is reported by SDL_GetMemoryUsage().
+ */
+typedef enum
+{
+    SDL_MEMORY_VIDEO_SURFACES,  /**< Surfaces and their pixels */
+    SDL_MEMORY_AUDIO_BUFFERS,   /**< Open audio devices and their buffers */
+    SDL_MEMORY_EVENT_QUEUE,     /**< Event queue entries */
+    SDL_MEMORY_RENDER_TEXTURES, /**< Textures and their streaming pixels */
+    SDL_NUM_MEMORY_CATEGORIES
+} SDL_MemoryCategory;
+
+/**
+ *  The memory held by a subsystem.
+ */
+typedef struct SDL_MemoryUsage
+{
+    Uint64 bytes;       /**< Bytes currently allocated */
+    int allocations;    /**< Number of live allocations */
+} SDL_MemoryUsage;
+
+/**
+ *  Get the memory currently held by one of SDL's subsystems.
+ *
+ *  \return 0, or -1 if the category is invalid.
+ */
+extern DECLSPEC int SDLCALL SDL_GetMemoryUsage(SDL_MemoryCategory category,
+                                               SDL_MemoryUsage *usage);
+
+/**
+ *  The number of small object size classes in SDL_MallocStats.
+ *  Class \c i holds allocations of up to 16 * (i + 1) bytes.
+ */
+#define SDL_MALLOC_SIZE_CLASSES 16
+
+/**
+ *  Statistics for SDL's built in memory allocator.
+ *
+ *  Counters are gathered a batch at a time from each thread, so they may
+ *  lag slightly behind the true values, or be briefly out of step with each
+ *  other, while other threads are allocating.  Everything a thread did is
+ *  counted by the time it has exited.
+ */
+typedef struct SDL_MallocStats
+{
+    size_t bytes_in_use;        /**< Bytes currently allocated */
+    size_t peak_bytes_in_use;   /**< The most bytes that have been allocated at once */
+    Uint32 class_allocations[SDL_MALLOC_SIZE_CLASSES];  /**< Total allocations in each size class */
+    Uint32 class_in_use[SDL_MALLOC_SIZE_CLASSES];       /**< Blocks of each size class currently allocated */
+} SDL_MallocStats;
+
+/**
+ *  Get statistics for SDL's built in memory allocator.
+ *
+ *  \return 0, or -1 if SDL was built to use the C runtime's malloc().
+ */
+extern DECLSPEC int SDLCALL SDL_GetMallocStats(SDL_MallocStats *stats);
+
 extern DECLSPEC char *SDLCALL SDL_getenv(const char *name);
 extern DECLSPEC int SDLCALL SDL_setenv(const char *name, const char *value, int overwrite);
 
 extern DECLSPEC void SDLCALL SDL_qsort(void *base, size_t nmemb, size_t size, int (*compare) (const void *, const void *));
 
+/**
+ *  The type of the key passed to SDL_SortByKey().
+ */
+typedef enum
+{
+    SDL_SORTKEY_UINT32,
+    SDL_SORTKEY_SINT32,
+    SDL_SORTKEY_UINT64,
+    SDL_SORTKEY_SINT64,
+    SDL_SORTKEY_FLOAT,
+    SDL_SORTKEY_DOUBLE
+} SDL_SortKeyType;
+
+/**
+ *  Sort an array in ascending order of a number stored in each element,
+ *  using a radix sort instead of comparisons.
+ *
+ *  The sort is stable, and takes time proportional to the number of
+ *  elements.  Negative floating point numbers sort before positive ones,
+ *  with NaNs at the ends.
+ *
+ *  \param base The array to sort.
+ *  \param nmemb The number of elements in the array.
+ *  \param size The size of each element, in bytes.
+ *  \param key_offset The offset of the key within each element, in bytes.
+ *  \param key_type The type of the key.
+ *
+ *  \return 0, or -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_SortByKey(void *base, size_t nmemb, size_t size, size_t key_offset, SDL_SortKeyType key_type);
+
 extern DECLSPEC int SDLCALL SDL_abs(int x);
 
 /* !!! FIXME: these have side effects. You probably shouldn't use them. */
@@ -301,6 +417,8 @@ extern DECLSPEC size_t SDLCALL SDL_wcslcat(wchar_t *dst, const wchar_t *src, siz
 extern DECLSPEC size_t SDLCALL SDL_strlen(const char *str);
 extern DECLSPEC size_t SDLCALL SDL_strlcpy(char *dst, const char *src, size_t maxlen);
 extern DECLSPEC size_t SDLCALL SDL_utf8strlcpy(char *dst, const char *src, size_t dst_bytes);
+extern DECLSPEC size_t SDLCALL SDL_utf8strlen(const char *str);
+extern DECLSPEC SDL_bool SDLCALL SDL_utf8valid(const char *str, size_t len);
 extern DECLSPEC size_t SDLCALL SDL_strlcat(char *dst, const char *src, size_t maxlen);
 extern DECLSPEC char *SDLCALL SDL_strdup(const char *str);
 extern DECLSPEC char *SDLCALL SDL_strrev(char *str);
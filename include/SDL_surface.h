@@ -181,11 +181,42 @@ extern DECLSPEC SDL_Surface *SDLCALL SDL_LoadBMP_RW(SDL_RWops * src,
  */
 #define SDL_LoadBMP(file)   SDL_LoadBMP_RW(SDL_RWFromFile(file, "rb"), 1)
 
+/**
+ *  Load a surface from a seekable SDL data stream, converting it to the
+ *  given pixel format as it is read.
+ *
+ *  This is faster than loading the surface and converting it afterwards,
+ *  since no copy of the image is made in the format of the file.
+ *
+ *  \param src The stream to read from.
+ *  \param freesrc Non-zero to close the stream after it is read.
+ *  \param pixel_format One of the ::SDL_PixelFormatEnum values, or
+ *                      ::SDL_PIXELFORMAT_UNKNOWN to keep the format of the
+ *                      file.  Indexed formats are only supported if the
+ *                      file has the same format.
+ *
+ *  \return the new surface, or NULL if there was an error.
+ */
+extern DECLSPEC SDL_Surface *SDLCALL SDL_LoadBMPFormat_RW(SDL_RWops * src,
+                                                          int freesrc,
+                                                          Uint32 pixel_format);
+
+/**
+ *  Load a surface from a file, converting it to the given pixel format.
+ *
+ *  Convenience macro.
+ */
+#define SDL_LoadBMPFormat(file, pixel_format) \
+        SDL_LoadBMPFormat_RW(SDL_RWFromFile(file, "rb"), 1, pixel_format)
+
 /**
  *  Save a surface to a seekable SDL data stream (memory or file).
  *
  *  If \c freedst is non-zero, the stream will be closed after being written.
  *
+ *  Surfaces that aren't already in a format BMP files can hold are
+ *  converted a row at a time while they are written.
+ *
  *  \return 0 if successful or -1 if there was an error.
  */
 extern DECLSPEC int SDLCALL SDL_SaveBMP_RW
@@ -491,6 +522,64 @@ extern DECLSPEC int SDLCALL SDL_LowerBlitScaled
     (SDL_Surface * src, SDL_Rect * srcrect,
     SDL_Surface * dst, SDL_Rect * dstrect);
 
+/**
+ *  Counters for the blit setups shared between surfaces, see
+ *  SDL_GetBlitCacheStats().
+ */
+typedef struct SDL_BlitCacheStats
+{
+    Uint32 hits;            /**< Blit functions found in the cache */
+    Uint32 misses;          /**< Blit functions that had to be chosen */
+    Uint32 table_hits;      /**< Color lookup tables found in the cache */
+    Uint32 table_misses;    /**< Color lookup tables that had to be built */
+} SDL_BlitCacheStats;
+
+/**
+ *  \brief Get the counters for the blit setups shared between surfaces.
+ *
+ *  Surfaces set up a blit again whenever they are blitted to a different
+ *  surface, or their color modulation, blend mode or color key changes.
+ *  The blit function and color lookup tables chosen for the pixel formats,
+ *  palettes and flags involved are cached, so this is usually cheap.
+ *
+ *  \return 0 on success, or -1 if \c stats is NULL.
+ */
+extern DECLSPEC int SDLCALL SDL_GetBlitCacheStats(SDL_BlitCacheStats * stats);
+
+/**
+ *  Counters for the pool that surface pixels are allocated from, see
+ *  SDL_GetSurfacePoolStats().
+ */
+typedef struct SDL_SurfacePoolStats
+{
+    Uint32 hits;            /**< Pixel buffers reused from the pool */
+    Uint32 misses;          /**< Pixel buffers that had to be allocated */
+    Uint32 uncleared;       /**< Pixel buffers handed out without clearing them */
+    Uint32 free_buffers;    /**< Freed pixel buffers kept for reuse */
+    size_t free_bytes;      /**< The memory held by those buffers */
+} SDL_SurfacePoolStats;
+
+/**
+ *  \brief Get the counters for the pool that surface pixels are allocated from.
+ *
+ *  The pixels of surfaces created by SDL are allocated in size classes and
+ *  kept for reuse when the surface is freed, up to the number of bytes set
+ *  by the ::SDL_HINT_SURFACE_POOL_SIZE hint.  Surfaces that SDL creates for
+ *  itself and fills in right away, like the results of SDL_ConvertSurface(),
+ *  skip clearing their pixels.
+ *
+ *  \return 0 on success, or -1 if \c stats is NULL.
+ */
+extern DECLSPEC int SDLCALL SDL_GetSurfacePoolStats(SDL_SurfacePoolStats * stats);
+
+/**
+ *  \brief Free the pixel buffers kept for reuse by the surface pool.
+ *
+ *  This is done by SDL_Quit(), and can be called to give the memory back
+ *  after a burst of large surfaces.
+ */
+extern DECLSPEC void SDLCALL SDL_FlushSurfacePool(void);
+
 
 /* Ends C function definitions when using C++ */
 #ifdef __cplusplus
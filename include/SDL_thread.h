@@ -113,6 +113,20 @@ SDL_CreateThread(SDL_ThreadFunction fn, const char *name, void *data,
  */
 #define SDL_CreateThread(fn, name, data) SDL_CreateThread(fn, name, data, (pfnSDL_CurrentBeginThread)_beginthreadex, (pfnSDL_CurrentEndThread)_endthreadex)
 
+/**
+ *  Create a thread with a specific stack size.
+ */
+extern DECLSPEC SDL_Thread *SDLCALL
+SDL_CreateThreadWithStackSize(SDL_ThreadFunction fn, const char *name,
+                              size_t stacksize, void *data,
+                              pfnSDL_CurrentBeginThread pfnBeginThread,
+                              pfnSDL_CurrentEndThread pfnEndThread);
+
+/**
+ *  Create a thread with a specific stack size.
+ */
+#define SDL_CreateThreadWithStackSize(fn, name, stacksize, data) SDL_CreateThreadWithStackSize(fn, name, stacksize, data, (pfnSDL_CurrentBeginThread)_beginthreadex, (pfnSDL_CurrentEndThread)_endthreadex)
+
 #else
 
 /**
@@ -136,6 +150,18 @@ SDL_CreateThread(SDL_ThreadFunction fn, const char *name, void *data,
 extern DECLSPEC SDL_Thread *SDLCALL
 SDL_CreateThread(SDL_ThreadFunction fn, const char *name, void *data);
 
+/**
+ *  Create a thread with a specific stack size.
+ *
+ *  This is the same as SDL_CreateThread(), except that the new thread gets
+ *  a stack of \c stacksize bytes instead of the size given by the
+ *  SDL_HINT_THREAD_STACK_SIZE hint.  A \c stacksize of 0 uses the system
+ *  default.  Some platforms ignore the stack size.
+ */
+extern DECLSPEC SDL_Thread *SDLCALL
+SDL_CreateThreadWithStackSize(SDL_ThreadFunction fn, const char *name,
+                              size_t stacksize, void *data);
+
 #endif
 
 /**
@@ -164,6 +190,28 @@ extern DECLSPEC SDL_threadID SDLCALL SDL_GetThreadID(SDL_Thread * thread);
  */
 extern DECLSPEC int SDLCALL SDL_SetThreadPriority(SDL_ThreadPriority priority);
 
+/**
+ *  Restrict a thread to run only on a set of CPU cores.
+ *
+ *  \param thread The thread to pin, or NULL for the current thread.
+ *  \param cpu_mask A bit mask of the cores the thread may run on, where
+ *                  bit 0 is the first core.
+ *
+ *  \return 0 on success, or -1 if the mask is invalid or the platform
+ *          doesn't support thread affinity.
+ */
+extern DECLSPEC int SDLCALL SDL_SetThreadAffinity(SDL_Thread * thread, Uint64 cpu_mask);
+
+/**
+ *  Get the set of CPU cores a thread is allowed to run on.
+ *
+ *  \param thread The thread to query, or NULL for the current thread.
+ *  \param cpu_mask Filled in with a bit mask of the allowed cores.
+ *
+ *  \return 0 on success, or -1 if the platform doesn't support thread affinity.
+ */
+extern DECLSPEC int SDLCALL SDL_GetThreadAffinity(SDL_Thread * thread, Uint64 *cpu_mask);
+
 /**
  *  Wait for a thread to finish.
  *
@@ -708,6 +708,87 @@ extern DECLSPEC int SDLCALL SDL_UpdateWindowSurfaceRects(SDL_Window * window,
                                                          const SDL_Rect * rects,
                                                          int numrects);
 
+/**
+ *  \brief Frame statistics for a window using SDL_SetWindowSurfaceBuffers()
+ *
+ *  \sa SDL_GetWindowSurfaceStats()
+ */
+typedef struct SDL_WindowSurfaceStats
+{
+    Uint32 frames_presented;    /**< Frames copied to the screen */
+    Uint32 frames_dropped;      /**< Frames replaced by a newer one before they were shown */
+    Uint32 present_time;        /**< Milliseconds taken to show the last frame */
+} SDL_WindowSurfaceStats;
+
+/**
+ *  \brief Draw the window surface through a set of back buffers.
+ *
+ *  \param window The window to use back buffers with.
+ *  \param num_buffers 2 for double buffering, 3 for triple buffering,
+ *                     or 0 to go back to drawing on the window surface.
+ *  \param interval The minimum number of milliseconds between frames
+ *                  shown on the screen, or 0 to show them as they come.
+ *
+ *  \return 0 on success, or -1 on error.
+ *
+ *  Completed frames are copied to the screen on a separate thread while
+ *  the application draws the next one.  If a newer frame is presented
+ *  before an older one has been shown, the older one is dropped, so
+ *  drawing only waits when every other buffer is on its way to the screen.
+ *
+ *  A back buffer keeps whatever was last drawn into it, so if you only
+ *  redraw part of each frame, redraw everything that changed since that
+ *  buffer was last used.
+ *
+ *  Turning the back buffers off shows any frame that is still waiting.
+ *
+ *  \sa SDL_AcquireWindowSurface()
+ *  \sa SDL_PresentWindowSurface()
+ */
+extern DECLSPEC int SDLCALL SDL_SetWindowSurfaceBuffers(SDL_Window * window,
+                                                        int num_buffers,
+                                                        Uint32 interval);
+
+/**
+ *  \brief Get a back buffer to draw the next frame into.
+ *
+ *  \return A surface to draw into, or NULL on error.
+ *
+ *  The surface is owned by the window and is only valid until the next
+ *  call to SDL_PresentWindowSurface().  Calling this again before
+ *  presenting returns the same surface.
+ *
+ *  \sa SDL_SetWindowSurfaceBuffers()
+ *  \sa SDL_PresentWindowSurface()
+ */
+extern DECLSPEC SDL_Surface * SDLCALL SDL_AcquireWindowSurface(SDL_Window * window);
+
+/**
+ *  \brief Queue the surface from SDL_AcquireWindowSurface() to be shown.
+ *
+ *  \param window The window being drawn.
+ *  \param rects The areas of the frame that changed, or NULL for all of it.
+ *  \param numrects The number of rectangles in \c rects.
+ *
+ *  \return 0 on success, or -1 on error.
+ *
+ *  \sa SDL_AcquireWindowSurface()
+ *  \sa SDL_GetWindowSurfaceStats()
+ */
+extern DECLSPEC int SDLCALL SDL_PresentWindowSurface(SDL_Window * window,
+                                                     const SDL_Rect * rects,
+                                                     int numrects);
+
+/**
+ *  \brief Get frame statistics for a window using back buffers.
+ *
+ *  \return 0 on success, or -1 if the window isn't using back buffers.
+ *
+ *  \sa SDL_SetWindowSurfaceBuffers()
+ */
+extern DECLSPEC int SDLCALL SDL_GetWindowSurfaceStats(SDL_Window * window,
+                                                      SDL_WindowSurfaceStats * stats);
+
 /**
  *  \brief Set a window's input grab mode.
  *
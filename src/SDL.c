@@ -33,6 +33,9 @@
 #include "events/SDL_events_c.h"
 #include "haptic/SDL_haptic_c.h"
 #include "joystick/SDL_joystick_c.h"
+#include "thread/SDL_jobs_c.h"
+#include "file/SDL_asyncio_c.h"
+#include "stdlib/SDL_malloc_c.h"
 
 /* Initialization/Cleanup routines */
 #if !SDL_TIMERS_DISABLED
@@ -353,10 +356,17 @@ SDL_Quit(void)
 #endif
     SDL_QuitSubSystem(SDL_INIT_EVERYTHING);
 
+    SDL_AsyncIOQuit();
+    SDL_JobsQuit();
+    SDL_FlushSurfacePool();
     SDL_ClearHints();
     SDL_AssertionsQuit();
+    SDL_LogSetAsync(SDL_FALSE);
     SDL_LogResetPriorities();
 
+    /* The main thread never exits through SDL, so return its cached memory */
+    SDL_FlushMallocCache();
+
     /* Now that every subsystem has been quit, we reset the subsystem refcount
      * and the list of initialized subsystems.
      */
@@ -166,6 +166,9 @@ SDL_PromptAssertion(const SDL_assert_data *data, void *userdata)
 
     debug_print("\n\n%s\n\n", message);
 
+    /* Make sure the message is out before we stop to ask about it */
+    SDL_LogFlush();
+
     /* let env. variable override, so unit tests won't block in a GUI. */
     envr = SDL_getenv("SDL_ASSERT");
     if (envr != NULL) {
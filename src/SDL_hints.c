@@ -24,30 +24,99 @@
 #include "SDL_error.h"
 
 
-/* Assuming there aren't many hints set and they aren't being queried in
-   critical performance paths, we'll just use linked lists here.
+/* Hints are kept in a small hash table, since some of them are queried
+   for every texture or blit.  Hints with a handle are never freed.
  */
+#define SDL_HINT_BUCKETS    64
+
 typedef struct SDL_HintWatch {
     SDL_HintCallback callback;
     void *userdata;
     struct SDL_HintWatch *next;
 } SDL_HintWatch;
 
-typedef struct SDL_Hint {
+struct SDL_HintHandle {
     char *name;
+    Uint32 hash;
     char *value;
     SDL_HintPriority priority;
     SDL_HintWatch *callbacks;
-    struct SDL_Hint *next;
-} SDL_Hint;
+    SDL_bool registered;
+    const char *env;            /* The environment variable, cached for handles */
+    Uint32 env_generation;
+    struct SDL_HintHandle *next;
+};
+typedef struct SDL_HintHandle SDL_Hint;
+
+static SDL_Hint *SDL_hints[SDL_HINT_BUCKETS];
+static Uint32 SDL_hint_generation = 1;
+
+static void
+SDL_HintChanged(void)
+{
+    if (++SDL_hint_generation == 0) {
+        SDL_hint_generation = 1;
+    }
+}
+
+/* FNV-1a */
+static Uint32
+SDL_HashHint(const char *name)
+{
+    Uint32 hash = 2166136261u;
+
+    while (*name) {
+        hash ^= (Uint8) *name++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static SDL_Hint *
+SDL_FindHint(const char *name, Uint32 hash)
+{
+    SDL_Hint *hint;
+
+    for (hint = SDL_hints[hash % SDL_HINT_BUCKETS]; hint; hint = hint->next) {
+        if (hint->hash == hash && SDL_strcmp(name, hint->name) == 0) {
+            return hint;
+        }
+    }
+    return NULL;
+}
 
-static SDL_Hint *SDL_hints;
+static SDL_Hint *
+SDL_CreateHint(const char *name, Uint32 hash)
+{
+    SDL_Hint *hint;
+
+    hint = (SDL_Hint *)SDL_malloc(sizeof(*hint));
+    if (!hint) {
+        return NULL;
+    }
+    hint->name = SDL_strdup(name);
+    if (!hint->name) {
+        SDL_free(hint);
+        return NULL;
+    }
+    hint->hash = hash;
+    hint->value = NULL;
+    hint->priority = SDL_HINT_DEFAULT;
+    hint->callbacks = NULL;
+    hint->registered = SDL_FALSE;
+    hint->env = NULL;
+    hint->env_generation = 0;
+    hint->next = SDL_hints[hash % SDL_HINT_BUCKETS];
+    SDL_hints[hash % SDL_HINT_BUCKETS] = hint;
+    return hint;
+}
 
 SDL_bool
 SDL_SetHintWithPriority(const char *name, const char *value,
                         SDL_HintPriority priority)
 {
     const char *env;
+    Uint32 hash;
     SDL_Hint *hint;
     SDL_HintWatch *entry;
 
@@ -60,37 +129,38 @@ SDL_SetHintWithPriority(const char *name, const char *value,
         return SDL_FALSE;
     }
 
-    for (hint = SDL_hints; hint; hint = hint->next) {
-        if (SDL_strcmp(name, hint->name) == 0) {
-            if (priority < hint->priority) {
-                return SDL_FALSE;
-            }
-            if (!hint->value || !value || SDL_strcmp(hint->value, value) != 0) {
-                for (entry = hint->callbacks; entry; ) {
-                    /* Save the next entry in case this one is deleted */
-                    SDL_HintWatch *next = entry->next;
-                    entry->callback(entry->userdata, name, hint->value, value);
-                    entry = next;
-                }
-                SDL_free(hint->value);
-                hint->value = value ? SDL_strdup(value) : NULL;
+    hash = SDL_HashHint(name);
+    hint = SDL_FindHint(name, hash);
+    if (hint) {
+        if (priority < hint->priority) {
+            return SDL_FALSE;
+        }
+        if (!hint->value || !value || SDL_strcmp(hint->value, value) != 0) {
+            for (entry = hint->callbacks; entry; ) {
+                /* Save the next entry in case this one is deleted */
+                SDL_HintWatch *next = entry->next;
+                entry->callback(entry->userdata, name, hint->value, value);
+                entry = next;
             }
-            hint->priority = priority;
-            return SDL_TRUE;
+            SDL_free(hint->value);
+            hint->value = value ? SDL_strdup(value) : NULL;
+            SDL_HintChanged();
+        } else if (priority != hint->priority) {
+            /* The same value may now win or lose against the environment */
+            SDL_HintChanged();
         }
+        hint->priority = priority;
+        return SDL_TRUE;
     }
 
     /* Couldn't find the hint, add a new one */
-    hint = (SDL_Hint *)SDL_malloc(sizeof(*hint));
+    hint = SDL_CreateHint(name, hash);
     if (!hint) {
         return SDL_FALSE;
     }
-    hint->name = SDL_strdup(name);
     hint->value = value ? SDL_strdup(value) : NULL;
     hint->priority = priority;
-    hint->callbacks = NULL;
-    hint->next = SDL_hints;
-    SDL_hints = hint;
+    SDL_HintChanged();
     return SDL_TRUE;
 }
 
@@ -107,20 +177,67 @@ SDL_GetHint(const char *name)
     SDL_Hint *hint;
 
     env = SDL_getenv(name);
-    for (hint = SDL_hints; hint; hint = hint->next) {
-        if (SDL_strcmp(name, hint->name) == 0) {
-            if (!env || hint->priority == SDL_HINT_OVERRIDE) {
-                return hint->value;
-            }
-            break;
-        }
+    hint = SDL_FindHint(name, SDL_HashHint(name));
+    if (hint && (!env || hint->priority == SDL_HINT_OVERRIDE)) {
+        return hint->value;
     }
     return env;
 }
 
+SDL_HintHandle *
+SDL_RegisterHint(const char *name)
+{
+    Uint32 hash;
+    SDL_Hint *hint;
+
+    if (!name || !*name) {
+        SDL_InvalidParamError("name");
+        return NULL;
+    }
+
+    hash = SDL_HashHint(name);
+    hint = SDL_FindHint(name, hash);
+    if (!hint) {
+        hint = SDL_CreateHint(name, hash);
+        if (!hint) {
+            SDL_OutOfMemory();
+            return NULL;
+        }
+    }
+    hint->registered = SDL_TRUE;
+    return hint;
+}
+
+const char *
+SDL_GetHintValue(SDL_HintHandle *handle)
+{
+    SDL_Hint *hint = handle;
+
+    if (!hint) {
+        return NULL;
+    }
+    /* The environment is expected to stay put while the program runs, so
+       it's only looked at again after some hint has been set. */
+    if (hint->env_generation != SDL_hint_generation) {
+        hint->env = SDL_getenv(hint->name);
+        hint->env_generation = SDL_hint_generation;
+    }
+    if (!hint->env || hint->priority == SDL_HINT_OVERRIDE) {
+        return hint->value;
+    }
+    return hint->env;
+}
+
+Uint32
+SDL_GetHintGeneration(void)
+{
+    return SDL_hint_generation;
+}
+
 void
 SDL_AddHintCallback(const char *name, SDL_HintCallback callback, void *userdata)
 {
+    Uint32 hash;
     SDL_Hint *hint;
     SDL_HintWatch *entry;
     const char *value;
@@ -137,26 +254,22 @@ SDL_AddHintCallback(const char *name, SDL_HintCallback callback, void *userdata)
     SDL_DelHintCallback(name, callback, userdata);
 
     entry = (SDL_HintWatch *)SDL_malloc(sizeof(*entry));
+    if (!entry) {
+        SDL_OutOfMemory();
+        return;
+    }
     entry->callback = callback;
     entry->userdata = userdata;
 
-    for (hint = SDL_hints; hint; hint = hint->next) {
-        if (SDL_strcmp(name, hint->name) == 0) {
-            break;
-        }
-    }
+    hash = SDL_HashHint(name);
+    hint = SDL_FindHint(name, hash);
     if (!hint) {
         /* Need to add a hint entry for this watcher */
-        hint = (SDL_Hint *)SDL_malloc(sizeof(*hint));
+        hint = SDL_CreateHint(name, hash);
         if (!hint) {
+            SDL_free(entry);
             return;
         }
-        hint->name = SDL_strdup(name);
-        hint->value = NULL;
-        hint->priority = SDL_HINT_DEFAULT;
-        hint->callbacks = NULL;
-        hint->next = SDL_hints;
-        SDL_hints = hint;
     }
 
     /* Add it to the callbacks for this hint */
@@ -174,44 +287,56 @@ SDL_DelHintCallback(const char *name, SDL_HintCallback callback, void *userdata)
     SDL_Hint *hint;
     SDL_HintWatch *entry, *prev;
 
-    for (hint = SDL_hints; hint; hint = hint->next) {
-        if (SDL_strcmp(name, hint->name) == 0) {
-            prev = NULL;
-            for (entry = hint->callbacks; entry; entry = entry->next) {
-                if (callback == entry->callback && userdata == entry->userdata) {
-                    if (prev) {
-                        prev->next = entry->next;
-                    } else {
-                        hint->callbacks = entry->next;
-                    }
-                    SDL_free(entry);
-                    break;
+    hint = SDL_FindHint(name, SDL_HashHint(name));
+    if (hint) {
+        prev = NULL;
+        for (entry = hint->callbacks; entry; entry = entry->next) {
+            if (callback == entry->callback && userdata == entry->userdata) {
+                if (prev) {
+                    prev->next = entry->next;
+                } else {
+                    hint->callbacks = entry->next;
                 }
-                prev = entry;
+                SDL_free(entry);
+                break;
             }
-            return;
+            prev = entry;
         }
     }
 }
 
 void SDL_ClearHints(void)
 {
-    SDL_Hint *hint;
+    SDL_Hint *hint, **prev;
     SDL_HintWatch *entry;
+    int i;
 
-    while (SDL_hints) {
-        hint = SDL_hints;
-        SDL_hints = hint->next;
+    for (i = 0; i < SDL_HINT_BUCKETS; ++i) {
+        prev = &SDL_hints[i];
+        while (*prev) {
+            hint = *prev;
 
-        SDL_free(hint->name);
-        SDL_free(hint->value);
-        for (entry = hint->callbacks; entry; ) {
-            SDL_HintWatch *freeable = entry;
-            entry = entry->next;
-            SDL_free(freeable);
+            SDL_free(hint->value);
+            hint->value = NULL;
+            for (entry = hint->callbacks; entry; ) {
+                SDL_HintWatch *freeable = entry;
+                entry = entry->next;
+                SDL_free(freeable);
+            }
+            hint->callbacks = NULL;
+
+            /* Handles may still be in use, so just reset them */
+            if (hint->registered) {
+                hint->priority = SDL_HINT_DEFAULT;
+                prev = &hint->next;
+            } else {
+                *prev = hint->next;
+                SDL_free(hint->name);
+                SDL_free(hint);
+            }
         }
-        SDL_free(hint);
     }
+    SDL_HintChanged();
 }
 
 /* vi: set ts=4 sw=4 expandtab: */
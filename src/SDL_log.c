@@ -27,6 +27,11 @@
 /* Simple log messages in SDL */
 
 #include "SDL_log.h"
+#include "SDL_error.h"
+#include "SDL_atomic.h"
+#include "SDL_mutex.h"
+#include "SDL_thread.h"
+#include "SDL_timer.h"
 
 #if HAVE_STDIO_H
 #include <stdio.h>
@@ -41,8 +46,8 @@
 #define DEFAULT_APPLICATION_PRIORITY    SDL_LOG_PRIORITY_INFO
 #define DEFAULT_TEST_PRIORITY           SDL_LOG_PRIORITY_VERBOSE
 
-/* Forward definition of error function */
-extern int SDL_SetError(const char *fmt, ...);
+/* The number of messages in the asynchronous log queue, a power of two */
+#define SDL_LOG_QUEUE_SIZE              64
 
 typedef struct SDL_LogLevel
 {
@@ -64,6 +69,35 @@ static SDL_LogPriority SDL_test_priority = DEFAULT_TEST_PRIORITY;
 static SDL_LogOutputFunction SDL_log_function = SDL_LogOutput;
 static void *SDL_log_userdata = NULL;
 
+/* The asynchronous log queue is a bounded multi-producer queue: a thread
+   logging a message claims a slot by advancing enqueue_pos, formats the
+   message into it, and publishes it by setting its sequence number.  The
+   slots are read back in order by the log thread, or by SDL_LogFlush().
+ */
+typedef struct SDL_LogQueueSlot
+{
+    SDL_atomic_t sequence;
+    int category;
+    SDL_LogPriority priority;
+    char message[SDL_MAX_LOG_MESSAGE];
+} SDL_LogQueueSlot;
+
+typedef struct SDL_LogQueue
+{
+    SDL_LogQueueSlot slots[SDL_LOG_QUEUE_SIZE];
+    SDL_atomic_t enqueue_pos;
+    int dequeue_pos;            /* Protected by lock */
+    int dropped_reported;       /* Protected by lock */
+    SDL_mutex *lock;
+    SDL_sem *wakeup;
+    SDL_Thread *thread;
+    SDL_atomic_t quit;
+} SDL_LogQueue;
+
+static SDL_LogQueue *SDL_log_queue;
+static SDL_atomic_t SDL_log_queue_users;
+static SDL_atomic_t SDL_log_dropped;
+
 static const char *SDL_priority_prefixes[SDL_NUM_LOG_PRIORITIES] = {
     NULL,
     "VERBOSE",
@@ -265,11 +299,229 @@ GetCategoryPrefix(int category)
 }
 #endif /* __ANDROID__ */
 
+static void
+SDL_LogChopEndline(char *message)
+{
+    size_t len;
+
+    /* Chop off final endline. */
+    len = SDL_strlen(message);
+    if ((len > 0) && (message[len-1] == '\n')) {
+        message[--len] = '\0';
+        if ((len > 0) && (message[len-1] == '\r')) {  /* catch "\r\n", too. */
+            message[--len] = '\0';
+        }
+    }
+}
+
+/* Add a message to the asynchronous log queue, if it's enabled */
+static SDL_bool
+SDL_LogQueueMessage(int category, SDL_LogPriority priority, const char *fmt, va_list ap)
+{
+    SDL_LogQueue *queue;
+    SDL_LogQueueSlot *slot = NULL;
+    SDL_bool queued = SDL_FALSE;
+
+    /* The queue isn't freed while anyone is using it */
+    SDL_AtomicIncRef(&SDL_log_queue_users);
+    queue = (SDL_LogQueue *) SDL_AtomicGetPtr((void **) &SDL_log_queue);
+    if (queue) {
+        int pos = SDL_AtomicGet(&queue->enqueue_pos);
+
+        for ( ; ; ) {
+            int diff;
+
+            slot = &queue->slots[pos & (SDL_LOG_QUEUE_SIZE - 1)];
+            diff = (int) ((unsigned int) SDL_AtomicGet(&slot->sequence) - (unsigned int) pos);
+            if (diff == 0) {
+                /* The slot is free, try to claim it */
+                if (SDL_AtomicCAS(&queue->enqueue_pos, pos, (int) ((unsigned int) pos + 1))) {
+                    break;
+                }
+                pos = SDL_AtomicGet(&queue->enqueue_pos);
+            } else if (diff < 0) {
+                /* The queue is full */
+                SDL_AtomicIncRef(&SDL_log_dropped);
+                slot = NULL;
+                break;
+            } else {
+                /* Another thread claimed the slot first */
+                pos = SDL_AtomicGet(&queue->enqueue_pos);
+            }
+        }
+
+        if (slot) {
+            slot->category = category;
+            slot->priority = priority;
+            SDL_vsnprintf(slot->message, SDL_MAX_LOG_MESSAGE, fmt, ap);
+            SDL_LogChopEndline(slot->message);
+            /* SDL_AtomicSet() is only an acquire barrier, publish the message first */
+            SDL_MemoryBarrierRelease();
+            SDL_AtomicSet(&slot->sequence, (int) ((unsigned int) pos + 1));
+
+            if (SDL_SemValue(queue->wakeup) == 0) {
+                SDL_SemPost(queue->wakeup);
+            }
+        }
+        queued = SDL_TRUE;
+    }
+    SDL_AtomicAdd(&SDL_log_queue_users, -1);
+
+    return queued;
+}
+
+/* Output the published messages at the head of the queue, with the lock held */
+static void
+SDL_LogDrainQueue(SDL_LogQueue *queue)
+{
+    int dropped;
+
+    for ( ; ; ) {
+        const int pos = queue->dequeue_pos;
+        SDL_LogQueueSlot *slot = &queue->slots[pos & (SDL_LOG_QUEUE_SIZE - 1)];
+
+        if (SDL_AtomicGet(&slot->sequence) != (int) ((unsigned int) pos + 1)) {
+            break;
+        }
+        SDL_MemoryBarrierAcquire();
+
+        if (SDL_log_function) {
+            SDL_log_function(SDL_log_userdata, slot->category, slot->priority, slot->message);
+        }
+        /* Finish with the message before handing the slot back */
+        SDL_MemoryBarrierRelease();
+        SDL_AtomicSet(&slot->sequence, (int) ((unsigned int) pos + SDL_LOG_QUEUE_SIZE));
+        queue->dequeue_pos = (int) ((unsigned int) pos + 1);
+    }
+
+    dropped = SDL_AtomicGet(&SDL_log_dropped);
+    if (dropped != queue->dropped_reported) {
+        char message[64];
+
+        SDL_snprintf(message, sizeof(message), "%d log messages were dropped",
+                     dropped - queue->dropped_reported);
+        queue->dropped_reported = dropped;
+        if (SDL_log_function) {
+            SDL_log_function(SDL_log_userdata, SDL_LOG_CATEGORY_SYSTEM, SDL_LOG_PRIORITY_WARN, message);
+        }
+    }
+}
+
+static int
+SDL_LogThread(void *data)
+{
+    SDL_LogQueue *queue = (SDL_LogQueue *) data;
+
+    while (!SDL_AtomicGet(&queue->quit)) {
+        SDL_SemWait(queue->wakeup);
+
+        SDL_LockMutex(queue->lock);
+        SDL_LogDrainQueue(queue);
+        SDL_UnlockMutex(queue->lock);
+    }
+    return 0;
+}
+
+static void
+SDL_LogFreeQueue(SDL_LogQueue *queue)
+{
+    if (queue->lock) {
+        SDL_DestroyMutex(queue->lock);
+    }
+    if (queue->wakeup) {
+        SDL_DestroySemaphore(queue->wakeup);
+    }
+    SDL_free(queue);
+}
+
+int
+SDL_LogSetAsync(SDL_bool enabled)
+{
+    SDL_LogQueue *queue = SDL_log_queue;
+    int i;
+
+    if (enabled) {
+        if (queue) {
+            return 0;
+        }
+
+        queue = (SDL_LogQueue *) SDL_calloc(1, sizeof(*queue));
+        if (!queue) {
+            return SDL_OutOfMemory();
+        }
+        for (i = 0; i < SDL_LOG_QUEUE_SIZE; ++i) {
+            SDL_AtomicSet(&queue->slots[i].sequence, i);
+        }
+        queue->dropped_reported = SDL_AtomicGet(&SDL_log_dropped);
+        queue->lock = SDL_CreateMutex();
+        queue->wakeup = SDL_CreateSemaphore(0);
+        if (!queue->lock || !queue->wakeup) {
+            SDL_LogFreeQueue(queue);
+            return -1;
+        }
+        queue->thread = SDL_CreateThread(SDL_LogThread, "SDLLog", queue);
+        if (!queue->thread) {
+            SDL_LogFreeQueue(queue);
+            return -1;
+        }
+        SDL_MemoryBarrierRelease();
+        (void)SDL_AtomicSetPtr((void **) &SDL_log_queue, queue);
+    } else {
+        if (!queue) {
+            return 0;
+        }
+
+        /* Wait for threads that are adding messages to finish */
+        (void)SDL_AtomicSetPtr((void **) &SDL_log_queue, NULL);
+        while (SDL_AtomicGet(&SDL_log_queue_users) > 0) {
+            SDL_Delay(0);
+        }
+
+        SDL_AtomicSet(&queue->quit, 1);
+        SDL_SemPost(queue->wakeup);
+        SDL_WaitThread(queue->thread, NULL);
+
+        /* Output whatever the log thread didn't get to */
+        SDL_LogDrainQueue(queue);
+        SDL_LogFreeQueue(queue);
+    }
+    return 0;
+}
+
+void
+SDL_LogFlush(void)
+{
+    SDL_LogQueue *queue;
+
+    SDL_AtomicIncRef(&SDL_log_queue_users);
+    queue = (SDL_LogQueue *) SDL_AtomicGetPtr((void **) &SDL_log_queue);
+    if (queue) {
+        const int end = SDL_AtomicGet(&queue->enqueue_pos);
+
+        SDL_LockMutex(queue->lock);
+        for ( ; ; ) {
+            SDL_LogDrainQueue(queue);
+            if ((int) ((unsigned int) end - (unsigned int) queue->dequeue_pos) <= 0) {
+                break;
+            }
+            /* Another thread is still formatting a message */
+            SDL_Delay(0);
+        }
+        SDL_UnlockMutex(queue->lock);
+    }
+    SDL_AtomicAdd(&SDL_log_queue_users, -1);
+}
+
+int
+SDL_LogGetDropped(void)
+{
+    return SDL_AtomicGet(&SDL_log_dropped);
+}
+
 void
 SDL_LogMessageV(int category, SDL_LogPriority priority, const char *fmt, va_list ap)
 {
     char *message;
-    size_t len;
 
     /* Nothing to do if we don't have an output function */
     if (!SDL_log_function) {
@@ -286,21 +538,17 @@ SDL_LogMessageV(int category, SDL_LogPriority priority, const char *fmt, va_list
         return;
     }
 
+    if (SDL_LogQueueMessage(category, priority, fmt, ap)) {
+        return;
+    }
+
     message = SDL_stack_alloc(char, SDL_MAX_LOG_MESSAGE);
     if (!message) {
         return;
     }
 
     SDL_vsnprintf(message, SDL_MAX_LOG_MESSAGE, fmt, ap);
-
-    /* Chop off final endline. */
-    len = SDL_strlen(message);
-    if ((len > 0) && (message[len-1] == '\n')) {
-        message[--len] = '\0';
-        if ((len > 0) && (message[len-1] == '\r')) {  /* catch "\r\n", too. */
-            message[--len] = '\0';
-        }
-    }
+    SDL_LogChopEndline(message);
 
     SDL_log_function(SDL_log_userdata, category, priority, message);
     SDL_stack_free(message);
@@ -101,6 +101,210 @@ SDL_AtomicCASPtr(void **a, void *oldval, void *newval)
     return retval;
 }
 
+/* 64-bit atomic operations
+
+   These use the compiler's __atomic builtins when it can do 64-bit
+   operations without a library call, the Interlocked intrinsics on Visual
+   C++, and the spin lock vector above everywhere else.
+ */
+#if defined(__GCC_ATOMIC_LLONG_LOCK_FREE) && (__GCC_ATOMIC_LLONG_LOCK_FREE == 2)
+#define HAVE_ATOMIC64_BUILTINS 1
+#elif defined(HAVE_MSC_ATOMICS)
+#define HAVE_ATOMIC64_INTERLOCKED 1
+#endif
+
+#if HAVE_ATOMIC64_BUILTINS
+
+/* The builtins treat orders that aren't compile time constants as
+   sequentially consistent, so expand each case explicitly.
+ */
+#define SDL_ATOMIC_ORDER_SWITCH(order, OP) \
+    switch (order) { \
+    case SDL_MEMORY_ORDER_RELAXED: OP(__ATOMIC_RELAXED, __ATOMIC_RELAXED); \
+    case SDL_MEMORY_ORDER_ACQUIRE: OP(__ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE); \
+    case SDL_MEMORY_ORDER_RELEASE: OP(__ATOMIC_RELEASE, __ATOMIC_RELAXED); \
+    case SDL_MEMORY_ORDER_ACQ_REL: OP(__ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE); \
+    default: OP(__ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST); \
+    }
+
+SDL_bool
+SDL_AtomicCAS64Explicit(SDL_atomic64_t *a, Sint64 oldval, Sint64 newval, SDL_MemoryOrder order)
+{
+#define CAS64(success, failure) \
+    return __atomic_compare_exchange_n(&a->value, &oldval, newval, 0, success, failure) ? SDL_TRUE : SDL_FALSE
+    SDL_ATOMIC_ORDER_SWITCH(order, CAS64)
+#undef CAS64
+}
+
+Sint64
+SDL_AtomicAdd64Explicit(SDL_atomic64_t *a, Sint64 v, SDL_MemoryOrder order)
+{
+#define ADD64(success, failure) \
+    return __atomic_fetch_add(&a->value, v, success)
+    SDL_ATOMIC_ORDER_SWITCH(order, ADD64)
+#undef ADD64
+}
+
+Sint64
+SDL_AtomicLoad64(SDL_atomic64_t *a, SDL_MemoryOrder order)
+{
+    switch (order) {
+    case SDL_MEMORY_ORDER_RELAXED:
+        return __atomic_load_n(&a->value, __ATOMIC_RELAXED);
+    case SDL_MEMORY_ORDER_ACQUIRE:
+    case SDL_MEMORY_ORDER_ACQ_REL:
+        return __atomic_load_n(&a->value, __ATOMIC_ACQUIRE);
+    default:
+        return __atomic_load_n(&a->value, __ATOMIC_SEQ_CST);
+    }
+}
+
+void
+SDL_AtomicStore64(SDL_atomic64_t *a, Sint64 v, SDL_MemoryOrder order)
+{
+    switch (order) {
+    case SDL_MEMORY_ORDER_RELAXED:
+        __atomic_store_n(&a->value, v, __ATOMIC_RELAXED);
+        break;
+    case SDL_MEMORY_ORDER_RELEASE:
+    case SDL_MEMORY_ORDER_ACQ_REL:
+        __atomic_store_n(&a->value, v, __ATOMIC_RELEASE);
+        break;
+    default:
+        __atomic_store_n(&a->value, v, __ATOMIC_SEQ_CST);
+        break;
+    }
+}
+
+Sint64
+SDL_AtomicSet64(SDL_atomic64_t *a, Sint64 v)
+{
+    return __atomic_exchange_n(&a->value, v, __ATOMIC_SEQ_CST);
+}
+
+#elif HAVE_ATOMIC64_INTERLOCKED
+
+/* The Interlocked functions are always full barriers */
+SDL_bool
+SDL_AtomicCAS64Explicit(SDL_atomic64_t *a, Sint64 oldval, Sint64 newval, SDL_MemoryOrder order)
+{
+    return (_InterlockedCompareExchange64(&a->value, newval, oldval) == oldval) ? SDL_TRUE : SDL_FALSE;
+}
+
+Sint64
+SDL_AtomicAdd64Explicit(SDL_atomic64_t *a, Sint64 v, SDL_MemoryOrder order)
+{
+    Sint64 value;
+    do {
+        value = a->value;
+    } while (_InterlockedCompareExchange64(&a->value, value + v, value) != value);
+    return value;
+}
+
+Sint64
+SDL_AtomicLoad64(SDL_atomic64_t *a, SDL_MemoryOrder order)
+{
+    /* A compare-exchange is the only atomic 64-bit read on 32-bit x86 */
+    return _InterlockedCompareExchange64(&a->value, 0, 0);
+}
+
+void
+SDL_AtomicStore64(SDL_atomic64_t *a, Sint64 v, SDL_MemoryOrder order)
+{
+    SDL_AtomicSet64(a, v);
+}
+
+Sint64
+SDL_AtomicSet64(SDL_atomic64_t *a, Sint64 v)
+{
+    Sint64 value;
+    do {
+        value = a->value;
+    } while (_InterlockedCompareExchange64(&a->value, v, value) != value);
+    return value;
+}
+
+#else
+
+SDL_bool
+SDL_AtomicCAS64Explicit(SDL_atomic64_t *a, Sint64 oldval, Sint64 newval, SDL_MemoryOrder order)
+{
+    SDL_bool retval = SDL_FALSE;
+
+    enterLock(a);
+    if (a->value == oldval) {
+        a->value = newval;
+        retval = SDL_TRUE;
+    }
+    leaveLock(a);
+
+    return retval;
+}
+
+Sint64
+SDL_AtomicAdd64Explicit(SDL_atomic64_t *a, Sint64 v, SDL_MemoryOrder order)
+{
+    Sint64 value;
+
+    enterLock(a);
+    value = a->value;
+    a->value = value + v;
+    leaveLock(a);
+
+    return value;
+}
+
+Sint64
+SDL_AtomicLoad64(SDL_atomic64_t *a, SDL_MemoryOrder order)
+{
+    Sint64 value;
+
+    enterLock(a);
+    value = a->value;
+    leaveLock(a);
+
+    return value;
+}
+
+void
+SDL_AtomicStore64(SDL_atomic64_t *a, Sint64 v, SDL_MemoryOrder order)
+{
+    SDL_AtomicSet64(a, v);
+}
+
+Sint64
+SDL_AtomicSet64(SDL_atomic64_t *a, Sint64 v)
+{
+    Sint64 value;
+
+    enterLock(a);
+    value = a->value;
+    a->value = v;
+    leaveLock(a);
+
+    return value;
+}
+
+#endif /* HAVE_ATOMIC64_BUILTINS */
+
+SDL_bool
+SDL_AtomicCAS64(SDL_atomic64_t *a, Sint64 oldval, Sint64 newval)
+{
+    return SDL_AtomicCAS64Explicit(a, oldval, newval, SDL_MEMORY_ORDER_SEQ_CST);
+}
+
+Sint64
+SDL_AtomicGet64(SDL_atomic64_t *a)
+{
+    return SDL_AtomicLoad64(a, SDL_MEMORY_ORDER_SEQ_CST);
+}
+
+Sint64
+SDL_AtomicAdd64(SDL_atomic64_t *a, Sint64 v)
+{
+    return SDL_AtomicAdd64Explicit(a, v, SDL_MEMORY_ORDER_SEQ_CST);
+}
+
 #if defined(__GNUC__) && defined(__arm__) && \
    (defined(__ARM_ARCH_6__) || defined(__ARM_ARCH_6J__) || defined(__ARM_ARCH_6K__) || defined(__ARM_ARCH_6T2__) || defined(__ARM_ARCH_6Z__) || defined(__ARM_ARCH_6ZK__))
 __asm__(
@@ -0,0 +1,486 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2013 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "SDL_config.h"
+
+/* Lock-free containers built on the SDL atomic operations */
+
+#include "SDL_atomic.h"
+#include "SDL_cpuinfo.h"
+#include "SDL_lockfree.h"
+
+/* The largest power of two capacity we'll allocate */
+#define SDL_LOCKFREE_MAX_CAPACITY   0x40000000
+
+static Uint32
+SDL_NextPowerOfTwo(Uint32 value)
+{
+    Uint32 result = 1;
+
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+/* Get the size of an array of elements, failing if it doesn't fit in size_t */
+static SDL_bool
+SDL_GetArraySize(Uint32 count, size_t element_size, size_t *size)
+{
+    if (element_size && count > (~(size_t)0) / element_size) {
+        return SDL_FALSE;
+    }
+    *size = count * element_size;
+    return SDL_TRUE;
+}
+
+/* The reader and writer positions live on separate cache lines, so the
+   two threads only share a line when one of them checks the other's
+   progress.  The positions count bytes forever and wrap around naturally.
+ */
+struct SDL_RingBuffer
+{
+    Uint8 *buffer;
+    Uint32 size;
+    Uint32 mask;
+
+    char pad0[SDL_CACHELINE_SIZE];
+    volatile Uint32 read_pos;
+    char pad1[SDL_CACHELINE_SIZE - sizeof(Uint32)];
+    volatile Uint32 write_pos;
+    char pad2[SDL_CACHELINE_SIZE - sizeof(Uint32)];
+};
+
+SDL_RingBuffer *
+SDL_CreateRingBuffer(Uint32 size)
+{
+    SDL_RingBuffer *rb;
+
+    if (size == 0 || size > SDL_LOCKFREE_MAX_CAPACITY) {
+        SDL_InvalidParamError("size");
+        return NULL;
+    }
+
+    rb = (SDL_RingBuffer *) SDL_calloc(1, sizeof(*rb));
+    if (!rb) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    rb->size = SDL_NextPowerOfTwo(size);
+    rb->mask = rb->size - 1;
+    rb->buffer = (Uint8 *) SDL_malloc(rb->size);
+    if (!rb->buffer) {
+        SDL_free(rb);
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    return rb;
+}
+
+void
+SDL_DestroyRingBuffer(SDL_RingBuffer * rb)
+{
+    if (rb) {
+        SDL_free(rb->buffer);
+        SDL_free(rb);
+    }
+}
+
+Uint32
+SDL_RingBufferWrite(SDL_RingBuffer * rb, const void *data, Uint32 len)
+{
+    Uint32 read_pos, write_pos, offset, first;
+
+    if (!rb) {
+        return 0;
+    }
+
+    read_pos = rb->read_pos;
+    /* Don't overwrite bytes until the reader is done with them */
+    SDL_MemoryBarrierAcquire();
+    write_pos = rb->write_pos;
+
+    len = SDL_min(len, rb->size - (write_pos - read_pos));
+    if (len == 0) {
+        return 0;
+    }
+
+    offset = write_pos & rb->mask;
+    first = SDL_min(len, rb->size - offset);
+    SDL_memcpy(rb->buffer + offset, data, first);
+    SDL_memcpy(rb->buffer, (const Uint8 *)data + first, len - first);
+
+    /* Publish the bytes before moving the write position */
+    SDL_MemoryBarrierRelease();
+    rb->write_pos = write_pos + len;
+    return len;
+}
+
+Uint32
+SDL_RingBufferRead(SDL_RingBuffer * rb, void *data, Uint32 len)
+{
+    Uint32 read_pos, write_pos, offset, first;
+
+    if (!rb) {
+        return 0;
+    }
+
+    write_pos = rb->write_pos;
+    /* Don't read bytes until the writer has published them */
+    SDL_MemoryBarrierAcquire();
+    read_pos = rb->read_pos;
+
+    len = SDL_min(len, write_pos - read_pos);
+    if (len == 0) {
+        return 0;
+    }
+
+    offset = read_pos & rb->mask;
+    first = SDL_min(len, rb->size - offset);
+    SDL_memcpy(data, rb->buffer + offset, first);
+    SDL_memcpy((Uint8 *)data + first, rb->buffer, len - first);
+
+    /* Finish reading before handing the space back to the writer */
+    SDL_MemoryBarrierRelease();
+    rb->read_pos = read_pos + len;
+    return len;
+}
+
+Uint32
+SDL_RingBufferAvailable(SDL_RingBuffer * rb)
+{
+    if (!rb) {
+        return 0;
+    }
+    return rb->write_pos - rb->read_pos;
+}
+
+Uint32
+SDL_RingBufferSpace(SDL_RingBuffer * rb)
+{
+    if (!rb) {
+        return 0;
+    }
+    return rb->size - (rb->write_pos - rb->read_pos);
+}
+
+
+/* This is Dmitry Vyukov's bounded MPMC queue:
+   http://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+
+   Each cell has a sequence number which tells producers and consumers
+   whether the cell is ready for them at their current lap of the queue.
+   Claiming a cell is a single CAS on the enqueue or dequeue position.
+ */
+struct SDL_LockFreeQueue
+{
+    SDL_atomic_t *sequences;
+    Uint8 *elements;
+    Uint32 element_size;
+    Uint32 mask;
+
+    char pad0[SDL_CACHELINE_SIZE];
+    SDL_atomic_t enqueue_pos;
+    char pad1[SDL_CACHELINE_SIZE - sizeof(SDL_atomic_t)];
+    SDL_atomic_t dequeue_pos;
+    char pad2[SDL_CACHELINE_SIZE - sizeof(SDL_atomic_t)];
+};
+
+SDL_LockFreeQueue *
+SDL_CreateLockFreeQueue(Uint32 capacity, Uint32 element_size)
+{
+    SDL_LockFreeQueue *queue;
+    size_t sequences_size, elements_size;
+    Uint32 i;
+
+    if (capacity < 2 || capacity > SDL_LOCKFREE_MAX_CAPACITY) {
+        SDL_InvalidParamError("capacity");
+        return NULL;
+    }
+    if (element_size == 0) {
+        SDL_InvalidParamError("element_size");
+        return NULL;
+    }
+
+    capacity = SDL_NextPowerOfTwo(capacity);
+    if (!SDL_GetArraySize(capacity, sizeof(SDL_atomic_t), &sequences_size) ||
+        !SDL_GetArraySize(capacity, element_size, &elements_size)) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+
+    queue = (SDL_LockFreeQueue *) SDL_calloc(1, sizeof(*queue));
+    if (!queue) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    queue->mask = capacity - 1;
+    queue->element_size = element_size;
+    queue->sequences = (SDL_atomic_t *) SDL_malloc(sequences_size);
+    queue->elements = (Uint8 *) SDL_malloc(elements_size);
+    if (!queue->sequences || !queue->elements) {
+        SDL_DestroyLockFreeQueue(queue);
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    for (i = 0; i < capacity; ++i) {
+        SDL_AtomicSet(&queue->sequences[i], (int)i);
+    }
+    return queue;
+}
+
+void
+SDL_DestroyLockFreeQueue(SDL_LockFreeQueue * queue)
+{
+    if (queue) {
+        SDL_free(queue->sequences);
+        SDL_free(queue->elements);
+        SDL_free(queue);
+    }
+}
+
+SDL_bool
+SDL_LockFreeQueuePush(SDL_LockFreeQueue * queue, const void *element)
+{
+    SDL_atomic_t *sequence;
+    unsigned int pos;
+
+    if (!queue) {
+        return SDL_FALSE;
+    }
+
+    pos = (unsigned int)SDL_AtomicGet(&queue->enqueue_pos);
+    for ( ; ; ) {
+        int delta;
+
+        sequence = &queue->sequences[pos & queue->mask];
+        delta = (int)((unsigned int)SDL_AtomicGet(sequence) - pos);
+        if (delta == 0) {
+            if (SDL_AtomicCAS(&queue->enqueue_pos, (int)pos, (int)(pos + 1))) {
+                break;
+            }
+        } else if (delta < 0) {
+            /* The consumers haven't emptied this cell from the last lap */
+            return SDL_FALSE;
+        }
+        pos = (unsigned int)SDL_AtomicGet(&queue->enqueue_pos);
+    }
+
+    SDL_memcpy(queue->elements + (size_t)(pos & queue->mask) * queue->element_size,
+               element, queue->element_size);
+    /* SDL_AtomicSet() is only an acquire barrier, publish the element first */
+    SDL_MemoryBarrierRelease();
+    SDL_AtomicSet(sequence, (int)(pos + 1));
+    return SDL_TRUE;
+}
+
+SDL_bool
+SDL_LockFreeQueuePop(SDL_LockFreeQueue * queue, void *element)
+{
+    SDL_atomic_t *sequence;
+    unsigned int pos;
+
+    if (!queue) {
+        return SDL_FALSE;
+    }
+
+    pos = (unsigned int)SDL_AtomicGet(&queue->dequeue_pos);
+    for ( ; ; ) {
+        int delta;
+
+        sequence = &queue->sequences[pos & queue->mask];
+        delta = (int)((unsigned int)SDL_AtomicGet(sequence) - (pos + 1));
+        if (delta == 0) {
+            if (SDL_AtomicCAS(&queue->dequeue_pos, (int)pos, (int)(pos + 1))) {
+                break;
+            }
+        } else if (delta < 0) {
+            /* The producers haven't filled this cell yet */
+            return SDL_FALSE;
+        }
+        pos = (unsigned int)SDL_AtomicGet(&queue->dequeue_pos);
+    }
+
+    SDL_memcpy(element, queue->elements + (size_t)(pos & queue->mask) * queue->element_size,
+               queue->element_size);
+    /* Finish reading before handing the cell back to the producers */
+    SDL_MemoryBarrierRelease();
+    SDL_AtomicSet(sequence, (int)(pos + queue->mask + 1));
+    return SDL_TRUE;
+}
+
+
+/* A Treiber stack over a fixed array of nodes.
+
+   Links are node indices plus one, so zero means the end of the list.
+   The low 32 bits of a list head hold the link and the high 32 bits hold
+   a tag which is bumped on every change.  A thread that read the head,
+   got preempted, and came back after the same node was popped and pushed
+   again will see a different tag and fail its CAS, which is what makes
+   the stack safe from ABA.
+
+   Free nodes are kept on a second list managed the same way.
+ */
+struct SDL_LockFreeStack
+{
+    volatile Uint32 *links;
+    Uint8 *elements;
+    Uint32 element_size;
+
+    char pad0[SDL_CACHELINE_SIZE];
+    SDL_atomic64_t head;
+    char pad1[SDL_CACHELINE_SIZE - sizeof(SDL_atomic64_t)];
+    SDL_atomic64_t free;
+    char pad2[SDL_CACHELINE_SIZE - sizeof(SDL_atomic64_t)];
+};
+
+#define SDL_STACK_LINK(head)    ((Uint32)((Uint64)(head) & 0xFFFFFFFF))
+#define SDL_STACK_TAG(head)     ((Uint32)((Uint64)(head) >> 32))
+#define SDL_STACK_HEAD(tag, link)   ((Sint64)(((Uint64)(tag) << 32) | (link)))
+
+static void
+SDL_PushStackNode(SDL_LockFreeStack *stack, SDL_atomic64_t *list, Uint32 link)
+{
+    Sint64 head;
+
+    do {
+        head = SDL_AtomicLoad64(list, SDL_MEMORY_ORDER_RELAXED);
+        stack->links[link - 1] = SDL_STACK_LINK(head);
+    } while (!SDL_AtomicCAS64Explicit(list, head,
+                                      SDL_STACK_HEAD(SDL_STACK_TAG(head) + 1, link),
+                                      SDL_MEMORY_ORDER_RELEASE));
+}
+
+static Uint32
+SDL_PopStackNode(SDL_LockFreeStack *stack, SDL_atomic64_t *list)
+{
+    Sint64 head;
+    Uint32 link;
+
+    do {
+        head = SDL_AtomicLoad64(list, SDL_MEMORY_ORDER_ACQUIRE);
+        link = SDL_STACK_LINK(head);
+        if (link == 0) {
+            return 0;
+        }
+    } while (!SDL_AtomicCAS64Explicit(list, head,
+                                      SDL_STACK_HEAD(SDL_STACK_TAG(head) + 1, stack->links[link - 1]),
+                                      SDL_MEMORY_ORDER_ACQUIRE));
+    return link;
+}
+
+SDL_LockFreeStack *
+SDL_CreateLockFreeStack(Uint32 capacity, Uint32 element_size)
+{
+    SDL_LockFreeStack *stack;
+    size_t links_size, elements_size;
+    Uint32 i;
+
+    if (capacity == 0 || capacity > SDL_LOCKFREE_MAX_CAPACITY) {
+        SDL_InvalidParamError("capacity");
+        return NULL;
+    }
+    if (element_size == 0) {
+        SDL_InvalidParamError("element_size");
+        return NULL;
+    }
+
+    if (!SDL_GetArraySize(capacity, sizeof(Uint32), &links_size) ||
+        !SDL_GetArraySize(capacity, element_size, &elements_size)) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+
+    stack = (SDL_LockFreeStack *) SDL_calloc(1, sizeof(*stack));
+    if (!stack) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    stack->element_size = element_size;
+    stack->links = (volatile Uint32 *) SDL_malloc(links_size);
+    stack->elements = (Uint8 *) SDL_malloc(elements_size);
+    if (!stack->links || !stack->elements) {
+        SDL_DestroyLockFreeStack(stack);
+        SDL_OutOfMemory();
+        return NULL;
+    }
+
+    /* Chain all the nodes onto the free list */
+    for (i = 0; i < capacity; ++i) {
+        stack->links[i] = (i + 1 < capacity) ? (i + 2) : 0;
+    }
+    SDL_AtomicSet64(&stack->free, SDL_STACK_HEAD(0, 1));
+    SDL_AtomicSet64(&stack->head, SDL_STACK_HEAD(0, 0));
+    return stack;
+}
+
+void
+SDL_DestroyLockFreeStack(SDL_LockFreeStack * stack)
+{
+    if (stack) {
+        SDL_free((void *)stack->links);
+        SDL_free(stack->elements);
+        SDL_free(stack);
+    }
+}
+
+SDL_bool
+SDL_LockFreeStackPush(SDL_LockFreeStack * stack, const void *element)
+{
+    Uint32 link;
+
+    if (!stack) {
+        return SDL_FALSE;
+    }
+
+    link = SDL_PopStackNode(stack, &stack->free);
+    if (!link) {
+        return SDL_FALSE;
+    }
+    SDL_memcpy(stack->elements + (size_t)(link - 1) * stack->element_size,
+               element, stack->element_size);
+    /* Publish the element before the node goes on the list */
+    SDL_MemoryBarrierRelease();
+    SDL_PushStackNode(stack, &stack->head, link);
+    return SDL_TRUE;
+}
+
+SDL_bool
+SDL_LockFreeStackPop(SDL_LockFreeStack * stack, void *element)
+{
+    Uint32 link;
+
+    if (!stack) {
+        return SDL_FALSE;
+    }
+
+    link = SDL_PopStackNode(stack, &stack->head);
+    if (!link) {
+        return SDL_FALSE;
+    }
+    SDL_memcpy(element, stack->elements + (size_t)(link - 1) * stack->element_size,
+               stack->element_size);
+    /* Finish reading before the node can be reused */
+    SDL_MemoryBarrierRelease();
+    SDL_PushStackNode(stack, &stack->free, link);
+    return SDL_TRUE;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
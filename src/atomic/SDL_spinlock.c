@@ -28,6 +28,22 @@
 #include "SDL_mutex.h"
 #include "SDL_timer.h"
 
+/* The statistics use atomic adds, which must not be emulated with the
+   spinlocks we are collecting statistics for.
+ */
+#ifdef SDL_AtomicCAS
+#define SDL_SPINLOCK_STATS 1
+static SDL_atomic_t SDL_spinlock_contended;
+static SDL_atomic_t SDL_spinlock_spins;
+static SDL_atomic_t SDL_spinlock_sleeps;
+#endif
+
+/* The longest run of pause instructions between attempts to take the lock.
+   Past this point the lock holder is probably not running, so we yield
+   the CPU to it instead.
+ */
+#define SDL_SPINLOCK_MAX_BACKOFF    64
+
 
 /* This function is where all the magic happens... */
 SDL_bool
@@ -99,10 +115,37 @@ SDL_AtomicTryLock(SDL_SpinLock *lock)
 void
 SDL_AtomicLock(SDL_SpinLock *lock)
 {
+    int backoff = 1;
+    int spins = 0;
+    int sleeps = 0;
+
+    if (SDL_AtomicTryLock(lock)) {
+        return;
+    }
+
     /* FIXME: Should we have an eventual timeout? */
-    while (!SDL_AtomicTryLock(lock)) {
-        SDL_Delay(0);
+    do {
+        if (backoff <= SDL_SPINLOCK_MAX_BACKOFF) {
+            int i;
+            for (i = 0; i < backoff; ++i) {
+                SDL_CPUPauseInstruction();
+            }
+            spins += backoff;
+            backoff <<= 1;
+        } else {
+            SDL_Delay(0);
+            ++sleeps;
+        }
+        /* Wait until the lock looks free before hitting the bus again */
+    } while (*(volatile SDL_SpinLock *)lock || !SDL_AtomicTryLock(lock));
+
+#if SDL_SPINLOCK_STATS
+    SDL_AtomicAdd(&SDL_spinlock_contended, 1);
+    SDL_AtomicAdd(&SDL_spinlock_spins, spins);
+    if (sleeps) {
+        SDL_AtomicAdd(&SDL_spinlock_sleeps, sleeps);
     }
+#endif
 }
 
 void
@@ -123,4 +166,21 @@ SDL_AtomicUnlock(SDL_SpinLock *lock)
 #endif
 }
 
+int
+SDL_GetSpinLockStats(SDL_LockStats *stats)
+{
+    if (!stats) {
+        return SDL_InvalidParamError("stats");
+    }
+
+    SDL_zerop(stats);
+#if SDL_SPINLOCK_STATS
+    stats->contended = (Uint32)SDL_AtomicGet(&SDL_spinlock_contended);
+    stats->locks = stats->contended;
+    stats->spins = (Uint32)SDL_AtomicGet(&SDL_spinlock_spins);
+    stats->sleeps = (Uint32)SDL_AtomicGet(&SDL_spinlock_sleeps);
+#endif
+    return 0;
+}
+
 /* vi: set ts=4 sw=4 expandtab: */
@@ -27,6 +27,7 @@
 #include "SDL_audio_c.h"
 #include "SDL_audiomem.h"
 #include "SDL_sysaudio.h"
+#include "../stdlib/SDL_malloc_c.h"
 
 #define _THIS SDL_AudioDevice *_this
 
@@ -763,14 +764,22 @@ close_audio_device(SDL_AudioDevice * device)
     if (device->mixer_lock != NULL) {
         SDL_DestroyMutex(device->mixer_lock);
     }
+    if (device->fake_stream) {
+        SDL_TrackFree(SDL_MEMORY_AUDIO_BUFFERS, device->spec.size);
+    }
     SDL_FreeAudioMem(device->fake_stream);
     if (device->convert.needed) {
+        if (device->convert.buf) {
+            SDL_TrackFree(SDL_MEMORY_AUDIO_BUFFERS,
+                          device->convert.len * device->convert.len_mult);
+        }
         SDL_FreeAudioMem(device->convert.buf);
     }
     if (device->opened) {
         current_audio.impl.CloseDevice(device);
         device->opened = 0;
     }
+    SDL_TrackFree(SDL_MEMORY_AUDIO_BUFFERS, sizeof(SDL_AudioDevice));
     SDL_FreeAudioMem(device);
 }
 
@@ -922,6 +931,7 @@ open_audio_device(const char *devname, int iscapture,
         return 0;
     }
     SDL_memset(device, '\0', sizeof(SDL_AudioDevice));
+    SDL_TrackAllocation(SDL_MEMORY_AUDIO_BUFFERS, sizeof(SDL_AudioDevice));
     device->spec = *obtained;
     device->enabled = 1;
     device->paused = 1;
@@ -955,6 +965,7 @@ open_audio_device(const char *devname, int iscapture,
         SDL_OutOfMemory();
         return 0;
     }
+    SDL_TrackAllocation(SDL_MEMORY_AUDIO_BUFFERS, device->spec.size);
 
     /* See if we need to do any conversion */
     build_cvt = SDL_FALSE;
@@ -1011,6 +1022,8 @@ open_audio_device(const char *devname, int iscapture,
                 SDL_OutOfMemory();
                 return 0;
             }
+            SDL_TrackAllocation(SDL_MEMORY_AUDIO_BUFFERS,
+                                device->convert.len * device->convert.len_mult);
         }
     }
 
@@ -24,6 +24,7 @@
 
 #include "SDL_audio.h"
 #include "SDL_wave.h"
+#include "../file/SDL_rwops_c.h"
 
 
 static int ReadChunk(SDL_RWops * src, Chunk * chunk);
@@ -407,6 +408,7 @@ SDL_LoadWAV_RW(SDL_RWops * src, int freesrc,
 {
     int was_error;
     Chunk chunk;
+    SDL_RWops *buffered = NULL;
     int lenread;
     int IEEE_float_encoded, MS_ADPCM_encoded, IMA_ADPCM_encoded;
     int samplesize;
@@ -429,6 +431,12 @@ SDL_LoadWAV_RW(SDL_RWops * src, int freesrc,
         goto done;
     }
 
+    /* Read through a buffer if the stream doesn't have one */
+    buffered = SDL_RWBufferIfNeeded(src, freesrc);
+    if (buffered) {
+        src = buffered;
+    }
+
     /* Check the magic header */
     RIFFchunk = SDL_ReadLE32(src);
     wavelen = SDL_ReadLE32(src);
@@ -586,6 +594,9 @@ SDL_LoadWAV_RW(SDL_RWops * src, int freesrc,
         } else {
             /* seek to the end of the file (given by the RIFF chunk) */
             SDL_RWseek(src, wavelen - chunk.length - headerDiff, RW_SEEK_CUR);
+            if (buffered) {
+                SDL_RWclose(buffered);
+            }
         }
     }
     if (was_error) {
@@ -28,6 +28,7 @@
 #include "SDL_thread.h"
 #include "SDL_events_c.h"
 #include "../timer/SDL_timer_c.h"
+#include "../stdlib/SDL_malloc_c.h"
 #if !SDL_JOYSTICK_DISABLED
 #include "../joystick/SDL_joystick_c.h"
 #endif
@@ -114,21 +115,25 @@ SDL_StopEventLoop(void)
     /* Clean out EventQ */
     for (entry = SDL_EventQ.head; entry; ) {
         SDL_EventEntry *next = entry->next;
+        SDL_TrackFree(SDL_MEMORY_EVENT_QUEUE, sizeof(*entry));
         SDL_free(entry);
         entry = next;
     }
     for (entry = SDL_EventQ.free; entry; ) {
         SDL_EventEntry *next = entry->next;
+        SDL_TrackFree(SDL_MEMORY_EVENT_QUEUE, sizeof(*entry));
         SDL_free(entry);
         entry = next;
     }
     for (wmmsg = SDL_EventQ.wmmsg_used; wmmsg; ) {
         SDL_SysWMEntry *next = wmmsg->next;
+        SDL_TrackFree(SDL_MEMORY_EVENT_QUEUE, sizeof(*wmmsg));
         SDL_free(wmmsg);
         wmmsg = next;
     }
     for (wmmsg = SDL_EventQ.wmmsg_free; wmmsg; ) {
         SDL_SysWMEntry *next = wmmsg->next;
+        SDL_TrackFree(SDL_MEMORY_EVENT_QUEUE, sizeof(*wmmsg));
         SDL_free(wmmsg);
         wmmsg = next;
     }
@@ -206,6 +211,7 @@ SDL_AddEvent(SDL_Event * event)
         if (!entry) {
             return 0;
         }
+        SDL_TrackAllocation(SDL_MEMORY_EVENT_QUEUE, sizeof(*entry));
     } else {
         entry = SDL_EventQ.free;
         SDL_EventQ.free = entry->next;
@@ -321,6 +327,7 @@ SDL_PeepEvents(SDL_Event * events, int numevents, SDL_eventaction action,
                             SDL_EventQ.wmmsg_free = wmmsg->next;
                         } else {
                             wmmsg = (SDL_SysWMEntry *)SDL_malloc(sizeof(*wmmsg));
+                            SDL_TrackAllocation(SDL_MEMORY_EVENT_QUEUE, sizeof(*wmmsg));
                         }
                         wmmsg->msg = *entry->event.syswm.msg;
                         wmmsg->next = SDL_EventQ.wmmsg_used;
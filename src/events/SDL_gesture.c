@@ -26,6 +26,7 @@
 #include "SDL_events.h"
 #include "SDL_events_c.h"
 #include "SDL_gesture_c.h"
+#include "../file/SDL_rwops_c.h"
 
 #if !defined(__PSP__)
 #include <memory.h>
@@ -134,12 +135,22 @@ static int SaveTemplate(SDL_DollarTemplate *templ, SDL_RWops *dst)
 int SDL_SaveAllDollarTemplates(SDL_RWops *dst)
 {
     int i,j,rtrn = 0;
+    SDL_RWops *buffered = NULL;
+
+    /* Write through a buffer if the stream doesn't have one */
+    if (dst != NULL) {
+        buffered = SDL_RWBufferIfNeeded(dst, SDL_FALSE);
+        if (buffered != NULL) dst = buffered;
+    }
+
     for (i = 0; i < SDL_numGestureTouches; i++) {
         SDL_GestureTouch* touch = &SDL_gestureTouch[i];
         for (j = 0; j < touch->numDollarTemplates; j++) {
             rtrn += SaveTemplate(&touch->dollarTemplate[i], dst);
         }
     }
+
+    if (buffered != NULL && SDL_RWclose(buffered) < 0) return 0;
     return rtrn;
 }
 
@@ -205,6 +216,7 @@ int SDL_LoadDollarTemplates(SDL_TouchID touchId, SDL_RWops *src)
 {
     int i,loaded = 0;
     SDL_GestureTouch *touch = NULL;
+    SDL_RWops *buffered;
     if (src == NULL) return 0;
     if (touchId >= 0) {
         for (i = 0; i < SDL_numGestureTouches; i++)
@@ -213,6 +225,10 @@ int SDL_LoadDollarTemplates(SDL_TouchID touchId, SDL_RWops *src)
         if (touch == NULL) return -1;
     }
 
+    /* Read through a buffer if the stream doesn't have one */
+    buffered = SDL_RWBufferIfNeeded(src, SDL_FALSE);
+    if (buffered != NULL) src = buffered;
+
     while (1) {
         SDL_DollarTemplate templ;
 
@@ -236,6 +252,7 @@ int SDL_LoadDollarTemplates(SDL_TouchID touchId, SDL_RWops *src)
         }
     }
 
+    if (buffered != NULL) SDL_RWclose(buffered);
     return loaded;
 }
 
@@ -0,0 +1,620 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2013 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "SDL_config.h"
+
+/* Read-only access to the files in uncompressed zip and SDL pack archives */
+
+#include "SDL_endian.h"
+#include "SDL_mutex.h"
+#include "SDL_archive.h"
+
+#define PACK_MAGIC          "SDLPACK1"
+#define PACK_HEADER_SIZE    12
+#define PACK_ENTRY_SIZE     18
+
+#define ZIP_LOCAL_SIG       0x04034b50
+#define ZIP_CENTRAL_SIG     0x02014b50
+#define ZIP_EOCD_SIG        0x06054b50
+#define ZIP_LOCAL_SIZE      30
+#define ZIP_CENTRAL_SIZE    46
+#define ZIP_EOCD_SIZE       22
+#define ZIP_STORED          0
+
+typedef struct SDL_ArchiveEntry
+{
+    size_t name;        /* Offset of the name in the archive's name pool */
+    Uint32 hash;
+    Uint16 method;      /* Zip compression method */
+    Sint64 header;      /* Offset of the zip local header */
+    Sint64 offset;      /* Offset of the data, or -1 until the local header is read */
+    Sint64 size;
+} SDL_ArchiveEntry;
+
+struct SDL_Archive
+{
+    SDL_RWops *src;
+    int freesrc;
+    SDL_mutex *lock;
+    const Uint8 *mem;   /* The whole archive, if the stream is in memory */
+    Sint64 size;
+    int num_entries;
+    SDL_ArchiveEntry *entries;
+    char *names;
+    int *table;         /* Entry index for each hash slot, or -1 */
+    Uint32 table_mask;
+};
+
+/* The state of a stream over a file in an archive */
+typedef struct SDL_ArchiveStream
+{
+    SDL_Archive *archive;
+    Sint64 start;
+    Sint64 size;
+    Sint64 pos;
+} SDL_ArchiveStream;
+
+
+static Uint16
+SDL_ArchiveLE16(const Uint8 * p)
+{
+    return (Uint16) (p[0] | (p[1] << 8));
+}
+
+static Uint32
+SDL_ArchiveLE32(const Uint8 * p)
+{
+    return ((Uint32) p[0] | ((Uint32) p[1] << 8) |
+            ((Uint32) p[2] << 16) | ((Uint32) p[3] << 24));
+}
+
+/* FNV-1a */
+static Uint32
+SDL_HashArchiveName(const char *name)
+{
+    Uint32 hash = 2166136261u;
+
+    while (*name) {
+        hash ^= (Uint8) *name++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/* Read from the archive, with the lock held if the archive isn't in memory */
+static int
+SDL_ReadArchive(SDL_Archive * archive, Sint64 offset, void *ptr, size_t size)
+{
+    if (offset < 0 || offset > archive->size ||
+        (Sint64) size > archive->size - offset) {
+        return SDL_SetError("Corrupt archive");
+    }
+    if (archive->mem) {
+        SDL_memcpy(ptr, archive->mem + offset, size);
+        return 0;
+    }
+    if (SDL_RWseek(archive->src, offset, RW_SEEK_SET) != offset ||
+        SDL_RWread(archive->src, ptr, 1, size) != size) {
+        return SDL_Error(SDL_EFREAD);
+    }
+    return 0;
+}
+
+static int
+SDL_LoadZipDirectory(SDL_Archive * archive)
+{
+    Uint8 *tail, *dir, *p, *end;
+    size_t tail_size, names_size = 0;
+    Uint32 num_entries, dir_size, dir_offset, i;
+
+    tail_size = (size_t) SDL_min(archive->size, ZIP_EOCD_SIZE + 0xFFFF);
+    if (tail_size < ZIP_EOCD_SIZE) {
+        return SDL_SetError("File is not a zip or pack archive");
+    }
+    tail = (Uint8 *) SDL_malloc(tail_size);
+    if (!tail) {
+        return SDL_OutOfMemory();
+    }
+    if (SDL_ReadArchive(archive, archive->size - tail_size, tail, tail_size) < 0) {
+        SDL_free(tail);
+        return -1;
+    }
+
+    /* The end of central directory record is followed by a comment */
+    for (p = tail + tail_size - ZIP_EOCD_SIZE; p >= tail; --p) {
+        if (SDL_ArchiveLE32(p) == ZIP_EOCD_SIG) {
+            break;
+        }
+    }
+    if (p < tail) {
+        SDL_free(tail);
+        return SDL_SetError("File is not a zip or pack archive");
+    }
+    num_entries = SDL_ArchiveLE16(p + 10);
+    dir_size = SDL_ArchiveLE32(p + 12);
+    dir_offset = SDL_ArchiveLE32(p + 16);
+    SDL_free(tail);
+
+    dir = (Uint8 *) SDL_malloc(dir_size ? dir_size : 1);
+    if (!dir) {
+        return SDL_OutOfMemory();
+    }
+    if (SDL_ReadArchive(archive, dir_offset, dir, dir_size) < 0) {
+        SDL_free(dir);
+        return -1;
+    }
+
+    /* Each name is shorter than its directory record, which leaves room
+       for the terminating zeros */
+    archive->entries = (SDL_ArchiveEntry *) SDL_malloc((num_entries + 1) * sizeof(SDL_ArchiveEntry));
+    archive->names = (char *) SDL_malloc(dir_size + 1);
+    if (!archive->entries || !archive->names) {
+        SDL_free(dir);
+        return SDL_OutOfMemory();
+    }
+
+    p = dir;
+    end = dir + dir_size;
+    for (i = 0; i < num_entries; ++i) {
+        Uint16 name_len, extra_len, comment_len;
+
+        if (end - p < ZIP_CENTRAL_SIZE || SDL_ArchiveLE32(p) != ZIP_CENTRAL_SIG) {
+            SDL_free(dir);
+            return SDL_SetError("Corrupt zip directory");
+        }
+        name_len = SDL_ArchiveLE16(p + 28);
+        extra_len = SDL_ArchiveLE16(p + 30);
+        comment_len = SDL_ArchiveLE16(p + 32);
+        if (end - p - ZIP_CENTRAL_SIZE < name_len + extra_len + comment_len) {
+            SDL_free(dir);
+            return SDL_SetError("Corrupt zip directory");
+        }
+
+        /* Directories have names ending with a slash and no data */
+        if (name_len > 0 && p[ZIP_CENTRAL_SIZE + name_len - 1] != '/') {
+            SDL_ArchiveEntry *entry = &archive->entries[archive->num_entries++];
+
+            SDL_memcpy(archive->names + names_size, p + ZIP_CENTRAL_SIZE, name_len);
+            archive->names[names_size + name_len] = '\0';
+            entry->name = names_size;
+            entry->method = SDL_ArchiveLE16(p + 10);
+            entry->size = SDL_ArchiveLE32(p + 24);
+            entry->header = SDL_ArchiveLE32(p + 42);
+            entry->offset = -1;
+            names_size += name_len + 1;
+        }
+        p += ZIP_CENTRAL_SIZE + name_len + extra_len + comment_len;
+    }
+
+    SDL_free(dir);
+    return 0;
+}
+
+static int
+SDL_LoadPackDirectory(SDL_Archive * archive, Uint32 num_entries)
+{
+    SDL_RWops *rw;
+    size_t names_size = 0, names_max = 0;
+    Uint32 i;
+
+    /* Every entry takes at least PACK_ENTRY_SIZE bytes */
+    if (num_entries > (archive->size - PACK_HEADER_SIZE) / PACK_ENTRY_SIZE) {
+        return SDL_SetError("Corrupt pack directory");
+    }
+    archive->entries = (SDL_ArchiveEntry *) SDL_malloc((num_entries + 1) * sizeof(SDL_ArchiveEntry));
+    if (!archive->entries) {
+        return SDL_OutOfMemory();
+    }
+
+    /* The directory is read in many small pieces */
+    if (SDL_RWseek(archive->src, PACK_HEADER_SIZE, RW_SEEK_SET) != PACK_HEADER_SIZE) {
+        return SDL_Error(SDL_EFSEEK);
+    }
+    rw = SDL_RWFromBuffered(archive->src, 0, SDL_FALSE);
+    if (!rw) {
+        return -1;
+    }
+
+    for (i = 0; i < num_entries; ++i) {
+        SDL_ArchiveEntry *entry = &archive->entries[i];
+        Uint64 offset = SDL_ReadLE64(rw);
+        Uint64 size = SDL_ReadLE64(rw);
+        Uint16 name_len = SDL_ReadLE16(rw);
+
+        if (offset > (Uint64) archive->size || size > (Uint64) archive->size - offset) {
+            SDL_RWclose(rw);
+            return SDL_SetError("Corrupt pack directory");
+        }
+        if (names_size + name_len + 1 > names_max) {
+            char *names;
+
+            names_max = SDL_max(names_max * 2, names_size + name_len + 1024);
+            names = (char *) SDL_realloc(archive->names, names_max);
+            if (!names) {
+                SDL_RWclose(rw);
+                return SDL_OutOfMemory();
+            }
+            archive->names = names;
+        }
+        if (SDL_RWread(rw, archive->names + names_size, 1, name_len) != name_len) {
+            SDL_RWclose(rw);
+            return SDL_SetError("Corrupt pack directory");
+        }
+        archive->names[names_size + name_len] = '\0';
+
+        entry->name = names_size;
+        entry->method = ZIP_STORED;
+        entry->header = (Sint64) offset;
+        entry->offset = (Sint64) offset;
+        entry->size = (Sint64) size;
+        names_size += name_len + 1;
+    }
+    archive->num_entries = (int) num_entries;
+
+    SDL_RWclose(rw);
+    return 0;
+}
+
+static int
+SDL_IndexArchive(SDL_Archive * archive)
+{
+    Uint32 table_size = 16;
+    int i;
+
+    while (table_size < (Uint32) archive->num_entries * 2) {
+        table_size *= 2;
+    }
+    archive->table = (int *) SDL_malloc(table_size * sizeof(int));
+    if (!archive->table) {
+        return SDL_OutOfMemory();
+    }
+    SDL_memset(archive->table, 0xFF, table_size * sizeof(int));
+    archive->table_mask = table_size - 1;
+
+    for (i = 0; i < archive->num_entries; ++i) {
+        SDL_ArchiveEntry *entry = &archive->entries[i];
+        const char *name = archive->names + entry->name;
+        Uint32 slot;
+
+        entry->hash = SDL_HashArchiveName(name);
+        slot = entry->hash & archive->table_mask;
+        while (archive->table[slot] >= 0) {
+            SDL_ArchiveEntry *other = &archive->entries[archive->table[slot]];
+
+            /* A later entry with the same name replaces the earlier one */
+            if (other->hash == entry->hash &&
+                SDL_strcmp(archive->names + other->name, name) == 0) {
+                break;
+            }
+            slot = (slot + 1) & archive->table_mask;
+        }
+        archive->table[slot] = i;
+    }
+    return 0;
+}
+
+static SDL_ArchiveEntry *
+SDL_FindArchiveEntry(SDL_Archive * archive, const char *name)
+{
+    Uint32 hash = SDL_HashArchiveName(name);
+    Uint32 slot = hash & archive->table_mask;
+
+    while (archive->table[slot] >= 0) {
+        SDL_ArchiveEntry *entry = &archive->entries[archive->table[slot]];
+
+        if (entry->hash == hash &&
+            SDL_strcmp(archive->names + entry->name, name) == 0) {
+            return entry;
+        }
+        slot = (slot + 1) & archive->table_mask;
+    }
+    return NULL;
+}
+
+SDL_Archive *
+SDL_OpenArchiveRW(SDL_RWops * src, int freesrc)
+{
+    SDL_Archive *archive;
+    Uint8 header[PACK_HEADER_SIZE];
+    size_t available;
+    int status;
+
+    if (!src) {
+        SDL_InvalidParamError("src");
+        return NULL;
+    }
+
+    archive = (SDL_Archive *) SDL_calloc(1, sizeof(*archive));
+    if (!archive) {
+        if (freesrc) {
+            SDL_RWclose(src);
+        }
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    archive->src = src;
+    archive->freesrc = freesrc;
+
+    archive->size = SDL_RWsize(src);
+    archive->lock = SDL_CreateMutex();
+    if (archive->size < 0 || !archive->lock ||
+        SDL_RWseek(src, 0, RW_SEEK_SET) != 0) {
+        SDL_CloseArchive(archive);
+        return NULL;
+    }
+    archive->mem = (const Uint8 *) SDL_RWGetPointer(src, &available);
+    if (archive->mem && (Sint64) available != archive->size) {
+        archive->mem = NULL;
+    }
+
+    if (archive->size >= PACK_HEADER_SIZE &&
+        SDL_ReadArchive(archive, 0, header, sizeof(header)) == 0 &&
+        SDL_memcmp(header, PACK_MAGIC, 8) == 0) {
+        status = SDL_LoadPackDirectory(archive, SDL_ArchiveLE32(header + 8));
+    } else {
+        status = SDL_LoadZipDirectory(archive);
+    }
+    if (status < 0 || SDL_IndexArchive(archive) < 0) {
+        SDL_CloseArchive(archive);
+        return NULL;
+    }
+    return archive;
+}
+
+SDL_Archive *
+SDL_OpenArchive(const char *file)
+{
+    SDL_RWops *src = SDL_RWFromFile(file, "rbm");
+
+    if (!src) {
+        return NULL;
+    }
+    return SDL_OpenArchiveRW(src, 1);
+}
+
+int
+SDL_GetNumArchiveFiles(SDL_Archive * archive)
+{
+    if (!archive) {
+        return SDL_InvalidParamError("archive");
+    }
+    return archive->num_entries;
+}
+
+const char *
+SDL_GetArchiveFileName(SDL_Archive * archive, int index)
+{
+    if (!archive) {
+        SDL_InvalidParamError("archive");
+        return NULL;
+    }
+    if (index < 0 || index >= archive->num_entries) {
+        SDL_InvalidParamError("index");
+        return NULL;
+    }
+    return archive->names + archive->entries[index].name;
+}
+
+Sint64
+SDL_GetArchiveFileSize(SDL_Archive * archive, const char *name)
+{
+    SDL_ArchiveEntry *entry;
+
+    if (!archive) {
+        return SDL_InvalidParamError("archive");
+    }
+    if (!name) {
+        return SDL_InvalidParamError("name");
+    }
+    entry = SDL_FindArchiveEntry(archive, name);
+    if (!entry) {
+        return SDL_SetError("Couldn't find %s in archive", name);
+    }
+    return entry->size;
+}
+
+/* Functions to read a file in an archive that isn't in memory */
+
+static Sint64 SDLCALL
+archive_size(SDL_RWops * context)
+{
+    SDL_ArchiveStream *stream = (SDL_ArchiveStream *) context->hidden.unknown.data1;
+
+    return stream->size;
+}
+
+static Sint64 SDLCALL
+archive_seek(SDL_RWops * context, Sint64 offset, int whence)
+{
+    SDL_ArchiveStream *stream = (SDL_ArchiveStream *) context->hidden.unknown.data1;
+    Sint64 newpos;
+
+    switch (whence) {
+    case RW_SEEK_SET:
+        newpos = offset;
+        break;
+    case RW_SEEK_CUR:
+        newpos = stream->pos + offset;
+        break;
+    case RW_SEEK_END:
+        newpos = stream->size + offset;
+        break;
+    default:
+        return SDL_SetError("Unknown value for 'whence'");
+    }
+    if (newpos < 0) {
+        newpos = 0;
+    }
+    if (newpos > stream->size) {
+        newpos = stream->size;
+    }
+    stream->pos = newpos;
+    return newpos;
+}
+
+static size_t SDLCALL
+archive_read(SDL_RWops * context, void *ptr, size_t size, size_t maxnum)
+{
+    SDL_ArchiveStream *stream = (SDL_ArchiveStream *) context->hidden.unknown.data1;
+    SDL_Archive *archive = stream->archive;
+    size_t total_bytes, nread = 0;
+
+    total_bytes = (maxnum * size);
+    if ((maxnum <= 0) || (size <= 0)
+        || ((total_bytes / maxnum) != (size_t) size)) {
+        return 0;
+    }
+    if ((Sint64) total_bytes > stream->size - stream->pos) {
+        total_bytes = (size_t) (stream->size - stream->pos);
+    }
+    if (total_bytes == 0) {
+        return 0;
+    }
+
+    /* Readers on other threads share the archive's stream */
+    SDL_LockMutex(archive->lock);
+    if (SDL_RWseek(archive->src, stream->start + stream->pos, RW_SEEK_SET) >= 0) {
+        nread = SDL_RWread(archive->src, ptr, 1, total_bytes);
+    }
+    SDL_UnlockMutex(archive->lock);
+
+    stream->pos += nread;
+    return (nread / size);
+}
+
+static size_t SDLCALL
+archive_write(SDL_RWops * context, const void *ptr, size_t size, size_t num)
+{
+    SDL_SetError("Can't write to a file in an archive");
+    return (0);
+}
+
+static int SDLCALL
+archive_close(SDL_RWops * context)
+{
+    if (context) {
+        SDL_free(context->hidden.unknown.data1);
+        SDL_FreeRW(context);
+    }
+    return (0);
+}
+
+SDL_RWops *
+SDL_RWFromArchive(SDL_Archive * archive, const char *name)
+{
+    SDL_ArchiveEntry *entry;
+    SDL_ArchiveStream *stream;
+    SDL_RWops *rwops;
+    Sint64 offset;
+
+    if (!archive) {
+        SDL_InvalidParamError("archive");
+        return NULL;
+    }
+    if (!name) {
+        SDL_InvalidParamError("name");
+        return NULL;
+    }
+
+    entry = SDL_FindArchiveEntry(archive, name);
+    if (!entry) {
+        SDL_SetError("Couldn't find %s in archive", name);
+        return NULL;
+    }
+    if (entry->method != ZIP_STORED) {
+        SDL_SetError("%s is compressed, only stored files are supported", name);
+        return NULL;
+    }
+
+    /* The data follows the zip local header, which is only read when the
+       file is first opened, so opening the archive stays cheap. */
+    SDL_LockMutex(archive->lock);
+    if (entry->offset < 0) {
+        Uint8 header[ZIP_LOCAL_SIZE];
+
+        if (SDL_ReadArchive(archive, entry->header, header, sizeof(header)) == 0) {
+            if (SDL_ArchiveLE32(header) == ZIP_LOCAL_SIG) {
+                entry->offset = entry->header + ZIP_LOCAL_SIZE +
+                    SDL_ArchiveLE16(header + 26) + SDL_ArchiveLE16(header + 28);
+            } else {
+                SDL_SetError("Corrupt zip file header for %s", name);
+            }
+        }
+    }
+    offset = entry->offset;
+    SDL_UnlockMutex(archive->lock);
+
+    if (offset < 0) {
+        return NULL;
+    }
+    if (offset > archive->size || entry->size > archive->size - offset) {
+        SDL_SetError("Corrupt archive entry for %s", name);
+        return NULL;
+    }
+
+    /* Files in memory are read directly, without locking */
+    if (archive->mem && entry->size > 0 && entry->size <= 0x7FFFFFFF) {
+        return SDL_RWFromConstMem(archive->mem + offset, (int) entry->size);
+    }
+
+    stream = (SDL_ArchiveStream *) SDL_malloc(sizeof(*stream));
+    if (!stream) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    rwops = SDL_AllocRW();
+    if (!rwops) {
+        SDL_free(stream);
+        return NULL;
+    }
+    stream->archive = archive;
+    stream->start = offset;
+    stream->size = entry->size;
+    stream->pos = 0;
+
+    rwops->size = archive_size;
+    rwops->seek = archive_seek;
+    rwops->read = archive_read;
+    rwops->write = archive_write;
+    rwops->close = archive_close;
+    rwops->hidden.unknown.data1 = stream;
+    rwops->type = SDL_RWOPS_ARCHIVE;
+    return (rwops);
+}
+
+void
+SDL_CloseArchive(SDL_Archive * archive)
+{
+    if (!archive) {
+        return;
+    }
+    if (archive->freesrc) {
+        SDL_RWclose(archive->src);
+    }
+    if (archive->lock) {
+        SDL_DestroyMutex(archive->lock);
+    }
+    SDL_free(archive->table);
+    SDL_free(archive->names);
+    SDL_free(archive->entries);
+    SDL_free(archive);
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -0,0 +1,477 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2013 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "SDL_config.h"
+
+/* Asynchronous reads from SDL_RWops, run on a small pool of I/O threads */
+
+#include "SDL_atomic.h"
+#include "SDL_events.h"
+#include "SDL_hints.h"
+#include "SDL_thread.h"
+#include "SDL_asyncio.h"
+#include "SDL_asyncio_c.h"
+
+#define SDL_MAX_ASYNCIO_THREADS     8
+#define SDL_DEFAULT_ASYNCIO_THREADS 2
+
+struct SDL_AsyncIO
+{
+    SDL_RWops *src;
+    Sint64 offset;
+    void *ptr;
+    size_t size;
+    int priority;
+    SDL_AsyncIOCallback callback;
+    void *userdata;
+    SDL_AsyncIOStatus status;
+    size_t bytes;
+    SDL_bool queued;
+    SDL_bool notified;  /* The callback or event is done with the request */
+    SDL_AsyncIO *next;
+};
+
+static SDL_SpinLock SDL_asyncio_init_lock;
+static SDL_bool SDL_asyncio_initialized = SDL_FALSE;
+static SDL_bool SDL_asyncio_quit = SDL_FALSE;
+static SDL_mutex *SDL_asyncio_lock = NULL;
+static SDL_cond *SDL_asyncio_wakeup = NULL;
+static SDL_cond *SDL_asyncio_done = NULL;
+
+/* Queued requests, sorted from highest to lowest priority */
+static SDL_AsyncIO *SDL_asyncio_pending = NULL;
+
+/* The stream each thread is reading, so no two threads share one */
+static SDL_RWops *SDL_asyncio_busy[SDL_MAX_ASYNCIO_THREADS];
+static SDL_Thread *SDL_asyncio_threads[SDL_MAX_ASYNCIO_THREADS];
+static int SDL_asyncio_num_threads = 0;
+
+
+static void
+SDL_AsyncIOFinish(SDL_AsyncIO * request, SDL_AsyncIOStatus status, size_t bytes)
+{
+    /* Publish the result first, so the callback and anyone handling the
+       event see the finished request when they query it. */
+    SDL_LockMutex(SDL_asyncio_lock);
+    request->bytes = bytes;
+    request->status = status;
+    SDL_CondBroadcast(SDL_asyncio_done);
+    SDL_UnlockMutex(SDL_asyncio_lock);
+
+    if (request->callback) {
+        request->callback(request->userdata, request, status, bytes);
+    } else if (SDL_GetEventState(SDL_ASYNCIOCOMPLETE) == SDL_ENABLE) {
+        SDL_Event event;
+
+        SDL_zero(event);
+        event.asyncio.type = SDL_ASYNCIOCOMPLETE;
+        event.asyncio.request = request;
+        event.asyncio.userdata = request->userdata;
+        event.asyncio.status = status;
+        event.asyncio.bytes = bytes;
+        SDL_PushEvent(&event);
+    }
+
+    /* The request may be freed as soon as this is published */
+    SDL_LockMutex(SDL_asyncio_lock);
+    request->notified = SDL_TRUE;
+    SDL_CondBroadcast(SDL_asyncio_done);
+    SDL_UnlockMutex(SDL_asyncio_lock);
+}
+
+/* Run a chain of requests on one stream, each starting where the last ended */
+static void
+SDL_AsyncIORun(SDL_AsyncIO * chain)
+{
+    SDL_AsyncIO *request, *next;
+    Sint64 position = -1;
+
+    for (request = chain; request; request = next) {
+        size_t bytes = 0;
+
+        next = request->next;
+        request->next = NULL;
+
+        if (position != request->offset) {
+            position = SDL_RWseek(request->src, request->offset, RW_SEEK_SET);
+        }
+        if (position == request->offset && request->size > 0) {
+            bytes = SDL_RWread(request->src, request->ptr, 1, request->size);
+            position += bytes;
+        }
+
+        if (bytes > 0 || (request->size == 0 && position == request->offset)) {
+            SDL_AsyncIOFinish(request, SDL_ASYNCIO_COMPLETE, bytes);
+        } else {
+            SDL_AsyncIOFinish(request, SDL_ASYNCIO_FAILED, 0);
+        }
+    }
+}
+
+static SDL_bool
+SDL_AsyncIOBusy(SDL_RWops * src)
+{
+    int i;
+
+    for (i = 0; i < SDL_asyncio_num_threads; ++i) {
+        if (SDL_asyncio_busy[i] == src) {
+            return SDL_TRUE;
+        }
+    }
+    return SDL_FALSE;
+}
+
+/* Take the most important request on a stream nobody is reading, along with
+   any pending requests that continue where it ends.  Called with the lock held.
+ */
+static SDL_AsyncIO *
+SDL_AsyncIODequeue(void)
+{
+    SDL_AsyncIO **prev;
+    SDL_AsyncIO *chain, *tail, *request;
+    Sint64 end;
+
+    for (prev = &SDL_asyncio_pending; *prev; prev = &(*prev)->next) {
+        if (!SDL_AsyncIOBusy((*prev)->src)) {
+            break;
+        }
+    }
+    chain = *prev;
+    if (!chain) {
+        return NULL;
+    }
+    *prev = chain->next;
+    chain->next = NULL;
+    chain->queued = SDL_FALSE;
+
+    tail = chain;
+    end = chain->offset + chain->size;
+    prev = &SDL_asyncio_pending;
+    while ((request = *prev) != NULL) {
+        if (request->src == chain->src && request->offset == end) {
+            *prev = request->next;
+            request->next = NULL;
+            request->queued = SDL_FALSE;
+            tail->next = request;
+            tail = request;
+            end += request->size;
+
+            /* An earlier request may continue from the new end */
+            prev = &SDL_asyncio_pending;
+        } else {
+            prev = &request->next;
+        }
+    }
+    return chain;
+}
+
+static int SDLCALL
+SDL_AsyncIOThread(void *data)
+{
+    const int index = (int) (size_t) data;
+    SDL_AsyncIO *chain;
+
+    SDL_LockMutex(SDL_asyncio_lock);
+    while (!SDL_asyncio_quit) {
+        chain = SDL_AsyncIODequeue();
+        if (!chain) {
+            SDL_CondWait(SDL_asyncio_wakeup, SDL_asyncio_lock);
+            continue;
+        }
+
+        SDL_asyncio_busy[index] = chain->src;
+        SDL_UnlockMutex(SDL_asyncio_lock);
+
+        SDL_AsyncIORun(chain);
+
+        SDL_LockMutex(SDL_asyncio_lock);
+        SDL_asyncio_busy[index] = NULL;
+
+        /* Another thread may have skipped a request on this stream */
+        if (SDL_asyncio_pending) {
+            SDL_CondSignal(SDL_asyncio_wakeup);
+        }
+    }
+    SDL_UnlockMutex(SDL_asyncio_lock);
+
+    return 0;
+}
+
+static int
+SDL_AsyncIOInit(void)
+{
+    int retval = 0;
+
+    if (SDL_asyncio_initialized) {
+        SDL_MemoryBarrierAcquire();
+        return 0;
+    }
+
+    SDL_AtomicLock(&SDL_asyncio_init_lock);
+    if (!SDL_asyncio_initialized) {
+        const char *hint = SDL_GetHint(SDL_HINT_ASYNCIO_THREADS);
+        int num_threads = SDL_DEFAULT_ASYNCIO_THREADS;
+        int i;
+
+        if (hint && *hint) {
+            num_threads = SDL_max(0, SDL_min(SDL_atoi(hint), SDL_MAX_ASYNCIO_THREADS));
+        }
+
+        SDL_asyncio_lock = SDL_CreateMutex();
+        SDL_asyncio_wakeup = SDL_CreateCond();
+        SDL_asyncio_done = SDL_CreateCond();
+        if (!SDL_asyncio_lock || !SDL_asyncio_wakeup || !SDL_asyncio_done) {
+            if (SDL_asyncio_done) {
+                SDL_DestroyCond(SDL_asyncio_done);
+                SDL_asyncio_done = NULL;
+            }
+            if (SDL_asyncio_wakeup) {
+                SDL_DestroyCond(SDL_asyncio_wakeup);
+                SDL_asyncio_wakeup = NULL;
+            }
+            if (SDL_asyncio_lock) {
+                SDL_DestroyMutex(SDL_asyncio_lock);
+                SDL_asyncio_lock = NULL;
+            }
+            retval = -1;
+        } else {
+            for (i = 0; i < num_threads; ++i) {
+                char name[64];
+
+                SDL_snprintf(name, sizeof (name), "SDLAsyncIO%d", i);
+                SDL_asyncio_threads[i] = SDL_CreateThread(SDL_AsyncIOThread, name, (void *) (size_t) i);
+                if (!SDL_asyncio_threads[i]) {
+                    /* We'll make do with the threads we have, or read inline */
+                    break;
+                }
+                ++SDL_asyncio_num_threads;
+            }
+            SDL_MemoryBarrierRelease();
+            SDL_asyncio_initialized = SDL_TRUE;
+        }
+    }
+    SDL_AtomicUnlock(&SDL_asyncio_init_lock);
+
+    return retval;
+}
+
+SDL_AsyncIO *
+SDL_ReadAsync(SDL_RWops * src, Sint64 offset, void *ptr, size_t size,
+              int priority, SDL_AsyncIOCallback callback, void *userdata)
+{
+    SDL_AsyncIO *request;
+    SDL_AsyncIO **prev;
+
+    if (!src) {
+        SDL_InvalidParamError("src");
+        return NULL;
+    }
+    if (offset < 0) {
+        SDL_InvalidParamError("offset");
+        return NULL;
+    }
+    if (!ptr && size > 0) {
+        SDL_InvalidParamError("ptr");
+        return NULL;
+    }
+    if (SDL_AsyncIOInit() < 0) {
+        return NULL;
+    }
+
+    request = (SDL_AsyncIO *) SDL_calloc(1, sizeof(*request));
+    if (!request) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    request->src = src;
+    request->offset = offset;
+    request->ptr = ptr;
+    request->size = size;
+    request->priority = priority;
+    request->callback = callback;
+    request->userdata = userdata;
+    request->status = SDL_ASYNCIO_PENDING;
+
+    if (SDL_asyncio_num_threads == 0) {
+        SDL_AsyncIORun(request);
+        return request;
+    }
+
+    /* Requests of equal priority run in the order they were queued */
+    SDL_LockMutex(SDL_asyncio_lock);
+    for (prev = &SDL_asyncio_pending; *prev; prev = &(*prev)->next) {
+        if ((*prev)->priority < priority) {
+            break;
+        }
+    }
+    request->next = *prev;
+    *prev = request;
+    request->queued = SDL_TRUE;
+    SDL_CondSignal(SDL_asyncio_wakeup);
+    SDL_UnlockMutex(SDL_asyncio_lock);
+
+    return request;
+}
+
+/* Remove a request from the queue, returning SDL_FALSE if it had started */
+static SDL_bool
+SDL_AsyncIOUnqueue(SDL_AsyncIO * request)
+{
+    SDL_AsyncIO **prev;
+    SDL_bool removed = SDL_FALSE;
+
+    SDL_LockMutex(SDL_asyncio_lock);
+    if (request->queued) {
+        for (prev = &SDL_asyncio_pending; *prev; prev = &(*prev)->next) {
+            if (*prev == request) {
+                *prev = request->next;
+                break;
+            }
+        }
+        request->next = NULL;
+        request->queued = SDL_FALSE;
+        removed = SDL_TRUE;
+    }
+    SDL_UnlockMutex(SDL_asyncio_lock);
+
+    return removed;
+}
+
+SDL_AsyncIOStatus
+SDL_GetAsyncIOStatus(SDL_AsyncIO * request, size_t * bytes)
+{
+    SDL_AsyncIOStatus status;
+
+    if (!request) {
+        SDL_InvalidParamError("request");
+        return SDL_ASYNCIO_FAILED;
+    }
+
+    SDL_LockMutex(SDL_asyncio_lock);
+    status = request->status;
+    if (bytes) {
+        *bytes = request->bytes;
+    }
+    SDL_UnlockMutex(SDL_asyncio_lock);
+
+    return status;
+}
+
+SDL_AsyncIOStatus
+SDL_WaitAsyncIO(SDL_AsyncIO * request, size_t * bytes)
+{
+    SDL_AsyncIOStatus status;
+
+    if (!request) {
+        SDL_InvalidParamError("request");
+        return SDL_ASYNCIO_FAILED;
+    }
+
+    SDL_LockMutex(SDL_asyncio_lock);
+    while (request->status == SDL_ASYNCIO_PENDING) {
+        SDL_CondWait(SDL_asyncio_done, SDL_asyncio_lock);
+    }
+    status = request->status;
+    if (bytes) {
+        *bytes = request->bytes;
+    }
+    SDL_UnlockMutex(SDL_asyncio_lock);
+
+    return status;
+}
+
+int
+SDL_CancelAsyncIO(SDL_AsyncIO * request)
+{
+    if (!request) {
+        return SDL_InvalidParamError("request");
+    }
+    if (!SDL_AsyncIOUnqueue(request)) {
+        return SDL_SetError("Asynchronous I/O request already started");
+    }
+    SDL_AsyncIOFinish(request, SDL_ASYNCIO_CANCELED, 0);
+    return 0;
+}
+
+void
+SDL_FreeAsyncIO(SDL_AsyncIO * request)
+{
+    if (!request) {
+        return;
+    }
+    if (!SDL_AsyncIOUnqueue(request)) {
+        /* Wait until the callback or event no longer needs the request */
+        SDL_LockMutex(SDL_asyncio_lock);
+        while (!request->notified) {
+            SDL_CondWait(SDL_asyncio_done, SDL_asyncio_lock);
+        }
+        SDL_UnlockMutex(SDL_asyncio_lock);
+    }
+    SDL_free(request);
+}
+
+void
+SDL_AsyncIOQuit(void)
+{
+    SDL_AsyncIO *canceled, *request;
+    int i;
+
+    SDL_AtomicLock(&SDL_asyncio_init_lock);
+    if (!SDL_asyncio_initialized) {
+        SDL_AtomicUnlock(&SDL_asyncio_init_lock);
+        return;
+    }
+
+    SDL_LockMutex(SDL_asyncio_lock);
+    SDL_asyncio_quit = SDL_TRUE;
+    canceled = SDL_asyncio_pending;
+    SDL_asyncio_pending = NULL;
+    for (request = canceled; request; request = request->next) {
+        request->queued = SDL_FALSE;
+    }
+    SDL_CondBroadcast(SDL_asyncio_wakeup);
+    SDL_UnlockMutex(SDL_asyncio_lock);
+
+    /* The threads finish the requests they're running before exiting */
+    for (i = 0; i < SDL_asyncio_num_threads; ++i) {
+        SDL_WaitThread(SDL_asyncio_threads[i], NULL);
+        SDL_asyncio_threads[i] = NULL;
+    }
+    SDL_asyncio_num_threads = 0;
+
+    while (canceled) {
+        request = canceled;
+        canceled = request->next;
+        request->next = NULL;
+        SDL_AsyncIOFinish(request, SDL_ASYNCIO_CANCELED, 0);
+    }
+
+    SDL_DestroyCond(SDL_asyncio_done);
+    SDL_DestroyCond(SDL_asyncio_wakeup);
+    SDL_DestroyMutex(SDL_asyncio_lock);
+    SDL_asyncio_done = NULL;
+    SDL_asyncio_wakeup = NULL;
+    SDL_asyncio_lock = NULL;
+    SDL_asyncio_quit = SDL_FALSE;
+    SDL_asyncio_initialized = SDL_FALSE;
+    SDL_AtomicUnlock(&SDL_asyncio_init_lock);
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
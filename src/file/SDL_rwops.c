@@ -33,6 +33,17 @@
 
 #include "SDL_endian.h"
 #include "SDL_rwops.h"
+#include "SDL_hints.h"
+#include "SDL_rwops_c.h"
+
+#if defined(HAVE_MMAP) && defined(HAVE_STDIO_H)
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#define HAVE_MAPPED_FILES
+#elif defined(__WIN32__)
+#define HAVE_MAPPED_FILES
+#endif
 
 #ifdef __APPLE__
 #include "cocoa/SDL_rwopsbundlesupport.h"
@@ -451,6 +462,333 @@ mem_close(SDL_RWops * context)
     return (0);
 }
 
+#ifdef HAVE_MAPPED_FILES
+
+/* Functions to read memory mapped files, using the memory functions above */
+
+static SDL_bool
+mapped_file_wanted(const char *mode)
+{
+    const char *hint;
+
+    if (SDL_strchr(mode, 'w') || SDL_strchr(mode, 'a') || SDL_strchr(mode, '+')) {
+        return SDL_FALSE;
+    }
+    if (SDL_strchr(mode, 'm')) {
+        return SDL_TRUE;
+    }
+    hint = SDL_GetHint(SDL_HINT_RWOPS_MMAP);
+    if (hint && *hint == '1') {
+        return SDL_TRUE;
+    }
+    return SDL_FALSE;
+}
+
+static void
+mapped_file_init(SDL_RWops * context, void *base, size_t size)
+{
+    context->size = mem_size;
+    context->seek = mem_seek;
+    context->read = mem_read;
+    context->write = mem_writeconst;
+    context->hidden.mem.base = (Uint8 *) base;
+    context->hidden.mem.here = context->hidden.mem.base;
+    context->hidden.mem.stop = context->hidden.mem.base + size;
+    context->type = SDL_RWOPS_MAPPED;
+}
+
+#ifdef __WIN32__
+
+static int SDLCALL
+windows_mapped_close(SDL_RWops * context)
+{
+    if (context) {
+        UnmapViewOfFile(context->hidden.mem.base);
+        SDL_FreeRW(context);
+    }
+    return (0);
+}
+
+/* Replace an open file with a mapping of it, leaving it alone on failure */
+static SDL_bool
+windows_file_map(SDL_RWops * context)
+{
+    HANDLE h = context->hidden.windowsio.h;
+    HANDLE mapping;
+    LARGE_INTEGER size;
+    void *base;
+
+    if (!GetFileSizeEx(h, &size) || size.QuadPart <= 0 ||
+        (Uint64) size.QuadPart > (Uint64) ((size_t) -1)) {
+        return SDL_FALSE;
+    }
+    mapping = CreateFileMapping(h, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!mapping) {
+        return SDL_FALSE;
+    }
+    base = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);   /* the view keeps the mapping alive */
+    if (!base) {
+        return SDL_FALSE;
+    }
+
+    CloseHandle(h);
+    SDL_free(context->hidden.windowsio.buffer.data);
+    mapped_file_init(context, base, (size_t) size.QuadPart);
+    context->close = windows_mapped_close;
+    return SDL_TRUE;
+}
+
+#else
+
+static int SDLCALL
+mmap_close(SDL_RWops * context)
+{
+    if (context) {
+        munmap(context->hidden.mem.base,
+               context->hidden.mem.stop - context->hidden.mem.base);
+        SDL_FreeRW(context);
+    }
+    return (0);
+}
+
+/* Map a file opened with stdio and close it, or return NULL on failure */
+static SDL_RWops *
+mmap_from_fp(FILE * fp)
+{
+    SDL_RWops *rwops;
+    struct stat sb;
+    size_t size;
+    void *base;
+
+    if (fstat(fileno(fp), &sb) < 0 || !S_ISREG(sb.st_mode) ||
+        sb.st_size <= 0 || (Uint64) sb.st_size > (Uint64) ((size_t) -1)) {
+        return NULL;
+    }
+    size = (size_t) sb.st_size;
+    base = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fileno(fp), 0);
+    if (base == MAP_FAILED) {
+        return NULL;
+    }
+    rwops = SDL_AllocRW();
+    if (!rwops) {
+        munmap(base, size);
+        return NULL;
+    }
+
+    fclose(fp);             /* the mapping keeps the file alive */
+    mapped_file_init(rwops, base, size);
+    rwops->close = mmap_close;
+    return rwops;
+}
+
+#endif /* __WIN32__ */
+
+#endif /* HAVE_MAPPED_FILES */
+
+
+/* Functions to read/write another SDL_RWops through a buffer */
+
+#define SDL_RWOPS_BUFFER_SIZE   4096
+
+typedef struct SDL_BufferedRW
+{
+    SDL_RWops *src;
+    SDL_bool autoclose;
+    SDL_bool dirty;     /* The buffer holds data not yet written to src */
+    Sint64 base;        /* The stream position of the start of the buffer */
+    size_t pos;         /* The current position within the buffer */
+    size_t len;         /* The number of bytes of data in the buffer */
+    size_t size;
+    Uint8 *data;
+} SDL_BufferedRW;
+
+/* While reading, src is positioned at the end of the buffered data.
+   While writing, src is positioned at the start of the buffer.
+ */
+
+static int
+buffered_flush(SDL_BufferedRW * buffer)
+{
+    size_t len = buffer->len;
+    size_t written = 0;
+
+    if (len > 0) {
+        written = SDL_RWwrite(buffer->src, buffer->data, 1, len);
+    }
+    buffer->dirty = SDL_FALSE;
+    buffer->base += written;
+    buffer->pos = buffer->len = 0;
+    if (written < len) {
+        return SDL_Error(SDL_EFWRITE);
+    }
+    return 0;
+}
+
+static Sint64 SDLCALL
+buffered_size(SDL_RWops * context)
+{
+    SDL_BufferedRW *buffer = (SDL_BufferedRW *) context->hidden.unknown.data1;
+
+    if (buffer->dirty && buffered_flush(buffer) < 0) {
+        return -1;
+    }
+    return SDL_RWsize(buffer->src);
+}
+
+static Sint64 SDLCALL
+buffered_seek(SDL_RWops * context, Sint64 offset, int whence)
+{
+    SDL_BufferedRW *buffer = (SDL_BufferedRW *) context->hidden.unknown.data1;
+    Sint64 newpos;
+
+    switch (whence) {
+    case RW_SEEK_SET:
+        newpos = offset;
+        break;
+    case RW_SEEK_CUR:
+        newpos = buffer->base + buffer->pos + offset;
+        break;
+    case RW_SEEK_END:
+        newpos = -1;
+        break;
+    default:
+        return SDL_SetError("Unknown value for 'whence'");
+    }
+
+    if (newpos == buffer->base + buffer->pos) {
+        return newpos;
+    }
+    if (!buffer->dirty && newpos >= buffer->base &&
+        newpos <= buffer->base + (Sint64) buffer->len) {
+        buffer->pos = (size_t) (newpos - buffer->base);
+        return newpos;
+    }
+
+    if (buffer->dirty) {
+        if (buffered_flush(buffer) < 0) {
+            return -1;
+        }
+    } else {
+        buffer->pos = buffer->len = 0;
+    }
+    if (whence == RW_SEEK_END) {
+        newpos = SDL_RWseek(buffer->src, offset, RW_SEEK_END);
+    } else {
+        newpos = SDL_RWseek(buffer->src, newpos, RW_SEEK_SET);
+    }
+    if (newpos >= 0) {
+        buffer->base = newpos;
+    }
+    return newpos;
+}
+
+static size_t SDLCALL
+buffered_read(SDL_RWops * context, void *ptr, size_t size, size_t maxnum)
+{
+    SDL_BufferedRW *buffer = (SDL_BufferedRW *) context->hidden.unknown.data1;
+    Uint8 *dst = (Uint8 *) ptr;
+    size_t total_bytes, left, n;
+
+    total_bytes = (maxnum * size);
+    if ((maxnum <= 0) || (size <= 0)
+        || ((total_bytes / maxnum) != (size_t) size)) {
+        return 0;
+    }
+    if (buffer->dirty && buffered_flush(buffer) < 0) {
+        return 0;
+    }
+
+    left = total_bytes;
+    while (left > 0) {
+        if (buffer->pos < buffer->len) {
+            n = SDL_min(buffer->len - buffer->pos, left);
+            SDL_memcpy(dst, buffer->data + buffer->pos, n);
+            buffer->pos += n;
+            dst += n;
+            left -= n;
+            continue;
+        }
+
+        buffer->base += buffer->len;
+        buffer->pos = buffer->len = 0;
+        if (left >= buffer->size) {
+            /* Large reads go straight into the caller's memory */
+            n = SDL_RWread(buffer->src, dst, 1, left);
+            buffer->base += n;
+            left -= n;
+            break;
+        }
+        n = SDL_RWread(buffer->src, buffer->data, 1, buffer->size);
+        if (n == 0) {
+            break;
+        }
+        buffer->len = n;
+    }
+    return ((total_bytes - left) / size);
+}
+
+static size_t SDLCALL
+buffered_write(SDL_RWops * context, const void *ptr, size_t size, size_t num)
+{
+    SDL_BufferedRW *buffer = (SDL_BufferedRW *) context->hidden.unknown.data1;
+    size_t total_bytes, n;
+
+    total_bytes = (num * size);
+    if ((num <= 0) || (size <= 0)
+        || ((total_bytes / num) != (size_t) size)) {
+        return 0;
+    }
+
+    if (!buffer->dirty && buffer->len > 0) {
+        /* Drop the read-ahead data and go back to where the reader was */
+        if (buffer->pos < buffer->len &&
+            SDL_RWseek(buffer->src, buffer->base + buffer->pos, RW_SEEK_SET) < 0) {
+            return 0;
+        }
+        buffer->base += buffer->pos;
+        buffer->pos = buffer->len = 0;
+    }
+    if (total_bytes > buffer->size - buffer->len) {
+        if (buffered_flush(buffer) < 0) {
+            return 0;
+        }
+    }
+
+    if (total_bytes >= buffer->size) {
+        n = SDL_RWwrite(buffer->src, ptr, 1, total_bytes);
+        buffer->base += n;
+        return (n / size);
+    }
+    SDL_memcpy(buffer->data + buffer->len, ptr, total_bytes);
+    buffer->len += total_bytes;
+    buffer->pos = buffer->len;
+    buffer->dirty = SDL_TRUE;
+    return (num);
+}
+
+static int SDLCALL
+buffered_close(SDL_RWops * context)
+{
+    int status = 0;
+    if (context) {
+        SDL_BufferedRW *buffer = (SDL_BufferedRW *) context->hidden.unknown.data1;
+
+        if (buffer->dirty) {
+            status = buffered_flush(buffer);
+        } else if (!buffer->autoclose && buffer->pos < buffer->len) {
+            /* Leave src where the reader stopped */
+            SDL_RWseek(buffer->src, buffer->base + buffer->pos, RW_SEEK_SET);
+        }
+        if (buffer->autoclose && SDL_RWclose(buffer->src) < 0) {
+            status = -1;
+        }
+        SDL_free(buffer);
+        SDL_FreeRW(context);
+    }
+    return status;
+}
+
 
 /* Functions to create SDL_RWops structures from various data sources */
 
@@ -468,7 +806,14 @@ SDL_RWFromFile(const char *file, const char *mode)
     if (*file == '/') {
         FILE *fp = fopen(file, mode);
         if (fp) {
-            return SDL_RWFromFP(fp, 1);
+#ifdef HAVE_MAPPED_FILES
+            if (mapped_file_wanted(mode)) {
+                rwops = mmap_from_fp(fp);
+            }
+            if (!rwops)
+#endif
+            rwops = SDL_RWFromFP(fp, 1);
+            return rwops;
         }
     } else {
         /* Try opening it from internal storage if it's a relative path */
@@ -482,7 +827,14 @@ SDL_RWFromFile(const char *file, const char *mode)
             fp = fopen(path, mode);
             SDL_stack_free(path);
             if (fp) {
-                return SDL_RWFromFP(fp, 1);
+#ifdef HAVE_MAPPED_FILES
+                if (mapped_file_wanted(mode)) {
+                    rwops = mmap_from_fp(fp);
+                }
+                if (!rwops)
+#endif
+                rwops = SDL_RWFromFP(fp, 1);
+                return rwops;
             }
         }
     }
@@ -511,6 +863,9 @@ SDL_RWFromFile(const char *file, const char *mode)
         SDL_FreeRW(rwops);
         return NULL;
     }
+    if (mapped_file_wanted(mode) && windows_file_map(rwops)) {
+        return rwops;
+    }
     rwops->size = windows_file_size;
     rwops->seek = windows_file_seek;
     rwops->read = windows_file_read;
@@ -528,6 +883,12 @@ SDL_RWFromFile(const char *file, const char *mode)
         if (fp == NULL) {
             SDL_SetError("Couldn't open %s", file);
         } else {
+#ifdef HAVE_MAPPED_FILES
+            if (mapped_file_wanted(mode)) {
+                rwops = mmap_from_fp(fp);
+            }
+            if (!rwops)
+#endif
             rwops = SDL_RWFromFP(fp, 1);
         }
     }
@@ -622,6 +983,98 @@ SDL_RWFromConstMem(const void *mem, int size)
     return (rwops);
 }
 
+SDL_RWops *
+SDL_RWFromBuffered(SDL_RWops * src, int buffer_size, SDL_bool autoclose)
+{
+    SDL_RWops *rwops;
+    SDL_BufferedRW *buffer;
+    Sint64 base;
+
+    if (!src) {
+        SDL_InvalidParamError("src");
+        return NULL;
+    }
+    if (buffer_size < 0) {
+        SDL_InvalidParamError("buffer_size");
+        return NULL;
+    }
+    if (!buffer_size) {
+        buffer_size = SDL_RWOPS_BUFFER_SIZE;
+    }
+
+    buffer = (SDL_BufferedRW *) SDL_malloc(sizeof(*buffer) + buffer_size);
+    if (!buffer) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    rwops = SDL_AllocRW();
+    if (!rwops) {
+        SDL_free(buffer);
+        return NULL;
+    }
+
+    /* Streams that can't seek still work, as long as nobody seeks */
+    base = SDL_RWtell(src);
+
+    buffer->src = src;
+    buffer->autoclose = autoclose;
+    buffer->dirty = SDL_FALSE;
+    buffer->base = (base > 0) ? base : 0;
+    buffer->pos = 0;
+    buffer->len = 0;
+    buffer->size = (size_t) buffer_size;
+    buffer->data = (Uint8 *) (buffer + 1);
+
+    rwops->size = buffered_size;
+    rwops->seek = buffered_seek;
+    rwops->read = buffered_read;
+    rwops->write = buffered_write;
+    rwops->close = buffered_close;
+    rwops->hidden.unknown.data1 = buffer;
+    rwops->type = SDL_RWOPS_BUFFERED;
+    return (rwops);
+}
+
+SDL_RWops *
+SDL_RWBufferIfNeeded(SDL_RWops * src, int autoclose)
+{
+    switch (src->type) {
+    case SDL_RWOPS_UNKNOWN:
+    case SDL_RWOPS_WINFILE:
+    case SDL_RWOPS_JNIFILE:
+    case SDL_RWOPS_ARCHIVE:
+        return SDL_RWFromBuffered(src, 0, autoclose ? SDL_TRUE : SDL_FALSE);
+    default:
+        /* stdio and memory streams are cheap to read in small pieces */
+        return NULL;
+    }
+}
+
+const void *
+SDL_RWGetPointer(SDL_RWops * context, size_t * available)
+{
+    if (available) {
+        *available = 0;
+    }
+    if (!context) {
+        SDL_InvalidParamError("context");
+        return NULL;
+    }
+
+    switch (context->type) {
+    case SDL_RWOPS_MEMORY:
+    case SDL_RWOPS_MEMORY_RO:
+    case SDL_RWOPS_MAPPED:
+        if (available) {
+            *available = (size_t)(context->hidden.mem.stop - context->hidden.mem.here);
+        }
+        return context->hidden.mem.here;
+    default:
+        SDL_SetError("Stream isn't backed by memory");
+        return NULL;
+    }
+}
+
 SDL_RWops *
 SDL_AllocRW(void)
 {
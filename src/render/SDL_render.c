@@ -28,6 +28,7 @@
 #include "SDL_render.h"
 #include "SDL_sysrender.h"
 #include "software/SDL_render_sw_c.h"
+#include "../stdlib/SDL_malloc_c.h"
 
 
 #define SDL_WINDOWRENDERDATA    "_SDL_WindowRenderData"
@@ -274,6 +275,7 @@ SDL_CreateRenderer(SDL_Window * window, int index, Uint32 flags)
         renderer->window = window;
         renderer->scale.x = 1.0f;
         renderer->scale.y = 1.0f;
+        renderer->line_width = 1.0f;
 
         if (SDL_GetWindowFlags(window) & (SDL_WINDOW_HIDDEN|SDL_WINDOW_MINIMIZED)) {
             renderer->hidden = SDL_TRUE;
@@ -309,6 +311,7 @@ SDL_CreateSoftwareRenderer(SDL_Surface * surface)
         renderer->magic = &renderer_magic;
         renderer->scale.x = 1.0f;
         renderer->scale.y = 1.0f;
+        renderer->line_width = 1.0f;
 
         SDL_RenderSetViewport(renderer, NULL);
     }
@@ -419,6 +422,7 @@ SDL_CreateTexture(SDL_Renderer * renderer, Uint32 format, int access, int w, int
         SDL_OutOfMemory();
         return NULL;
     }
+    SDL_TrackAllocation(SDL_MEMORY_RENDER_TEXTURES, sizeof(*texture));
     texture->magic = &texture_magic;
     texture->format = format;
     texture->access = access;
@@ -476,6 +480,7 @@ SDL_CreateTexture(SDL_Renderer * renderer, Uint32 format, int access, int w, int
                 SDL_DestroyTexture(texture);
                 return NULL;
             }
+            SDL_TrackAllocation(SDL_MEMORY_RENDER_TEXTURES, texture->pitch * h);
         }
     }
     return texture;
@@ -1324,6 +1329,35 @@ SDL_GetRenderDrawBlendMode(SDL_Renderer * renderer, SDL_BlendMode *blendMode)
     return 0;
 }
 
+int
+SDL_SetRenderDrawLineStyle(SDL_Renderer * renderer, float width,
+                           SDL_bool antialias)
+{
+    CHECK_RENDERER_MAGIC(renderer, -1);
+
+    if (!(width > 0.0f)) {
+        return SDL_InvalidParamError("width");
+    }
+    renderer->line_width = width;
+    renderer->line_antialias = antialias ? SDL_TRUE : SDL_FALSE;
+    return 0;
+}
+
+int
+SDL_GetRenderDrawLineStyle(SDL_Renderer * renderer, float *width,
+                           SDL_bool *antialias)
+{
+    CHECK_RENDERER_MAGIC(renderer, -1);
+
+    if (width) {
+        *width = renderer->line_width;
+    }
+    if (antialias) {
+        *antialias = renderer->line_antialias;
+    }
+    return 0;
+}
+
 int
 SDL_RenderClear(SDL_Renderer * renderer)
 {
@@ -1425,6 +1459,225 @@ SDL_RenderDrawLine(SDL_Renderer * renderer, int x1, int y1, int x2, int y2)
     return SDL_RenderDrawLines(renderer, points, 2);
 }
 
+/* Longest miter, in half widths, before a sharp joint gets clamped */
+#define MAX_LINE_MITER  4.0f
+
+/* Fill in the offset of each vertex of a polyline for a half width of 1.
+   For a segment going in direction (dx, dy) the offset is (-dy, dx). The
+   offsets are mitered at the joints, and are the plain segment normal at the
+   line ends, so the line direction there is (miter.y, -miter.x).
+ */
+static void
+SDL_GetLineMiters(const SDL_FPoint * points, int count, SDL_FPoint * miters)
+{
+    float dx = 1.0f, dy = 0.0f;
+    float nx, ny, len;
+    int i, first = -1;
+
+    /* Find the direction of the first segment that isn't a single point */
+    for (i = 0; i < count-1; ++i) {
+        nx = points[i+1].x - points[i].x;
+        ny = points[i+1].y - points[i].y;
+        len = (float)SDL_sqrt(nx * nx + ny * ny);
+        if (len > 0.0f) {
+            dx = nx / len;
+            dy = ny / len;
+            first = i;
+            break;
+        }
+    }
+    if (first < 0) {
+        /* Every point is the same, there's no direction at all */
+        for (i = 0; i < count; ++i) {
+            miters[i].x = -dy;
+            miters[i].y = dx;
+        }
+        return;
+    }
+    for (i = 0; i <= first; ++i) {
+        miters[i].x = -dy;
+        miters[i].y = dx;
+    }
+
+    /* dx,dy is the direction coming into point i */
+    for (i = first+1; i < count; ++i) {
+        float ndx = dx, ndy = dy;
+        float mx, my, d;
+
+        if (i < count-1) {
+            nx = points[i+1].x - points[i].x;
+            ny = points[i+1].y - points[i].y;
+            len = (float)SDL_sqrt(nx * nx + ny * ny);
+            if (len > 0.0f) {
+                ndx = nx / len;
+                ndy = ny / len;
+            }
+        }
+
+        /* The miter is the sum of the two normals, scaled so that it is
+           one half width away from both edges */
+        mx = -dy - ndy;
+        my = dx + ndx;
+        d = 1.0f + (dx * ndx + dy * ndy);
+        if (d > 1.0f / (MAX_LINE_MITER * MAX_LINE_MITER)) {
+            mx /= d;
+            my /= d;
+            len = (float)SDL_sqrt(mx * mx + my * my);
+            if (len > MAX_LINE_MITER) {
+                mx *= MAX_LINE_MITER / len;
+                my *= MAX_LINE_MITER / len;
+            }
+        } else if (mx * mx + my * my > 0.0f) {
+            len = (float)SDL_sqrt(mx * mx + my * my);
+            mx *= MAX_LINE_MITER / len;
+            my *= MAX_LINE_MITER / len;
+        } else {
+            /* The line doubles back on itself */
+            mx = -dy;
+            my = dx;
+        }
+        miters[i].x = mx;
+        miters[i].y = my;
+
+        dx = ndx;
+        dy = ndy;
+    }
+
+    /* The line ends get the normal of the last segment */
+    miters[count-1].x = -dy;
+    miters[count-1].y = dx;
+}
+
+#define SET_LINE_VERTEX(X, Y, C) \
+    do {                    \
+        vertices[0] = (X);  \
+        vertices[1] = (Y);  \
+        vertices[2] = (C);  \
+        vertices += 3;      \
+    } while (0)
+
+static float *
+SDL_GetLineCapStrip(float *vertices, const SDL_FPoint * p,
+                    const SDL_FPoint * normal, const SDL_FPoint * out,
+                    float half, float coverage)
+{
+    const float ox = normal->x * (half + 1.0f);
+    const float oy = normal->y * (half + 1.0f);
+    const float ix = normal->x * half;
+    const float iy = normal->y * half;
+
+    /* The corners join up with the fringes along the sides */
+    SET_LINE_VERTEX(p->x + ox, p->y + oy, 0.0f);
+    SET_LINE_VERTEX(p->x + ix, p->y + iy, coverage);
+    SET_LINE_VERTEX(p->x + ox + out->x, p->y + oy + out->y, 0.0f);
+    SET_LINE_VERTEX(p->x - ix, p->y - iy, coverage);
+    SET_LINE_VERTEX(p->x - ox + out->x, p->y - oy + out->y, 0.0f);
+    SET_LINE_VERTEX(p->x - ox, p->y - oy, 0.0f);
+    return vertices;
+}
+
+int
+SDL_GetLineStrips(const SDL_FPoint * points, int count, float width,
+                  SDL_bool antialias, float * vertices)
+{
+    SDL_FPoint *miters;
+    SDL_FPoint first, last, start_out, end_out;
+    float half, coverage;
+    int i;
+
+    miters = SDL_stack_alloc(SDL_FPoint, count);
+    if (!miters) {
+        return SDL_OutOfMemory();
+    }
+    SDL_GetLineMiters(points, count, miters);
+
+    /* Anti-aliased lines have a solid middle and fade out over one pixel
+       on each side, so the coverage is half at the nominal edge */
+    if (antialias) {
+        half = SDL_max(width * 0.5f - 0.5f, 0.0f);
+        coverage = SDL_min(width, 1.0f);
+    } else {
+        half = SDL_max(width * 0.5f, 0.5f);
+        coverage = 1.0f;
+    }
+
+    /* The ends are extended by the half width for square line ends */
+    start_out.x = -miters[0].y;
+    start_out.y = miters[0].x;
+    end_out.x = miters[count-1].y;
+    end_out.y = -miters[count-1].x;
+    first.x = points[0].x + start_out.x * half;
+    first.y = points[0].y + start_out.y * half;
+    last.x = points[count-1].x + end_out.x * half;
+    last.y = points[count-1].y + end_out.y * half;
+
+#define LINE_POINT(i) ((i) == 0 ? &first : (i) == count-1 ? &last : &points[i])
+
+    for (i = 0; i < count; ++i) {
+        const SDL_FPoint *p = LINE_POINT(i);
+        const float mx = miters[i].x * half;
+        const float my = miters[i].y * half;
+
+        SET_LINE_VERTEX(p->x + mx, p->y + my, coverage);
+        SET_LINE_VERTEX(p->x - mx, p->y - my, coverage);
+    }
+
+    if (antialias) {
+        for (i = 0; i < count; ++i) {
+            const SDL_FPoint *p = LINE_POINT(i);
+
+            SET_LINE_VERTEX(p->x + miters[i].x * (half + 1.0f),
+                            p->y + miters[i].y * (half + 1.0f), 0.0f);
+            SET_LINE_VERTEX(p->x + miters[i].x * half,
+                            p->y + miters[i].y * half, coverage);
+        }
+        for (i = 0; i < count; ++i) {
+            const SDL_FPoint *p = LINE_POINT(i);
+
+            SET_LINE_VERTEX(p->x - miters[i].x * half,
+                            p->y - miters[i].y * half, coverage);
+            SET_LINE_VERTEX(p->x - miters[i].x * (half + 1.0f),
+                            p->y - miters[i].y * (half + 1.0f), 0.0f);
+        }
+        vertices = SDL_GetLineCapStrip(vertices, &first, &miters[0],
+                                       &start_out, half, coverage);
+        vertices = SDL_GetLineCapStrip(vertices, &last, &miters[count-1],
+                                       &end_out, half, coverage);
+    }
+
+#undef LINE_POINT
+
+    SDL_stack_free(miters);
+    return 0;
+}
+
+static int
+RenderDrawLinesEx(SDL_Renderer * renderer,
+                  const SDL_Point * points, int count)
+{
+    SDL_FPoint *fpoints;
+    float width;
+    int i;
+    int status;
+
+    fpoints = SDL_stack_alloc(SDL_FPoint, count);
+    if (!fpoints) {
+        return SDL_OutOfMemory();
+    }
+    for (i = 0; i < count; ++i) {
+        fpoints[i].x = points[i].x * renderer->scale.x;
+        fpoints[i].y = points[i].y * renderer->scale.y;
+    }
+    width = renderer->line_width * (renderer->scale.x + renderer->scale.y) * 0.5f;
+
+    status = renderer->RenderDrawLinesEx(renderer, fpoints, count,
+                                         width, renderer->line_antialias);
+
+    SDL_stack_free(fpoints);
+
+    return status;
+}
+
 static int
 RenderDrawLinesWithRects(SDL_Renderer * renderer,
                      const SDL_Point * points, int count)
@@ -1502,6 +1755,11 @@ SDL_RenderDrawLines(SDL_Renderer * renderer,
         return 0;
     }
 
+    if ((renderer->line_width != 1.0f || renderer->line_antialias) &&
+        renderer->RenderDrawLinesEx) {
+        return RenderDrawLinesEx(renderer, points, count);
+    }
+
     if (renderer->scale.x != 1.0f || renderer->scale.y != 1.0f) {
         return RenderDrawLinesWithRects(renderer, points, count);
     }
@@ -1826,9 +2084,13 @@ SDL_DestroyTexture(SDL_Texture * texture)
     if (texture->yuv) {
         SDL_SW_DestroyYUVTexture(texture->yuv);
     }
+    if (texture->pixels) {
+        SDL_TrackFree(SDL_MEMORY_RENDER_TEXTURES, texture->pitch * texture->h);
+    }
     SDL_free(texture->pixels);
 
     renderer->DestroyTexture(renderer, texture);
+    SDL_TrackFree(SDL_MEMORY_RENDER_TEXTURES, sizeof(*texture));
     SDL_free(texture);
 }
 
@@ -105,6 +105,8 @@ struct SDL_Renderer
                              int count);
     int (*RenderDrawLines) (SDL_Renderer * renderer, const SDL_FPoint * points,
                             int count);
+    int (*RenderDrawLinesEx) (SDL_Renderer * renderer, const SDL_FPoint * points,
+                              int count, float width, SDL_bool antialias);
     int (*RenderFillRects) (SDL_Renderer * renderer, const SDL_FRect * rects,
                             int count);
     int (*RenderCopy) (SDL_Renderer * renderer, SDL_Texture * texture,
@@ -125,6 +127,10 @@ struct SDL_Renderer
     /* The current renderer info */
     SDL_RendererInfo info;
 
+    /* Whether LockTexture() gives access to a copy of the texture in system
+       memory, which keeps its address and contents while it's unlocked */
+    SDL_bool persistent_locks;
+
     /* The window associated with the renderer */
     SDL_Window *window;
     SDL_bool hidden;
@@ -153,6 +159,8 @@ struct SDL_Renderer
 
     Uint8 r, g, b, a;                   /**< Color for drawing operations values */
     SDL_BlendMode blendMode;            /**< The drawing blend mode */
+    float line_width;                   /**< The line width in pixels */
+    SDL_bool line_antialias;            /**< Whether lines are anti-aliased */
 
     void *driverdata;
 };
@@ -188,6 +196,20 @@ extern SDL_RenderDriver PSP_RenderDriver;
 #endif
 extern SDL_RenderDriver SW_RenderDriver;
 
+/* Expand a polyline of the given width into triangle strips, for renderers
+   that draw wide lines as triangles. Each vertex is x, y and the coverage of
+   the line there, from 0 to 1. The strips are, in order, the solid middle of
+   the line with 2*count vertices, and for anti-aliased lines the fringes
+   along either side with 2*count vertices each, followed by the fringes
+   around the line ends with 6 vertices each.
+ */
+#define SDL_LINE_STRIP_VERTICES(count, antialias) \
+    ((antialias) ? (6 * (count) + 12) : (2 * (count)))
+
+extern int SDL_GetLineStrips(const SDL_FPoint * points, int count,
+                             float width, SDL_bool antialias,
+                             float * vertices);
+
 #endif /* !SDL_RENDER_DISABLED */
 
 #endif /* _SDL_sysrender_h */
@@ -68,6 +68,9 @@ static int GL_RenderDrawPoints(SDL_Renderer * renderer,
                                const SDL_FPoint * points, int count);
 static int GL_RenderDrawLines(SDL_Renderer * renderer,
                               const SDL_FPoint * points, int count);
+static int GL_RenderDrawLinesEx(SDL_Renderer * renderer,
+                                const SDL_FPoint * points, int count,
+                                float width, SDL_bool antialias);
 static int GL_RenderFillRects(SDL_Renderer * renderer,
                               const SDL_FRect * rects, int count);
 static int GL_RenderCopy(SDL_Renderer * renderer, SDL_Texture * texture,
@@ -417,6 +420,7 @@ GL_CreateRenderer(SDL_Window * window, Uint32 flags)
     renderer->RenderClear = GL_RenderClear;
     renderer->RenderDrawPoints = GL_RenderDrawPoints;
     renderer->RenderDrawLines = GL_RenderDrawLines;
+    renderer->RenderDrawLinesEx = GL_RenderDrawLinesEx;
     renderer->RenderFillRects = GL_RenderFillRects;
     renderer->RenderCopy = GL_RenderCopy;
     renderer->RenderCopyEx = GL_RenderCopyEx;
@@ -428,6 +432,7 @@ GL_CreateRenderer(SDL_Window * window, Uint32 flags)
     renderer->GL_UnbindTexture = GL_UnbindTexture;
     renderer->info = GL_RenderDriver.info;
     renderer->info.flags = SDL_RENDERER_ACCELERATED;
+    renderer->persistent_locks = SDL_TRUE;
     renderer->driverdata = data;
     renderer->window = window;
 
@@ -1125,6 +1130,81 @@ GL_RenderDrawLines(SDL_Renderer * renderer, const SDL_FPoint * points,
     return GL_CheckError("", renderer);
 }
 
+static void
+GL_EmitLineStrip(GL_RenderData * data, const float *vertices, int count,
+                 SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+    int i;
+
+    data->glBegin(GL_TRIANGLE_STRIP);
+    for (i = 0; i < count; ++i, vertices += 3) {
+        const GLfloat coverage = vertices[2];
+
+        if (blendMode == SDL_BLENDMODE_MOD) {
+            /* Fade the modulation color towards white */
+            data->glColor4f(1.0f - coverage + r * inv255f * coverage,
+                            1.0f - coverage + g * inv255f * coverage,
+                            1.0f - coverage + b * inv255f * coverage,
+                            a * inv255f);
+        } else {
+            data->glColor4f(r * inv255f, g * inv255f, b * inv255f,
+                            a * inv255f * coverage);
+        }
+        data->glVertex2f(0.5f + vertices[0], 0.5f + vertices[1]);
+    }
+    data->glEnd();
+}
+
+static int
+GL_RenderDrawLinesEx(SDL_Renderer * renderer, const SDL_FPoint * points,
+                     int count, float width, SDL_bool antialias)
+{
+    GL_RenderData *data = (GL_RenderData *) renderer->driverdata;
+    SDL_BlendMode blendMode = renderer->blendMode;
+    const Uint8 r = renderer->r;
+    const Uint8 g = renderer->g;
+    const Uint8 b = renderer->b;
+    const Uint8 a = renderer->a;
+    const int nvertices = SDL_LINE_STRIP_VERTICES(count, antialias);
+    float *vertices, *strip;
+
+    vertices = (float *)SDL_malloc(nvertices * 3 * sizeof(float));
+    if (!vertices) {
+        return SDL_OutOfMemory();
+    }
+    if (SDL_GetLineStrips(points, count, width, antialias, vertices) < 0) {
+        SDL_free(vertices);
+        return -1;
+    }
+
+    GL_SetDrawingState(renderer);
+
+    /* The edges are blended even if the line isn't */
+    if (antialias && blendMode == SDL_BLENDMODE_NONE) {
+        blendMode = SDL_BLENDMODE_BLEND;
+        GL_SetBlendMode(data, blendMode);
+    }
+
+    strip = vertices;
+    GL_EmitLineStrip(data, strip, 2 * count, blendMode, r, g, b, a);
+    if (antialias) {
+        strip += 2 * count * 3;
+        GL_EmitLineStrip(data, strip, 2 * count, blendMode, r, g, b, a);
+        strip += 2 * count * 3;
+        GL_EmitLineStrip(data, strip, 2 * count, blendMode, r, g, b, a);
+        strip += 2 * count * 3;
+        GL_EmitLineStrip(data, strip, 6, blendMode, r, g, b, a);
+        strip += 6 * 3;
+        GL_EmitLineStrip(data, strip, 6, blendMode, r, g, b, a);
+    }
+    SDL_free(vertices);
+
+    /* The per vertex colors replaced the current drawing color */
+    data->glColor4f(r * inv255f, g * inv255f, b * inv255f, a * inv255f);
+
+    return GL_CheckError("", renderer);
+}
+
 static int
 GL_RenderFillRects(SDL_Renderer * renderer, const SDL_FRect * rects, int count)
 {
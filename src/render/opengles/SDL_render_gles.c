@@ -136,6 +136,7 @@ typedef struct
     GLenum formattype;
     void *pixels;
     int pitch;
+    SDL_Rect locked_rect;
     GLES_FBOList *fbo;
 } GLES_TextureData;
 
@@ -330,6 +331,7 @@ GLES_CreateRenderer(SDL_Window * window, Uint32 flags)
     renderer->GL_UnbindTexture = GLES_UnbindTexture;
     renderer->info = GLES_RenderDriver.info;
     renderer->info.flags = SDL_RENDERER_ACCELERATED;
+    renderer->persistent_locks = SDL_TRUE;
     renderer->driverdata = data;
     renderer->window = window;
 
@@ -590,6 +592,7 @@ GLES_LockTexture(SDL_Renderer * renderer, SDL_Texture * texture,
 {
     GLES_TextureData *data = (GLES_TextureData *) texture->driverdata;
 
+    data->locked_rect = *rect;
     *pixels =
         (void *) ((Uint8 *) data->pixels + rect->y * data->pitch +
                   rect->x * SDL_BYTESPERPIXEL(texture->format));
@@ -601,14 +604,14 @@ static void
 GLES_UnlockTexture(SDL_Renderer * renderer, SDL_Texture * texture)
 {
     GLES_TextureData *data = (GLES_TextureData *) texture->driverdata;
-    SDL_Rect rect;
-
-    /* We do whole texture updates, at least for now */
-    rect.x = 0;
-    rect.y = 0;
-    rect.w = texture->w;
-    rect.h = texture->h;
-    GLES_UpdateTexture(renderer, texture, &rect, data->pixels, data->pitch);
+    const SDL_Rect *rect;
+    void *pixels;
+
+    rect = &data->locked_rect;
+    pixels =
+        (void *) ((Uint8 *) data->pixels + rect->y * data->pitch +
+                  rect->x * SDL_BYTESPERPIXEL(texture->format));
+    GLES_UpdateTexture(renderer, texture, rect, pixels, data->pitch);
 }
 
 static int
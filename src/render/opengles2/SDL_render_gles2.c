@@ -73,6 +73,7 @@ typedef struct GLES2_TextureData
     GLenum pixel_type;
     void *pixel_data;
     size_t pitch;
+    SDL_Rect locked_rect;
     GLES2_FBOList *fbo;
 } GLES2_TextureData;
 
@@ -133,6 +134,7 @@ typedef enum
 typedef enum
 {
     GLES2_IMAGESOURCE_SOLID,
+    GLES2_IMAGESOURCE_SOLID_COVERAGE,
     GLES2_IMAGESOURCE_TEXTURE_ABGR,
     GLES2_IMAGESOURCE_TEXTURE_ARGB,
     GLES2_IMAGESOURCE_TEXTURE_RGB,
@@ -575,6 +577,7 @@ GLES2_LockTexture(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_Rect *
     GLES2_TextureData *tdata = (GLES2_TextureData *)texture->driverdata;
 
     /* Retrieve the buffer/pitch for the specified region */
+    tdata->locked_rect = *rect;
     *pixels = (Uint8 *)tdata->pixel_data +
               (tdata->pitch * rect->y) +
               (rect->x * SDL_BYTESPERPIXEL(texture->format));
@@ -587,14 +590,13 @@ static void
 GLES2_UnlockTexture(SDL_Renderer *renderer, SDL_Texture *texture)
 {
     GLES2_TextureData *tdata = (GLES2_TextureData *)texture->driverdata;
-    SDL_Rect rect;
-
-    /* We do whole texture updates, at least for now */
-    rect.x = 0;
-    rect.y = 0;
-    rect.w = texture->w;
-    rect.h = texture->h;
-    GLES2_UpdateTexture(renderer, texture, &rect, tdata->pixel_data, tdata->pitch);
+    const SDL_Rect *rect = &tdata->locked_rect;
+    void *pixels;
+
+    pixels = (Uint8 *)tdata->pixel_data +
+             (tdata->pitch * rect->y) +
+             (rect->x * SDL_BYTESPERPIXEL(texture->format));
+    GLES2_UpdateTexture(renderer, texture, rect, pixels, tdata->pitch);
 }
 
 static int
@@ -909,6 +911,9 @@ GLES2_SelectProgram(SDL_Renderer *renderer, GLES2_ImageSource source, SDL_BlendM
     case GLES2_IMAGESOURCE_SOLID:
         ftype = GLES2_SHADER_FRAGMENT_SOLID_SRC;
         break;
+    case GLES2_IMAGESOURCE_SOLID_COVERAGE:
+        ftype = GLES2_SHADER_FRAGMENT_SOLID_COVERAGE_SRC;
+        break;
     case GLES2_IMAGESOURCE_TEXTURE_ABGR:
         ftype = GLES2_SHADER_FRAGMENT_TEXTURE_ABGR_SRC;
         break;
@@ -1104,10 +1109,10 @@ GLES2_SetTexCoords(GLES2_DriverContext * data, SDL_bool enabled)
 }
 
 static int
-GLES2_SetDrawingState(SDL_Renderer * renderer)
+GLES2_SetSolidDrawingState(SDL_Renderer * renderer, GLES2_ImageSource source,
+                           SDL_BlendMode blendMode)
 {
     GLES2_DriverContext *data = (GLES2_DriverContext *)renderer->driverdata;
-    const int blendMode = renderer->blendMode;
     GLES2_ProgramCacheEntry *program;
     Uint8 r, g, b, a;
 
@@ -1115,10 +1120,11 @@ GLES2_SetDrawingState(SDL_Renderer * renderer)
 
     GLES2_SetBlendMode(data, blendMode);
 
-    GLES2_SetTexCoords(data, SDL_FALSE);
+    /* The coverage shader takes the coverage in the texture coordinates */
+    GLES2_SetTexCoords(data, source == GLES2_IMAGESOURCE_SOLID_COVERAGE);
 
     /* Activate an appropriate shader and set the projection matrix */
-    if (GLES2_SelectProgram(renderer, GLES2_IMAGESOURCE_SOLID, blendMode) < 0) {
+    if (GLES2_SelectProgram(renderer, source, blendMode) < 0) {
         return -1;
     }
 
@@ -1149,6 +1155,13 @@ GLES2_SetDrawingState(SDL_Renderer * renderer)
     return 0;
 }
 
+static int
+GLES2_SetDrawingState(SDL_Renderer * renderer)
+{
+    return GLES2_SetSolidDrawingState(renderer, GLES2_IMAGESOURCE_SOLID,
+                                      renderer->blendMode);
+}
+
 static int
 GLES2_RenderDrawPoints(SDL_Renderer *renderer, const SDL_FPoint *points, int count)
 {
@@ -1208,6 +1221,72 @@ GLES2_RenderDrawLines(SDL_Renderer *renderer, const SDL_FPoint *points, int coun
     return GL_CheckError("", renderer);
 }
 
+static int
+GLES2_RenderDrawLinesEx(SDL_Renderer *renderer, const SDL_FPoint *points,
+                        int count, float width, SDL_bool antialias)
+{
+    GLES2_DriverContext *data = (GLES2_DriverContext *)renderer->driverdata;
+    SDL_BlendMode blendMode = renderer->blendMode;
+    const int nvertices = SDL_LINE_STRIP_VERTICES(count, antialias);
+    GLfloat *vertices, *coverage;
+    int idx, first;
+
+    vertices = (GLfloat *)SDL_malloc(nvertices * 5 * sizeof(GLfloat));
+    if (!vertices) {
+        return SDL_OutOfMemory();
+    }
+    coverage = vertices + nvertices * 3;
+    if (SDL_GetLineStrips(points, count, width, antialias, vertices) < 0) {
+        SDL_free(vertices);
+        return -1;
+    }
+
+    if (antialias) {
+        /* The edges are blended even if the line isn't */
+        if (blendMode == SDL_BLENDMODE_NONE) {
+            blendMode = SDL_BLENDMODE_BLEND;
+        }
+        if (GLES2_SetSolidDrawingState(renderer, GLES2_IMAGESOURCE_SOLID_COVERAGE, blendMode) < 0) {
+            SDL_free(vertices);
+            return -1;
+        }
+    } else {
+        if (GLES2_SetDrawingState(renderer) < 0) {
+            SDL_free(vertices);
+            return -1;
+        }
+    }
+
+    /* Split the x, y, coverage vertices into positions and coverage */
+    for (idx = 0; idx < nvertices; ++idx) {
+        const GLfloat c = vertices[(idx * 3) + 2];
+
+        vertices[idx * 2] = vertices[idx * 3] + 0.5f;
+        vertices[(idx * 2) + 1] = vertices[(idx * 3) + 1] + 0.5f;
+        coverage[idx * 2] = c;
+        coverage[(idx * 2) + 1] = 0.0f;
+    }
+    data->glVertexAttribPointer(GLES2_ATTRIBUTE_POSITION, 2, GL_FLOAT, GL_FALSE, 0, vertices);
+    if (antialias) {
+        data->glVertexAttribPointer(GLES2_ATTRIBUTE_TEXCOORD, 2, GL_FLOAT, GL_FALSE, 0, coverage);
+    }
+
+    data->glDrawArrays(GL_TRIANGLE_STRIP, 0, 2 * count);
+    if (antialias) {
+        first = 2 * count;
+        data->glDrawArrays(GL_TRIANGLE_STRIP, first, 2 * count);
+        first += 2 * count;
+        data->glDrawArrays(GL_TRIANGLE_STRIP, first, 2 * count);
+        first += 2 * count;
+        data->glDrawArrays(GL_TRIANGLE_STRIP, first, 6);
+        first += 6;
+        data->glDrawArrays(GL_TRIANGLE_STRIP, first, 6);
+    }
+    SDL_free(vertices);
+
+    return GL_CheckError("", renderer);
+}
+
 static int
 GLES2_RenderFillRects(SDL_Renderer *renderer, const SDL_FRect *rects, int count)
 {
@@ -1752,6 +1831,7 @@ GLES2_CreateRenderer(SDL_Window *window, Uint32 flags)
     }
     renderer->info = GLES2_RenderDriver.info;
     renderer->info.flags = SDL_RENDERER_ACCELERATED | SDL_RENDERER_TARGETTEXTURE;
+    renderer->persistent_locks = SDL_TRUE;
     renderer->driverdata = data;
     renderer->window = window;
 
@@ -1836,6 +1916,7 @@ GLES2_CreateRenderer(SDL_Window *window, Uint32 flags)
     renderer->RenderClear         = &GLES2_RenderClear;
     renderer->RenderDrawPoints    = &GLES2_RenderDrawPoints;
     renderer->RenderDrawLines     = &GLES2_RenderDrawLines;
+    renderer->RenderDrawLinesEx   = &GLES2_RenderDrawLinesEx;
     renderer->RenderFillRects     = &GLES2_RenderFillRects;
     renderer->RenderCopy          = &GLES2_RenderCopy;
     renderer->RenderCopyEx        = &GLES2_RenderCopyEx;
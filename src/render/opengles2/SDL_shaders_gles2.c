@@ -62,6 +62,32 @@ static const Uint8 GLES2_FragmentSrc_SolidSrc_[] = " \
     } \
 ";
 
+/* Solid color faded by the line coverage in the texture coordinate */
+static const Uint8 GLES2_FragmentSrc_SolidCoverageSrc_[] = " \
+    precision mediump float; \
+    uniform vec4 u_color; \
+    varying vec2 v_texCoord; \
+    \
+    void main() \
+    { \
+        gl_FragColor = u_color; \
+        gl_FragColor.a *= v_texCoord.x; \
+    } \
+";
+
+/* Modulation color faded towards white by the line coverage */
+static const Uint8 GLES2_FragmentSrc_SolidCoverageModSrc_[] = " \
+    precision mediump float; \
+    uniform vec4 u_color; \
+    varying vec2 v_texCoord; \
+    \
+    void main() \
+    { \
+        gl_FragColor = u_color; \
+        gl_FragColor.rgb = mix(vec3(1.0), u_color.rgb, v_texCoord.x); \
+    } \
+";
+
 static const Uint8 GLES2_FragmentSrc_TextureABGRSrc_[] = " \
     precision mediump float; \
     uniform sampler2D u_texture; \
@@ -140,6 +166,20 @@ static const GLES2_ShaderInstance GLES2_FragmentSrc_SolidSrc = {
     GLES2_FragmentSrc_SolidSrc_
 };
 
+static const GLES2_ShaderInstance GLES2_FragmentSrc_SolidCoverageSrc = {
+    GL_FRAGMENT_SHADER,
+    GLES2_SOURCE_SHADER,
+    sizeof(GLES2_FragmentSrc_SolidCoverageSrc_),
+    GLES2_FragmentSrc_SolidCoverageSrc_
+};
+
+static const GLES2_ShaderInstance GLES2_FragmentSrc_SolidCoverageModSrc = {
+    GL_FRAGMENT_SHADER,
+    GLES2_SOURCE_SHADER,
+    sizeof(GLES2_FragmentSrc_SolidCoverageModSrc_),
+    GLES2_FragmentSrc_SolidCoverageModSrc_
+};
+
 static const GLES2_ShaderInstance GLES2_FragmentSrc_TextureABGRSrc = {
     GL_FRAGMENT_SHADER,
     GLES2_SOURCE_SHADER,
@@ -552,6 +592,20 @@ static GLES2_Shader GLES2_FragmentShader_Modulated_SolidSrc = {
     }
 };
 
+static GLES2_Shader GLES2_FragmentShader_Alpha_SolidCoverageSrc = {
+    1,
+    {
+        &GLES2_FragmentSrc_SolidCoverageSrc
+    }
+};
+
+static GLES2_Shader GLES2_FragmentShader_Modulated_SolidCoverageSrc = {
+    1,
+    {
+        &GLES2_FragmentSrc_SolidCoverageModSrc
+    }
+};
+
 static GLES2_Shader GLES2_FragmentShader_None_TextureABGRSrc = {
 #if GLES2_INCLUDE_NVIDIA_SHADERS
     2,
@@ -716,6 +770,18 @@ const GLES2_Shader *GLES2_GetShader(GLES2_ShaderType type, SDL_BlendMode blendMo
     default:
         return NULL;
     }
+    case GLES2_SHADER_FRAGMENT_SOLID_COVERAGE_SRC:
+        switch (blendMode)
+    {
+        case SDL_BLENDMODE_NONE:
+        case SDL_BLENDMODE_BLEND:
+        case SDL_BLENDMODE_ADD:
+            return &GLES2_FragmentShader_Alpha_SolidCoverageSrc;
+        case SDL_BLENDMODE_MOD:
+            return &GLES2_FragmentShader_Modulated_SolidCoverageSrc;
+        default:
+            return NULL;
+    }
     case GLES2_SHADER_FRAGMENT_TEXTURE_ABGR_SRC:
         switch (blendMode)
     {
@@ -43,6 +43,7 @@ typedef enum
 {
     GLES2_SHADER_VERTEX_DEFAULT,
     GLES2_SHADER_FRAGMENT_SOLID_SRC,
+    GLES2_SHADER_FRAGMENT_SOLID_COVERAGE_SRC,
     GLES2_SHADER_FRAGMENT_TEXTURE_ABGR_SRC,
     GLES2_SHADER_FRAGMENT_TEXTURE_ARGB_SRC,
     GLES2_SHADER_FRAGMENT_TEXTURE_BGR_SRC,
@@ -25,6 +25,7 @@
 #include "SDL_draw.h"
 #include "SDL_blendline.h"
 #include "SDL_blendpoint.h"
+#include "SDL_blendspan.h"
 
 
 static void
@@ -667,6 +668,53 @@ SDL_BlendLine_ARGB8888(SDL_Surface * dst, int x1, int y1, int x2, int y2,
     }
 }
 
+/* Horizontal and vertical lines are drawn as spans, if the format has them */
+static SDL_bool
+SDL_BlendStraightLine(SDL_Surface * dst, SDL_BlendSpanFunc span,
+                      int x1, int y1, int x2, int y2, SDL_BlendMode blendMode,
+                      Uint8 r, Uint8 g, Uint8 b, Uint8 a, SDL_bool draw_end)
+{
+    int x, y, w, h;
+
+    if (y1 == y2) {
+        x = SDL_min(x1, x2);
+        y = y1;
+        w = ABS(x2 - x1) + 1;
+        h = 1;
+        if (!draw_end) {
+            --w;
+            if (x2 < x1) {
+                ++x;
+            }
+        }
+    } else if (x1 == x2) {
+        x = x1;
+        y = SDL_min(y1, y2);
+        w = 1;
+        h = ABS(y2 - y1) + 1;
+        if (!draw_end) {
+            --h;
+            if (y2 < y1) {
+                ++y;
+            }
+        }
+    } else {
+        return SDL_FALSE;
+    }
+
+    if (blendMode == SDL_BLENDMODE_BLEND || blendMode == SDL_BLENDMODE_ADD) {
+        r = DRAW_MUL(r, a);
+        g = DRAW_MUL(g, a);
+        b = DRAW_MUL(b, a);
+    }
+    if (w > 0 && h > 0) {
+        span(dst->format, (Uint8 *)dst->pixels + y * dst->pitch +
+             x * dst->format->BytesPerPixel, dst->pitch,
+             w, h, blendMode, r, g, b, a);
+    }
+    return SDL_TRUE;
+}
+
 typedef void (*BlendLineFunc) (SDL_Surface * dst,
                                int x1, int y1, int x2, int y2,
                                SDL_BlendMode blendMode,
@@ -709,6 +757,7 @@ SDL_BlendLine(SDL_Surface * dst, int x1, int y1, int x2, int y2,
               SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
 {
     BlendLineFunc func;
+    SDL_BlendSpanFunc span;
 
     if (!dst) {
         return SDL_SetError("SDL_BlendLine(): Passed NULL destination surface");
@@ -718,6 +767,7 @@ SDL_BlendLine(SDL_Surface * dst, int x1, int y1, int x2, int y2,
     if (!func) {
         return SDL_SetError("SDL_BlendLine(): Unsupported surface format");
     }
+    span = SDL_GetBlendSpanFunc(dst->format);
 
     /* Perform clipping */
     /* FIXME: We don't actually want to clip, as it may change line slope */
@@ -725,6 +775,10 @@ SDL_BlendLine(SDL_Surface * dst, int x1, int y1, int x2, int y2,
         return 0;
     }
 
+    if (span &&
+        SDL_BlendStraightLine(dst, span, x1, y1, x2, y2, blendMode, r, g, b, a, SDL_TRUE)) {
+        return 0;
+    }
     func(dst, x1, y1, x2, y2, blendMode, r, g, b, a, SDL_TRUE);
     return 0;
 }
@@ -738,6 +792,7 @@ SDL_BlendLines(SDL_Surface * dst, const SDL_Point * points, int count,
     int x2, y2;
     SDL_bool draw_end;
     BlendLineFunc func;
+    SDL_BlendSpanFunc span;
 
     if (!dst) {
         return SDL_SetError("SDL_BlendLines(): Passed NULL destination surface");
@@ -747,6 +802,7 @@ SDL_BlendLines(SDL_Surface * dst, const SDL_Point * points, int count,
     if (!func) {
         return SDL_SetError("SDL_BlendLines(): Unsupported surface format");
     }
+    span = SDL_GetBlendSpanFunc(dst->format);
 
     for (i = 1; i < count; ++i) {
         x1 = points[i-1].x;
@@ -763,6 +819,10 @@ SDL_BlendLines(SDL_Surface * dst, const SDL_Point * points, int count,
         /* Draw the end if it was clipped */
         draw_end = (x2 != points[i].x || y2 != points[i].y);
 
+        if (span &&
+            SDL_BlendStraightLine(dst, span, x1, y1, x2, y2, blendMode, r, g, b, a, draw_end)) {
+            continue;
+        }
         func(dst, x1, y1, x2, y2, blendMode, r, g, b, a, draw_end);
     }
     if (points[0].x != points[count-1].x || points[0].y != points[count-1].y) {
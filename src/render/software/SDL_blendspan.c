@@ -0,0 +1,410 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2013 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "SDL_config.h"
+
+#if !SDL_RENDER_DISABLED
+
+#include "SDL_cpuinfo.h"
+#include "SDL_draw.h"
+#include "SDL_blendspan.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/* Span functions for blended rectangles and horizontal and vertical lines.
+
+   The blend mode is picked once per span rather than once per pixel, and
+   the common formats blend 4 (32-bit) or 8 (16-bit) pixels at a time with
+   SSE2.  The results match the DRAW_SETPIXEL_* macros exactly.
+
+   The SSE2 versions are only built when the compiler targets SSE2, so they
+   run without checking the CPU.
+ */
+
+/*
+ * 32-bit formats with 8-bit channels
+ */
+
+typedef struct
+{
+    Uint32 color;       /* r, g, b in place, with 0 in the other bits */
+    Uint32 solid;       /* the pixel written without blending */
+    Uint32 chan;        /* bits written when blending */
+    Uint32 keep;        /* bits kept from the destination */
+    unsigned inva;
+} SDL_BlendSpan32;
+
+/* x / 255 for the two 16-bit halves of x, each no more than 255 * 255 */
+#define DIV255x2(x) \
+    ((((x) + (((x) >> 8) & 0x00FF00FF) + 0x00010001) >> 8) & 0x00FF00FF)
+
+static SDL_INLINE Uint32
+SDL_BlendPixel32(Uint32 d, const SDL_BlendSpan32 * span)
+{
+    Uint32 rb = (d & 0x00FF00FF) * span->inva;
+    Uint32 ag = ((d >> 8) & 0x00FF00FF) * span->inva;
+    Uint32 s = DIV255x2(rb) | (DIV255x2(ag) << 8);
+
+    return ((s + span->color) & span->chan) | (d & span->keep);
+}
+
+static SDL_INLINE Uint32
+SDL_AddPixel32(Uint32 d, const SDL_BlendSpan32 * span)
+{
+    Uint32 rb = (d & 0x00FF00FF) + (span->color & 0x00FF00FF);
+    Uint32 ag = ((d >> 8) & 0x00FF00FF) + ((span->color >> 8) & 0x00FF00FF);
+
+    /* Saturate each channel that carried into its upper byte */
+    rb = (rb | (((rb >> 8) & 0x00010001) * 0xFF)) & 0x00FF00FF;
+    ag = (ag | (((ag >> 8) & 0x00010001) * 0xFF)) & 0x00FF00FF;
+
+    return ((rb | (ag << 8)) & span->chan) | (d & span->keep);
+}
+
+static SDL_INLINE Uint32
+SDL_ModPixel32(Uint32 d, const SDL_BlendSpan32 * span)
+{
+    Uint32 s = 0;
+    int shift;
+
+    for (shift = 0; shift < 32; shift += 8) {
+        s |= DRAW_MUL((d >> shift) & 0xFF, (span->color >> shift) & 0xFF) << shift;
+    }
+    return (s & span->chan) | (d & span->keep);
+}
+
+#define SPAN32(op) \
+    while (h--) { \
+        Uint32 *pixel = (Uint32 *)pixels; \
+        int n = w; \
+        while (n--) { \
+            *pixel = op(*pixel, span); \
+            ++pixel; \
+        } \
+        pixels += pitch; \
+    }
+
+static void
+SDL_BlendRows32(Uint8 * pixels, int pitch, int w, int h,
+                SDL_BlendMode blendMode, const SDL_BlendSpan32 * span)
+{
+    switch (blendMode) {
+    case SDL_BLENDMODE_BLEND:
+        SPAN32(SDL_BlendPixel32);
+        break;
+    case SDL_BLENDMODE_ADD:
+        SPAN32(SDL_AddPixel32);
+        break;
+    case SDL_BLENDMODE_MOD:
+        SPAN32(SDL_ModPixel32);
+        break;
+    default:
+        while (h--) {
+            Uint32 *pixel = (Uint32 *)pixels;
+            int n = w;
+            while (n--) {
+                *pixel++ = span->solid;
+            }
+            pixels += pitch;
+        }
+        break;
+    }
+}
+
+#ifdef __SSE2__
+
+/* x / 255 for 16-bit lanes no more than 255 * 255, the same as DRAW_MUL() */
+#define DIV255_SSE2(x) \
+    _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), one), 8)
+
+#define SPAN32_SSE2(vector_op, op) \
+    while (h--) { \
+        Uint32 *pixel = (Uint32 *)pixels; \
+        int n = w; \
+        for ( ; n >= 4; n -= 4, pixel += 4) { \
+            __m128i d = _mm_loadu_si128((const __m128i *)pixel); \
+            __m128i s, lo, hi; \
+            vector_op; \
+            s = _mm_or_si128(_mm_and_si128(s, chan), _mm_and_si128(d, keep)); \
+            _mm_storeu_si128((__m128i *)pixel, s); \
+        } \
+        while (n--) { \
+            *pixel = op(*pixel, span); \
+            ++pixel; \
+        } \
+        pixels += pitch; \
+    }
+
+#define BLEND32_SSE2 \
+    lo = _mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), vinva); \
+    hi = _mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), vinva); \
+    s = _mm_add_epi8(_mm_packus_epi16(DIV255_SSE2(lo), DIV255_SSE2(hi)), color)
+
+#define ADD32_SSE2 \
+    (void) lo; (void) hi; \
+    s = _mm_adds_epu8(d, color)
+
+#define MOD32_SSE2 \
+    lo = _mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), color16); \
+    hi = _mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), color16); \
+    s = _mm_packus_epi16(DIV255_SSE2(lo), DIV255_SSE2(hi))
+
+static void
+SDL_BlendRows32_SSE2(Uint8 * pixels, int pitch, int w, int h,
+                     SDL_BlendMode blendMode, const SDL_BlendSpan32 * span)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi16(1);
+    const __m128i color = _mm_set1_epi32(span->color);
+    const __m128i color16 = _mm_unpacklo_epi8(color, zero);
+    const __m128i vinva = _mm_set1_epi16((short)span->inva);
+    const __m128i chan = _mm_set1_epi32(span->chan);
+    const __m128i keep = _mm_set1_epi32(span->keep);
+
+    switch (blendMode) {
+    case SDL_BLENDMODE_BLEND:
+        SPAN32_SSE2(BLEND32_SSE2, SDL_BlendPixel32);
+        break;
+    case SDL_BLENDMODE_ADD:
+        SPAN32_SSE2(ADD32_SSE2, SDL_AddPixel32);
+        break;
+    case SDL_BLENDMODE_MOD:
+        SPAN32_SSE2(MOD32_SSE2, SDL_ModPixel32);
+        break;
+    default:
+        {
+            const __m128i solid = _mm_set1_epi32(span->solid);
+            while (h--) {
+                Uint32 *pixel = (Uint32 *)pixels;
+                int n = w;
+                for ( ; n >= 4; n -= 4, pixel += 4) {
+                    _mm_storeu_si128((__m128i *)pixel, solid);
+                }
+                while (n--) {
+                    *pixel++ = span->solid;
+                }
+                pixels += pitch;
+            }
+        }
+        break;
+    }
+}
+
+#endif /* __SSE2__ */
+
+static void
+SDL_BlendSpan_8888(const SDL_PixelFormat * fmt,
+                   Uint8 * pixels, int pitch, int w, int h,
+                   SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+    SDL_BlendSpan32 span;
+
+    span.color = ((Uint32)r << fmt->Rshift) |
+                 ((Uint32)g << fmt->Gshift) |
+                 ((Uint32)b << fmt->Bshift);
+    span.solid = span.color;
+    if (fmt->Amask) {
+        span.solid |= ((Uint32)a << fmt->Ashift);
+    }
+    span.chan = fmt->Rmask | fmt->Gmask | fmt->Bmask;
+    span.keep = fmt->Amask;
+    span.inva = 0xff - a;
+
+#ifdef __SSE2__
+    if (w >= 4) {
+        SDL_BlendRows32_SSE2(pixels, pitch, w, h, blendMode, &span);
+        return;
+    }
+#endif
+    SDL_BlendRows32(pixels, pitch, w, h, blendMode, &span);
+}
+
+/*
+ * RGB565 and RGB555
+ */
+
+#define SPAN16(op) \
+    while (h--) { \
+        Uint16 *pixel = (Uint16 *)pixels; \
+        int n = w; \
+        while (n--) { \
+            op; \
+            ++pixel; \
+        } \
+        pixels += pitch; \
+    }
+
+#ifdef __SSE2__
+
+/* Expand 5 and 6 bit channels to 8 bits the way SDL_expand_byte does,
+   x * 255 / 31 and x * 255 / 63 rounded down.
+ */
+#define EXPAND5_SSE2(x) \
+    _mm_srli_epi16(_mm_mulhi_epu16(_mm_sub_epi16(_mm_slli_epi16(x, 8), x), expand5), 2)
+#define EXPAND6_SSE2(x) \
+    _mm_srli_epi16(_mm_mulhi_epu16(_mm_sub_epi16(_mm_slli_epi16(x, 8), x), expand6), 3)
+
+#define BLEND16_SSE2(c, col) \
+    c = _mm_add_epi16(DIV255_SSE2(_mm_mullo_epi16(c, vinva)), col)
+
+#define ADD16_SSE2(c, col) \
+    c = _mm_min_epi16(_mm_add_epi16(c, col), max)
+
+#define MOD16_SSE2(c, col) \
+    c = DIV255_SSE2(_mm_mullo_epi16(c, col))
+
+#define SPAN16_SSE2(vector_op, op, rshift, gbits, EXPAND_G) \
+    while (h--) { \
+        Uint16 *pixel = (Uint16 *)pixels; \
+        int n = w; \
+        for ( ; n >= 8; n -= 8, pixel += 8) { \
+            __m128i d = _mm_loadu_si128((const __m128i *)pixel); \
+            __m128i sr = EXPAND5_SSE2(_mm_and_si128(_mm_srli_epi16(d, rshift), mask5)); \
+            __m128i sg = EXPAND_G(_mm_and_si128(_mm_srli_epi16(d, 5), gmask)); \
+            __m128i sb = EXPAND5_SSE2(_mm_and_si128(d, mask5)); \
+            vector_op(sr, vr); \
+            vector_op(sg, vg); \
+            vector_op(sb, vb); \
+            d = _mm_or_si128(_mm_or_si128( \
+                    _mm_slli_epi16(_mm_srli_epi16(sr, 3), rshift), \
+                    _mm_slli_epi16(_mm_srli_epi16(sg, 8 - gbits), 5)), \
+                    _mm_srli_epi16(sb, 3)); \
+            _mm_storeu_si128((__m128i *)pixel, d); \
+        } \
+        while (n--) { \
+            op; \
+            ++pixel; \
+        } \
+        pixels += pitch; \
+    }
+
+#define DEFINE_BLENDSPAN16_SSE2(name, rshift, gbits, EXPAND_G) \
+static void \
+SDL_BlendSpan_##name##_SSE2(Uint8 * pixels, int pitch, int w, int h, \
+                            SDL_BlendMode blendMode, \
+                            unsigned r, unsigned g, unsigned b, unsigned a) \
+{ \
+    const __m128i one = _mm_set1_epi16(1); \
+    const __m128i max = _mm_set1_epi16(0xff); \
+    const __m128i mask5 = _mm_set1_epi16(0x1f); \
+    const __m128i gmask = _mm_set1_epi16((1 << gbits) - 1); \
+    const __m128i expand5 = _mm_set1_epi16(8457); \
+    const __m128i expand6 = _mm_set1_epi16(8323); \
+    const __m128i vinva = _mm_set1_epi16((short)(0xff - a)); \
+    const __m128i vr = _mm_set1_epi16((short)r); \
+    const __m128i vg = _mm_set1_epi16((short)g); \
+    const __m128i vb = _mm_set1_epi16((short)b); \
+    unsigned inva = 0xff - a; \
+ \
+    (void) expand6; \
+    switch (blendMode) { \
+    case SDL_BLENDMODE_BLEND: \
+        SPAN16_SSE2(BLEND16_SSE2, DRAW_SETPIXEL_BLEND_##name, rshift, gbits, EXPAND_G); \
+        break; \
+    case SDL_BLENDMODE_ADD: \
+        SPAN16_SSE2(ADD16_SSE2, DRAW_SETPIXEL_ADD_##name, rshift, gbits, EXPAND_G); \
+        break; \
+    case SDL_BLENDMODE_MOD: \
+        SPAN16_SSE2(MOD16_SSE2, DRAW_SETPIXEL_MOD_##name, rshift, gbits, EXPAND_G); \
+        break; \
+    default: \
+        SPAN16(DRAW_SETPIXEL_##name); \
+        break; \
+    } \
+}
+
+DEFINE_BLENDSPAN16_SSE2(RGB565, 11, 6, EXPAND6_SSE2)
+DEFINE_BLENDSPAN16_SSE2(RGB555, 10, 5, EXPAND5_SSE2)
+
+#endif /* __SSE2__ */
+
+#ifdef __SSE2__
+#define BLENDSPAN16_SSE2(name) \
+    if (w >= 8) { \
+        SDL_BlendSpan_##name##_SSE2(pixels, pitch, w, h, blendMode, r, g, b, a); \
+        return; \
+    }
+#else
+#define BLENDSPAN16_SSE2(name)
+#endif
+
+#define DEFINE_BLENDSPAN16(name) \
+static void \
+SDL_BlendSpan_##name(const SDL_PixelFormat * fmt, \
+                     Uint8 * pixels, int pitch, int w, int h, \
+                     SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a) \
+{ \
+    unsigned inva = 0xff - a; \
+ \
+    BLENDSPAN16_SSE2(name); \
+ \
+    switch (blendMode) { \
+    case SDL_BLENDMODE_BLEND: \
+        SPAN16(DRAW_SETPIXEL_BLEND_##name); \
+        break; \
+    case SDL_BLENDMODE_ADD: \
+        SPAN16(DRAW_SETPIXEL_ADD_##name); \
+        break; \
+    case SDL_BLENDMODE_MOD: \
+        SPAN16(DRAW_SETPIXEL_MOD_##name); \
+        break; \
+    default: \
+        SPAN16(DRAW_SETPIXEL_##name); \
+        break; \
+    } \
+}
+
+DEFINE_BLENDSPAN16(RGB565)
+DEFINE_BLENDSPAN16(RGB555)
+
+
+SDL_BlendSpanFunc
+SDL_GetBlendSpanFunc(const SDL_PixelFormat * fmt)
+{
+    switch (fmt->BytesPerPixel) {
+    case 2:
+        if (fmt->Amask) {
+            break;
+        }
+        if (fmt->Rmask == 0xF800 && fmt->Gmask == 0x07E0 && fmt->Bmask == 0x001F) {
+            return SDL_BlendSpan_RGB565;
+        }
+        if (fmt->Rmask == 0x7C00 && fmt->Gmask == 0x03E0 && fmt->Bmask == 0x001F) {
+            return SDL_BlendSpan_RGB555;
+        }
+        break;
+    case 4:
+        /* Any order of 8-bit channels, with or without alpha */
+        if (fmt->Rmask == (0xFFu << fmt->Rshift) &&
+            fmt->Gmask == (0xFFu << fmt->Gshift) &&
+            fmt->Bmask == (0xFFu << fmt->Bshift) &&
+            (!fmt->Amask || fmt->Amask == (0xFFu << fmt->Ashift))) {
+            return SDL_BlendSpan_8888;
+        }
+        break;
+    }
+    return NULL;
+}
+
+#endif /* !SDL_RENDER_DISABLED */
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -0,0 +1,370 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2013 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "SDL_config.h"
+
+#if !SDL_RENDER_DISABLED
+
+#include "SDL_draw.h"
+#include "SDL_blendfillrect.h"
+#include "SDL_blendspan.h"
+#include "SDL_blendwideline.h"
+
+/* The line is the union of a capsule around each segment: every pixel whose
+   center is within half the width of a segment is inside the line. The
+   coverage of an anti-aliased pixel is approximated from that distance, so
+   a pixel right on the edge is half covered.
+
+   The line is drawn one row at a time. Each segment contributes a coverage
+   value to the pixels it reaches in the row, overlapping segments keep the
+   largest value so joints aren't blended twice, and the row is then blended
+   as runs of pixels with the same coverage.
+ */
+
+typedef struct
+{
+    float x1, y1;
+    float dx, dy;
+    float inv_len2;
+    int ymin, ymax;
+} SDL_WideSegment;
+
+/* Sampling just below and right of the pixel center breaks the tie for
+   pixels that are exactly on the edge of a line with hard edges, so an
+   even width covers exactly that many rows or columns. */
+#define WIDE_LINE_BIAS  (1.0f / 256.0f)
+
+/* These only need to handle values within the clip rectangle */
+#define WIDE_FLOOR(x)   ((int)(x) - ((float)(int)(x) > (x)))
+#define WIDE_CEIL(x)    ((int)(x) + ((float)(int)(x) < (x)))
+
+static int
+SDL_CompareWideSegments(const void *a, const void *b)
+{
+    const SDL_WideSegment *A = (const SDL_WideSegment *)a;
+    const SDL_WideSegment *B = (const SDL_WideSegment *)b;
+
+    if (A->ymin < B->ymin) {
+        return -1;
+    } else if (A->ymin > B->ymin) {
+        return 1;
+    }
+    return 0;
+}
+
+/* Add the coverage of one segment to the pixels xmin to xmax of row y */
+static void
+SDL_CoverWideSegment(const SDL_WideSegment * seg, Uint8 * coverage,
+                     int xmin, int xmax, float y, float radius, float reach,
+                     float scale, SDL_bool antialias)
+{
+    const float radius2 = radius * radius;
+    const float reach2 = reach * reach;
+    const float py = y - seg->y1;
+    const float t0 = py * seg->dy;
+    int x;
+
+    for (x = xmin; x <= xmax; ++x) {
+        float px = (float)x - seg->x1;
+        float t = (px * seg->dx + t0) * seg->inv_len2;
+        float ex, ey, d2;
+        int value;
+
+        if (t < 0.0f) {
+            t = 0.0f;
+        } else if (t > 1.0f) {
+            t = 1.0f;
+        }
+        ex = px - t * seg->dx;
+        ey = py - t * seg->dy;
+        d2 = ex * ex + ey * ey;
+
+        if (!antialias) {
+            if (d2 <= radius2) {
+                coverage[x] = 0xff;
+            }
+        } else if (d2 < reach2) {
+            float c = (reach - (float)SDL_sqrt(d2)) * scale;
+            if (c > 1.0f) {
+                c = 1.0f;
+            }
+            value = (int)(c * 255.0f + 0.5f);
+            if (value > coverage[x]) {
+                coverage[x] = (Uint8)value;
+            }
+        }
+    }
+}
+
+/* Blend a run of pixels with the same coverage */
+static void
+SDL_BlendCoverageRun(SDL_Surface * dst, SDL_BlendSpanFunc span,
+                     int x, int y, int w, Uint8 coverage,
+                     SDL_BlendMode blendMode,
+                     Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+    if (coverage != 0xff) {
+        switch (blendMode) {
+        case SDL_BLENDMODE_NONE:
+            blendMode = SDL_BLENDMODE_BLEND;
+            a = coverage;
+            break;
+        case SDL_BLENDMODE_BLEND:
+        case SDL_BLENDMODE_ADD:
+            a = DRAW_MUL(a, coverage);
+            break;
+        case SDL_BLENDMODE_MOD:
+            /* Fade the modulation color towards white */
+            r = (0xff - coverage) + DRAW_MUL(r, coverage);
+            g = (0xff - coverage) + DRAW_MUL(g, coverage);
+            b = (0xff - coverage) + DRAW_MUL(b, coverage);
+            break;
+        }
+    }
+
+    if (span) {
+        if (blendMode == SDL_BLENDMODE_BLEND || blendMode == SDL_BLENDMODE_ADD) {
+            r = DRAW_MUL(r, a);
+            g = DRAW_MUL(g, a);
+            b = DRAW_MUL(b, a);
+        }
+        span(dst->format, (Uint8 *)dst->pixels + y * dst->pitch +
+             x * dst->format->BytesPerPixel, dst->pitch,
+             w, 1, blendMode, r, g, b, a);
+    } else {
+        SDL_Rect rect;
+
+        rect.x = x;
+        rect.y = y;
+        rect.w = w;
+        rect.h = 1;
+        SDL_BlendFillRect(dst, &rect, blendMode, r, g, b, a);
+    }
+}
+
+int
+SDL_BlendWideLines(SDL_Surface * dst, const SDL_FPoint * points, int count,
+                   float width, SDL_bool antialias, SDL_BlendMode blendMode,
+                   Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+    const SDL_Rect *clip;
+    SDL_BlendSpanFunc span;
+    SDL_WideSegment *segments;
+    int *active;
+    Uint8 *coverage;
+    float radius, reach, scale, bias;
+    int i, nsegments, nactive, next, y, ymin, ymax;
+
+    if (!dst) {
+        return SDL_SetError("Passed NULL destination surface");
+    }
+
+    /* This function doesn't work on surfaces < 8 bpp */
+    if (dst->format->BitsPerPixel < 8) {
+        return SDL_SetError("SDL_BlendWideLines(): Unsupported surface format");
+    }
+
+    if (count < 1 || !(width > 0.0f)) {
+        return 0;
+    }
+
+    radius = width * 0.5f;
+    if (antialias) {
+        /* Coverage ramps from full to none over the pixel on the edge, and
+           lines thinner than a pixel are drawn as 1 pixel lines faded out */
+        if (width < 1.0f) {
+            reach = 1.0f;
+            scale = width;
+        } else {
+            reach = radius + 0.5f;
+            scale = 1.0f;
+        }
+        bias = 0.0f;
+    } else {
+        if (radius < 0.5f) {
+            radius = 0.5f;
+        }
+        reach = radius;
+        scale = 1.0f;
+        bias = WIDE_LINE_BIAS;
+    }
+
+    clip = &dst->clip_rect;
+    if (clip->w <= 0 || clip->h <= 0) {
+        return 0;
+    }
+
+    segments = (SDL_WideSegment *)SDL_malloc(count * sizeof(*segments));
+    active = (int *)SDL_malloc(count * sizeof(*active));
+    coverage = (Uint8 *)SDL_calloc(1, dst->w);
+    if (!segments || !active || !coverage) {
+        SDL_free(segments);
+        SDL_free(active);
+        SDL_free(coverage);
+        return SDL_OutOfMemory();
+    }
+
+    /* A single point is drawn as a segment with no length */
+    nsegments = 0;
+    for (i = 0; i < SDL_max(count-1, 1); ++i) {
+        const SDL_FPoint *p1 = &points[i];
+        const SDL_FPoint *p2 = (count > 1) ? &points[i+1] : p1;
+        SDL_WideSegment *seg = &segments[nsegments];
+        float len2, top, bottom;
+
+        seg->x1 = p1->x - bias;
+        seg->y1 = p1->y - bias;
+        seg->dx = p2->x - p1->x;
+        seg->dy = p2->y - p1->y;
+        len2 = seg->dx * seg->dx + seg->dy * seg->dy;
+        seg->inv_len2 = (len2 > 0.0f) ? (1.0f / len2) : 0.0f;
+
+        top = SDL_min(p1->y, p2->y) - bias - reach;
+        bottom = SDL_max(p1->y, p2->y) - bias + reach;
+        if (bottom < (float)clip->y || top > (float)(clip->y + clip->h - 1)) {
+            continue;
+        }
+        top = SDL_max(top, (float)clip->y);
+        bottom = SDL_min(bottom, (float)(clip->y + clip->h - 1));
+        seg->ymin = WIDE_CEIL(top);
+        seg->ymax = WIDE_FLOOR(bottom);
+        if (seg->ymin > seg->ymax) {
+            continue;
+        }
+        ++nsegments;
+    }
+    if (nsegments == 0) {
+        SDL_free(segments);
+        SDL_free(active);
+        SDL_free(coverage);
+        return 0;
+    }
+
+    SDL_qsort(segments, nsegments, sizeof(*segments), SDL_CompareWideSegments);
+
+    ymin = segments[0].ymin;
+    ymax = segments[0].ymax;
+    for (i = 1; i < nsegments; ++i) {
+        ymax = SDL_max(ymax, segments[i].ymax);
+    }
+
+    span = SDL_GetBlendSpanFunc(dst->format);
+    nactive = 0;
+    next = 0;
+    for (y = ymin; y <= ymax; ++y) {
+        const float fy = (float)y;
+        int xmin = clip->x + clip->w;
+        int xmax = clip->x - 1;
+        int x;
+
+        /* Update the list of segments touching this row */
+        for (i = 0; i < nactive; ) {
+            if (segments[active[i]].ymax < y) {
+                active[i] = active[--nactive];
+            } else {
+                ++i;
+            }
+        }
+        while (next < nsegments && segments[next].ymin <= y) {
+            active[nactive++] = next++;
+        }
+        if (nactive == 0) {
+            if (next < nsegments) {
+                y = segments[next].ymin - 1;
+            }
+            continue;
+        }
+
+        for (i = 0; i < nactive; ++i) {
+            const SDL_WideSegment *seg = &segments[active[i]];
+            float t1, t2, x1, x2;
+            int xs, xe;
+
+            /* Find the part of the segment within reach of this row */
+            if (seg->dy != 0.0f) {
+                t1 = (fy - reach - seg->y1) / seg->dy;
+                t2 = (fy + reach - seg->y1) / seg->dy;
+                if (t1 > t2) {
+                    float t = t1;
+                    t1 = t2;
+                    t2 = t;
+                }
+                t1 = SDL_max(t1, 0.0f);
+                t2 = SDL_min(t2, 1.0f);
+                if (t1 > t2) {
+                    continue;
+                }
+            } else {
+                t1 = 0.0f;
+                t2 = 1.0f;
+            }
+            x1 = seg->x1 + t1 * seg->dx;
+            x2 = seg->x1 + t2 * seg->dx;
+            if (x1 > x2) {
+                float t = x1;
+                x1 = x2;
+                x2 = t;
+            }
+            x1 -= reach;
+            x2 += reach;
+            if (x2 < (float)clip->x || x1 > (float)(clip->x + clip->w - 1)) {
+                continue;
+            }
+            x1 = SDL_max(x1, (float)clip->x);
+            x2 = SDL_min(x2, (float)(clip->x + clip->w - 1));
+            xs = WIDE_CEIL(x1);
+            xe = WIDE_FLOOR(x2);
+            if (xs > xe) {
+                continue;
+            }
+
+            SDL_CoverWideSegment(seg, coverage, xs, xe, fy,
+                                 radius, reach, scale, antialias);
+            xmin = SDL_min(xmin, xs);
+            xmax = SDL_max(xmax, xe);
+        }
+
+        /* Blend the row as runs of the same coverage */
+        x = xmin;
+        while (x <= xmax) {
+            const Uint8 value = coverage[x];
+            int end = x + 1;
+
+            while (end <= xmax && coverage[end] == value) {
+                coverage[end++] = 0;
+            }
+            if (value) {
+                SDL_BlendCoverageRun(dst, span, x, y, end - x, value,
+                                     blendMode, r, g, b, a);
+                coverage[x] = 0;
+            }
+            x = end;
+        }
+    }
+
+    SDL_free(segments);
+    SDL_free(active);
+    SDL_free(coverage);
+    return 0;
+}
+
+#endif /* !SDL_RENDER_DISABLED */
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -30,9 +30,11 @@
 #include "SDL_blendfillrect.h"
 #include "SDL_blendline.h"
 #include "SDL_blendpoint.h"
+#include "SDL_blendwideline.h"
 #include "SDL_drawline.h"
 #include "SDL_drawpoint.h"
 #include "SDL_rotate.h"
+#include "../../video/SDL_surface_c.h"
 
 /* SDL surface based renderer implementation */
 
@@ -61,6 +63,9 @@ static int SW_RenderDrawPoints(SDL_Renderer * renderer,
                                const SDL_FPoint * points, int count);
 static int SW_RenderDrawLines(SDL_Renderer * renderer,
                               const SDL_FPoint * points, int count);
+static int SW_RenderDrawLinesEx(SDL_Renderer * renderer,
+                                const SDL_FPoint * points, int count,
+                                float width, SDL_bool antialias);
 static int SW_RenderFillRects(SDL_Renderer * renderer,
                               const SDL_FRect * rects, int count);
 static int SW_RenderCopy(SDL_Renderer * renderer, SDL_Texture * texture,
@@ -162,6 +167,7 @@ SW_CreateRendererForSurface(SDL_Surface * surface)
     renderer->RenderClear = SW_RenderClear;
     renderer->RenderDrawPoints = SW_RenderDrawPoints;
     renderer->RenderDrawLines = SW_RenderDrawLines;
+    renderer->RenderDrawLinesEx = SW_RenderDrawLinesEx;
     renderer->RenderFillRects = SW_RenderFillRects;
     renderer->RenderCopy = SW_RenderCopy;
     renderer->RenderCopyEx = SW_RenderCopyEx;
@@ -170,6 +176,7 @@ SW_CreateRendererForSurface(SDL_Surface * surface)
     renderer->DestroyTexture = SW_DestroyTexture;
     renderer->DestroyRenderer = SW_DestroyRenderer;
     renderer->info = SW_RenderDriver.info;
+    renderer->persistent_locks = SDL_TRUE;
     renderer->driverdata = data;
 
     SW_ActivateRenderer(renderer);
@@ -479,6 +486,36 @@ SW_RenderDrawLines(SDL_Renderer * renderer, const SDL_FPoint * points,
     return status;
 }
 
+static int
+SW_RenderDrawLinesEx(SDL_Renderer * renderer, const SDL_FPoint * points,
+                     int count, float width, SDL_bool antialias)
+{
+    SDL_Surface *surface = SW_ActivateRenderer(renderer);
+    SDL_FPoint *final_points;
+    int i, status;
+
+    if (!surface) {
+        return -1;
+    }
+
+    final_points = SDL_stack_alloc(SDL_FPoint, count);
+    if (!final_points) {
+        return SDL_OutOfMemory();
+    }
+    for (i = 0; i < count; ++i) {
+        final_points[i].x = renderer->viewport.x + points[i].x;
+        final_points[i].y = renderer->viewport.y + points[i].y;
+    }
+
+    status = SDL_BlendWideLines(surface, final_points, count, width,
+                                antialias, renderer->blendMode,
+                                renderer->r, renderer->g, renderer->b,
+                                renderer->a);
+    SDL_stack_free(final_points);
+
+    return status;
+}
+
 static int
 SW_RenderFillRects(SDL_Renderer * renderer, const SDL_FRect * rects, int count)
 {
@@ -561,13 +598,27 @@ SW_RenderCopy(SDL_Renderer * renderer, SDL_Texture * texture,
 static int
 GetScaleQuality(void)
 {
-    const char *hint = SDL_GetHint(SDL_HINT_RENDER_SCALE_QUALITY);
+    static SDL_HintHandle *handle = NULL;
+    static Uint32 generation = 0;
+    static int quality = 0;
 
-    if (!hint || *hint == '0' || SDL_strcasecmp(hint, "nearest") == 0) {
-        return 0;
-    } else {
-        return 1;
+    /* This is called for every rotated copy, so only parse the hint again
+       if it might have changed */
+    if (generation != SDL_GetHintGeneration()) {
+        const char *hint;
+
+        if (!handle) {
+            handle = SDL_RegisterHint(SDL_HINT_RENDER_SCALE_QUALITY);
+        }
+        hint = SDL_GetHintValue(handle);
+        if (!hint || *hint == '0' || SDL_strcasecmp(hint, "nearest") == 0) {
+            quality = 0;
+        } else {
+            quality = 1;
+        }
+        generation = SDL_GetHintGeneration();
     }
+    return quality;
 }
 
 static int
@@ -597,9 +648,11 @@ SW_RenderCopyEx(SDL_Renderer * renderer, SDL_Texture * texture,
     final_rect.w = (int)dstrect->w;
     final_rect.h = (int)dstrect->h;
 
-    surface_scaled = SDL_CreateRGBSurface(SDL_SWSURFACE, final_rect.w, final_rect.h, src->format->BitsPerPixel,
-                                          src->format->Rmask, src->format->Gmask,
-                                          src->format->Bmask, src->format->Amask );
+    /* The scaled copy is blended onto a clear surface, so it can't skip
+       clearing, but it comes from the surface pool */
+    surface_scaled = SDL_CreateSurfaceInternal(SDL_SURFACE_ALIGNED, final_rect.w, final_rect.h, src->format->BitsPerPixel,
+                                               src->format->Rmask, src->format->Gmask,
+                                               src->format->Bmask, src->format->Amask );
     if (surface_scaled) {
         SDL_GetColorKey(src, &colorkey);
         SDL_SetColorKey(surface_scaled, SDL_TRUE, colorkey);
@@ -648,11 +701,12 @@ SW_RenderCopyEx(SDL_Renderer * renderer, SDL_Texture * texture,
                 tmp_rect.h = dstheight;
 
                 retval = SDL_BlitSurface(surface_rotated, NULL, surface, &tmp_rect);
-                SDL_FreeSurface(surface_scaled);
                 SDL_FreeSurface(surface_rotated);
-                return retval;
+            } else {
+                retval = -1;
             }
         }
+        SDL_FreeSurface(surface_scaled);
         return retval;
     }
 
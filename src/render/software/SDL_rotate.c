@@ -39,6 +39,7 @@ Andreas Schiffler -- aschiffler at ferzkopp dot net
 
 #include "SDL.h"
 #include "SDL_rotate.h"
+#include "../../video/SDL_surface_c.h"
 
 /* ---- Internally used structures */
 
@@ -381,7 +382,7 @@ SDLgfx_rotateSurface(SDL_Surface * src, double angle, int centerx, int centery,
         * New source surface is 32bit with a defined RGBA ordering
         */
         rz_src =
-            SDL_CreateRGBSurface(SDL_SWSURFACE, src->w, src->h, 32,
+            SDL_CreateSurfaceInternal(SDL_SURFACE_ALIGNED, src->w, src->h, 32,
 #if SDL_BYTEORDER == SDL_LIL_ENDIAN
             0x000000ff, 0x0000ff00, 0x00ff0000, 0xff000000
 #else
@@ -415,17 +416,20 @@ SDLgfx_rotateSurface(SDL_Surface * src, double angle, int centerx, int centery,
     rz_dst = NULL;
     if (is32bit) {
         /*
-        * Target surface is 32bit with source RGBA/ABGR ordering
+        * Target surface is 32bit with source RGBA/ABGR ordering,
+        * it's only filled with the colorkey below if there is one
         */
         rz_dst =
-            SDL_CreateRGBSurface(SDL_SWSURFACE, dstwidth, dstheight + GUARD_ROWS, 32,
+            SDL_CreateSurfaceInternal(SDL_SURFACE_ALIGNED | (colorKeyAvailable ? SDL_SURFACE_NOCLEAR : 0),
+            dstwidth, dstheight + GUARD_ROWS, 32,
             rz_src->format->Rmask, rz_src->format->Gmask,
             rz_src->format->Bmask, rz_src->format->Amask);
     } else {
         /*
-        * Target surface is 8bit
+        * Target surface is 8bit, cleared to the colorkey when it's rotated
         */
-        rz_dst = SDL_CreateRGBSurface(SDL_SWSURFACE, dstwidth, dstheight + GUARD_ROWS, 8, 0, 0, 0, 0);
+        rz_dst = SDL_CreateSurfaceInternal(SDL_SURFACE_ALIGNED | SDL_SURFACE_NOCLEAR,
+            dstwidth, dstheight + GUARD_ROWS, 8, 0, 0, 0, 0);
     }
 
     /* Check target */
@@ -24,6 +24,7 @@
 
 #include "SDL_stdinc.h"
 #include "SDL_endian.h"
+#include "SDL_cpuinfo.h"
 
 #ifdef HAVE_ICONV
 
@@ -236,6 +237,439 @@ SDL_iconv_open(const char *tocode, const char *fromcode)
     return (SDL_iconv_t) - 1;
 }
 
+/* The fast paths below convert well formed text directly between the
+   formats they know, and leave anything unusual to the generic code, so
+   the results are always the same as converting through UCS-4.
+ */
+static SDL_bool
+SDL_iconv_fast_format(int format)
+{
+    switch (format) {
+    case ENCODING_ASCII:
+    case ENCODING_LATIN1:
+    case ENCODING_UTF8:
+    case ENCODING_UTF16BE:
+    case ENCODING_UTF16LE:
+    case ENCODING_UTF32BE:
+    case ENCODING_UTF32LE:
+    case ENCODING_UCS4BE:
+    case ENCODING_UCS4LE:
+        return SDL_TRUE;
+    default:
+        return SDL_FALSE;
+    }
+}
+
+static size_t
+SDL_iconv_unit_size(int format)
+{
+    switch (format) {
+    case ENCODING_UTF16BE:
+    case ENCODING_UTF16LE:
+        return 2;
+    case ENCODING_UTF32BE:
+    case ENCODING_UTF32LE:
+    case ENCODING_UCS4BE:
+    case ENCODING_UCS4LE:
+        return 4;
+    default:
+        return 1;
+    }
+}
+
+static SDL_bool
+SDL_iconv_big_endian(int format)
+{
+    return (format == ENCODING_UTF16BE ||
+            format == ENCODING_UTF32BE ||
+            format == ENCODING_UCS4BE) ? SDL_TRUE : SDL_FALSE;
+}
+
+/* The length of a UTF-8 sequence from its first byte, 0 if it's invalid */
+static const Uint8 utf8_lengths[256] = {
+/* *INDENT-OFF* */
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+    3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+    4, 4, 4, 4, 4, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+/* *INDENT-ON* */
+};
+
+/* Decode a well formed character, returning the number of bytes used, or 0
+   if the generic decoder should handle it.
+ */
+static size_t
+SDL_iconv_decode_fast(int format, const Uint8 *p, size_t len, Uint32 *ch)
+{
+    Uint32 W1, W2;
+
+    switch (format) {
+    case ENCODING_ASCII:
+        *ch = (Uint32) (p[0] & 0x7F);
+        return 1;
+    case ENCODING_LATIN1:
+        *ch = (Uint32) p[0];
+        return 1;
+    case ENCODING_UTF8:
+        switch (utf8_lengths[p[0]]) {
+        case 1:
+            *ch = (Uint32) p[0];
+            return 1;
+        case 2:
+            if (len < 2 || (p[1] & 0xC0) != 0x80) {
+                return 0;
+            }
+            *ch = ((Uint32) (p[0] & 0x1F) << 6) | (Uint32) (p[1] & 0x3F);
+            return 2;
+        case 3:
+            if (len < 3 || (p[1] & 0xC0) != 0x80 || (p[2] & 0xC0) != 0x80) {
+                return 0;
+            }
+            W1 = ((Uint32) (p[0] & 0x0F) << 12) |
+                 ((Uint32) (p[1] & 0x3F) << 6) | (Uint32) (p[2] & 0x3F);
+            /* Overlong forms, surrogates and non-characters are replaced */
+            if (W1 < 0x800 || (W1 >= 0xD800 && W1 <= 0xDFFF) || W1 >= 0xFFFE) {
+                return 0;
+            }
+            *ch = W1;
+            return 3;
+        case 4:
+            if (len < 4 || (p[1] & 0xC0) != 0x80 ||
+                (p[2] & 0xC0) != 0x80 || (p[3] & 0xC0) != 0x80) {
+                return 0;
+            }
+            W1 = ((Uint32) (p[0] & 0x07) << 18) |
+                 ((Uint32) (p[1] & 0x3F) << 12) |
+                 ((Uint32) (p[2] & 0x3F) << 6) | (Uint32) (p[3] & 0x3F);
+            if (W1 < 0x10000 || W1 > 0x10FFFF) {
+                return 0;
+            }
+            *ch = W1;
+            return 4;
+        default:
+            return 0;
+        }
+    case ENCODING_UTF16BE:
+    case ENCODING_UTF16LE:
+        {
+            const int hi = (format == ENCODING_UTF16BE) ? 0 : 1;
+            if (len < 2) {
+                return 0;
+            }
+            W1 = ((Uint32) p[hi] << 8) | (Uint32) p[!hi];
+            if (W1 < 0xD800 || W1 > 0xDFFF) {
+                *ch = W1;
+                return 2;
+            }
+            if (W1 > 0xDBFF || len < 4) {
+                return 0;
+            }
+            W2 = ((Uint32) p[2 + hi] << 8) | (Uint32) p[2 + !hi];
+            if (W2 < 0xDC00 || W2 > 0xDFFF) {
+                return 0;
+            }
+            *ch = (((W1 & 0x3FF) << 10) | (W2 & 0x3FF)) + 0x10000;
+            return 4;
+        }
+    case ENCODING_UTF32BE:
+    case ENCODING_UCS4BE:
+        if (len < 4) {
+            return 0;
+        }
+        W1 = ((Uint32) p[0] << 24) | ((Uint32) p[1] << 16) |
+             ((Uint32) p[2] << 8) | (Uint32) p[3];
+        break;
+    case ENCODING_UTF32LE:
+    case ENCODING_UCS4LE:
+        if (len < 4) {
+            return 0;
+        }
+        W1 = ((Uint32) p[3] << 24) | ((Uint32) p[2] << 16) |
+             ((Uint32) p[1] << 8) | (Uint32) p[0];
+        break;
+    default:
+        return 0;
+    }
+
+    /* Values outside of Unicode are clamped differently by each encoder */
+    if (W1 > 0x10FFFF) {
+        return 0;
+    }
+    *ch = W1;
+    return 4;
+}
+
+/* Encode a character no larger than 0x10FFFF, returning the number of
+   bytes written, or 0 if there isn't enough room.
+ */
+static size_t
+SDL_iconv_encode_fast(int format, Uint32 ch, Uint8 *p, size_t len)
+{
+    switch (format) {
+    case ENCODING_ASCII:
+    case ENCODING_LATIN1:
+        if (len < 1) {
+            return 0;
+        }
+        if (ch > ((format == ENCODING_ASCII) ? 0x7F : 0xFF)) {
+            p[0] = UNKNOWN_ASCII;
+        } else {
+            p[0] = (Uint8) ch;
+        }
+        return 1;
+    case ENCODING_UTF8:
+        if (ch <= 0x7F) {
+            if (len < 1) {
+                return 0;
+            }
+            p[0] = (Uint8) ch;
+            return 1;
+        } else if (ch <= 0x7FF) {
+            if (len < 2) {
+                return 0;
+            }
+            p[0] = 0xC0 | (Uint8) (ch >> 6);
+            p[1] = 0x80 | (Uint8) (ch & 0x3F);
+            return 2;
+        } else if (ch <= 0xFFFF) {
+            if (len < 3) {
+                return 0;
+            }
+            p[0] = 0xE0 | (Uint8) (ch >> 12);
+            p[1] = 0x80 | (Uint8) ((ch >> 6) & 0x3F);
+            p[2] = 0x80 | (Uint8) (ch & 0x3F);
+            return 3;
+        } else {
+            if (len < 4) {
+                return 0;
+            }
+            p[0] = 0xF0 | (Uint8) (ch >> 18);
+            p[1] = 0x80 | (Uint8) ((ch >> 12) & 0x3F);
+            p[2] = 0x80 | (Uint8) ((ch >> 6) & 0x3F);
+            p[3] = 0x80 | (Uint8) (ch & 0x3F);
+            return 4;
+        }
+    case ENCODING_UTF16BE:
+    case ENCODING_UTF16LE:
+        {
+            const int hi = (format == ENCODING_UTF16BE) ? 0 : 1;
+            if (ch < 0x10000) {
+                if (len < 2) {
+                    return 0;
+                }
+                p[hi] = (Uint8) (ch >> 8);
+                p[!hi] = (Uint8) ch;
+                return 2;
+            } else {
+                Uint16 W1, W2;
+                if (len < 4) {
+                    return 0;
+                }
+                ch = ch - 0x10000;
+                W1 = 0xD800 | (Uint16) ((ch >> 10) & 0x3FF);
+                W2 = 0xDC00 | (Uint16) (ch & 0x3FF);
+                p[hi] = (Uint8) (W1 >> 8);
+                p[!hi] = (Uint8) W1;
+                p[2 + hi] = (Uint8) (W2 >> 8);
+                p[2 + !hi] = (Uint8) W2;
+                return 4;
+            }
+        }
+    case ENCODING_UTF32BE:
+    case ENCODING_UCS4BE:
+        if (len < 4) {
+            return 0;
+        }
+        p[0] = (Uint8) (ch >> 24);
+        p[1] = (Uint8) (ch >> 16);
+        p[2] = (Uint8) (ch >> 8);
+        p[3] = (Uint8) ch;
+        return 4;
+    case ENCODING_UTF32LE:
+    case ENCODING_UCS4LE:
+        if (len < 4) {
+            return 0;
+        }
+        p[3] = (Uint8) (ch >> 24);
+        p[2] = (Uint8) (ch >> 16);
+        p[1] = (Uint8) (ch >> 8);
+        p[0] = (Uint8) ch;
+        return 4;
+    default:
+        return 0;
+    }
+}
+
+/* Convert a run of ASCII characters, which are a single code unit with the
+   same value in every format, returning the number of characters converted.
+   Byte formats are copied or widened to UTF-16 and UTF-32, and UTF-16 is
+   narrowed to byte formats, 16 characters at a time with SSE2.  Like the
+   SSE2 string functions, that's only built when the compiler targets SSE2,
+   so it runs without checking the CPU.
+ */
+static size_t
+SDL_iconv_ascii_run(int src_fmt, int dst_fmt, const Uint8 *src, size_t srclen,
+                    Uint8 *dst, size_t dstlen)
+{
+    const size_t srcsize = SDL_iconv_unit_size(src_fmt);
+    const size_t dstsize = SDL_iconv_unit_size(dst_fmt);
+    const int big = SDL_iconv_big_endian(srcsize == 1 ? dst_fmt : src_fmt);
+    size_t count = SDL_min(srclen / srcsize, dstlen / dstsize);
+    size_t i = 0;
+#ifdef __SSE2__
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i mask = _mm_set1_epi16((short) 0xFF80);
+#endif
+
+    if (srcsize == 1) {
+        if (count == 0 || src[0] >= 0x80) {
+            return 0;
+        }
+#ifdef __SSE2__
+        for (; i + 16 <= count; i += 16) {
+            const __m128i v = _mm_loadu_si128((const __m128i *) (src + i));
+            if (_mm_movemask_epi8(v) != 0) {
+                break;
+            }
+            if (dstsize == 1) {
+                _mm_storeu_si128((__m128i *) (dst + i), v);
+            } else {
+                const __m128i lo = big ? _mm_unpacklo_epi8(zero, v) : _mm_unpacklo_epi8(v, zero);
+                const __m128i hi = big ? _mm_unpackhi_epi8(zero, v) : _mm_unpackhi_epi8(v, zero);
+                __m128i *d = (__m128i *) (dst + i * dstsize);
+                if (dstsize == 2) {
+                    _mm_storeu_si128(d + 0, lo);
+                    _mm_storeu_si128(d + 1, hi);
+                } else if (big) {
+                    _mm_storeu_si128(d + 0, _mm_unpacklo_epi16(zero, lo));
+                    _mm_storeu_si128(d + 1, _mm_unpackhi_epi16(zero, lo));
+                    _mm_storeu_si128(d + 2, _mm_unpacklo_epi16(zero, hi));
+                    _mm_storeu_si128(d + 3, _mm_unpackhi_epi16(zero, hi));
+                } else {
+                    _mm_storeu_si128(d + 0, _mm_unpacklo_epi16(lo, zero));
+                    _mm_storeu_si128(d + 1, _mm_unpackhi_epi16(lo, zero));
+                    _mm_storeu_si128(d + 2, _mm_unpacklo_epi16(hi, zero));
+                    _mm_storeu_si128(d + 3, _mm_unpackhi_epi16(hi, zero));
+                }
+            }
+        }
+#endif
+        switch (dstsize) {
+        case 1:
+            for (; i < count && src[i] < 0x80; ++i) {
+                dst[i] = src[i];
+            }
+            break;
+        case 2:
+            for (; i < count && src[i] < 0x80; ++i) {
+                dst[i * 2 + big] = src[i];
+                dst[i * 2 + !big] = 0;
+            }
+            break;
+        default:
+            for (; i < count && src[i] < 0x80; ++i) {
+                Uint8 *d = dst + i * 4;
+                d[0] = d[1] = d[2] = d[3] = 0;
+                d[big ? 3 : 0] = src[i];
+            }
+            break;
+        }
+    } else if (srcsize == 2 && dstsize == 1) {
+        if (count == 0 || src[!big] != 0 || src[big] >= 0x80) {
+            return 0;
+        }
+#ifdef __SSE2__
+        for (; i + 16 <= count; i += 16) {
+            __m128i a = _mm_loadu_si128((const __m128i *) (src + i * 2));
+            __m128i b = _mm_loadu_si128((const __m128i *) (src + i * 2 + 16));
+            if (big) {
+                a = _mm_or_si128(_mm_slli_epi16(a, 8), _mm_srli_epi16(a, 8));
+                b = _mm_or_si128(_mm_slli_epi16(b, 8), _mm_srli_epi16(b, 8));
+            }
+            if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(_mm_or_si128(a, b), mask), zero)) != 0xFFFF) {
+                break;
+            }
+            _mm_storeu_si128((__m128i *) (dst + i), _mm_packus_epi16(a, b));
+        }
+#endif
+        for (; i < count; ++i) {
+            const Uint8 *s = src + i * 2;
+            if (s[!big] != 0 || s[big] >= 0x80) {
+                break;
+            }
+            dst[i] = s[big];
+        }
+    }
+    return i;
+}
+
+/* Convert as much as possible with the fast paths, returning the number of
+   characters converted.  The buffers are updated as for SDL_iconv().
+ */
+static size_t
+SDL_iconv_fast(int src_fmt, int dst_fmt,
+               const char **inbuf, size_t * inbytesleft,
+               char **outbuf, size_t * outbytesleft)
+{
+    const Uint8 *src = (const Uint8 *) *inbuf;
+    Uint8 *dst = (Uint8 *) *outbuf;
+    size_t srclen = *inbytesleft;
+    size_t dstlen = *outbytesleft;
+    const size_t srcsize = SDL_iconv_unit_size(src_fmt);
+    const size_t dstsize = SDL_iconv_unit_size(dst_fmt);
+    const SDL_bool runs = (srcsize == 1 || dstsize == 1) && srcsize <= 2;
+    size_t total = 0;
+
+    while (srclen > 0) {
+        Uint32 ch = 0;
+        size_t used, written;
+
+        if (runs) {
+            const size_t count = SDL_iconv_ascii_run(src_fmt, dst_fmt, src, srclen, dst, dstlen);
+            if (count > 0) {
+                src += count * srcsize;
+                srclen -= count * srcsize;
+                dst += count * dstsize;
+                dstlen -= count * dstsize;
+                total += count;
+                continue;
+            }
+        }
+
+        used = SDL_iconv_decode_fast(src_fmt, src, srclen, &ch);
+        if (!used) {
+            break;
+        }
+        written = SDL_iconv_encode_fast(dst_fmt, ch, dst, dstlen);
+        if (!written) {
+            break;
+        }
+        src += used;
+        srclen -= used;
+        dst += written;
+        dstlen -= written;
+        ++total;
+    }
+
+    *inbuf = (const char *) src;
+    *inbytesleft = srclen;
+    *outbuf = (char *) dst;
+    *outbytesleft = dstlen;
+    return total;
+}
+
 size_t
 SDL_iconv(SDL_iconv_t cd,
           const char **inbuf, size_t * inbytesleft,
@@ -247,6 +681,7 @@ SDL_iconv(SDL_iconv_t cd,
     size_t srclen, dstlen;
     Uint32 ch = 0;
     size_t total;
+    SDL_bool fast;
 
     if (!inbuf || !*inbuf) {
         /* Reset the context */
@@ -333,7 +768,23 @@ SDL_iconv(SDL_iconv_t cd,
     }
 
     total = 0;
+    fast = SDL_iconv_fast_format(cd->src_fmt) && SDL_iconv_fast_format(cd->dst_fmt);
     while (srclen > 0) {
+        if (fast) {
+            /* Convert directly until something needs the generic code */
+            size_t count = SDL_iconv_fast(cd->src_fmt, cd->dst_fmt, &src, &srclen, &dst, &dstlen);
+            if (count > 0) {
+                *inbuf = src;
+                *inbytesleft = srclen;
+                *outbuf = dst;
+                *outbytesleft = dstlen;
+                total += count;
+            }
+            if (srclen == 0) {
+                break;
+            }
+        }
+
         /* Decode a character */
         switch (cd->src_fmt) {
         case ENCODING_ASCII:
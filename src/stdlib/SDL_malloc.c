@@ -23,29 +23,41 @@
 /* This file contains portable memory management functions for SDL */
 
 #include "SDL_stdinc.h"
+#include "SDL_atomic.h"
+#include "SDL_error.h"
+#include "SDL_malloc_c.h"
 
 #if defined(HAVE_MALLOC)
 
-void *SDL_malloc(size_t size)
+static void * SDLCALL real_malloc(size_t size)
 {
     return malloc(size);
 }
 
-void *SDL_calloc(size_t nmemb, size_t size)
+static void * SDLCALL real_calloc(size_t nmemb, size_t size)
 {
     return calloc(nmemb, size);
 }
 
-void *SDL_realloc(void *ptr, size_t size)
+static void * SDLCALL real_realloc(void *ptr, size_t size)
 {
     return realloc(ptr, size);
 }
 
-void SDL_free(void *ptr)
+static void SDLCALL real_free(void *ptr)
 {
     free(ptr);
 }
 
+int SDL_GetMallocStats(SDL_MallocStats *stats)
+{
+    return SDL_Unsupported();
+}
+
+void SDL_FlushMallocCache(void)
+{
+}
+
 #else  /* the rest of this is a LOT of tapdancing to implement malloc. :) */
 
 #define LACKS_SYS_TYPES_H
@@ -54,6 +66,25 @@ void SDL_free(void *ptr)
 #define LACKS_STRING_H
 #define LACKS_STDLIB_H
 #define ABORT
+#define USE_DL_PREFIX   /* real_malloc() and friends are defined at the end */
+
+/* Keep the dl names out of the application's namespace */
+#define dlcalloc               SDL_dlcalloc
+#define dlfree                 SDL_dlfree
+#define dlmalloc               SDL_dlmalloc
+#define dlmemalign             SDL_dlmemalign
+#define dlrealloc              SDL_dlrealloc
+#define dlvalloc               SDL_dlvalloc
+#define dlpvalloc              SDL_dlpvalloc
+#define dlmallinfo             SDL_dlmallinfo
+#define dlmallopt              SDL_dlmallopt
+#define dlmalloc_trim          SDL_dlmalloc_trim
+#define dlmalloc_stats         SDL_dlmalloc_stats
+#define dlmalloc_usable_size   SDL_dlmalloc_usable_size
+#define dlmalloc_footprint     SDL_dlmalloc_footprint
+#define dlmalloc_max_footprint SDL_dlmalloc_max_footprint
+#define dlindependent_calloc   SDL_dlindependent_calloc
+#define dlindependent_comalloc SDL_dlindependent_comalloc
 
 /*
   This is a version (aka dlmalloc) of malloc/free/realloc written by
@@ -632,10 +663,6 @@ DEFAULT_MMAP_THRESHOLD       default: 256K
 
 #define memset  SDL_memset
 #define memcpy  SDL_memcpy
-#define malloc  SDL_malloc
-#define calloc  SDL_calloc
-#define realloc SDL_realloc
-#define free    SDL_free
 
 /*
   mallopt tuning options.  SVID/XPG defines four standard parameter
@@ -4980,6 +5007,438 @@ mspace_mallopt(int param_number, int value)
 
 #endif /* MSPACES */
 
+/* ----------------------- SDL small object front end ---------------------- */
+
+/*
+  dlmalloc isn't thread safe as configured here, so every call into it
+  is serialized by a spinlock.  Small allocations, which are most of the
+  ones SDL makes, are served from caches of free blocks sorted into size
+  classes, so that most of them never touch the lock.  A cache is refilled
+  from dlmalloc, and flushed back to it, a batch of blocks at a time.
+
+  The caches are per thread where the compiler supports thread local
+  variables and there's a way to find out when a thread exits, so that
+  its cache can be flushed.  That's done for every thread, including ones
+  SDL didn't create, with a pthread key destructor.  Elsewhere each thread
+  hashes to one of a small set of caches, each protected by its own
+  spinlock, which outlive their threads.
+
+  Blocks in a cache are ordinary dlmalloc chunks, so the size class of a
+  block being freed is found from its usable size.  Large requests are
+  padded so they can never be mistaken for a small block.
+*/
+
+#include "SDL_atomic.h"
+#include "SDL_thread.h"
+#include "../thread/SDL_thread_c.h"
+
+#define SMALL_CLASS_SHIFT   4
+#define SMALL_CLASSES       SDL_MALLOC_SIZE_CLASSES
+#define SMALL_MAX           ((size_t)SMALL_CLASSES << SMALL_CLASS_SHIFT)
+#define LARGE_MIN           (SMALL_MAX + ((size_t)1 << SMALL_CLASS_SHIFT))
+#define CLASS_SIZE(c)       ((size_t)((c) + 1) << SMALL_CLASS_SHIFT)
+#define SIZE_TO_CLASS(s)    ((s) ? (int)(((s) - 1) >> SMALL_CLASS_SHIFT) : 0)
+#define USABLE_TO_CLASS(u)  ((int)((u) >> SMALL_CLASS_SHIFT) - 1)
+
+#if defined(SDL_THREAD_LOCAL) && (SDL_THREADS_DISABLED || SDL_THREAD_PTHREAD)
+#define SMALL_CACHE_PER_THREAD
+#endif
+
+#if defined(SMALL_CACHE_PER_THREAD) && SDL_THREAD_PTHREAD
+#include <pthread.h>
+#endif
+
+#define CACHE_BATCH         16  /* blocks moved to or from dlmalloc at once */
+#define CACHE_MAX           (2 * CACHE_BATCH)
+#define STATS_BATCH         64  /* operations between statistics updates */
+
+typedef struct small_cache
+{
+    void *blocks[SMALL_CLASSES];    /* free lists linked through the blocks */
+    int count[SMALL_CLASSES];
+
+    /* Statistics not yet added to the totals */
+    int pending;
+    Sint64 bytes_delta;
+    Uint32 allocations[SMALL_CLASSES];
+    int in_use_delta[SMALL_CLASSES];
+
+#ifdef SMALL_CACHE_PER_THREAD
+    SDL_bool registered;            /* whether it's flushed at thread exit */
+#else
+    SDL_SpinLock lock;
+#endif
+} small_cache;
+
+static SDL_SpinLock malloc_lock;
+static struct
+{
+    Sint64 bytes_in_use;
+    Sint64 peak_bytes_in_use;
+    Uint32 class_allocations[SMALL_CLASSES];
+    int class_in_use[SMALL_CLASSES];
+} malloc_totals;
+
+#ifdef SMALL_CACHE_PER_THREAD
+static SDL_THREAD_LOCAL small_cache thread_cache;
+
+#if SDL_THREAD_PTHREAD
+static pthread_key_t thread_cache_key;
+static int thread_cache_key_state;  /* 1 if created, -1 if that failed */
+static SDL_SpinLock thread_cache_key_lock;
+
+static void flush_thread_cache(small_cache *cache);
+
+static void
+release_thread_cache(void *data)
+{
+    small_cache *cache = (small_cache *)data;
+
+    /* Destructors run after this one may allocate again, which registers
+       the cache again, and pthreads calls the destructor again for it */
+    cache->registered = SDL_FALSE;
+    flush_thread_cache(cache);
+}
+
+static small_cache *
+get_thread_cache(void)
+{
+    small_cache *cache = &thread_cache;
+
+    if (!cache->registered) {
+        SDL_AtomicLock(&thread_cache_key_lock);
+        if (!thread_cache_key_state) {
+            if (pthread_key_create(&thread_cache_key, release_thread_cache) == 0) {
+                thread_cache_key_state = 1;
+            } else {
+                thread_cache_key_state = -1;
+            }
+        }
+        SDL_AtomicUnlock(&thread_cache_key_lock);
+
+        if (thread_cache_key_state > 0) {
+            pthread_setspecific(thread_cache_key, cache);
+        }
+        cache->registered = SDL_TRUE;
+    }
+    return cache;
+}
+
+#define LOCK_SMALL_CACHE()      get_thread_cache()
+#else
+#define LOCK_SMALL_CACHE()      (&thread_cache)
+#endif /* SDL_THREAD_PTHREAD */
+#define UNLOCK_SMALL_CACHE(c)
+#else
+#define NUM_SHARED_CACHES   8
+static small_cache shared_caches[NUM_SHARED_CACHES];
+
+static small_cache *
+lock_shared_cache(void)
+{
+    size_t hash = (size_t) SDL_ThreadID();
+    small_cache *cache;
+
+    hash ^= (hash >> 16);
+    hash ^= (hash >> 8);
+    cache = &shared_caches[hash % NUM_SHARED_CACHES];
+    SDL_AtomicLock(&cache->lock);
+    return cache;
+}
+
+#define LOCK_SMALL_CACHE()      lock_shared_cache()
+#define UNLOCK_SMALL_CACHE(c)   SDL_AtomicUnlock(&(c)->lock)
+#endif /* SMALL_CACHE_PER_THREAD */
+
+/* Add a cache's statistics to the totals.  The malloc lock must be held. */
+static void
+publish_cache_stats(small_cache *cache)
+{
+    int i;
+
+    malloc_totals.bytes_in_use += cache->bytes_delta;
+    if (malloc_totals.bytes_in_use > malloc_totals.peak_bytes_in_use) {
+        malloc_totals.peak_bytes_in_use = malloc_totals.bytes_in_use;
+    }
+    for (i = 0; i < SMALL_CLASSES; ++i) {
+        malloc_totals.class_allocations[i] += cache->allocations[i];
+        malloc_totals.class_in_use[i] += cache->in_use_delta[i];
+        cache->allocations[i] = 0;
+        cache->in_use_delta[i] = 0;
+    }
+    cache->bytes_delta = 0;
+    cache->pending = 0;
+}
+
+static void
+count_small_op(small_cache *cache)
+{
+    if (++cache->pending >= STATS_BATCH) {
+        SDL_AtomicLock(&malloc_lock);
+        publish_cache_stats(cache);
+        SDL_AtomicUnlock(&malloc_lock);
+    }
+}
+
+/* Move a batch of blocks from dlmalloc into an empty size class */
+static void
+refill_small_cache(small_cache *cache, int c)
+{
+    size_t size = CLASS_SIZE(c);
+    int i;
+
+    SDL_AtomicLock(&malloc_lock);
+    for (i = 0; i < CACHE_BATCH; ++i) {
+        void *mem = dlmalloc(size);
+        if (!mem) {
+            break;
+        }
+        *(void **)mem = cache->blocks[c];
+        cache->blocks[c] = mem;
+        ++cache->count[c];
+    }
+    publish_cache_stats(cache);
+    SDL_AtomicUnlock(&malloc_lock);
+}
+
+/* Move blocks from a size class back to dlmalloc, keeping \c keep of them */
+static void
+flush_small_cache(small_cache *cache, int c, int keep)
+{
+    SDL_AtomicLock(&malloc_lock);
+    while (cache->count[c] > keep) {
+        void *mem = cache->blocks[c];
+        cache->blocks[c] = *(void **)mem;
+        --cache->count[c];
+        dlfree(mem);
+    }
+    publish_cache_stats(cache);
+    SDL_AtomicUnlock(&malloc_lock);
+}
+
+static void *
+small_malloc(size_t size)
+{
+    small_cache *cache = LOCK_SMALL_CACHE();
+    int c = SIZE_TO_CLASS(size);
+    void *mem;
+
+    if (!cache->blocks[c]) {
+        refill_small_cache(cache, c);
+    }
+    mem = cache->blocks[c];
+    if (mem) {
+        size_t usable;
+
+        cache->blocks[c] = *(void **)mem;
+        --cache->count[c];
+
+        /* dlmalloc may hand out a chunk that's a little bigger than asked
+           for, so count the block in the class it will be freed as */
+        usable = dlmalloc_usable_size(mem);
+        c = USABLE_TO_CLASS(usable);
+        if (c < SMALL_CLASSES) {
+            cache->bytes_delta += CLASS_SIZE(c);
+            ++cache->allocations[c];
+            ++cache->in_use_delta[c];
+            count_small_op(cache);
+        } else {
+            SDL_AtomicLock(&malloc_lock);
+            malloc_totals.bytes_in_use += usable;
+            if (malloc_totals.bytes_in_use > malloc_totals.peak_bytes_in_use) {
+                malloc_totals.peak_bytes_in_use = malloc_totals.bytes_in_use;
+            }
+            SDL_AtomicUnlock(&malloc_lock);
+        }
+    }
+    UNLOCK_SMALL_CACHE(cache);
+    return mem;
+}
+
+static void
+small_free(void *mem, int c)
+{
+    small_cache *cache = LOCK_SMALL_CACHE();
+
+    *(void **)mem = cache->blocks[c];
+    cache->blocks[c] = mem;
+    cache->bytes_delta -= CLASS_SIZE(c);
+    --cache->in_use_delta[c];
+    if (++cache->count[c] >= CACHE_MAX) {
+        flush_small_cache(cache, c, CACHE_MAX - CACHE_BATCH);
+    } else {
+        count_small_op(cache);
+    }
+    UNLOCK_SMALL_CACHE(cache);
+}
+
+static void *
+large_malloc(size_t size, SDL_bool zero)
+{
+    void *mem;
+
+    if (size < LARGE_MIN) {
+        size = LARGE_MIN;
+    }
+    SDL_AtomicLock(&malloc_lock);
+    mem = zero ? dlcalloc(1, size) : dlmalloc(size);
+    if (mem) {
+        malloc_totals.bytes_in_use += dlmalloc_usable_size(mem);
+        if (malloc_totals.bytes_in_use > malloc_totals.peak_bytes_in_use) {
+            malloc_totals.peak_bytes_in_use = malloc_totals.bytes_in_use;
+        }
+    }
+    SDL_AtomicUnlock(&malloc_lock);
+    return mem;
+}
+
+static void * SDLCALL
+real_malloc(size_t size)
+{
+    if (size <= SMALL_MAX) {
+        return small_malloc(size);
+    }
+    return large_malloc(size, SDL_FALSE);
+}
+
+static void * SDLCALL
+real_calloc(size_t nmemb, size_t size)
+{
+    size_t total = nmemb * size;
+    void *mem;
+
+    if (nmemb && (total / nmemb) != size) {
+        return NULL;    /* overflow */
+    }
+    if (total > SMALL_MAX) {
+        /* dlcalloc() knows when fresh memory is already zeroed */
+        return large_malloc(total, SDL_TRUE);
+    }
+    mem = small_malloc(total);
+    if (mem) {
+        SDL_memset(mem, 0, total);
+    }
+    return mem;
+}
+
+static void SDLCALL real_free(void *ptr);
+
+static void * SDLCALL
+real_realloc(void *ptr, size_t size)
+{
+    size_t oldsize;
+    void *mem;
+
+    if (!ptr) {
+        return real_malloc(size);
+    }
+
+    oldsize = dlmalloc_usable_size(ptr);
+    if (USABLE_TO_CLASS(oldsize) < SMALL_CLASSES || size <= SMALL_MAX) {
+        /* Moving to or from a size class, or between them */
+        if (USABLE_TO_CLASS(oldsize) < SMALL_CLASSES &&
+            SIZE_TO_CLASS(size) == USABLE_TO_CLASS(oldsize)) {
+            return ptr;
+        }
+        mem = real_malloc(size);
+        if (mem) {
+            SDL_memcpy(mem, ptr, SDL_min(oldsize, size));
+            real_free(ptr);
+        }
+        return mem;
+    }
+
+    if (size < LARGE_MIN) {
+        size = LARGE_MIN;
+    }
+    SDL_AtomicLock(&malloc_lock);
+    mem = dlrealloc(ptr, size);
+    if (mem) {
+        malloc_totals.bytes_in_use += (Sint64)dlmalloc_usable_size(mem) - (Sint64)oldsize;
+        if (malloc_totals.bytes_in_use > malloc_totals.peak_bytes_in_use) {
+            malloc_totals.peak_bytes_in_use = malloc_totals.bytes_in_use;
+        }
+    }
+    SDL_AtomicUnlock(&malloc_lock);
+    return mem;
+}
+
+static void SDLCALL
+real_free(void *ptr)
+{
+    int c;
+
+    if (!ptr) {
+        return;
+    }
+
+    c = USABLE_TO_CLASS(dlmalloc_usable_size(ptr));
+    if (c < SMALL_CLASSES) {
+        small_free(ptr, c);
+        return;
+    }
+
+    SDL_AtomicLock(&malloc_lock);
+    malloc_totals.bytes_in_use -= dlmalloc_usable_size(ptr);
+    dlfree(ptr);
+    SDL_AtomicUnlock(&malloc_lock);
+}
+
+#ifdef SMALL_CACHE_PER_THREAD
+static void
+flush_thread_cache(small_cache *cache)
+{
+    int c;
+
+    for (c = 0; c < SMALL_CLASSES; ++c) {
+        flush_small_cache(cache, c, 0);
+    }
+}
+#endif
+
+void
+SDL_FlushMallocCache(void)
+{
+#ifdef SMALL_CACHE_PER_THREAD
+    flush_thread_cache(&thread_cache);
+#endif
+    /* Shared caches outlive their threads, so there's nothing to do */
+}
+
+int
+SDL_GetMallocStats(SDL_MallocStats *stats)
+{
+    int i;
+
+    if (!stats) {
+        return SDL_InvalidParamError("stats");
+    }
+
+    /* Bring in the statistics that haven't been added to the totals yet,
+       from every cache where that's possible */
+#ifdef SMALL_CACHE_PER_THREAD
+    SDL_AtomicLock(&malloc_lock);
+    publish_cache_stats(&thread_cache);
+#else
+    for (i = 0; i < NUM_SHARED_CACHES; ++i) {
+        SDL_AtomicLock(&shared_caches[i].lock);
+        SDL_AtomicLock(&malloc_lock);
+        publish_cache_stats(&shared_caches[i]);
+        SDL_AtomicUnlock(&malloc_lock);
+        SDL_AtomicUnlock(&shared_caches[i].lock);
+    }
+    SDL_AtomicLock(&malloc_lock);
+#endif
+    stats->bytes_in_use = (size_t)SDL_max(malloc_totals.bytes_in_use, 0);
+    stats->peak_bytes_in_use = (size_t)malloc_totals.peak_bytes_in_use;
+    for (i = 0; i < SMALL_CLASSES; ++i) {
+        stats->class_allocations[i] = malloc_totals.class_allocations[i];
+        stats->class_in_use[i] = (Uint32)SDL_max(malloc_totals.class_in_use[i], 0);
+    }
+    SDL_AtomicUnlock(&malloc_lock);
+    return 0;
+}
+
 /* -------------------- Alternative MORECORE functions ------------------- */
 
 /*
@@ -5255,4 +5714,107 @@ History:
 
 #endif /* !HAVE_MALLOC */
 
+static struct
+{
+    SDL_malloc_func malloc_func;
+    SDL_calloc_func calloc_func;
+    SDL_realloc_func realloc_func;
+    SDL_free_func free_func;
+} s_mem = {
+    real_malloc, real_calloc, real_realloc, real_free
+};
+
+static SDL_atomic64_t memory_bytes[SDL_NUM_MEMORY_CATEGORIES];
+static SDL_atomic_t memory_allocations[SDL_NUM_MEMORY_CATEGORIES];
+
+void SDL_GetMemoryFunctions(SDL_malloc_func *malloc_func,
+                            SDL_calloc_func *calloc_func,
+                            SDL_realloc_func *realloc_func,
+                            SDL_free_func *free_func)
+{
+    if (malloc_func) {
+        *malloc_func = s_mem.malloc_func;
+    }
+    if (calloc_func) {
+        *calloc_func = s_mem.calloc_func;
+    }
+    if (realloc_func) {
+        *realloc_func = s_mem.realloc_func;
+    }
+    if (free_func) {
+        *free_func = s_mem.free_func;
+    }
+}
+
+int SDL_SetMemoryFunctions(SDL_malloc_func malloc_func,
+                           SDL_calloc_func calloc_func,
+                           SDL_realloc_func realloc_func,
+                           SDL_free_func free_func)
+{
+    if (!malloc_func) {
+        return SDL_InvalidParamError("malloc_func");
+    }
+    if (!calloc_func) {
+        return SDL_InvalidParamError("calloc_func");
+    }
+    if (!realloc_func) {
+        return SDL_InvalidParamError("realloc_func");
+    }
+    if (!free_func) {
+        return SDL_InvalidParamError("free_func");
+    }
+
+    s_mem.malloc_func = malloc_func;
+    s_mem.calloc_func = calloc_func;
+    s_mem.realloc_func = realloc_func;
+    s_mem.free_func = free_func;
+    return 0;
+}
+
+void *SDL_malloc(size_t size)
+{
+    return s_mem.malloc_func(size);
+}
+
+void *SDL_calloc(size_t nmemb, size_t size)
+{
+    return s_mem.calloc_func(nmemb, size);
+}
+
+void *SDL_realloc(void *ptr, size_t size)
+{
+    return s_mem.realloc_func(ptr, size);
+}
+
+void SDL_free(void *ptr)
+{
+    s_mem.free_func(ptr);
+}
+
+void SDL_TrackAllocation(SDL_MemoryCategory category, size_t size)
+{
+    SDL_AtomicAdd64(&memory_bytes[category], (Sint64)size);
+    SDL_AtomicIncRef(&memory_allocations[category]);
+}
+
+void SDL_TrackFree(SDL_MemoryCategory category, size_t size)
+{
+    SDL_AtomicAdd64(&memory_bytes[category], -(Sint64)size);
+    SDL_AtomicAdd(&memory_allocations[category], -1);
+}
+
+int SDL_GetMemoryUsage(SDL_MemoryCategory category, SDL_MemoryUsage *usage)
+{
+    if ((int)category < 0 || category >= SDL_NUM_MEMORY_CATEGORIES) {
+        return SDL_InvalidParamError("category");
+    }
+    if (!usage) {
+        return SDL_InvalidParamError("usage");
+    }
+
+    usage->bytes = (Uint64)SDL_AtomicGet64(&memory_bytes[category]);
+    usage->allocations = SDL_AtomicGet(&memory_allocations[category]);
+    return 0;
+}
+
 /* vi: set ts=4 sw=4 expandtab: */
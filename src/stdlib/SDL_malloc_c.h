@@ -0,0 +1,42 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2013 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "SDL_config.h"
+
+#ifndef _SDL_malloc_c_h
+#define _SDL_malloc_c_h
+
+#include "SDL_stdinc.h"
+
+/* Return the calling thread's cached free blocks to the shared heap.
+   This is called as threads created by SDL_CreateThread() exit.
+ */
+extern void SDL_FlushMallocCache(void);
+
+/* Account for memory held by a subsystem, as reported by SDL_GetMemoryUsage().
+   Each call to SDL_TrackAllocation() should be balanced by a call to
+   SDL_TrackFree() with the same size.
+ */
+extern void SDL_TrackAllocation(SDL_MemoryCategory category, size_t size);
+extern void SDL_TrackFree(SDL_MemoryCategory category, size_t size);
+
+#endif /* _SDL_malloc_c_h */
+
+/* vi: set ts=4 sw=4 expandtab: */
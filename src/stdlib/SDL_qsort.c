@@ -84,7 +84,7 @@ SDL_qsort(void *base, size_t nmemb, size_t size, int (*compare) (const void *, c
 #endif
 #define qsort	SDL_qsort
 
-static const char _ID[] = "<qsort.c gjm 1.12 1998-03-19>";
+static const char _ID[] = "<qsort.c gjm 1.12 1998-03-19 altered for SDL: introsort depth limit>";
 
 /* How many bytes are there per word? (Must be a power of 2,
  * and must in fact equal sizeof(int).)
@@ -113,18 +113,23 @@ static const char _ID[] = "<qsort.c gjm 1.12 1998-03-19>";
  */
 #define PIVOT_THRESHOLD 40
 
+/* SDL change: each stack entry also remembers how many more times its
+ * sub-array may be partitioned before it is heap sorted instead.
+ */
 typedef struct
 {
     char *first;
     char *last;
+    int depth;
 } stack_entry;
-#define pushLeft {stack[stacktop].first=ffirst;stack[stacktop++].last=last;}
-#define pushRight {stack[stacktop].first=first;stack[stacktop++].last=llast;}
+#define pushLeft {stack[stacktop].first=ffirst;stack[stacktop].depth=depth;stack[stacktop++].last=last;}
+#define pushRight {stack[stacktop].first=first;stack[stacktop].depth=depth;stack[stacktop++].last=llast;}
 #define doLeft {first=ffirst;llast=last;continue;}
 #define doRight {ffirst=first;last=llast;continue;}
 #define pop {if (--stacktop<0) break;\
   first=ffirst=stack[stacktop].first;\
   last=llast=stack[stacktop].last;\
+  depth=stack[stacktop].depth;\
   continue;}
 
 /* Some comments on the implementation.
@@ -167,6 +172,13 @@ typedef struct
  *    have that n^2 worst case.) However, the overhead
  *    from the extra bookkeeping means that it's just
  *    not worth while.
+ * 5' SDL change: it's also easy to construct datasets that
+ *    defeat the median-of-medians pivot, so we do limit
+ *    the depth after all. Once a sub-array has been split
+ *    2*log2(n) times it is heap sorted instead, which keeps
+ *    the worst case at order n log n (this is "introsort").
+ *    For the same reason, a partitioning step that needed
+ *    no swaps only skips a sub-array that really is sorted.
  * 6. This is pretty clean and portable code. Here are
  *    all the potential portability pitfalls and problems
  *    I know of:
@@ -239,9 +251,16 @@ typedef struct
       first+=sz; last-=sz; }			\
     else if (first==last) { first+=sz; last-=sz; break; }\
   } while (first<=last);			\
-  if (!swapped) pop				\
+  if (!swapped && is_sorted(ffirst,llast,sz,compare)) pop \
 }
 
+/* and so is the depth limit (SDL change): */
+#define DepthLimit(sz)				\
+  if (--depth<0) {				\
+    heap_sort(first,(size_t)(last-first)/sz+1,sz,compare);\
+    pop					\
+  }
+
 /* and so is the pre-insertion-sort operation of putting
  * the smallest element into place as a sentinel.
  * Doing this makes the inner loop nicer. I got this
@@ -289,6 +308,75 @@ typedef struct
 
 /* ---------------------------------------------------------------------- */
 
+/* SDL change: helpers for the depth limit. */
+static int
+depth_limit(size_t nmemb)
+{
+    int depth = 0;
+    while (nmemb >>= 1) {
+        depth += 2;
+    }
+    return depth;
+}
+
+static int
+is_sorted(char *first, char *last, size_t size,
+          int compare(const void *, const void *))
+{
+    for (; first < last; first += size) {
+        if (compare(first, first + size) > 0) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static void
+swap_bytes(char *a, char *b, size_t size)
+{
+    do {
+        char t = *a;
+        *a++ = *b;
+        *b++ = t;
+    } while (--size);
+}
+
+static void
+sift_down(char *base, size_t root, size_t nmemb, size_t size,
+          int compare(const void *, const void *))
+{
+    size_t child;
+
+    while ((child = 2 * root + 1) < nmemb) {
+        if (child + 1 < nmemb &&
+            compare(base + child * size, base + (child + 1) * size) < 0) {
+            ++child;
+        }
+        if (compare(base + root * size, base + child * size) >= 0) {
+            break;
+        }
+        swap_bytes(base + root * size, base + child * size, size);
+        root = child;
+    }
+}
+
+static void
+heap_sort(char *base, size_t nmemb, size_t size,
+          int compare(const void *, const void *))
+{
+    size_t i;
+
+    for (i = nmemb / 2; i > 0; --i) {
+        sift_down(base, i - 1, nmemb, size, compare);
+    }
+    for (i = nmemb - 1; i > 0; --i) {
+        swap_bytes(base, base + i * size, size);
+        sift_down(base, 0, i, size, compare);
+    }
+}
+
+/* ---------------------------------------------------------------------- */
+
 static char *
 pivot_big(char *first, char *mid, char *last, size_t size,
           int compare(const void *, const void *))
@@ -342,6 +430,7 @@ qsort_nonaligned(void *base, size_t nmemb, size_t size,
     char *first, *last;
     char *pivot = malloc(size);
     size_t trunc = TRUNC_nonaligned * size;
+    int depth = depth_limit(nmemb);
     assert(pivot != 0);
 
     first = (char *) base;
@@ -350,6 +439,7 @@ qsort_nonaligned(void *base, size_t nmemb, size_t size,
     if ((size_t) (last - first) > trunc) {
         char *ffirst = first, *llast = last;
         while (1) {
+            DepthLimit(size);
             /* Select pivot */
             {
                 char *mid = first + size * ((last - first) / size >> 1);
@@ -376,6 +466,7 @@ qsort_aligned(void *base, size_t nmemb, size_t size,
     char *first, *last;
     char *pivot = malloc(size);
     size_t trunc = TRUNC_aligned * size;
+    int depth = depth_limit(nmemb);
     assert(pivot != 0);
 
     first = (char *) base;
@@ -384,6 +475,7 @@ qsort_aligned(void *base, size_t nmemb, size_t size,
     if ((size_t) (last - first) > trunc) {
         char *ffirst = first, *llast = last;
         while (1) {
+            DepthLimit(size);
             /* Select pivot */
             {
                 char *mid = first + size * ((last - first) / size >> 1);
@@ -409,6 +501,7 @@ qsort_words(void *base, size_t nmemb,
     int stacktop = 0;
     char *first, *last;
     char *pivot = malloc(WORD_BYTES);
+    int depth = depth_limit(nmemb);
     assert(pivot != 0);
 
     first = (char *) base;
@@ -422,6 +515,7 @@ qsort_words(void *base, size_t nmemb,
                     (first - (char *) base) / WORD_BYTES,
                     (last - (char *) base) / WORD_BYTES);
 #endif
+            DepthLimit(WORD_BYTES);
             /* Select pivot */
             {
                 char *mid =
@@ -0,0 +1,206 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2013 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "SDL_config.h"
+
+/* This file contains the radix sort used by SDL_SortByKey() */
+
+#include "SDL_stdinc.h"
+#include "SDL_error.h"
+
+/* Arrays smaller than this are insertion sorted */
+#define SDL_RADIX_SORT_THRESHOLD    64
+
+typedef struct SDL_SortEntry
+{
+    Uint64 key;
+    size_t index;
+} SDL_SortEntry;
+
+/* Read a key and map it to an unsigned integer with the same ordering */
+static Uint64
+SDL_GetSortKey(const Uint8 *p, SDL_SortKeyType key_type)
+{
+    Uint32 key32;
+    Uint64 key64;
+
+    switch (key_type) {
+    case SDL_SORTKEY_UINT32:
+        SDL_memcpy(&key32, p, sizeof(key32));
+        return key32;
+    case SDL_SORTKEY_SINT32:
+        SDL_memcpy(&key32, p, sizeof(key32));
+        return key32 ^ 0x80000000;
+    case SDL_SORTKEY_FLOAT:
+        /* Negative numbers sort in reverse, so flip all of their bits */
+        SDL_memcpy(&key32, p, sizeof(key32));
+        return (key32 & 0x80000000) ? ~key32 : (key32 | 0x80000000);
+    case SDL_SORTKEY_UINT64:
+        SDL_memcpy(&key64, p, sizeof(key64));
+        return key64;
+    case SDL_SORTKEY_SINT64:
+        SDL_memcpy(&key64, p, sizeof(key64));
+        return key64 ^ 0x8000000000000000ULL;
+    case SDL_SORTKEY_DOUBLE:
+        SDL_memcpy(&key64, p, sizeof(key64));
+        return (key64 & 0x8000000000000000ULL) ? ~key64 : (key64 | 0x8000000000000000ULL);
+    default:
+        return 0;
+    }
+}
+
+static size_t
+SDL_GetSortKeySize(SDL_SortKeyType key_type)
+{
+    switch (key_type) {
+    case SDL_SORTKEY_UINT32:
+    case SDL_SORTKEY_SINT32:
+    case SDL_SORTKEY_FLOAT:
+        return 4;
+    case SDL_SORTKEY_UINT64:
+    case SDL_SORTKEY_SINT64:
+    case SDL_SORTKEY_DOUBLE:
+        return 8;
+    default:
+        return 0;
+    }
+}
+
+/* Sort the entries by key, leaving the result in either array */
+static SDL_SortEntry *
+SDL_RadixSort(SDL_SortEntry *entries, SDL_SortEntry *scratch, size_t nmemb, size_t key_size)
+{
+    size_t (*counts)[256];
+    size_t i, pass;
+
+    if (nmemb < SDL_RADIX_SORT_THRESHOLD) {
+        for (i = 1; i < nmemb; ++i) {
+            SDL_SortEntry entry = entries[i];
+            size_t j = i;
+            while (j > 0 && entries[j - 1].key > entry.key) {
+                entries[j] = entries[j - 1];
+                --j;
+            }
+            entries[j] = entry;
+        }
+        return entries;
+    }
+
+    counts = (size_t (*)[256]) SDL_calloc(key_size, sizeof(*counts));
+    if (!counts) {
+        return NULL;
+    }
+
+    /* Count every digit up front, so one pass over the keys does them all */
+    for (i = 0; i < nmemb; ++i) {
+        const Uint64 key = entries[i].key;
+        for (pass = 0; pass < key_size; ++pass) {
+            ++counts[pass][(key >> (pass * 8)) & 0xFF];
+        }
+    }
+
+    for (pass = 0; pass < key_size; ++pass) {
+        const int shift = (int) pass * 8;
+        size_t *count = counts[pass];
+        size_t offset = 0;
+        SDL_SortEntry *swap;
+        int digit;
+
+        /* Skip digits that are the same in every key */
+        if (count[(entries[0].key >> shift) & 0xFF] == nmemb) {
+            continue;
+        }
+
+        for (digit = 0; digit < 256; ++digit) {
+            const size_t n = count[digit];
+            count[digit] = offset;
+            offset += n;
+        }
+        for (i = 0; i < nmemb; ++i) {
+            scratch[count[(entries[i].key >> shift) & 0xFF]++] = entries[i];
+        }
+
+        swap = entries;
+        entries = scratch;
+        scratch = swap;
+    }
+    SDL_free(counts);
+
+    return entries;
+}
+
+int
+SDL_SortByKey(void *base, size_t nmemb, size_t size, size_t key_offset, SDL_SortKeyType key_type)
+{
+    const size_t key_size = SDL_GetSortKeySize(key_type);
+    SDL_SortEntry *entries, *sorted;
+    Uint8 *elements = (Uint8 *) base;
+    Uint8 *copy;
+    size_t i;
+
+    if (!key_size) {
+        return SDL_InvalidParamError("key_type");
+    }
+    if (key_offset > size || size - key_offset < key_size) {
+        return SDL_InvalidParamError("key_offset");
+    }
+    if (nmemb <= 1) {
+        return 0;
+    }
+    if (!base) {
+        return SDL_InvalidParamError("base");
+    }
+
+    /* The key and element buffers can't be bigger than the address space */
+    if (nmemb > (~(size_t)0) / (2 * sizeof(*entries)) || nmemb > (~(size_t)0) / size) {
+        return SDL_OutOfMemory();
+    }
+
+    /* Sort the keys with the element indices, then move the elements */
+    entries = (SDL_SortEntry *) SDL_malloc(2 * nmemb * sizeof(*entries));
+    copy = (Uint8 *) SDL_malloc(nmemb * size);
+    if (!entries || !copy) {
+        SDL_free(entries);
+        SDL_free(copy);
+        return SDL_OutOfMemory();
+    }
+
+    for (i = 0; i < nmemb; ++i) {
+        entries[i].key = SDL_GetSortKey(elements + i * size + key_offset, key_type);
+        entries[i].index = i;
+    }
+    sorted = SDL_RadixSort(entries, entries + nmemb, nmemb, key_size);
+    if (!sorted) {
+        SDL_free(entries);
+        SDL_free(copy);
+        return SDL_OutOfMemory();
+    }
+
+    SDL_memcpy(copy, elements, nmemb * size);
+    for (i = 0; i < nmemb; ++i) {
+        SDL_memcpy(elements + i * size, copy + sorted[i].index * size, size);
+    }
+
+    SDL_free(entries);
+    SDL_free(copy);
+    return 0;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
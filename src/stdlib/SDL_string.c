@@ -23,6 +23,7 @@
 /* This file contains portable string manipulation functions for SDL */
 
 #include "SDL_stdinc.h"
+#include "SDL_cpuinfo.h"
 
 
 #define SDL_isupperhex(X)   (((X) >= 'A') && ((X) <= 'F'))
@@ -43,6 +44,132 @@ static int UTF8_TrailingBytes(unsigned char c)
         return 0;
 }
 
+/* The index of the lowest set bit, which must exist */
+static SDL_INLINE int
+SDL_LowestBitIndex32(Uint32 x)
+{
+#if defined(__GNUC__) && (__GNUC__ >= 4)
+    return __builtin_ctz(x);
+#else
+    int i = 0;
+    while (!(x & 1)) {
+        x >>= 1;
+        ++i;
+    }
+    return i;
+#endif
+}
+
+static SDL_INLINE int
+SDL_PopCount32(Uint32 x)
+{
+#if defined(__GNUC__) && (__GNUC__ >= 4)
+    return __builtin_popcount(x);
+#else
+    x = x - ((x >> 1) & 0x55555555);
+    x = (x & 0x33333333) + ((x >> 2) & 0x33333333);
+    x = (x + (x >> 4)) & 0x0F0F0F0F;
+    return (int)((x * 0x01010101) >> 24);
+#endif
+}
+
+/* The SSE2 versions scan strings with aligned 16 byte loads, which can read
+   past the end of the string but never into another page.
+
+   These are only built when the compiler targets SSE2 (__SSE2__), and then
+   it may use SSE2 anywhere, so they're called without checking the CPU.
+ */
+#ifdef __SSE2__
+#ifndef HAVE_STRLEN
+static size_t
+SDL_strlen_SSE2(const char *string)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const int offset = (int)((uintptr_t)string & 15);
+    const __m128i *p = (const __m128i *)(string - offset);
+    Uint32 mask;
+
+    mask = (Uint32)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_load_si128(p), zero)) >> offset;
+    if (mask) {
+        return SDL_LowestBitIndex32(mask);
+    }
+    for (;;) {
+        ++p;
+        mask = (Uint32)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_load_si128(p), zero));
+        if (mask) {
+            return ((const char *)p - string) + SDL_LowestBitIndex32(mask);
+        }
+    }
+}
+#endif /* !HAVE_STRLEN */
+
+static size_t
+SDL_utf8strlen_SSE2(const char *string)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i trailing = _mm_set1_epi8((char)0xC0);
+    const int offset = (int)((uintptr_t)string & 15);
+    const __m128i *p = (const __m128i *)(string - offset);
+    Uint32 valid = 0xFFFF << offset;
+    size_t count = 0;
+
+    for (;;) {
+        const __m128i v = _mm_load_si128(p++);
+        /* Bytes 0x80-0xBF are the only ones less than 0xC0 as signed bytes */
+        const Uint32 chars = (Uint32)_mm_movemask_epi8(_mm_cmplt_epi8(v, trailing)) ^ 0xFFFF;
+        const Uint32 zeros = (Uint32)_mm_movemask_epi8(_mm_cmpeq_epi8(v, zero)) & valid;
+
+        if (zeros) {
+            valid &= (zeros & (~zeros + 1)) - 1;
+            return count + SDL_PopCount32(chars & valid);
+        }
+        count += SDL_PopCount32(chars & valid);
+        valid = 0xFFFF;
+    }
+}
+#endif /* __SSE2__ */
+
+/* Validate the UTF-8 sequence starting at text[0], returning its length,
+   or 0 if it's invalid or truncated */
+static size_t
+UTF8_SequenceLength(const Uint8 *text, size_t len)
+{
+    const Uint8 c = text[0];
+    Uint8 lo = 0x80, hi = 0xBF;
+    size_t i, n;
+
+    if (c < 0x80) {
+        return 1;
+    } else if (c >= 0xC2 && c <= 0xDF) {
+        n = 2;
+    } else if (c >= 0xE0 && c <= 0xEF) {
+        n = 3;
+        if (c == 0xE0) {
+            lo = 0xA0;  /* Overlong */
+        } else if (c == 0xED) {
+            hi = 0x9F;  /* Surrogates */
+        }
+    } else if (c >= 0xF0 && c <= 0xF4) {
+        n = 4;
+        if (c == 0xF0) {
+            lo = 0x90;  /* Overlong */
+        } else if (c == 0xF4) {
+            hi = 0x8F;  /* Above U+10FFFF */
+        }
+    } else {
+        return 0;
+    }
+    if (len < n || text[1] < lo || text[1] > hi) {
+        return 0;
+    }
+    for (i = 2; i < n; ++i) {
+        if (!UTF8_IsTrailingByte(text[i])) {
+            return 0;
+        }
+    }
+    return n;
+}
+
 #if !defined(HAVE_SSCANF) || !defined(HAVE_STRTOL)
 static size_t
 SDL_ScanLong(const char *text, int radix, long *valuep)
@@ -263,12 +390,38 @@ SDL_memset(void *dst, int c, size_t len)
 #if defined(HAVE_MEMSET)
     return memset(dst, c, len);
 #else
-    size_t left = (len % 4);
+    size_t left;
     Uint32 *dstp4;
     Uint8 *dstp1;
     Uint32 value4 = (c | (c << 8) | (c << 16) | (c << 24));
     Uint8 value1 = (Uint8) c;
 
+#ifdef __SSE2__
+    if (len >= 64) {
+        __m128i value16 = _mm_set1_epi8((char) c);
+        __m128i *dstp16;
+
+        dstp1 = (Uint8 *) dst;
+        while ((uintptr_t) dstp1 & 15) {
+            *dstp1++ = value1;
+            --len;
+        }
+        dstp16 = (__m128i *) dstp1;
+        for (; len >= 64; len -= 64) {
+            _mm_store_si128(dstp16++, value16);
+            _mm_store_si128(dstp16++, value16);
+            _mm_store_si128(dstp16++, value16);
+            _mm_store_si128(dstp16++, value16);
+        }
+        dstp1 = (Uint8 *) dstp16;
+        while (len--) {
+            *dstp1++ = value1;
+        }
+        return dst;
+    }
+#endif /* __SSE2__ */
+
+    left = (len % 4);
     dstp4 = (Uint32 *) dst;
     len /= 4;
     while (len--) {
@@ -303,6 +456,37 @@ SDL_memcpy(void *dst, const void *src, size_t len)
     bcopy(src, dst, len);
     return dst;
 #else
+#ifdef __SSE2__
+    if (len >= 64) {
+        const Uint8 *srcp1 = (const Uint8 *)src;
+        Uint8 *dstp1 = (Uint8 *)dst;
+        __m128i *dstp16;
+
+        /* Align the destination, the source can be unaligned */
+        while ((uintptr_t) dstp1 & 15) {
+            *dstp1++ = *srcp1++;
+            --len;
+        }
+        dstp16 = (__m128i *) dstp1;
+        for (; len >= 64; len -= 64) {
+            __m128i a = _mm_loadu_si128((const __m128i *) srcp1);
+            __m128i b = _mm_loadu_si128((const __m128i *) (srcp1 + 16));
+            __m128i c = _mm_loadu_si128((const __m128i *) (srcp1 + 32));
+            __m128i d = _mm_loadu_si128((const __m128i *) (srcp1 + 48));
+            _mm_store_si128(dstp16++, a);
+            _mm_store_si128(dstp16++, b);
+            _mm_store_si128(dstp16++, c);
+            _mm_store_si128(dstp16++, d);
+            srcp1 += 64;
+        }
+        dstp1 = (Uint8 *) dstp16;
+        while (len--) {
+            *dstp1++ = *srcp1++;
+        }
+        return dst;
+    }
+#endif /* __SSE2__ */
+
     /* GCC 4.9.0 with -O3 will generate movaps instructions with the loop
        using Uint32* pointers, so we need to make sure the pointers are
        aligned before we loop using them.
@@ -390,6 +574,8 @@ SDL_strlen(const char *string)
 {
 #if defined(HAVE_STRLEN)
     return strlen(string);
+#elif defined(__SSE2__)
+    return SDL_strlen_SSE2(string);
 #else
     size_t len = 0;
     while (*string++) {
@@ -492,6 +678,57 @@ size_t SDL_utf8strlcpy(char *dst, const char *src, size_t dst_bytes)
     return bytes;
 }
 
+size_t
+SDL_utf8strlen(const char *str)
+{
+#ifdef __SSE2__
+    return SDL_utf8strlen_SSE2(str);
+#else
+    const Uint8 *p = (const Uint8 *) str;
+    size_t count = 0;
+
+    while (*p) {
+        if (!UTF8_IsTrailingByte(*p)) {
+            ++count;
+        }
+        ++p;
+    }
+    return count;
+#endif
+}
+
+SDL_bool
+SDL_utf8valid(const char *str, size_t len)
+{
+    const Uint8 *p = (const Uint8 *) str;
+    const Uint8 *end = p + len;
+
+    while (p < end) {
+        size_t n;
+
+        /* Skip runs of ASCII quickly */
+#ifdef __SSE2__
+        while (end - p >= 16 &&
+               _mm_movemask_epi8(_mm_loadu_si128((const __m128i *) p)) == 0) {
+            p += 16;
+        }
+#endif
+        while (p < end && *p < 0x80) {
+            ++p;
+        }
+        if (p == end) {
+            break;
+        }
+
+        n = UTF8_SequenceLength(p, end - p);
+        if (!n) {
+            return SDL_FALSE;
+        }
+        p += n;
+    }
+    return SDL_TRUE;
+}
+
 size_t
 SDL_strlcat(char *dst, const char *src, size_t maxlen)
 {
@@ -510,16 +747,13 @@ SDL_strlcat(char *dst, const char *src, size_t maxlen)
 char *
 SDL_strdup(const char *string)
 {
-#if defined(HAVE_STRDUP)
-    return strdup(string);
-#else
+    /* Always use SDL_malloc(), the result is released with SDL_free() */
     size_t len = SDL_strlen(string) + 1;
     char *newstr = SDL_malloc(len);
     if (newstr) {
         SDL_strlcpy(newstr, string, len);
     }
     return newstr;
-#endif /* HAVE_STRDUP */
 }
 
 char *
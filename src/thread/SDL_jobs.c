@@ -0,0 +1,713 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2013 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "SDL_config.h"
+
+/* A work-stealing job system built on top of the SDL thread API */
+
+#include "SDL_thread.h"
+#include "SDL_cpuinfo.h"
+#include "SDL_jobs.h"
+#include "SDL_jobs_c.h"
+
+/* This must be a power of two */
+#define SDL_JOB_QUEUE_SIZE  1024
+#define SDL_JOB_QUEUE_MASK  (SDL_JOB_QUEUE_SIZE - 1)
+
+typedef struct SDL_Job
+{
+    SDL_JobFunction fn;
+    void *data;
+    SDL_JobGroup *group;
+} SDL_Job;
+
+/* Each worker owns a deque of jobs.  The owner pushes and pops at the
+   bottom, so recently queued (and cache-hot) jobs run first, and other
+   workers steal the oldest jobs from the top.
+ */
+typedef struct SDL_JobWorker
+{
+    SDL_JobPool *pool;
+    SDL_Thread *thread;
+    SDL_threadID threadid;
+    SDL_SpinLock lock;
+    unsigned int top;
+    unsigned int bottom;
+    SDL_Job jobs[SDL_JOB_QUEUE_SIZE];
+} SDL_JobWorker;
+
+struct SDL_JobPool
+{
+    int num_workers;
+    SDL_JobWorker *workers;
+    SDL_atomic_t queued;
+    SDL_atomic_t sleeping;
+    SDL_atomic_t next_worker;
+    SDL_atomic_t quit;
+    SDL_mutex *lock;
+    SDL_cond *wakeup;
+};
+
+struct SDL_JobGroup
+{
+    SDL_JobPool *pool;
+    SDL_atomic_t pending;
+    SDL_atomic_t signalling;
+    SDL_mutex *lock;
+    SDL_cond *done;
+};
+
+typedef struct SDL_ParallelForRange
+{
+    SDL_ParallelForFunction fn;
+    void *data;
+    int start;
+    int end;
+} SDL_ParallelForRange;
+
+static SDL_SpinLock SDL_shared_job_pool_lock;
+static SDL_JobPool *SDL_shared_job_pool;
+
+
+static SDL_bool
+SDL_PushJob(SDL_JobWorker *worker, const SDL_Job *job)
+{
+    SDL_bool retval = SDL_FALSE;
+
+    SDL_AtomicLock(&worker->lock);
+    if ((worker->bottom - worker->top) < SDL_JOB_QUEUE_SIZE) {
+        worker->jobs[worker->bottom & SDL_JOB_QUEUE_MASK] = *job;
+        ++worker->bottom;
+        retval = SDL_TRUE;
+    }
+    SDL_AtomicUnlock(&worker->lock);
+
+    return retval;
+}
+
+static SDL_bool
+SDL_PopJob(SDL_JobWorker *worker, SDL_Job *job)
+{
+    SDL_bool retval = SDL_FALSE;
+
+    SDL_AtomicLock(&worker->lock);
+    if (worker->bottom != worker->top) {
+        --worker->bottom;
+        *job = worker->jobs[worker->bottom & SDL_JOB_QUEUE_MASK];
+        retval = SDL_TRUE;
+    }
+    SDL_AtomicUnlock(&worker->lock);
+
+    return retval;
+}
+
+static SDL_bool
+SDL_StealJob(SDL_JobWorker *worker, SDL_Job *job)
+{
+    SDL_bool retval = SDL_FALSE;
+
+    /* Don't bother taking the lock if there's obviously nothing to steal */
+    if (*(volatile unsigned int *)&worker->bottom == *(volatile unsigned int *)&worker->top) {
+        return SDL_FALSE;
+    }
+
+    SDL_AtomicLock(&worker->lock);
+    if (worker->bottom != worker->top) {
+        *job = worker->jobs[worker->top & SDL_JOB_QUEUE_MASK];
+        ++worker->top;
+        retval = SDL_TRUE;
+    }
+    SDL_AtomicUnlock(&worker->lock);
+
+    return retval;
+}
+
+static SDL_JobWorker *
+SDL_GetCurrentWorker(SDL_JobPool *pool)
+{
+    SDL_threadID threadid = SDL_ThreadID();
+    int i;
+
+    for (i = 0; i < pool->num_workers; ++i) {
+        if (pool->workers[i].threadid == threadid) {
+            return &pool->workers[i];
+        }
+    }
+    return NULL;
+}
+
+/* Find a job to run, looking in our own queue first */
+static SDL_bool
+SDL_FindJob(SDL_JobPool *pool, SDL_JobWorker *self, SDL_Job *job)
+{
+    int i, first;
+
+    if (SDL_AtomicGet(&pool->queued) <= 0) {
+        return SDL_FALSE;
+    }
+
+    if (self) {
+        if (SDL_PopJob(self, job)) {
+            SDL_AtomicAdd(&pool->queued, -1);
+            return SDL_TRUE;
+        }
+        first = (int)(self - pool->workers) + 1;
+    } else {
+        first = 0;
+    }
+
+    for (i = 0; i < pool->num_workers; ++i) {
+        SDL_JobWorker *victim = &pool->workers[(first + i) % pool->num_workers];
+        if (victim != self && SDL_StealJob(victim, job)) {
+            SDL_AtomicAdd(&pool->queued, -1);
+            return SDL_TRUE;
+        }
+    }
+    return SDL_FALSE;
+}
+
+static void
+SDL_RunJob(const SDL_Job *job)
+{
+    SDL_JobGroup *group = job->group;
+
+    job->fn(job->data);
+
+    /* The group may be destroyed as soon as pending reaches zero, so we
+       hold a reference via signalling until we're done touching it.
+     */
+    SDL_AtomicIncRef(&group->signalling);
+    if (SDL_AtomicDecRef(&group->pending)) {
+        SDL_LockMutex(group->lock);
+        SDL_CondBroadcast(group->done);
+        SDL_UnlockMutex(group->lock);
+    }
+    SDL_AtomicAdd(&group->signalling, -1);
+}
+
+static int SDLCALL
+SDL_JobWorkerThread(void *data)
+{
+    SDL_JobWorker *worker = (SDL_JobWorker *) data;
+    SDL_JobPool *pool = worker->pool;
+    SDL_Job job;
+
+    worker->threadid = SDL_ThreadID();
+
+    for ( ; ; ) {
+        if (SDL_FindJob(pool, worker, &job)) {
+            SDL_RunJob(&job);
+            continue;
+        }
+        if (SDL_AtomicGet(&pool->quit)) {
+            break;
+        }
+
+        /* Nothing to do, go to sleep until a job is submitted.
+           We announce that we're sleeping before checking the queue, so
+           a submitter either sees us sleeping or we see its job.
+         */
+        SDL_LockMutex(pool->lock);
+        SDL_AtomicIncRef(&pool->sleeping);
+        if (SDL_AtomicGet(&pool->queued) <= 0 && !SDL_AtomicGet(&pool->quit)) {
+            SDL_CondWait(pool->wakeup, pool->lock);
+        }
+        SDL_AtomicAdd(&pool->sleeping, -1);
+        SDL_UnlockMutex(pool->lock);
+    }
+    return 0;
+}
+
+SDL_JobPool *
+SDL_CreateJobPool(int num_threads)
+{
+    SDL_JobPool *pool;
+    int i;
+
+    if (num_threads <= 0) {
+        num_threads = SDL_GetCPUCount();
+    }
+
+    pool = (SDL_JobPool *) SDL_calloc(1, sizeof(*pool));
+    if (!pool) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+
+    pool->workers = (SDL_JobWorker *) SDL_calloc(num_threads, sizeof(*pool->workers));
+    pool->lock = SDL_CreateMutex();
+    pool->wakeup = SDL_CreateCond();
+    if (!pool->workers || !pool->lock || !pool->wakeup) {
+        if (!pool->workers) {
+            SDL_OutOfMemory();
+        }
+        SDL_DestroyJobPool(pool);
+        return NULL;
+    }
+
+    for (i = 0; i < num_threads; ++i) {
+        SDL_JobWorker *worker = &pool->workers[pool->num_workers];
+        char name[64];
+
+        SDL_snprintf(name, sizeof (name), "SDLJobWorker%d", i);
+        worker->pool = pool;
+        worker->thread = SDL_CreateThread(SDL_JobWorkerThread, name, worker);
+        if (!worker->thread) {
+            /* We'll make do with the workers we have, or run jobs inline */
+            break;
+        }
+        ++pool->num_workers;
+    }
+    return pool;
+}
+
+SDL_JobPool *
+SDL_GetSharedJobPool(void)
+{
+    if (!SDL_shared_job_pool) {
+        SDL_AtomicLock(&SDL_shared_job_pool_lock);
+        if (!SDL_shared_job_pool) {
+            SDL_JobPool *pool = SDL_CreateJobPool(0);
+            SDL_MemoryBarrierRelease();
+            SDL_shared_job_pool = pool;
+        }
+        SDL_AtomicUnlock(&SDL_shared_job_pool_lock);
+    }
+    SDL_MemoryBarrierAcquire();
+    return SDL_shared_job_pool;
+}
+
+int
+SDL_GetJobPoolThreadCount(SDL_JobPool * pool)
+{
+    if (!pool) {
+        pool = SDL_GetSharedJobPool();
+        if (!pool) {
+            return 0;
+        }
+    }
+    return pool->num_workers;
+}
+
+void
+SDL_DestroyJobPool(SDL_JobPool * pool)
+{
+    int i;
+
+    if (!pool) {
+        return;
+    }
+
+    if (pool->lock) {
+        SDL_LockMutex(pool->lock);
+        SDL_AtomicSet(&pool->quit, 1);
+        SDL_CondBroadcast(pool->wakeup);
+        SDL_UnlockMutex(pool->lock);
+    }
+
+    /* The workers drain their queues before exiting */
+    for (i = 0; i < pool->num_workers; ++i) {
+        SDL_WaitThread(pool->workers[i].thread, NULL);
+    }
+
+    if (pool->wakeup) {
+        SDL_DestroyCond(pool->wakeup);
+    }
+    if (pool->lock) {
+        SDL_DestroyMutex(pool->lock);
+    }
+    SDL_free(pool->workers);
+    SDL_free(pool);
+}
+
+SDL_JobGroup *
+SDL_CreateJobGroup(SDL_JobPool * pool)
+{
+    SDL_JobGroup *group;
+
+    if (!pool) {
+        pool = SDL_GetSharedJobPool();
+        if (!pool) {
+            return NULL;
+        }
+    }
+
+    group = (SDL_JobGroup *) SDL_calloc(1, sizeof(*group));
+    if (!group) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    group->pool = pool;
+    group->lock = SDL_CreateMutex();
+    group->done = SDL_CreateCond();
+    if (!group->lock || !group->done) {
+        SDL_DestroyJobGroup(group);
+        return NULL;
+    }
+    return group;
+}
+
+int
+SDL_SubmitJob(SDL_JobGroup * group, SDL_JobFunction fn, void *data)
+{
+    SDL_JobPool *pool;
+    SDL_JobWorker *self;
+    SDL_Job job;
+    SDL_bool queued = SDL_FALSE;
+
+    if (!group) {
+        return SDL_InvalidParamError("group");
+    }
+    if (!fn) {
+        return SDL_InvalidParamError("fn");
+    }
+
+    pool = group->pool;
+    job.fn = fn;
+    job.data = data;
+    job.group = group;
+    SDL_AtomicIncRef(&group->pending);
+
+    if (pool->num_workers > 0) {
+        self = SDL_GetCurrentWorker(pool);
+        if (self) {
+            queued = SDL_PushJob(self, &job);
+        }
+        if (!queued) {
+            int i, first;
+
+            first = SDL_AtomicAdd(&pool->next_worker, 1);
+            for (i = 0; i < pool->num_workers && !queued; ++i) {
+                int index = (int)((unsigned int)(first + i) % pool->num_workers);
+                queued = SDL_PushJob(&pool->workers[index], &job);
+            }
+        }
+    }
+
+    if (!queued) {
+        /* No workers, or every queue is full, just do it ourselves */
+        SDL_RunJob(&job);
+        return 0;
+    }
+
+    SDL_AtomicIncRef(&pool->queued);
+    if (SDL_AtomicGet(&pool->sleeping) > 0) {
+        SDL_LockMutex(pool->lock);
+        SDL_CondSignal(pool->wakeup);
+        SDL_UnlockMutex(pool->lock);
+    }
+    return 0;
+}
+
+int
+SDL_WaitJobGroup(SDL_JobGroup * group)
+{
+    SDL_JobPool *pool;
+    SDL_JobWorker *self;
+    SDL_Job job;
+
+    if (!group) {
+        return SDL_InvalidParamError("group");
+    }
+
+    pool = group->pool;
+    self = SDL_GetCurrentWorker(pool);
+    while (SDL_AtomicGet(&group->pending) > 0) {
+        /* Help out while we wait, this also keeps nested waits from
+           starving the pool of workers.
+         */
+        if (SDL_FindJob(pool, self, &job)) {
+            SDL_RunJob(&job);
+            continue;
+        }
+
+        /* The rest of the group's jobs are running on other threads */
+        SDL_LockMutex(group->lock);
+        if (SDL_AtomicGet(&group->pending) > 0) {
+            SDL_CondWait(group->done, group->lock);
+        }
+        SDL_UnlockMutex(group->lock);
+    }
+
+    /* Wait for the last job to finish signalling us */
+    while (SDL_AtomicGet(&group->signalling) > 0) {
+        SDL_CPUPauseInstruction();
+    }
+    return 0;
+}
+
+void
+SDL_DestroyJobGroup(SDL_JobGroup * group)
+{
+    if (!group) {
+        return;
+    }
+
+    if (group->lock && group->done) {
+        SDL_WaitJobGroup(group);
+    }
+    if (group->done) {
+        SDL_DestroyCond(group->done);
+    }
+    if (group->lock) {
+        SDL_DestroyMutex(group->lock);
+    }
+    SDL_free(group);
+}
+
+static void SDLCALL
+SDL_ParallelForJob(void *data)
+{
+    SDL_ParallelForRange *range = (SDL_ParallelForRange *) data;
+
+    range->fn(range->data, range->start, range->end);
+}
+
+int
+SDL_ParallelFor(SDL_JobPool * pool, int start, int end, int grain,
+                SDL_ParallelForFunction fn, void *data)
+{
+    SDL_ParallelForRange *ranges;
+    SDL_JobGroup *group;
+    int count, num_ranges, i;
+
+    if (!fn) {
+        return SDL_InvalidParamError("fn");
+    }
+    if (end <= start) {
+        return 0;
+    }
+    if (!pool) {
+        pool = SDL_GetSharedJobPool();
+    }
+
+    count = end - start;
+    if (grain <= 0) {
+        /* A few ranges per worker, so stealing can even out the load */
+        int parts = pool ? (pool->num_workers + 1) * 4 : 1;
+        grain = (count + parts - 1) / parts;
+    }
+    num_ranges = (count + grain - 1) / grain;
+
+    if (!pool || pool->num_workers == 0 || num_ranges <= 1) {
+        fn(data, start, end);
+        return 0;
+    }
+
+    ranges = (SDL_ParallelForRange *) SDL_malloc(num_ranges * sizeof(*ranges));
+    group = SDL_CreateJobGroup(pool);
+    if (!ranges || !group) {
+        SDL_free(ranges);
+        SDL_DestroyJobGroup(group);
+        fn(data, start, end);
+        return 0;
+    }
+
+    for (i = 0; i < num_ranges; ++i) {
+        ranges[i].fn = fn;
+        ranges[i].data = data;
+        ranges[i].start = start + i * grain;
+        ranges[i].end = SDL_min(ranges[i].start + grain, end);
+    }
+
+    /* Queue all but the first range, and run that one ourselves */
+    for (i = 1; i < num_ranges; ++i) {
+        SDL_SubmitJob(group, SDL_ParallelForJob, &ranges[i]);
+    }
+    SDL_ParallelForJob(&ranges[0]);
+
+    SDL_DestroyJobGroup(group);
+    SDL_free(ranges);
+    return 0;
+}
+
+/* Sorting chunks and merging runs are independent, so the parallel sort
+   runs each step with SDL_ParallelFor().  Merges are split into pieces at
+   matching positions in both runs, so the last ones still use every worker.
+ */
+typedef struct SDL_ParallelSortData
+{
+    char *src;
+    char *dst;
+    size_t nmemb;
+    size_t size;
+    int (*compare) (const void *, const void *);
+    int num_chunks;     /* The number of sorted runs at the start */
+    int run_chunks;     /* The number of chunks in each run being merged */
+    int pieces;         /* The number of pieces each merge is split into */
+} SDL_ParallelSortData;
+
+static size_t
+SDL_GetSortChunkStart(const SDL_ParallelSortData *sort, int chunk)
+{
+    return (size_t) (((Uint64) sort->nmemb * chunk) / sort->num_chunks);
+}
+
+static void SDLCALL
+SDL_SortChunks(void *data, int start, int end)
+{
+    SDL_ParallelSortData *sort = (SDL_ParallelSortData *) data;
+    int i;
+
+    for (i = start; i < end; ++i) {
+        const size_t first = SDL_GetSortChunkStart(sort, i);
+        const size_t last = SDL_GetSortChunkStart(sort, i + 1);
+        SDL_qsort(sort->src + first * sort->size, last - first, sort->size, sort->compare);
+    }
+}
+
+/* Find how many of the first k merged elements come from run a */
+static size_t
+SDL_MergeSplit(const SDL_ParallelSortData *sort, const char *a, size_t na,
+               const char *b, size_t nb, size_t k)
+{
+    const size_t size = sort->size;
+    size_t lo = (k > nb) ? (k - nb) : 0;
+    size_t hi = SDL_min(k, na);
+
+    while (lo < hi) {
+        const size_t i = lo + (hi - lo) / 2;
+        /* Equal elements are taken from a first */
+        if (sort->compare(a + i * size, b + (k - i - 1) * size) <= 0) {
+            lo = i + 1;
+        } else {
+            hi = i;
+        }
+    }
+    return lo;
+}
+
+static void SDLCALL
+SDL_MergeRuns(void *data, int start, int end)
+{
+    SDL_ParallelSortData *sort = (SDL_ParallelSortData *) data;
+    const size_t size = sort->size;
+    int t;
+
+    for (t = start; t < end; ++t) {
+        const int merge = t / sort->pieces;
+        const int piece = t % sort->pieces;
+        const int chunk = merge * 2 * sort->run_chunks;
+        const size_t first = SDL_GetSortChunkStart(sort, chunk);
+        const size_t middle = SDL_GetSortChunkStart(sort, SDL_min(chunk + sort->run_chunks, sort->num_chunks));
+        const size_t last = SDL_GetSortChunkStart(sort, SDL_min(chunk + 2 * sort->run_chunks, sort->num_chunks));
+        const char *a = sort->src + first * size;
+        const char *b = sort->src + middle * size;
+        const size_t na = middle - first;
+        const size_t nb = last - middle;
+        const size_t k0 = ((Uint64) (na + nb) * piece) / sort->pieces;
+        const size_t k1 = ((Uint64) (na + nb) * (piece + 1)) / sort->pieces;
+        size_t i = SDL_MergeSplit(sort, a, na, b, nb, k0);
+        size_t j = k0 - i;
+        const size_t iend = SDL_MergeSplit(sort, a, na, b, nb, k1);
+        const size_t jend = k1 - iend;
+        char *dst = sort->dst + (first + k0) * size;
+
+        while (i < iend && j < jend) {
+            if (sort->compare(a + i * size, b + j * size) <= 0) {
+                SDL_memcpy(dst, a + i * size, size);
+                ++i;
+            } else {
+                SDL_memcpy(dst, b + j * size, size);
+                ++j;
+            }
+            dst += size;
+        }
+        SDL_memcpy(dst, a + i * size, (iend - i) * size);
+        dst += (iend - i) * size;
+        SDL_memcpy(dst, b + j * size, (jend - j) * size);
+    }
+}
+
+int
+SDL_ParallelSort(SDL_JobPool * pool, void *base, size_t nmemb, size_t size,
+                 int (*compare) (const void *, const void *))
+{
+    /* Below this many elements per chunk it's not worth using workers */
+    const size_t min_chunk = 4096;
+    SDL_ParallelSortData sort;
+    char *scratch;
+    int workers;
+
+    if (!compare) {
+        return SDL_InvalidParamError("compare");
+    }
+    if (nmemb <= 1 || size == 0) {
+        return 0;
+    }
+    if (!base) {
+        return SDL_InvalidParamError("base");
+    }
+    if (!pool) {
+        pool = SDL_GetSharedJobPool();
+    }
+
+    workers = pool ? pool->num_workers + 1 : 1;
+    sort.num_chunks = 1;
+    while (sort.num_chunks < workers && sort.num_chunks < 1024 &&
+           nmemb / (sort.num_chunks * 2) >= min_chunk) {
+        sort.num_chunks *= 2;
+    }
+    scratch = (sort.num_chunks > 1) ? (char *) SDL_malloc(nmemb * size) : NULL;
+    if (!scratch) {
+        SDL_qsort(base, nmemb, size, compare);
+        return 0;
+    }
+
+    sort.src = (char *) base;
+    sort.dst = scratch;
+    sort.nmemb = nmemb;
+    sort.size = size;
+    sort.compare = compare;
+    SDL_ParallelFor(pool, 0, sort.num_chunks, 1, SDL_SortChunks, &sort);
+
+    for (sort.run_chunks = 1; sort.run_chunks < sort.num_chunks; sort.run_chunks *= 2) {
+        const int merges = sort.num_chunks / (sort.run_chunks * 2);
+        char *swap;
+
+        sort.pieces = (workers + merges - 1) / merges;
+        SDL_ParallelFor(pool, 0, merges * sort.pieces, 1, SDL_MergeRuns, &sort);
+
+        swap = sort.src;
+        sort.src = sort.dst;
+        sort.dst = swap;
+    }
+
+    if (sort.src != (char *) base) {
+        SDL_memcpy(base, sort.src, nmemb * size);
+    }
+    SDL_free(scratch);
+    return 0;
+}
+
+void
+SDL_JobsQuit(void)
+{
+    SDL_JobPool *pool;
+
+    SDL_AtomicLock(&SDL_shared_job_pool_lock);
+    pool = SDL_shared_job_pool;
+    SDL_shared_job_pool = NULL;
+    SDL_AtomicUnlock(&SDL_shared_job_pool_lock);
+
+    SDL_DestroyJobPool(pool);
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
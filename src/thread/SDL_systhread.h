@@ -30,7 +30,8 @@
 
 /* This function creates a thread, passing args to SDL_RunThread(),
    saves a system-dependent thread id in thread->id, and returns 0
-   on success.
+   on success.  If thread->stacksize is not 0 it is used as the size
+   of the new thread's stack.
 */
 #ifdef SDL_PASSED_BEGINTHREAD_ENDTHREAD
 extern int SDL_SYS_CreateThread(SDL_Thread * thread, void *args,
@@ -46,6 +47,12 @@ extern void SDL_SYS_SetupThread(const char *name);
 /* This function sets the current thread priority */
 extern int SDL_SYS_SetThreadPriority(SDL_ThreadPriority priority);
 
+/* These functions set and get the CPU cores a thread may run on.
+   The thread is NULL for the current thread.
+ */
+extern int SDL_SYS_SetThreadAffinity(SDL_Thread * thread, Uint64 cpu_mask);
+extern int SDL_SYS_GetThreadAffinity(SDL_Thread * thread, Uint64 *cpu_mask);
+
 /* This function waits for the thread to finish and frees any data
    allocated by SDL_SYS_CreateThread()
  */
@@ -23,9 +23,25 @@
 /* System independent thread management routines for SDL */
 
 #include "SDL_thread.h"
+#include "SDL_hints.h"
+#include "SDL_cpuinfo.h"
 #include "SDL_thread_c.h"
 #include "SDL_systhread.h"
 #include "../SDL_error_c.h"
+#include "../stdlib/SDL_malloc_c.h"
+
+
+#ifdef SDL_THREAD_LOCAL
+/* The compiler keeps track of these for us, so we don't need the OS */
+static SDL_THREAD_LOCAL SDL_TLSData *SDL_thread_local_storage;
+static SDL_THREAD_LOCAL SDL_error SDL_thread_errbuf;
+
+#define SDL_GetTLSData()        SDL_thread_local_storage
+#define SDL_SetTLSData(data)    (SDL_thread_local_storage = (data), 0)
+#else
+#define SDL_GetTLSData()        SDL_SYS_GetTLSData()
+#define SDL_SetTLSData(data)    SDL_SYS_SetTLSData(data)
+#endif
 
 
 SDL_TLSID
@@ -40,7 +56,7 @@ SDL_TLSGet(SDL_TLSID id)
 {
     SDL_TLSData *storage;
 
-    storage = SDL_SYS_GetTLSData();
+    storage = SDL_GetTLSData();
     if (!storage || id == 0 || id > storage->limit) {
         return NULL;
     }
@@ -56,7 +72,7 @@ SDL_TLSSet(SDL_TLSID id, const void *value, void (*destructor)(void *))
         return SDL_InvalidParamError("id");
     }
 
-    storage = SDL_SYS_GetTLSData();
+    storage = SDL_GetTLSData();
     if (!storage || (id > storage->limit)) {
         unsigned int i, oldlimit, newlimit;
 
@@ -71,7 +87,7 @@ SDL_TLSSet(SDL_TLSID id, const void *value, void (*destructor)(void *))
             storage->array[i].data = NULL;
             storage->array[i].destructor = NULL;
         }
-        if (SDL_SYS_SetTLSData(storage) != 0) {
+        if (SDL_SetTLSData(storage) != 0) {
             return -1;
         }
     }
@@ -86,7 +102,7 @@ SDL_TLSCleanup()
 {
     SDL_TLSData *storage;
 
-    storage = SDL_SYS_GetTLSData();
+    storage = SDL_GetTLSData();
     if (storage) {
         unsigned int i;
         for (i = 0; i < storage->limit; ++i) {
@@ -94,7 +110,7 @@ SDL_TLSCleanup()
                 storage->array[i].destructor(storage->array[i].data);
             }
         }
-        SDL_SYS_SetTLSData(NULL);
+        (void)SDL_SetTLSData(NULL);
         SDL_free(storage);
     }
 }
@@ -103,106 +119,141 @@ SDL_TLSCleanup()
 /* This is a generic implementation of thread-local storage which doesn't
    require additional OS support.
 
-   It is not especially efficient and doesn't clean up thread-local storage
-   as threads exit.  If there is a real OS that doesn't support thread-local
-   storage this implementation should be improved to be production quality.
+   Threads are hashed by id into a fixed set of buckets, each of which is
+   a list of entries that is only ever pushed onto, so lookups don't need
+   a lock.  When a thread clears its storage the entry is released for
+   another thread to claim, so the lists only grow as large as the number
+   of threads alive at once.
+
+   It doesn't clean up thread-local storage as threads exit, other than
+   for threads created with SDL_CreateThread().
 */
 
+#define SDL_TLS_BUCKETS 64
+
 typedef struct SDL_TLSEntry {
-    SDL_threadID thread;
+    void *owner;    /* The thread id of the thread using this, or NULL */
     SDL_TLSData *storage;
     struct SDL_TLSEntry *next;
 } SDL_TLSEntry;
 
-static SDL_mutex *SDL_generic_TLS_mutex;
-static SDL_TLSEntry *SDL_generic_TLS;
+static SDL_TLSEntry *SDL_generic_TLS[SDL_TLS_BUCKETS];
+
+static SDL_TLSEntry **
+SDL_Generic_GetTLSBucket(SDL_threadID thread)
+{
+    /* Thread ids are often aligned addresses, so mix in the high bits */
+    size_t hash = (size_t)thread;
+    hash ^= (hash >> 16);
+    hash ^= (hash >> 8);
+    return &SDL_generic_TLS[hash % SDL_TLS_BUCKETS];
+}
 
+static SDL_TLSEntry *
+SDL_Generic_FindTLSEntry(SDL_TLSEntry **bucket, void *owner)
+{
+    SDL_TLSEntry *entry = (SDL_TLSEntry *)SDL_AtomicGetPtr((void **)bucket);
+
+    /* Pairs with the CAS that published the entry */
+    SDL_MemoryBarrierAcquire();
+    for ( ; entry; entry = entry->next) {
+        if (SDL_AtomicGetPtr(&entry->owner) == owner) {
+            return entry;
+        }
+    }
+    return NULL;
+}
 
 SDL_TLSData *
 SDL_Generic_GetTLSData()
 {
+#if SDL_THREADS_DISABLED
+    return SDL_generic_TLS[0] ? SDL_generic_TLS[0]->storage : NULL;
+#else
     SDL_threadID thread = SDL_ThreadID();
     SDL_TLSEntry *entry;
-    SDL_TLSData *storage = NULL;
 
-#if !SDL_THREADS_DISABLED
-    if (!SDL_generic_TLS_mutex) {
-        static SDL_SpinLock tls_lock;
-        SDL_AtomicLock(&tls_lock);
-        if (!SDL_generic_TLS_mutex) {
-            SDL_mutex *mutex = SDL_CreateMutex();
-            SDL_MemoryBarrierRelease();
-            SDL_generic_TLS_mutex = mutex;
-            if (!SDL_generic_TLS_mutex) {
-                SDL_AtomicUnlock(&tls_lock);
-                return NULL;
-            }
-        }
-        SDL_AtomicUnlock(&tls_lock);
-    }
-#endif /* SDL_THREADS_DISABLED */
-
-    SDL_MemoryBarrierAcquire();
-    SDL_LockMutex(SDL_generic_TLS_mutex);
-    for (entry = SDL_generic_TLS; entry; entry = entry->next) {
-        if (entry->thread == thread) {
-            storage = entry->storage;
-            break;
-        }
-    }
-#if !SDL_THREADS_DISABLED
-    SDL_UnlockMutex(SDL_generic_TLS_mutex);
+    /* Only this thread ever changes the storage of its entry */
+    entry = SDL_Generic_FindTLSEntry(SDL_Generic_GetTLSBucket(thread), (void *)thread);
+    return entry ? entry->storage : NULL;
 #endif
-
-    return storage;
 }
 
 int
 SDL_Generic_SetTLSData(SDL_TLSData *storage)
 {
+#if SDL_THREADS_DISABLED
+    if (!SDL_generic_TLS[0]) {
+        SDL_generic_TLS[0] = (SDL_TLSEntry *)SDL_calloc(1, sizeof(SDL_TLSEntry));
+        if (!SDL_generic_TLS[0]) {
+            return SDL_OutOfMemory();
+        }
+    }
+    SDL_generic_TLS[0]->storage = storage;
+    return 0;
+#else
     SDL_threadID thread = SDL_ThreadID();
-    SDL_TLSEntry *prev, *entry;
-
-    /* SDL_Generic_GetTLSData() is always called first, so we can assume SDL_generic_TLS_mutex */
-    SDL_LockMutex(SDL_generic_TLS_mutex);
-    prev = NULL;
-    for (entry = SDL_generic_TLS; entry; entry = entry->next) {
-        if (entry->thread == thread) {
-            if (storage) {
-                entry->storage = storage;
-            } else {
-                if (prev) {
-                    prev->next = entry->next;
-                } else {
-                    SDL_generic_TLS = entry->next;
-                }
-                SDL_free(entry);
-            }
-            break;
+    SDL_TLSEntry **bucket = SDL_Generic_GetTLSBucket(thread);
+    SDL_TLSEntry *entry;
+
+    entry = SDL_Generic_FindTLSEntry(bucket, (void *)thread);
+    if (entry) {
+        entry->storage = storage;
+        if (!storage) {
+            /* Release the entry for another thread to use */
+            (void)SDL_AtomicSetPtr(&entry->owner, NULL);
         }
-        prev = entry;
+        return 0;
     }
-    if (!entry) {
-        entry = (SDL_TLSEntry *)SDL_malloc(sizeof(*entry));
-        if (entry) {
-            entry->thread = thread;
+    if (!storage) {
+        return 0;
+    }
+
+    /* Try to claim a released entry */
+    for (entry = (SDL_TLSEntry *)SDL_AtomicGetPtr((void **)bucket); entry; entry = entry->next) {
+        if (SDL_AtomicCASPtr(&entry->owner, NULL, (void *)thread)) {
             entry->storage = storage;
-            entry->next = SDL_generic_TLS;
-            SDL_generic_TLS = entry;
+            return 0;
         }
     }
-    SDL_UnlockMutex(SDL_generic_TLS_mutex);
 
+    /* Push a new entry onto the bucket */
+    entry = (SDL_TLSEntry *)SDL_malloc(sizeof(*entry));
     if (!entry) {
         return SDL_OutOfMemory();
     }
+    entry->owner = (void *)thread;
+    entry->storage = storage;
+    do {
+        entry->next = (SDL_TLSEntry *)SDL_AtomicGetPtr((void **)bucket);
+    } while (!SDL_AtomicCASPtr((void **)bucket, entry->next, entry));
+
     return 0;
+#endif /* SDL_THREADS_DISABLED */
+}
+
+int
+SDL_GetMutexSpinCount(void)
+{
+    const char *hint = SDL_GetHint(SDL_HINT_MUTEX_SPIN_COUNT);
+    int spin_count;
+
+    if (hint) {
+        spin_count = SDL_atoi(hint);
+        return (spin_count > 0) ? spin_count : 0;
+    }
+
+    /* Spinning only helps if the lock holder can run at the same time */
+    return (SDL_GetCPUCount() > 1) ? 100 : 0;
 }
 
 /* Routine to get the thread-specific error variable */
 SDL_error *
 SDL_GetErrBuf(void)
 {
+#ifdef SDL_THREAD_LOCAL
+    return &SDL_thread_errbuf;
+#else
     static SDL_SpinLock tls_lock;
     static SDL_bool tls_being_created;
     static SDL_TLSID tls_errbuf;
@@ -247,6 +298,7 @@ SDL_GetErrBuf(void)
         SDL_TLSSet(tls_errbuf, errbuf, SDL_free);
     }
     return errbuf;
+#endif /* SDL_THREAD_LOCAL */
 }
 
 
@@ -281,19 +333,22 @@ SDL_RunThread(void *data)
 
     /* Clean up thread-local storage */
     SDL_TLSCleanup();
+
+    /* Give back any memory this thread was holding on to */
+    SDL_FlushMallocCache();
 }
 
 #ifdef SDL_PASSED_BEGINTHREAD_ENDTHREAD
-#undef SDL_CreateThread
+#undef SDL_CreateThreadWithStackSize
 DECLSPEC SDL_Thread *SDLCALL
-SDL_CreateThread(int (SDLCALL * fn) (void *),
-                 const char *name, void *data,
-                 pfnSDL_CurrentBeginThread pfnBeginThread,
-                 pfnSDL_CurrentEndThread pfnEndThread)
+SDL_CreateThreadWithStackSize(int (SDLCALL * fn) (void *),
+                              const char *name, size_t stacksize, void *data,
+                              pfnSDL_CurrentBeginThread pfnBeginThread,
+                              pfnSDL_CurrentEndThread pfnEndThread)
 #else
 DECLSPEC SDL_Thread *SDLCALL
-SDL_CreateThread(int (SDLCALL * fn) (void *),
-                 const char *name, void *data)
+SDL_CreateThreadWithStackSize(int (SDLCALL * fn) (void *),
+                              const char *name, size_t stacksize, void *data)
 #endif
 {
     SDL_Thread *thread;
@@ -308,6 +363,7 @@ SDL_CreateThread(int (SDLCALL * fn) (void *),
     }
     SDL_memset(thread, 0, (sizeof *thread));
     thread->status = -1;
+    thread->stacksize = stacksize;
 
     /* Set up the arguments for the thread */
     if (name != NULL) {
@@ -366,6 +422,32 @@ SDL_CreateThread(int (SDLCALL * fn) (void *),
     return (thread);
 }
 
+#ifdef SDL_PASSED_BEGINTHREAD_ENDTHREAD
+#undef SDL_CreateThread
+DECLSPEC SDL_Thread *SDLCALL
+SDL_CreateThread(int (SDLCALL * fn) (void *),
+                 const char *name, void *data,
+                 pfnSDL_CurrentBeginThread pfnBeginThread,
+                 pfnSDL_CurrentEndThread pfnEndThread)
+#else
+DECLSPEC SDL_Thread *SDLCALL
+SDL_CreateThread(int (SDLCALL * fn) (void *),
+                 const char *name, void *data)
+#endif
+{
+    const char *hint = SDL_GetHint(SDL_HINT_THREAD_STACK_SIZE);
+    size_t stacksize = 0;
+
+    if (hint) {
+        stacksize = (size_t) SDL_strtoul(hint, NULL, 0);
+    }
+#ifdef SDL_PASSED_BEGINTHREAD_ENDTHREAD
+    return SDL_CreateThreadWithStackSize(fn, name, stacksize, data, pfnBeginThread, pfnEndThread);
+#else
+    return SDL_CreateThreadWithStackSize(fn, name, stacksize, data);
+#endif
+}
+
 SDL_threadID
 SDL_GetThreadID(SDL_Thread * thread)
 {
@@ -395,6 +477,24 @@ SDL_SetThreadPriority(SDL_ThreadPriority priority)
     return SDL_SYS_SetThreadPriority(priority);
 }
 
+int
+SDL_SetThreadAffinity(SDL_Thread * thread, Uint64 cpu_mask)
+{
+    if (!cpu_mask) {
+        return SDL_InvalidParamError("cpu_mask");
+    }
+    return SDL_SYS_SetThreadAffinity(thread, cpu_mask);
+}
+
+int
+SDL_GetThreadAffinity(SDL_Thread * thread, Uint64 *cpu_mask)
+{
+    if (!cpu_mask) {
+        return SDL_InvalidParamError("cpu_mask");
+    }
+    return SDL_SYS_GetThreadAffinity(thread, cpu_mask);
+}
+
 void
 SDL_WaitThread(SDL_Thread * thread, int *status)
 {
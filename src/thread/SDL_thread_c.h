@@ -52,6 +52,7 @@ struct SDL_Thread
     int status;
     SDL_error errbuf;
     char *name;
+    size_t stacksize;
     void *data;
 };
 
@@ -70,18 +71,39 @@ typedef struct {
 /* This is how many TLS entries we allocate at once */
 #define TLS_ALLOC_CHUNKSIZE 4
 
-/* Get cross-platform, slow, thread local storage for this thread.
+/* Compiler supported thread local variables, which are much faster to
+   get at than the OS thread local storage APIs.  These are only used on
+   platforms where they're known to work in shared libraries that are
+   loaded at runtime.
+ */
+#if SDL_THREADS_DISABLED
+#define SDL_THREAD_LOCAL    /* Only one thread, so plain variables will do */
+#elif defined(__GNUC__) && (defined(__LINUX__) && !defined(__ANDROID__) || \
+      defined(__FREEBSD__) || defined(__NETBSD__) || defined(__OPENBSD__))
+#define SDL_THREAD_LOCAL __thread
+#elif defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L) && \
+      !defined(__STDC_NO_THREADS__) && !defined(__MACOSX__) && \
+      !defined(__IPHONEOS__) && !defined(__ANDROID__)
+#define SDL_THREAD_LOCAL _Thread_local
+#endif
+
+/* Get cross-platform thread local storage for this thread.
    This is only intended as a fallback if getting real thread-local
    storage fails or isn't supported on this platform.
  */
 extern SDL_TLSData *SDL_Generic_GetTLSData();
 
-/* Set cross-platform, slow, thread local storage for this thread.
+/* Set cross-platform thread local storage for this thread.
    This is only intended as a fallback if getting real thread-local
    storage fails or isn't supported on this platform.
  */
 extern int SDL_Generic_SetTLSData(SDL_TLSData *data);
 
+/* Get the number of times a contended mutex is polled before blocking.
+   This is read from SDL_HINT_MUTEX_SPIN_COUNT when a mutex is created.
+ */
+extern int SDL_GetMutexSpinCount(void);
+
 #endif /* _SDL_thread_c_h */
 
 /* vi: set ts=4 sw=4 expandtab: */
@@ -113,6 +113,18 @@ SDL_SYS_SetThreadPriority(SDL_ThreadPriority priority)
     return 0;
 }
 
+int
+SDL_SYS_SetThreadAffinity(SDL_Thread * thread, Uint64 cpu_mask)
+{
+    return SDL_Unsupported();
+}
+
+int
+SDL_SYS_GetThreadAffinity(SDL_Thread * thread, Uint64 *cpu_mask)
+{
+    return SDL_Unsupported();
+}
+
 void
 SDL_SYS_WaitThread(SDL_Thread * thread)
 {
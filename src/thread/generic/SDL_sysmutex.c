@@ -31,6 +31,7 @@ struct SDL_mutex
     int recursive;
     SDL_threadID owner;
     SDL_sem *sem;
+    SDL_LockStats stats;
 };
 
 /* Create a mutex */
@@ -46,6 +47,7 @@ SDL_CreateMutex(void)
         mutex->sem = SDL_CreateSemaphore(1);
         mutex->recursive = 0;
         mutex->owner = 0;
+        SDL_zero(mutex->stats);
         if (!mutex->sem) {
             SDL_free(mutex);
             mutex = NULL;
@@ -89,9 +91,17 @@ SDL_LockMutex(SDL_mutex * mutex)
            We set the locking thread id after we obtain the lock
            so unlocks from other threads will fail.
          */
-        SDL_SemWait(mutex->sem);
-        mutex->owner = this_thread;
-        mutex->recursive = 0;
+        if (SDL_SemTryWait(mutex->sem) == 0) {
+            mutex->owner = this_thread;
+            mutex->recursive = 0;
+        } else {
+            SDL_SemWait(mutex->sem);
+            mutex->owner = this_thread;
+            mutex->recursive = 0;
+            ++mutex->stats.contended;
+            ++mutex->stats.sleeps;
+        }
+        ++mutex->stats.locks;
     }
 
     return 0;
@@ -124,6 +134,7 @@ SDL_TryLockMutex(SDL_mutex * mutex)
         if (retval == 0) {
             mutex->owner = this_thread;
             mutex->recursive = 0;
+            ++mutex->stats.locks;
         }
     }
 
@@ -162,4 +173,18 @@ SDL_mutexV(SDL_mutex * mutex)
 #endif /* SDL_THREADS_DISABLED */
 }
 
+int
+SDL_GetMutexStats(SDL_mutex * mutex, SDL_LockStats * stats)
+{
+    if (mutex == NULL) {
+        return SDL_SetError("Passed a NULL mutex");
+    }
+    if (stats == NULL) {
+        return SDL_InvalidParamError("stats");
+    }
+
+    *stats = mutex->stats;
+    return 0;
+}
+
 /* vi: set ts=4 sw=4 expandtab: */
@@ -0,0 +1,204 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2013 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "SDL_config.h"
+
+/* An implementation of read/write locks using a mutex and condition
+   variables.  Waiting writers block new readers, so a steady stream of
+   readers can't starve a writer out.
+ */
+
+#include "SDL_thread.h"
+
+struct SDL_rwlock
+{
+    SDL_mutex *lock;
+    SDL_cond *readers_cond;
+    SDL_cond *writers_cond;
+    int readers;            /* number of threads holding the lock to read */
+    int waiting_writers;    /* number of threads waiting to write */
+    SDL_threadID writer;    /* the thread holding the lock to write, or 0 */
+    SDL_bool writing;
+};
+
+/* Create a read/write lock */
+SDL_rwlock *
+SDL_CreateRWLock(void)
+{
+    SDL_rwlock *rwlock;
+
+    rwlock = (SDL_rwlock *) SDL_calloc(1, sizeof(*rwlock));
+    if (!rwlock) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+
+#if !SDL_THREADS_DISABLED
+    rwlock->lock = SDL_CreateMutex();
+    rwlock->readers_cond = SDL_CreateCond();
+    rwlock->writers_cond = SDL_CreateCond();
+    if (!rwlock->lock || !rwlock->readers_cond || !rwlock->writers_cond) {
+        SDL_DestroyRWLock(rwlock);
+        return NULL;
+    }
+#endif
+    return rwlock;
+}
+
+/* Free the read/write lock */
+void
+SDL_DestroyRWLock(SDL_rwlock * rwlock)
+{
+    if (rwlock) {
+        if (rwlock->writers_cond) {
+            SDL_DestroyCond(rwlock->writers_cond);
+        }
+        if (rwlock->readers_cond) {
+            SDL_DestroyCond(rwlock->readers_cond);
+        }
+        if (rwlock->lock) {
+            SDL_DestroyMutex(rwlock->lock);
+        }
+        SDL_free(rwlock);
+    }
+}
+
+int
+SDL_LockRWLockForReading(SDL_rwlock * rwlock)
+{
+#if SDL_THREADS_DISABLED
+    return 0;
+#else
+    if (rwlock == NULL) {
+        return SDL_SetError("Passed a NULL rwlock");
+    }
+
+    SDL_LockMutex(rwlock->lock);
+    while (rwlock->writing || rwlock->waiting_writers) {
+        SDL_CondWait(rwlock->readers_cond, rwlock->lock);
+    }
+    ++rwlock->readers;
+    SDL_UnlockMutex(rwlock->lock);
+    return 0;
+#endif /* SDL_THREADS_DISABLED */
+}
+
+int
+SDL_LockRWLockForWriting(SDL_rwlock * rwlock)
+{
+#if SDL_THREADS_DISABLED
+    return 0;
+#else
+    if (rwlock == NULL) {
+        return SDL_SetError("Passed a NULL rwlock");
+    }
+
+    SDL_LockMutex(rwlock->lock);
+    ++rwlock->waiting_writers;
+    while (rwlock->writing || rwlock->readers) {
+        SDL_CondWait(rwlock->writers_cond, rwlock->lock);
+    }
+    --rwlock->waiting_writers;
+    rwlock->writing = SDL_TRUE;
+    rwlock->writer = SDL_ThreadID();
+    SDL_UnlockMutex(rwlock->lock);
+    return 0;
+#endif /* SDL_THREADS_DISABLED */
+}
+
+int
+SDL_TryLockRWLockForReading(SDL_rwlock * rwlock)
+{
+#if SDL_THREADS_DISABLED
+    return 0;
+#else
+    int retval = SDL_MUTEX_TIMEDOUT;
+
+    if (rwlock == NULL) {
+        return SDL_SetError("Passed a NULL rwlock");
+    }
+
+    SDL_LockMutex(rwlock->lock);
+    if (!rwlock->writing && !rwlock->waiting_writers) {
+        ++rwlock->readers;
+        retval = 0;
+    }
+    SDL_UnlockMutex(rwlock->lock);
+    return retval;
+#endif /* SDL_THREADS_DISABLED */
+}
+
+int
+SDL_TryLockRWLockForWriting(SDL_rwlock * rwlock)
+{
+#if SDL_THREADS_DISABLED
+    return 0;
+#else
+    int retval = SDL_MUTEX_TIMEDOUT;
+
+    if (rwlock == NULL) {
+        return SDL_SetError("Passed a NULL rwlock");
+    }
+
+    SDL_LockMutex(rwlock->lock);
+    if (!rwlock->writing && !rwlock->readers) {
+        rwlock->writing = SDL_TRUE;
+        rwlock->writer = SDL_ThreadID();
+        retval = 0;
+    }
+    SDL_UnlockMutex(rwlock->lock);
+    return retval;
+#endif /* SDL_THREADS_DISABLED */
+}
+
+int
+SDL_UnlockRWLock(SDL_rwlock * rwlock)
+{
+#if SDL_THREADS_DISABLED
+    return 0;
+#else
+    int retval = 0;
+
+    if (rwlock == NULL) {
+        return SDL_SetError("Passed a NULL rwlock");
+    }
+
+    SDL_LockMutex(rwlock->lock);
+    if (rwlock->writing && rwlock->writer == SDL_ThreadID()) {
+        rwlock->writing = SDL_FALSE;
+        rwlock->writer = 0;
+        if (rwlock->waiting_writers) {
+            SDL_CondSignal(rwlock->writers_cond);
+        } else {
+            SDL_CondBroadcast(rwlock->readers_cond);
+        }
+    } else if (rwlock->readers > 0) {
+        if (--rwlock->readers == 0 && rwlock->waiting_writers) {
+            SDL_CondSignal(rwlock->writers_cond);
+        }
+    } else {
+        retval = SDL_SetError("rwlock not locked by this thread");
+    }
+    SDL_UnlockMutex(rwlock->lock);
+    return retval;
+#endif /* SDL_THREADS_DISABLED */
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
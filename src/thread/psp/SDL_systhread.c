@@ -51,7 +51,7 @@ int SDL_SYS_CreateThread(SDL_Thread *thread, void *args)
     }
 
     thread->handle = sceKernelCreateThread("SDL thread", ThreadEntry,
-                           priority, 0x8000,
+                           priority, thread->stacksize ? (int)thread->stacksize : 0x8000,
                            PSP_THREAD_ATTR_VFPU, NULL);
     if (thread->handle < 0) {
         return SDL_SetError("sceKernelCreateThread() failed");
@@ -98,5 +98,15 @@ int SDL_SYS_SetThreadPriority(SDL_ThreadPriority priority)
 
 }
 
+int SDL_SYS_SetThreadAffinity(SDL_Thread * thread, Uint64 cpu_mask)
+{
+    return SDL_Unsupported();
+}
+
+int SDL_SYS_GetThreadAffinity(SDL_Thread * thread, Uint64 *cpu_mask)
+{
+    return SDL_Unsupported();
+}
+
 /* vim: ts=4 sw=4
  */
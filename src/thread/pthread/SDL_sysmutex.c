@@ -25,6 +25,8 @@
 #include <errno.h>
 
 #include "SDL_thread.h"
+#include "SDL_atomic.h"
+#include "../SDL_thread_c.h"
 
 #if !SDL_THREAD_PTHREAD_RECURSIVE_MUTEX && \
     !SDL_THREAD_PTHREAD_RECURSIVE_MUTEX_NP
@@ -38,8 +40,56 @@ struct SDL_mutex
     int recursive;
     pthread_t owner;
 #endif
+    int spin_count;
+    SDL_LockStats stats;
 };
 
+/* Acquire the underlying pthread mutex, polling it for a while before
+   going to sleep in the kernel.  On Linux the blocking path is a futex
+   wait, so an uncontended or briefly contended lock never leaves user
+   space.
+
+   The statistics are updated after the lock is acquired, so they don't
+   need any extra synchronization.
+ */
+static int
+SDL_AdaptiveLock(SDL_mutex * mutex)
+{
+    int spins = 0;
+    int backoff = 1;
+
+    if (pthread_mutex_trylock(&mutex->id) == 0) {
+        ++mutex->stats.locks;
+        return 0;
+    }
+
+    while (spins < mutex->spin_count) {
+        int i;
+        for (i = 0; i < backoff; ++i) {
+            SDL_CPUPauseInstruction();
+        }
+        spins += backoff;
+        if (backoff < 16) {
+            backoff <<= 1;
+        }
+        if (pthread_mutex_trylock(&mutex->id) == 0) {
+            ++mutex->stats.locks;
+            ++mutex->stats.contended;
+            mutex->stats.spins += spins;
+            return 0;
+        }
+    }
+
+    if (pthread_mutex_lock(&mutex->id) != 0) {
+        return -1;
+    }
+    ++mutex->stats.locks;
+    ++mutex->stats.contended;
+    ++mutex->stats.sleeps;
+    mutex->stats.spins += spins;
+    return 0;
+}
+
 SDL_mutex *
 SDL_CreateMutex(void)
 {
@@ -57,6 +107,7 @@ SDL_CreateMutex(void)
 #else
         /* No extra attributes necessary */
 #endif
+        mutex->spin_count = SDL_GetMutexSpinCount();
         if (pthread_mutex_init(&mutex->id, &attr) != 0) {
             SDL_SetError("pthread_mutex_init() failed");
             SDL_free(mutex);
@@ -98,7 +149,7 @@ SDL_LockMutex(SDL_mutex * mutex)
            We set the locking thread id after we obtain the lock
            so unlocks from other threads will fail.
          */
-        if (pthread_mutex_lock(&mutex->id) == 0) {
+        if (SDL_AdaptiveLock(mutex) == 0) {
             mutex->owner = this_thread;
             mutex->recursive = 0;
         } else {
@@ -106,7 +157,7 @@ SDL_LockMutex(SDL_mutex * mutex)
         }
     }
 #else
-    if (pthread_mutex_lock(&mutex->id) < 0) {
+    if (SDL_AdaptiveLock(mutex) < 0) {
         return SDL_SetError("pthread_mutex_lock() failed");
     }
 #endif
@@ -138,6 +189,7 @@ SDL_TryLockMutex(SDL_mutex * mutex)
         if (pthread_mutex_lock(&mutex->id) == 0) {
             mutex->owner = this_thread;
             mutex->recursive = 0;
+            ++mutex->stats.locks;
         } else if (errno == EBUSY) {
             retval = SDL_MUTEX_TIMEDOUT;
         } else {
@@ -151,6 +203,8 @@ SDL_TryLockMutex(SDL_mutex * mutex)
         } else {
             retval = SDL_SetError("pthread_mutex_trylock() failed");
         }
+    } else {
+        ++mutex->stats.locks;
     }
 #endif
     return retval;
@@ -190,4 +244,18 @@ SDL_UnlockMutex(SDL_mutex * mutex)
     return 0;
 }
 
+int
+SDL_GetMutexStats(SDL_mutex * mutex, SDL_LockStats * stats)
+{
+    if (mutex == NULL) {
+        return SDL_SetError("Passed a NULL mutex");
+    }
+    if (stats == NULL) {
+        return SDL_InvalidParamError("stats");
+    }
+
+    *stats = mutex->stats;
+    return 0;
+}
+
 /* vi: set ts=4 sw=4 expandtab: */
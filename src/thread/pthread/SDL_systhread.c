@@ -21,6 +21,9 @@
 
 #include "SDL_config.h"
 
+#ifdef __LINUX__
+#define _GNU_SOURCE             /* for cpu_set_t and the affinity functions */
+#endif
 #include <pthread.h>
 
 #if HAVE_PTHREAD_NP_H
@@ -30,6 +33,7 @@
 #include <signal.h>
 
 #ifdef __LINUX__
+#include <sched.h>
 #include <sys/time.h>
 #include <sys/resource.h>
 #include <sys/syscall.h>
@@ -101,10 +105,27 @@ SDL_SYS_CreateThread(SDL_Thread * thread, void *args)
     }
     pthread_attr_setdetachstate(&type, PTHREAD_CREATE_JOINABLE);
 
+    /* Set caller-requested stack size, rounded up to a page */
+    if (thread->stacksize) {
+        size_t stacksize = thread->stacksize;
+#ifdef PTHREAD_STACK_MIN
+        if (stacksize < PTHREAD_STACK_MIN) {
+            stacksize = PTHREAD_STACK_MIN;
+        }
+#endif
+        stacksize = (stacksize + 4095) & ~(size_t)4095;
+        if (pthread_attr_setstacksize(&type, stacksize) != 0) {
+            pthread_attr_destroy(&type);
+            return SDL_SetError("Couldn't set thread stack size");
+        }
+    }
+
     /* Create the thread and go! */
     if (pthread_create(&thread->handle, &type, RunThread, args) != 0) {
+        pthread_attr_destroy(&type);
         return SDL_SetError("Not enough resources to create thread");
     }
+    pthread_attr_destroy(&type);
 
     return 0;
 }
@@ -198,6 +219,91 @@ SDL_SYS_SetThreadPriority(SDL_ThreadPriority priority)
 #endif /* linux */
 }
 
+#if defined(__LINUX__) && defined(CPU_SETSIZE)
+static void
+MaskToCPUSet(Uint64 cpu_mask, cpu_set_t *set)
+{
+    int i;
+
+    CPU_ZERO(set);
+    for (i = 0; i < 64 && i < CPU_SETSIZE; ++i) {
+        if (cpu_mask & ((Uint64)1 << i)) {
+            CPU_SET(i, set);
+        }
+    }
+}
+
+static Uint64
+CPUSetToMask(const cpu_set_t *set)
+{
+    Uint64 cpu_mask = 0;
+    int i;
+
+    for (i = 0; i < 64 && i < CPU_SETSIZE; ++i) {
+        if (CPU_ISSET(i, set)) {
+            cpu_mask |= ((Uint64)1 << i);
+        }
+    }
+    return cpu_mask;
+}
+#endif
+
+int
+SDL_SYS_SetThreadAffinity(SDL_Thread * thread, Uint64 cpu_mask)
+{
+#if defined(__LINUX__) && defined(CPU_SETSIZE)
+    cpu_set_t set;
+
+    MaskToCPUSet(cpu_mask, &set);
+#ifdef __ANDROID__
+    /* Bionic doesn't have pthread_setaffinity_np(), and we don't keep
+       the kernel thread id of other threads around.
+     */
+    if (thread && thread->threadid != SDL_ThreadID()) {
+        return SDL_Unsupported();
+    }
+    if (sched_setaffinity(0, sizeof(set), &set) < 0) {
+        return SDL_SetError("sched_setaffinity() failed");
+    }
+#else
+    if (pthread_setaffinity_np(thread ? thread->handle : pthread_self(),
+                               sizeof(set), &set) != 0) {
+        return SDL_SetError("pthread_setaffinity_np() failed");
+    }
+#endif
+    return 0;
+#else
+    return SDL_Unsupported();
+#endif /* linux */
+}
+
+int
+SDL_SYS_GetThreadAffinity(SDL_Thread * thread, Uint64 *cpu_mask)
+{
+#if defined(__LINUX__) && defined(CPU_SETSIZE)
+    cpu_set_t set;
+
+    CPU_ZERO(&set);
+#ifdef __ANDROID__
+    if (thread && thread->threadid != SDL_ThreadID()) {
+        return SDL_Unsupported();
+    }
+    if (sched_getaffinity(0, sizeof(set), &set) < 0) {
+        return SDL_SetError("sched_getaffinity() failed");
+    }
+#else
+    if (pthread_getaffinity_np(thread ? thread->handle : pthread_self(),
+                               sizeof(set), &set) != 0) {
+        return SDL_SetError("pthread_getaffinity_np() failed");
+    }
+#endif
+    *cpu_mask = CPUSetToMask(&set);
+    return 0;
+#else
+    return SDL_Unsupported();
+#endif /* linux */
+}
+
 void
 SDL_SYS_WaitThread(SDL_Thread * thread)
 {
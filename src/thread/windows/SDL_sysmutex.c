@@ -26,12 +26,15 @@
 
 #include "../../core/windows/SDL_windows.h"
 
+#include "SDL_hints.h"
 #include "SDL_mutex.h"
+#include "../SDL_thread_c.h"
 
 
 struct SDL_mutex
 {
     CRITICAL_SECTION cs;
+    SDL_LockStats stats;
 };
 
 /* Create a mutex */
@@ -45,7 +48,10 @@ SDL_CreateMutex(void)
     if (mutex) {
         /* Initialize */
         /* On SMP systems, a non-zero spin count generally helps performance */
-        InitializeCriticalSectionAndSpinCount(&mutex->cs, 2000);
+        const char *hint = SDL_GetHint(SDL_HINT_MUTEX_SPIN_COUNT);
+        DWORD spin_count = hint ? (DWORD)SDL_GetMutexSpinCount() : 2000;
+        InitializeCriticalSectionAndSpinCount(&mutex->cs, spin_count);
+        SDL_zero(mutex->stats);
     } else {
         SDL_OutOfMemory();
     }
@@ -70,7 +76,16 @@ SDL_LockMutex(SDL_mutex * mutex)
         return SDL_SetError("Passed a NULL mutex");
     }
 
-    EnterCriticalSection(&mutex->cs);
+    /* The critical section does its own spinning, we can only tell
+       whether we had to wait at all.
+     */
+    if (TryEnterCriticalSection(&mutex->cs)) {
+        ++mutex->stats.locks;
+    } else {
+        EnterCriticalSection(&mutex->cs);
+        ++mutex->stats.locks;
+        ++mutex->stats.contended;
+    }
     return (0);
 }
 
@@ -85,6 +100,8 @@ SDL_TryLockMutex(SDL_mutex * mutex)
 
     if (TryEnterCriticalSection(&mutex->cs) == 0) {
         retval = SDL_MUTEX_TIMEDOUT;
+    } else {
+        ++mutex->stats.locks;
     }
     return retval;
 }
@@ -101,6 +118,20 @@ SDL_UnlockMutex(SDL_mutex * mutex)
     return (0);
 }
 
+int
+SDL_GetMutexStats(SDL_mutex * mutex, SDL_LockStats * stats)
+{
+    if (mutex == NULL) {
+        return SDL_SetError("Passed a NULL mutex");
+    }
+    if (stats == NULL) {
+        return SDL_InvalidParamError("stats");
+    }
+
+    *stats = mutex->stats;
+    return 0;
+}
+
 #endif /* SDL_THREAD_WINDOWS */
 
 /* vi: set ts=4 sw=4 expandtab: */
@@ -24,11 +24,16 @@
 
 /* Win32 thread management routines for SDL */
 
+#include "SDL_atomic.h"
 #include "SDL_thread.h"
 #include "../SDL_thread_c.h"
 #include "../SDL_systhread.h"
 #include "SDL_systhread_c.h"
 
+#ifndef STACK_SIZE_PARAM_IS_A_RESERVATION
+#define STACK_SIZE_PARAM_IS_A_RESERVATION 0x00010000
+#endif
+
 #ifndef SDL_PASSED_BEGINTHREAD_ENDTHREAD
 /* We'll use the C library from this DLL */
 #include <process.h>
@@ -129,15 +134,20 @@ SDL_SYS_CreateThread(SDL_Thread * thread, void *args)
     /* Also save the real parameters we have to pass to thread function */
     pThreadParms->args = args;
 
+    /* A non-zero stack size reserves that much address space instead of
+       the size in the executable header.
+     */
     if (pfnBeginThread) {
         unsigned threadid = 0;
         thread->handle = (SYS_ThreadHandle)
-            ((size_t) pfnBeginThread(NULL, 0, RunThreadViaBeginThreadEx,
-                                     pThreadParms, 0, &threadid));
+            ((size_t) pfnBeginThread(NULL, (unsigned) thread->stacksize,
+                                     RunThreadViaBeginThreadEx, pThreadParms,
+                                     STACK_SIZE_PARAM_IS_A_RESERVATION, &threadid));
     } else {
         DWORD threadid = 0;
-        thread->handle = CreateThread(NULL, 0, RunThreadViaCreateThread,
-                                      pThreadParms, 0, &threadid);
+        thread->handle = CreateThread(NULL, thread->stacksize,
+                                      RunThreadViaCreateThread, pThreadParms,
+                                      STACK_SIZE_PARAM_IS_A_RESERVATION, &threadid);
     }
     if (thread->handle == NULL) {
         return SDL_SetError("Not enough resources to create thread");
@@ -227,6 +237,78 @@ SDL_SYS_SetThreadPriority(SDL_ThreadPriority priority)
     return 0;
 }
 
+/* NtQueryInformationThread() reads a thread's affinity without changing it.
+   It isn't declared in the SDK headers, so it's looked up from ntdll.dll.
+ */
+typedef struct
+{
+    LONG ExitStatus;
+    PVOID TebBaseAddress;
+    HANDLE UniqueProcess;
+    HANDLE UniqueThread;
+    ULONG_PTR AffinityMask;
+    LONG Priority;
+    LONG BasePriority;
+} SDL_THREAD_BASIC_INFORMATION;
+
+typedef LONG (WINAPI *pfnNtQueryInformationThread) (HANDLE, int, PVOID,
+                                                    ULONG, PULONG);
+
+/* Keeps affinity changes out of the fallback query in SDL_SYS_GetThreadAffinity() */
+static SDL_SpinLock SDL_affinity_lock;
+
+int
+SDL_SYS_SetThreadAffinity(SDL_Thread * thread, Uint64 cpu_mask)
+{
+    HANDLE handle = thread ? thread->handle : GetCurrentThread();
+    DWORD_PTR result;
+
+    SDL_AtomicLock(&SDL_affinity_lock);
+    result = SetThreadAffinityMask(handle, (DWORD_PTR) cpu_mask);
+    SDL_AtomicUnlock(&SDL_affinity_lock);
+    if (!result) {
+        return WIN_SetError("SetThreadAffinityMask()");
+    }
+    return 0;
+}
+
+int
+SDL_SYS_GetThreadAffinity(SDL_Thread * thread, Uint64 *cpu_mask)
+{
+    HANDLE handle = thread ? thread->handle : GetCurrentThread();
+    HMODULE ntdll = GetModuleHandle(TEXT("ntdll.dll"));
+    pfnNtQueryInformationThread query = NULL;
+    SDL_THREAD_BASIC_INFORMATION info;
+    DWORD_PTR process_mask, system_mask, thread_mask;
+
+    if (ntdll) {
+        query = (pfnNtQueryInformationThread) GetProcAddress(ntdll, "NtQueryInformationThread");
+    }
+    if (query && query(handle, 0 /* ThreadBasicInformation */, &info, sizeof (info), NULL) >= 0) {
+        *cpu_mask = (Uint64) info.AffinityMask;
+        return 0;
+    }
+
+    /* Otherwise setting the affinity returns the previous mask, which we
+       then put back.  The lock keeps SDL_SYS_SetThreadAffinity() from
+       changing it in between and having its mask overwritten.
+     */
+    if (!GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask)) {
+        return WIN_SetError("GetProcessAffinityMask()");
+    }
+    SDL_AtomicLock(&SDL_affinity_lock);
+    thread_mask = SetThreadAffinityMask(handle, process_mask);
+    if (thread_mask) {
+        SetThreadAffinityMask(handle, thread_mask);
+    }
+    SDL_AtomicUnlock(&SDL_affinity_lock);
+    if (!thread_mask) {
+        return WIN_SetError("SetThreadAffinityMask()");
+    }
+    *cpu_mask = (Uint64) thread_mask;
+    return 0;
+}
+
 void
 SDL_SYS_WaitThread(SDL_Thread * thread)
 {
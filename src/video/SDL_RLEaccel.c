@@ -60,9 +60,6 @@
  *
  * Encoding of surfaces with per-pixel alpha:
  *
- *   The sequence begins with a struct RLEDestFormat describing the target
- *   pixel format, to provide reliable un-encoding.
- *
  *   Each scan line is encoded twice: First all completely opaque pixels,
  *   encoded in the target format as described above, and then all
  *   partially transparent (translucent) pixels (where 1 <= alpha <= 254),
@@ -83,13 +80,26 @@
  *
  *   The end of the sequence is marked by a zero <skip>,<run> pair at the
  *   beginning of an opaque line.
+ *
+ * Both encodings are preceded by the offset in the sequence where each scan
+ * line starts, as an array of Uint32, so clipped blits can start at any
+ * line. Lines after the last non-blank one start at the end marker.
+ *
+ * The surface keeps its pixels alongside the encoding, so nothing has to be
+ * decoded when it is locked. Unlocking drops the encoding, and it is made
+ * again from the pixels the next time the surface is blitted.
  */
 
 #include "SDL_video.h"
+#include "SDL_cpuinfo.h"
 #include "SDL_sysvideo.h"
 #include "SDL_blit.h"
 #include "SDL_RLEaccel_c.h"
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 #ifndef MAX
 #define MAX(a, b) ((a) > (b) ? (a) : (b))
 #endif
@@ -97,6 +107,12 @@
 #define MIN(a, b) ((a) < (b) ? (a) : (b))
 #endif
 
+/* The start of scan line y in the encoding of a surface */
+#define RLE_LINE(surface, y)                                \
+    ((Uint8 *) (surface)->map->data +                       \
+     (surface)->h * sizeof(Uint32) +                        \
+     ((Uint32 *) (surface)->map->data)[y])
+
 #define PIXEL_COPY(to, from, len, bpp)          \
     SDL_memcpy(to, from, (size_t)(len) * (bpp))
 
@@ -373,7 +389,8 @@
 
 /*
  * This takes care of the case when the surface is clipped on the left and/or
- * right. Top clipping has already been taken care of.
+ * right. Top clipping has already been taken care of, srcbuf is the start of
+ * the first line to blit.
  */
 static void
 RLEClipBlit(int w, Uint8 * srcbuf, SDL_Surface * dst,
@@ -455,51 +472,7 @@ SDL_RLEBlit(SDL_Surface * src, SDL_Rect * srcrect,
     y = dstrect->y;
     dstbuf = (Uint8 *) dst->pixels
         + y * dst->pitch + x * src->format->BytesPerPixel;
-    srcbuf = (Uint8 *) src->map->data;
-
-    {
-        /* skip lines at the top if necessary */
-        int vskip = srcrect->y;
-        int ofs = 0;
-        if (vskip) {
-
-#define RLESKIP(bpp, Type)          \
-        for(;;) {           \
-            int run;            \
-            ofs += *(Type *)srcbuf; \
-            run = ((Type *)srcbuf)[1];  \
-            srcbuf += sizeof(Type) * 2; \
-            if(run) {           \
-            srcbuf += run * bpp;    \
-            ofs += run;     \
-            } else if(!ofs)     \
-            goto done;      \
-            if(ofs == w) {      \
-            ofs = 0;        \
-            if(!--vskip)        \
-                break;      \
-            }               \
-        }
-
-            switch (src->format->BytesPerPixel) {
-            case 1:
-                RLESKIP(1, Uint8);
-                break;
-            case 2:
-                RLESKIP(2, Uint8);
-                break;
-            case 3:
-                RLESKIP(3, Uint8);
-                break;
-            case 4:
-                RLESKIP(4, Uint16);
-                break;
-            }
-
-#undef RLESKIP
-
-        }
-    }
+    srcbuf = RLE_LINE(src, srcrect->y);
 
     alpha = src->map->info.a;
     /* if left or right edge clipping needed, call clip blit */
@@ -537,7 +510,6 @@ SDL_RLEBlit(SDL_Surface * src, SDL_Rect * srcrect,
 #undef RLEBLIT
     }
 
-  done:
     /* Unlock the destination if necessary */
     if (SDL_MUSTLOCK(dst)) {
         SDL_UnlockSurface(dst);
@@ -598,26 +570,6 @@ SDL_RLEBlit(SDL_Surface * src, SDL_Rect * srcrect,
     dst = (Uint16)(d | d >> 16);            \
     } while(0)
 
-/* used to save the destination format in the encoding. Designed to be
-   macro-compatible with SDL_PixelFormat but without the unneeded fields */
-typedef struct
-{
-    Uint8 BytesPerPixel;
-    Uint8 padding[3];
-    Uint32 Rmask;
-    Uint32 Gmask;
-    Uint32 Bmask;
-    Uint32 Amask;
-    Uint8 Rloss;
-    Uint8 Gloss;
-    Uint8 Bloss;
-    Uint8 Aloss;
-    Uint8 Rshift;
-    Uint8 Gshift;
-    Uint8 Bshift;
-    Uint8 Ashift;
-} RLEDestFormat;
-
 /* blit a pixel-alpha RLE surface clipped at the right and/or left edges */
 static void
 RLEAlphaClipBlit(int w, Uint8 * srcbuf, SDL_Surface * dst,
@@ -730,63 +682,7 @@ SDL_RLEAlphaBlit(SDL_Surface * src, SDL_Rect * srcrect,
     x = dstrect->x;
     y = dstrect->y;
     dstbuf = (Uint8 *) dst->pixels + y * dst->pitch + x * df->BytesPerPixel;
-    srcbuf = (Uint8 *) src->map->data + sizeof(RLEDestFormat);
-
-    {
-        /* skip lines at the top if necessary */
-        int vskip = srcrect->y;
-        if (vskip) {
-            int ofs;
-            if (df->BytesPerPixel == 2) {
-                /* the 16/32 interleaved format */
-                do {
-                    /* skip opaque line */
-                    ofs = 0;
-                    do {
-                        int run;
-                        ofs += srcbuf[0];
-                        run = srcbuf[1];
-                        srcbuf += 2;
-                        if (run) {
-                            srcbuf += 2 * run;
-                            ofs += run;
-                        } else if (!ofs)
-                            goto done;
-                    } while (ofs < w);
-
-                    /* skip padding */
-                    srcbuf += (uintptr_t) srcbuf & 2;
-
-                    /* skip translucent line */
-                    ofs = 0;
-                    do {
-                        int run;
-                        ofs += ((Uint16 *) srcbuf)[0];
-                        run = ((Uint16 *) srcbuf)[1];
-                        srcbuf += 4 * (run + 1);
-                        ofs += run;
-                    } while (ofs < w);
-                } while (--vskip);
-            } else {
-                /* the 32/32 interleaved format */
-                vskip <<= 1;    /* opaque and translucent have same format */
-                do {
-                    ofs = 0;
-                    do {
-                        int run;
-                        ofs += ((Uint16 *) srcbuf)[0];
-                        run = ((Uint16 *) srcbuf)[1];
-                        srcbuf += 4;
-                        if (run) {
-                            srcbuf += 4 * run;
-                            ofs += run;
-                        } else if (!ofs)
-                            goto done;
-                    } while (ofs < w);
-                } while (--vskip);
-            }
-        }
-    }
+    srcbuf = RLE_LINE(src, srcrect->y);
 
     /* if left or right edge clipping needed, call clip blit */
     if (srcrect->x || srcrect->w != src->w) {
@@ -869,20 +765,117 @@ SDL_RLEAlphaBlit(SDL_Surface * src, SDL_Rect * srcrect,
  * Auxiliary functions:
  * The encoding functions take 32bpp rgb + a, and
  * return the number of bytes copied to the destination.
- * The decoding functions copy to 32bpp rgb + a, and
- * return the number of bytes copied from the source.
- * These are only used in the encoder and un-RLE code and are therefore not
- * highly optimised.
+ * They are used every time a surface is encoded, which happens again after
+ * each lock, so the common cases are done 4 pixels at a time with SSE2.
+ * That's only built when the compiler targets SSE2, so it runs without
+ * checking the CPU.
  */
 
+#ifdef __SSE2__
+/* Move one component of 4 pixels the way RGBA_FROM_8888 and PIXEL_FROM_RGBA
+   do, the masks and shift counts come from the source and target formats */
+#define CONVERT_SSE2(pixels, mask, sshift, loss, dshift)                \
+    _mm_sll_epi32(_mm_srl_epi32(_mm_srl_epi32(_mm_and_si128(pixels, mask), \
+                                              sshift), loss), dshift)
+
+typedef struct
+{
+    __m128i mask[4];
+    __m128i sshift[4];
+    __m128i loss[4];
+    __m128i dshift[4];
+} SSE2Convert;
+
+static void
+SetupConvertSSE2(SSE2Convert * cvt, SDL_PixelFormat * sfmt,
+                 SDL_PixelFormat * dfmt)
+{
+    cvt->mask[0] = _mm_set1_epi32(sfmt->Rmask);
+    cvt->mask[1] = _mm_set1_epi32(sfmt->Gmask);
+    cvt->mask[2] = _mm_set1_epi32(sfmt->Bmask);
+    cvt->mask[3] = _mm_set1_epi32(sfmt->Amask);
+    cvt->sshift[0] = _mm_cvtsi32_si128(sfmt->Rshift);
+    cvt->sshift[1] = _mm_cvtsi32_si128(sfmt->Gshift);
+    cvt->sshift[2] = _mm_cvtsi32_si128(sfmt->Bshift);
+    cvt->sshift[3] = _mm_cvtsi32_si128(sfmt->Ashift);
+    cvt->loss[0] = _mm_cvtsi32_si128(dfmt->Rloss);
+    cvt->loss[1] = _mm_cvtsi32_si128(dfmt->Gloss);
+    cvt->loss[2] = _mm_cvtsi32_si128(dfmt->Bloss);
+    cvt->loss[3] = _mm_cvtsi32_si128(dfmt->Aloss);
+    cvt->dshift[0] = _mm_cvtsi32_si128(dfmt->Rshift);
+    cvt->dshift[1] = _mm_cvtsi32_si128(dfmt->Gshift);
+    cvt->dshift[2] = _mm_cvtsi32_si128(dfmt->Bshift);
+    cvt->dshift[3] = _mm_cvtsi32_si128(dfmt->Ashift);
+}
+
+static SDL_INLINE __m128i
+ConvertRGBSSE2(const SSE2Convert * cvt, __m128i pixels)
+{
+    return _mm_or_si128(_mm_or_si128(
+        CONVERT_SSE2(pixels, cvt->mask[0], cvt->sshift[0], cvt->loss[0], cvt->dshift[0]),
+        CONVERT_SSE2(pixels, cvt->mask[1], cvt->sshift[1], cvt->loss[1], cvt->dshift[1])),
+        CONVERT_SSE2(pixels, cvt->mask[2], cvt->sshift[2], cvt->loss[2], cvt->dshift[2]));
+}
+
+/* copy_opaque_16() for sources with 8 bit components, 8 pixels at a time */
+static int
+copy_opaque_16_SSE2(Uint16 * d, Uint32 * src, int n,
+                    SDL_PixelFormat * sfmt, SDL_PixelFormat * dfmt)
+{
+    SSE2Convert cvt;
+    const __m128i amask = _mm_set1_epi32(dfmt->Amask);
+    int i;
+
+    SetupConvertSSE2(&cvt, sfmt, dfmt);
+    for (i = 0; i + 8 <= n; i += 8) {
+        __m128i lo = _mm_loadu_si128((const __m128i *) (src + i));
+        __m128i hi = _mm_loadu_si128((const __m128i *) (src + i + 4));
+        lo = _mm_or_si128(ConvertRGBSSE2(&cvt, lo), amask);
+        hi = _mm_or_si128(ConvertRGBSSE2(&cvt, hi), amask);
+        /* sign extend the low 16 bits so the saturating pack keeps them */
+        lo = _mm_srai_epi32(_mm_slli_epi32(lo, 16), 16);
+        hi = _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16);
+        _mm_storeu_si128((__m128i *) (d + i), _mm_packs_epi32(lo, hi));
+    }
+    return i;
+}
+
+/* copy_32(), 4 pixels at a time */
+static int
+copy_32_SSE2(Uint32 * d, Uint32 * src, int n,
+             SDL_PixelFormat * sfmt, SDL_PixelFormat * dfmt)
+{
+    SSE2Convert cvt;
+    int i;
+
+    SetupConvertSSE2(&cvt, sfmt, dfmt);
+    for (i = 0; i + 4 <= n; i += 4) {
+        __m128i pixels = _mm_loadu_si128((const __m128i *) (src + i));
+        __m128i alpha = CONVERT_SSE2(pixels, cvt.mask[3], cvt.sshift[3],
+                                     cvt.loss[3], cvt.dshift[3]);
+        _mm_storeu_si128((__m128i *) (d + i),
+                         _mm_or_si128(ConvertRGBSSE2(&cvt, pixels), alpha));
+    }
+    return i;
+}
+#endif /* __SSE2__ */
+
 /* encode 32bpp rgb + a into 16bpp rgb, losing alpha */
 static int
 copy_opaque_16(void *dst, Uint32 * src, int n,
                SDL_PixelFormat * sfmt, SDL_PixelFormat * dfmt)
 {
-    int i;
+    int i = 0;
     Uint16 *d = dst;
-    for (i = 0; i < n; i++) {
+#ifdef __SSE2__
+    /* RGB_FROM_PIXEL doesn't expand 8 bit components */
+    if (n >= 8 && !(sfmt->Rloss | sfmt->Gloss | sfmt->Bloss)) {
+        i = copy_opaque_16_SSE2(d, src, n, sfmt, dfmt);
+        src += i;
+        d += i;
+    }
+#endif
+    for (; i < n; i++) {
         unsigned r, g, b;
         RGB_FROM_PIXEL(*src, sfmt, r, g, b);
         PIXEL_FROM_RGB(*d, dfmt, r, g, b);
@@ -892,26 +885,6 @@ copy_opaque_16(void *dst, Uint32 * src, int n,
     return n * 2;
 }
 
-/* decode opaque pixels from 16bpp to 32bpp rgb + a */
-static int
-uncopy_opaque_16(Uint32 * dst, void *src, int n,
-                 RLEDestFormat * sfmt, SDL_PixelFormat * dfmt)
-{
-    int i;
-    Uint16 *s = src;
-    unsigned alpha = dfmt->Amask ? 255 : 0;
-    for (i = 0; i < n; i++) {
-        unsigned r, g, b;
-        RGB_FROM_PIXEL(*s, sfmt, r, g, b);
-        PIXEL_FROM_RGBA(*dst, dfmt, r, g, b, alpha);
-        s++;
-        dst++;
-    }
-    return n * 2;
-}
-
-
-
 /* encode 32bpp rgb + a into 32bpp G0RAB format for blitting into 565 */
 static int
 copy_transl_565(void *dst, Uint32 * src, int n,
@@ -950,33 +923,21 @@ copy_transl_555(void *dst, Uint32 * src, int n,
     return n * 4;
 }
 
-/* decode translucent pixels from 32bpp GORAB to 32bpp rgb + a */
-static int
-uncopy_transl_16(Uint32 * dst, void *src, int n,
-                 RLEDestFormat * sfmt, SDL_PixelFormat * dfmt)
-{
-    int i;
-    Uint32 *s = src;
-    for (i = 0; i < n; i++) {
-        unsigned r, g, b, a;
-        Uint32 pix = *s++;
-        a = (pix & 0x3e0) >> 2;
-        pix = (pix & ~0x3e0) | pix >> 16;
-        RGB_FROM_PIXEL(pix, sfmt, r, g, b);
-        PIXEL_FROM_RGBA(*dst, dfmt, r, g, b, a);
-        dst++;
-    }
-    return n * 4;
-}
-
 /* encode 32bpp rgba into 32bpp rgba, keeping alpha (dual purpose) */
 static int
 copy_32(void *dst, Uint32 * src, int n,
         SDL_PixelFormat * sfmt, SDL_PixelFormat * dfmt)
 {
-    int i;
+    int i = 0;
     Uint32 *d = dst;
-    for (i = 0; i < n; i++) {
+#ifdef __SSE2__
+    if (n >= 4) {
+        i = copy_32_SSE2(d, src, n, sfmt, dfmt);
+        src += i;
+        d += i;
+    }
+#endif
+    for (; i < n; i++) {
         unsigned r, g, b, a;
         RGBA_FROM_8888(*src, sfmt, r, g, b, a);
         PIXEL_FROM_RGBA(*d, dfmt, r, g, b, a);
@@ -986,24 +947,6 @@ copy_32(void *dst, Uint32 * src, int n,
     return n * 4;
 }
 
-/* decode 32bpp rgba into 32bpp rgba, keeping alpha (dual purpose) */
-static int
-uncopy_32(Uint32 * dst, void *src, int n,
-          RLEDestFormat * sfmt, SDL_PixelFormat * dfmt)
-{
-    int i;
-    Uint32 *s = src;
-    for (i = 0; i < n; i++) {
-        unsigned r, g, b, a;
-        Uint32 pixel = *s++;
-        RGB_FROM_PIXEL(pixel, sfmt, r, g, b);
-        a = pixel >> 24;
-        PIXEL_FROM_RGBA(*dst, dfmt, r, g, b, a);
-        dst++;
-    }
-    return n * 4;
-}
-
 #define ISOPAQUE(pixel, fmt) ((((pixel) & fmt->Amask) >> fmt->Ashift) == 255)
 
 #define ISTRANSL(pixel, fmt)    \
@@ -1019,7 +962,8 @@ RLEAlphaSurface(SDL_Surface * surface)
     int max_opaque_run;
     int max_transl_run = 65535;
     unsigned masksum;
-    Uint8 *rlebuf, *dst;
+    Uint8 *rlebuf, *stream, *dst;
+    Uint32 *lines;
     int (*copy_opaque) (void *, Uint32 *, int,
                         SDL_PixelFormat *, SDL_PixelFormat *);
     int (*copy_transl) (void *, Uint32 *, int,
@@ -1078,29 +1022,13 @@ RLEAlphaSurface(SDL_Surface * surface)
         return -1;              /* anything else unsupported right now */
     }
 
-    maxsize += sizeof(RLEDestFormat);
-    rlebuf = (Uint8 *) SDL_malloc(maxsize);
+    rlebuf = (Uint8 *) SDL_malloc(surface->h * sizeof(Uint32) + maxsize);
     if (!rlebuf) {
         return SDL_OutOfMemory();
     }
-    {
-        /* save the destination format so we can undo the encoding later */
-        RLEDestFormat *r = (RLEDestFormat *) rlebuf;
-        r->BytesPerPixel = df->BytesPerPixel;
-        r->Rmask = df->Rmask;
-        r->Gmask = df->Gmask;
-        r->Bmask = df->Bmask;
-        r->Amask = df->Amask;
-        r->Rloss = df->Rloss;
-        r->Gloss = df->Gloss;
-        r->Bloss = df->Bloss;
-        r->Aloss = df->Aloss;
-        r->Rshift = df->Rshift;
-        r->Gshift = df->Gshift;
-        r->Bshift = df->Bshift;
-        r->Ashift = df->Ashift;
-    }
-    dst = rlebuf + sizeof(RLEDestFormat);
+    lines = (Uint32 *) rlebuf;
+    stream = rlebuf + surface->h * sizeof(Uint32);
+    dst = stream;
 
     /* Do the actual encoding */
     {
@@ -1129,6 +1057,7 @@ RLEAlphaSurface(SDL_Surface * surface)
         for (y = 0; y < h; y++) {
             int runstart, skipstart;
             int blankline = 0;
+            lines[y] = (Uint32) (dst - stream);
             /* First encode all opaque pixels of a scan line */
             x = 0;
             do {
@@ -1200,18 +1129,15 @@ RLEAlphaSurface(SDL_Surface * surface)
             src += surface->pitch >> 2;
         }
         dst = lastline;         /* back up past trailing blank lines */
+        while (y-- > 0 && lines[y] > (Uint32) (dst - stream)) {
+            lines[y] = (Uint32) (dst - stream);
+        }
         ADD_OPAQUE_COUNTS(0, 0);
     }
 
 #undef ADD_OPAQUE_COUNTS
 #undef ADD_TRANSL_COUNTS
 
-    /* Now that we have it encoded, release the original pixels */
-    if (!(surface->flags & SDL_PREALLOC)) {
-        SDL_free(surface->pixels);
-        surface->pixels = NULL;
-    }
-
     /* realloc the buffer to release unused memory */
     {
         Uint8 *p = SDL_realloc(rlebuf, dst - rlebuf);
@@ -1223,18 +1149,6 @@ RLEAlphaSurface(SDL_Surface * surface)
     return 0;
 }
 
-static Uint32
-getpix_8(Uint8 * srcbuf)
-{
-    return *srcbuf;
-}
-
-static Uint32
-getpix_16(Uint8 * srcbuf)
-{
-    return *(Uint16 *) srcbuf;
-}
-
 static Uint32
 getpix_24(Uint8 * srcbuf)
 {
@@ -1245,28 +1159,63 @@ getpix_24(Uint8 * srcbuf)
 #endif
 }
 
-static Uint32
-getpix_32(Uint8 * srcbuf)
+/*
+ * Find the end of a run of pixels in a line starting at x, which are the
+ * colorkey if transparent is 1, or aren't if it's 0
+ */
+static int
+ScanColorkey(Uint8 * srcbuf, int x, int w, int bpp,
+             Uint32 ckey, Uint32 rgbmask, int transparent)
 {
-    return *(Uint32 *) srcbuf;
-}
+#define SCAN_COLORKEY(pixel)                                            \
+    while (x < w && (((pixel) & rgbmask) == ckey) == transparent)       \
+        x++;
 
-typedef Uint32(*getpix_func) (Uint8 *);
+    switch (bpp) {
+    case 1:
+        SCAN_COLORKEY(srcbuf[x]);
+        break;
+    case 2:
+        SCAN_COLORKEY(((Uint16 *) srcbuf)[x]);
+        break;
+    case 3:
+        SCAN_COLORKEY(getpix_24(srcbuf + x * 3));
+        break;
+    case 4:
+#ifdef __SSE2__
+        if (w - x >= 4) {
+            const __m128i key = _mm_set1_epi32(ckey);
+            const __m128i mask = _mm_set1_epi32(rgbmask);
+            const int all = transparent ? 0xFFFF : 0;
+
+            while (x + 4 <= w) {
+                __m128i pixels = _mm_loadu_si128((const __m128i *) (srcbuf + x * 4));
+                __m128i match = _mm_cmpeq_epi32(_mm_and_si128(pixels, mask), key);
+                if (_mm_movemask_epi8(match) != all) {
+                    break;
+                }
+                x += 4;
+            }
+        }
+#endif
+        SCAN_COLORKEY(((Uint32 *) srcbuf)[x]);
+        break;
+    }
+    return x;
 
-static const getpix_func getpixes[4] = {
-    getpix_8, getpix_16, getpix_24, getpix_32
-};
+#undef SCAN_COLORKEY
+}
 
 static int
 RLEColorkeySurface(SDL_Surface * surface)
 {
-    Uint8 *rlebuf, *dst;
+    Uint8 *rlebuf, *stream, *dst;
+    Uint32 *lines;
     int maxn;
     int y;
     Uint8 *srcbuf, *lastline;
     int maxsize = 0;
     int bpp = surface->format->BytesPerPixel;
-    getpix_func getpix;
     Uint32 ckey, rgbmask;
     int w, h;
 
@@ -1290,7 +1239,7 @@ RLEColorkeySurface(SDL_Surface * surface)
         break;
     }
 
-    rlebuf = (Uint8 *) SDL_malloc(maxsize);
+    rlebuf = (Uint8 *) SDL_malloc(surface->h * sizeof(Uint32) + maxsize);
     if (rlebuf == NULL) {
         return SDL_OutOfMemory();
     }
@@ -1298,11 +1247,12 @@ RLEColorkeySurface(SDL_Surface * surface)
     /* Set up the conversion */
     srcbuf = (Uint8 *) surface->pixels;
     maxn = bpp == 4 ? 65535 : 255;
-    dst = rlebuf;
+    lines = (Uint32 *) rlebuf;
+    stream = rlebuf + surface->h * sizeof(Uint32);
+    dst = stream;
     rgbmask = ~surface->format->Amask;
     ckey = surface->map->info.colorkey & rgbmask;
     lastline = dst;
-    getpix = getpixes[bpp - 1];
     w = surface->w;
     h = surface->h;
 
@@ -1320,17 +1270,16 @@ RLEColorkeySurface(SDL_Surface * surface)
     for (y = 0; y < h; y++) {
         int x = 0;
         int blankline = 0;
+        lines[y] = (Uint32) (dst - stream);
         do {
             int run, skip, len;
             int runstart;
             int skipstart = x;
 
             /* find run of transparent, then opaque pixels */
-            while (x < w && (getpix(srcbuf + x * bpp) & rgbmask) == ckey)
-                x++;
+            x = ScanColorkey(srcbuf, x, w, bpp, ckey, rgbmask, 1);
             runstart = x;
-            while (x < w && (getpix(srcbuf + x * bpp) & rgbmask) != ckey)
-                x++;
+            x = ScanColorkey(srcbuf, x, w, bpp, ckey, rgbmask, 0);
             skip = runstart - skipstart;
             if (skip == w)
                 blankline = 1;
@@ -1362,16 +1311,13 @@ RLEColorkeySurface(SDL_Surface * surface)
         srcbuf += surface->pitch;
     }
     dst = lastline;             /* back up bast trailing blank lines */
+    while (y-- > 0 && lines[y] > (Uint32) (dst - stream)) {
+        lines[y] = (Uint32) (dst - stream);
+    }
     ADD_COUNTS(0, 0);
 
 #undef ADD_COUNTS
 
-    /* Now that we have it encoded, release the original pixels */
-    if (!(surface->flags & SDL_PREALLOC)) {
-        SDL_free(surface->pixels);
-        surface->pixels = NULL;
-    }
-
     /* realloc the buffer to release unused memory */
     {
         /* If realloc returns NULL, the original block is left intact */
@@ -1443,118 +1389,15 @@ SDL_RLESurface(SDL_Surface * surface)
 }
 
 /*
- * Un-RLE a surface with pixel alpha
- * This may not give back exactly the image before RLE-encoding; all
- * completely transparent pixels will be lost, and color and alpha depth
- * may have been reduced (when encoding for 16bpp targets).
+ * Drop the encoding of a surface. The pixels are kept alongside it, so there
+ * is nothing to decode, whether or not they are wanted back.
  */
-static SDL_bool
-UnRLEAlpha(SDL_Surface * surface)
-{
-    Uint8 *srcbuf;
-    Uint32 *dst;
-    SDL_PixelFormat *sf = surface->format;
-    RLEDestFormat *df = surface->map->data;
-    int (*uncopy_opaque) (Uint32 *, void *, int,
-                          RLEDestFormat *, SDL_PixelFormat *);
-    int (*uncopy_transl) (Uint32 *, void *, int,
-                          RLEDestFormat *, SDL_PixelFormat *);
-    int w = surface->w;
-    int bpp = df->BytesPerPixel;
-
-    if (bpp == 2) {
-        uncopy_opaque = uncopy_opaque_16;
-        uncopy_transl = uncopy_transl_16;
-    } else {
-        uncopy_opaque = uncopy_transl = uncopy_32;
-    }
-
-    surface->pixels = SDL_malloc(surface->h * surface->pitch);
-    if (!surface->pixels) {
-        return (SDL_FALSE);
-    }
-    /* fill background with transparent pixels */
-    SDL_memset(surface->pixels, 0, surface->h * surface->pitch);
-
-    dst = surface->pixels;
-    srcbuf = (Uint8 *) (df + 1);
-    for (;;) {
-        /* copy opaque pixels */
-        int ofs = 0;
-        do {
-            unsigned run;
-            if (bpp == 2) {
-                ofs += srcbuf[0];
-                run = srcbuf[1];
-                srcbuf += 2;
-            } else {
-                ofs += ((Uint16 *) srcbuf)[0];
-                run = ((Uint16 *) srcbuf)[1];
-                srcbuf += 4;
-            }
-            if (run) {
-                srcbuf += uncopy_opaque(dst + ofs, srcbuf, run, df, sf);
-                ofs += run;
-            } else if (!ofs)
-                return (SDL_TRUE);
-        } while (ofs < w);
-
-        /* skip padding if needed */
-        if (bpp == 2)
-            srcbuf += (uintptr_t) srcbuf & 2;
-
-        /* copy translucent pixels */
-        ofs = 0;
-        do {
-            unsigned run;
-            ofs += ((Uint16 *) srcbuf)[0];
-            run = ((Uint16 *) srcbuf)[1];
-            srcbuf += 4;
-            if (run) {
-                srcbuf += uncopy_transl(dst + ofs, srcbuf, run, df, sf);
-                ofs += run;
-            }
-        } while (ofs < w);
-        dst += surface->pitch >> 2;
-    }
-    /* Make the compiler happy */
-    return (SDL_TRUE);
-}
-
 void
 SDL_UnRLESurface(SDL_Surface * surface, int recode)
 {
     if (surface->flags & SDL_RLEACCEL) {
         surface->flags &= ~SDL_RLEACCEL;
 
-        if (recode && !(surface->flags & SDL_PREALLOC)) {
-            if (surface->map->info.flags & SDL_COPY_RLE_COLORKEY) {
-                SDL_Rect full;
-
-                /* re-create the original surface */
-                surface->pixels = SDL_malloc(surface->h * surface->pitch);
-                if (!surface->pixels) {
-                    /* Oh crap... */
-                    surface->flags |= SDL_RLEACCEL;
-                    return;
-                }
-
-                /* fill it with the background color */
-                SDL_FillRect(surface, NULL, surface->map->info.colorkey);
-
-                /* now render the encoded surface */
-                full.x = full.y = 0;
-                full.w = surface->w;
-                full.h = surface->h;
-                SDL_RLEBlit(surface, &full, surface, &full);
-            } else {
-                if (!UnRLEAlpha(surface)) {
-                    /* Oh crap... */
-                    surface->flags |= SDL_RLEACCEL;
-                    return;
-                }
-            }
-        }
         surface->map->info.flags &=
             ~(SDL_COPY_RLE_COLORKEY | SDL_COPY_RLE_ALPHAKEY);
 
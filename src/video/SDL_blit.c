@@ -21,6 +21,8 @@
 #include "SDL_config.h"
 
 #include "SDL_video.h"
+#include "SDL_atomic.h"
+#include "SDL_hints.h"
 #include "SDL_sysvideo.h"
 #include "SDL_blit.h"
 #include "SDL_blit_auto.h"
@@ -211,31 +213,43 @@ SDL_ChooseBlitFunc(Uint32 src_format, Uint32 dst_format, int flags,
     return NULL;
 }
 
-/* Figure out which of many blit routines to set up on a surface */
-int
-SDL_CalculateBlit(SDL_Surface * surface)
+/* The blit functions chosen for recent combinations of formats and flags,
+   so surfaces that are mapped again don't have to search for them.
+   Each combination hashes to a set of two entries, most recent first. */
+#define BLIT_CACHE_SETS     32  /* must be a power of two */
+#define BLIT_CACHE_IDENTITY 0x10000000
+
+typedef struct
+{
+    Uint32 src_format;
+    Uint32 dst_format;
+    int flags;
+    SDL_BlitFunc func;
+} SDL_BlitCacheEntry;
+
+static SDL_BlitCacheEntry blit_cache[BLIT_CACHE_SETS][2];
+static Uint32 blit_cache_generation = 0;
+static Uint32 blit_cache_hits = 0;
+static Uint32 blit_cache_misses = 0;
+static SDL_SpinLock blit_cache_lock = 0;
+
+static SDL_INLINE Uint32
+SDL_HashBlit(Uint32 src_format, Uint32 dst_format, int flags)
+{
+    Uint32 hash = src_format * 0x9E3779B1u;
+
+    hash = (hash ^ dst_format) * 0x9E3779B1u;
+    hash = (hash ^ (Uint32) flags) * 0x9E3779B1u;
+    return (hash >> 16) & (BLIT_CACHE_SETS - 1);
+}
+
+static SDL_BlitFunc
+SDL_ChooseBlit(SDL_Surface * surface)
 {
     SDL_BlitFunc blit = NULL;
     SDL_BlitMap *map = surface->map;
     SDL_Surface *dst = map->dst;
 
-    /* Clean everything out to start */
-    if ((surface->flags & SDL_RLEACCEL) == SDL_RLEACCEL) {
-        SDL_UnRLESurface(surface, 1);
-    }
-    map->blit = SDL_SoftBlit;
-    map->info.src_fmt = surface->format;
-    map->info.src_pitch = surface->pitch;
-    map->info.dst_fmt = dst->format;
-    map->info.dst_pitch = dst->pitch;
-
-    /* See if we can do RLE acceleration */
-    if (map->info.flags & SDL_COPY_RLE_DESIRED) {
-        if (SDL_RLESurface(surface) == 0) {
-            return 0;
-        }
-    }
-
     /* Choose a standard blit function */
     if (map->identity && !(map->info.flags & ~SDL_COPY_RLE_DESIRED)) {
         blit = SDL_BlitCopy;
@@ -272,6 +286,105 @@ SDL_CalculateBlit(SDL_Surface * surface)
             blit = SDL_Blit_Slow;
         }
     }
+    return blit;
+}
+
+/* Look up the blit function in the cache, or choose it and remember it.
+   The choice depends only on the two pixel formats, the copy flags and
+   whether the mapping is an identity, apart from hints, so the whole cache
+   is dropped whenever a hint changes. */
+static SDL_BlitFunc
+SDL_GetCachedBlit(SDL_Surface * surface)
+{
+    SDL_BlitMap *map = surface->map;
+    Uint32 src_format = surface->format->format;
+    Uint32 dst_format = map->dst->format->format;
+    Uint32 generation = SDL_GetHintGeneration();
+    int flags = (map->info.flags & ~SDL_COPY_RLE_MASK);
+    SDL_BlitCacheEntry *set, entry;
+    int i;
+
+    if (map->identity) {
+        flags |= BLIT_CACHE_IDENTITY;
+    }
+    set = blit_cache[SDL_HashBlit(src_format, dst_format, flags)];
+
+    SDL_AtomicLock(&blit_cache_lock);
+    if (blit_cache_generation != generation) {
+        SDL_zero(blit_cache);
+        blit_cache_generation = generation;
+    }
+    for (i = 0; i < 2; ++i) {
+        if (set[i].func && set[i].src_format == src_format &&
+            set[i].dst_format == dst_format && set[i].flags == flags) {
+            entry = set[i];
+            if (i > 0) {
+                set[1] = set[0];
+                set[0] = entry;
+            }
+            ++blit_cache_hits;
+            SDL_AtomicUnlock(&blit_cache_lock);
+            return entry.func;
+        }
+    }
+    ++blit_cache_misses;
+    SDL_AtomicUnlock(&blit_cache_lock);
+
+    entry.src_format = src_format;
+    entry.dst_format = dst_format;
+    entry.flags = flags;
+    entry.func = SDL_ChooseBlit(surface);
+    if (entry.func) {
+        SDL_AtomicLock(&blit_cache_lock);
+        if (blit_cache_generation == generation) {
+            set[1] = set[0];
+            set[0] = entry;
+        }
+        SDL_AtomicUnlock(&blit_cache_lock);
+    }
+    return entry.func;
+}
+
+int
+SDL_GetBlitCacheStats(SDL_BlitCacheStats * stats)
+{
+    if (!stats) {
+        return SDL_InvalidParamError("stats");
+    }
+    SDL_AtomicLock(&blit_cache_lock);
+    stats->hits = blit_cache_hits;
+    stats->misses = blit_cache_misses;
+    SDL_AtomicUnlock(&blit_cache_lock);
+    SDL_GetBlitTableStats(&stats->table_hits, &stats->table_misses);
+    return 0;
+}
+
+/* Figure out which of many blit routines to set up on a surface */
+int
+SDL_CalculateBlit(SDL_Surface * surface)
+{
+    SDL_BlitFunc blit = NULL;
+    SDL_BlitMap *map = surface->map;
+    SDL_Surface *dst = map->dst;
+
+    /* Clean everything out to start */
+    if ((surface->flags & SDL_RLEACCEL) == SDL_RLEACCEL) {
+        SDL_UnRLESurface(surface, 1);
+    }
+    map->blit = SDL_SoftBlit;
+    map->info.src_fmt = surface->format;
+    map->info.src_pitch = surface->pitch;
+    map->info.dst_fmt = dst->format;
+    map->info.dst_pitch = dst->pitch;
+
+    /* See if we can do RLE acceleration */
+    if (map->info.flags & SDL_COPY_RLE_DESIRED) {
+        if (SDL_RLESurface(surface) == 0) {
+            return 0;
+        }
+    }
+
+    blit = SDL_GetCachedBlit(surface);
     map->data = blit;
 
     /* Make sure we have a blit function */
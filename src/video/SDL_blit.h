@@ -30,6 +30,12 @@
 /* Table to do pixel byte expansion */
 extern Uint8* SDL_expand_byte[9];
 
+/* The inverse colormap for blits onto palettized surfaces is indexed by the
+   top 5 bits of each of red, green and blue */
+#define SDL_COLORMAP_SIZE           32768
+#define SDL_COLORMAP_INDEX(r, g, b) \
+    ((((r) & 0xF8) << 7) | (((g) & 0xF8) << 2) | (((b) & 0xF8) >> 3))
+
 /* SDL blit copy flags */
 #define SDL_COPY_MODULATE_COLOR     0x00000001
 #define SDL_COPY_MODULATE_ALPHA     0x00000002
@@ -81,6 +87,9 @@ typedef struct
     SDL_BlitFunc func;
 } SDL_BlitFuncEntry;
 
+/* A lookup table shared between blit maps, see SDL_pixels.c */
+typedef struct SDL_BlitTable SDL_BlitTable;
+
 /* Blit mapping definition */
 typedef struct SDL_BlitMap
 {
@@ -89,6 +98,7 @@ typedef struct SDL_BlitMap
     SDL_blit blit;
     void *data;
     SDL_BlitInfo info;
+    SDL_BlitTable *table;       /* The table behind info.table, if any */
 
     /* the version count matches the destination; mismatch indicates
        an invalid mapping */
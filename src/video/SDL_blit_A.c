@@ -56,12 +56,8 @@ BlitNto1SurfaceAlpha(SDL_BlitInfo * info)
 		dR &= 0xff;
 		dG &= 0xff;
 		dB &= 0xff;
-		/* Pack RGB into 8bit pixel */
-		if ( palmap == NULL ) {
-		    *dst =((dR>>5)<<(3+2))|((dG>>5)<<(2))|((dB>>6)<<(0));
-		} else {
-		    *dst = palmap[((dR>>5)<<(3+2))|((dG>>5)<<(2))|((dB>>6)<<(0))];
-		}
+		/* Look up the nearest palette entry */
+		*dst = palmap[SDL_COLORMAP_INDEX(dR, dG, dB)];
 		dst++;
 		src += srcbpp;
 	    },
@@ -102,12 +98,8 @@ BlitNto1PixelAlpha(SDL_BlitInfo * info)
 		dR &= 0xff;
 		dG &= 0xff;
 		dB &= 0xff;
-		/* Pack RGB into 8bit pixel */
-		if ( palmap == NULL ) {
-		    *dst =((dR>>5)<<(3+2))|((dG>>5)<<(2))|((dB>>6)<<(0));
-		} else {
-		    *dst = palmap[((dR>>5)<<(3+2))|((dG>>5)<<(2))|((dB>>6)<<(0))];
-		}
+		/* Look up the nearest palette entry */
+		*dst = palmap[SDL_COLORMAP_INDEX(dR, dG, dB)];
 		dst++;
 		src += srcbpp;
 	    },
@@ -151,12 +143,8 @@ BlitNto1SurfaceAlphaKey(SDL_BlitInfo * info)
 		    dR &= 0xff;
 		    dG &= 0xff;
 		    dB &= 0xff;
-		    /* Pack RGB into 8bit pixel */
-		    if ( palmap == NULL ) {
-                *dst =((dR>>5)<<(3+2))|((dG>>5)<<(2))|((dB>>6)<<(0));
-		    } else {
-                *dst = palmap[((dR>>5)<<(3+2))|((dG>>5)<<(2))|((dB>>6)<<(0))];
-		    }
+		    /* Look up the nearest palette entry */
+		    *dst = palmap[SDL_COLORMAP_INDEX(dR, dG, dB)];
 		}
 		dst++;
 		src += srcbpp;
@@ -22,6 +22,7 @@
 
 #include "SDL_video.h"
 #include "SDL_endian.h"
+#include "SDL_hints.h"
 #include "SDL_cpuinfo.h"
 #include "SDL_blit.h"
 
@@ -883,12 +884,9 @@ GetBlitFeatures(void)
 #define LO  1
 #endif
 
-/* Special optimized blit for RGB 8-8-8 --> RGB 3-3-2 */
-#define RGB888_RGB332(dst, src) { \
-    dst = (Uint8)((((src)&0x00E00000)>>16)| \
-                  (((src)&0x0000E000)>>11)| \
-                  (((src)&0x000000C0)>>6)); \
-}
+/* Special optimized blit for RGB 8-8-8 --> palette index */
+#define RGB888_COLORMAP_INDEX(src) \
+    ((((src) >> 9) & 0x7C00) | (((src) >> 6) & 0x03E0) | (((src) >> 3) & 0x001F))
 static void
 Blit_RGB888_index8(SDL_BlitInfo * info)
 {
@@ -910,95 +908,43 @@ Blit_RGB888_index8(SDL_BlitInfo * info)
     dstskip = info->dst_skip;
     map = info->table;
 
-    if (map == NULL) {
-        while (height--) {
+    while (height--) {
 #ifdef USE_DUFFS_LOOP
-            /* *INDENT-OFF* */
-            DUFFS_LOOP(
-                RGB888_RGB332(*dst++, *src);
-            , width);
-            /* *INDENT-ON* */
+        /* *INDENT-OFF* */
+        DUFFS_LOOP(
+            *dst++ = map[RGB888_COLORMAP_INDEX(*src)];
+            ++src;
+        , width);
+        /* *INDENT-ON* */
 #else
-            for (c = width / 4; c; --c) {
-                /* Pack RGB into 8bit pixel */
-                ++src;
-                RGB888_RGB332(*dst++, *src);
-                ++src;
-                RGB888_RGB332(*dst++, *src);
-                ++src;
-                RGB888_RGB332(*dst++, *src);
-                ++src;
-            }
-            switch (width & 3) {
-            case 3:
-                RGB888_RGB332(*dst++, *src);
-                ++src;
-            case 2:
-                RGB888_RGB332(*dst++, *src);
-                ++src;
-            case 1:
-                RGB888_RGB332(*dst++, *src);
-                ++src;
-            }
-#endif /* USE_DUFFS_LOOP */
-            src += srcskip;
-            dst += dstskip;
+        for (c = width / 4; c; --c) {
+            /* Look up the nearest palette entry */
+            *dst++ = map[RGB888_COLORMAP_INDEX(src[0])];
+            *dst++ = map[RGB888_COLORMAP_INDEX(src[1])];
+            *dst++ = map[RGB888_COLORMAP_INDEX(src[2])];
+            *dst++ = map[RGB888_COLORMAP_INDEX(src[3])];
+            src += 4;
         }
-    } else {
-        int Pixel;
-
-        while (height--) {
-#ifdef USE_DUFFS_LOOP
-            /* *INDENT-OFF* */
-            DUFFS_LOOP(
-                RGB888_RGB332(Pixel, *src);
-                *dst++ = map[Pixel];
-                ++src;
-            , width);
-            /* *INDENT-ON* */
-#else
-            for (c = width / 4; c; --c) {
-                /* Pack RGB into 8bit pixel */
-                RGB888_RGB332(Pixel, *src);
-                *dst++ = map[Pixel];
-                ++src;
-                RGB888_RGB332(Pixel, *src);
-                *dst++ = map[Pixel];
-                ++src;
-                RGB888_RGB332(Pixel, *src);
-                *dst++ = map[Pixel];
-                ++src;
-                RGB888_RGB332(Pixel, *src);
-                *dst++ = map[Pixel];
-                ++src;
-            }
-            switch (width & 3) {
-            case 3:
-                RGB888_RGB332(Pixel, *src);
-                *dst++ = map[Pixel];
-                ++src;
-            case 2:
-                RGB888_RGB332(Pixel, *src);
-                *dst++ = map[Pixel];
-                ++src;
-            case 1:
-                RGB888_RGB332(Pixel, *src);
-                *dst++ = map[Pixel];
-                ++src;
-            }
-#endif /* USE_DUFFS_LOOP */
-            src += srcskip;
-            dst += dstskip;
+        switch (width & 3) {
+        case 3:
+            *dst++ = map[RGB888_COLORMAP_INDEX(*src)];
+            ++src;
+        case 2:
+            *dst++ = map[RGB888_COLORMAP_INDEX(*src)];
+            ++src;
+        case 1:
+            *dst++ = map[RGB888_COLORMAP_INDEX(*src)];
+            ++src;
         }
+#endif /* USE_DUFFS_LOOP */
+        src += srcskip;
+        dst += dstskip;
     }
 }
 
-/* Special optimized blit for RGB 10-10-10 --> RGB 3-3-2 */
-#define RGB101010_RGB332(dst, src) { \
-    dst = (Uint8)((((src)&0x38000000)>>22)| \
-                  (((src)&0x000E0000)>>15)| \
-                  (((src)&0x00000300)>>8)); \
-}
+/* Special optimized blit for RGB 10-10-10 --> palette index */
+#define RGB101010_COLORMAP_INDEX(src) \
+    ((((src) >> 15) & 0x7C00) | (((src) >> 10) & 0x03E0) | (((src) >> 5) & 0x001F))
 static void
 Blit_RGB101010_index8(SDL_BlitInfo * info)
 {
@@ -1020,86 +966,37 @@ Blit_RGB101010_index8(SDL_BlitInfo * info)
     dstskip = info->dst_skip;
     map = info->table;
 
-    if (map == NULL) {
-        while (height--) {
+    while (height--) {
 #ifdef USE_DUFFS_LOOP
-            /* *INDENT-OFF* */
-            DUFFS_LOOP(
-                RGB101010_RGB332(*dst++, *src);
-            , width);
-            /* *INDENT-ON* */
+        /* *INDENT-OFF* */
+        DUFFS_LOOP(
+            *dst++ = map[RGB101010_COLORMAP_INDEX(*src)];
+            ++src;
+        , width);
+        /* *INDENT-ON* */
 #else
-            for (c = width / 4; c; --c) {
-                /* Pack RGB into 8bit pixel */
-                ++src;
-                RGB101010_RGB332(*dst++, *src);
-                ++src;
-                RGB101010_RGB332(*dst++, *src);
-                ++src;
-                RGB101010_RGB332(*dst++, *src);
-                ++src;
-            }
-            switch (width & 3) {
-            case 3:
-                RGB101010_RGB332(*dst++, *src);
-                ++src;
-            case 2:
-                RGB101010_RGB332(*dst++, *src);
-                ++src;
-            case 1:
-                RGB101010_RGB332(*dst++, *src);
-                ++src;
-            }
-#endif /* USE_DUFFS_LOOP */
-            src += srcskip;
-            dst += dstskip;
+        for (c = width / 4; c; --c) {
+            /* Look up the nearest palette entry */
+            *dst++ = map[RGB101010_COLORMAP_INDEX(src[0])];
+            *dst++ = map[RGB101010_COLORMAP_INDEX(src[1])];
+            *dst++ = map[RGB101010_COLORMAP_INDEX(src[2])];
+            *dst++ = map[RGB101010_COLORMAP_INDEX(src[3])];
+            src += 4;
         }
-    } else {
-        int Pixel;
-
-        while (height--) {
-#ifdef USE_DUFFS_LOOP
-            /* *INDENT-OFF* */
-            DUFFS_LOOP(
-                RGB101010_RGB332(Pixel, *src);
-                *dst++ = map[Pixel];
-                ++src;
-            , width);
-            /* *INDENT-ON* */
-#else
-            for (c = width / 4; c; --c) {
-                /* Pack RGB into 8bit pixel */
-                RGB101010_RGB332(Pixel, *src);
-                *dst++ = map[Pixel];
-                ++src;
-                RGB101010_RGB332(Pixel, *src);
-                *dst++ = map[Pixel];
-                ++src;
-                RGB101010_RGB332(Pixel, *src);
-                *dst++ = map[Pixel];
-                ++src;
-                RGB101010_RGB332(Pixel, *src);
-                *dst++ = map[Pixel];
-                ++src;
-            }
-            switch (width & 3) {
-            case 3:
-                RGB101010_RGB332(Pixel, *src);
-                *dst++ = map[Pixel];
-                ++src;
-            case 2:
-                RGB101010_RGB332(Pixel, *src);
-                *dst++ = map[Pixel];
-                ++src;
-            case 1:
-                RGB101010_RGB332(Pixel, *src);
-                *dst++ = map[Pixel];
-                ++src;
-            }
-#endif /* USE_DUFFS_LOOP */
-            src += srcskip;
-            dst += dstskip;
+        switch (width & 3) {
+        case 3:
+            *dst++ = map[RGB101010_COLORMAP_INDEX(*src)];
+            ++src;
+        case 2:
+            *dst++ = map[RGB101010_COLORMAP_INDEX(*src)];
+            ++src;
+        case 1:
+            *dst++ = map[RGB101010_COLORMAP_INDEX(*src)];
+            ++src;
         }
+#endif /* USE_DUFFS_LOOP */
+        src += srcskip;
+        dst += dstskip;
     }
 }
 
@@ -1997,71 +1894,98 @@ BlitNto1(SDL_BlitInfo * info)
     srcfmt = info->src_fmt;
     srcbpp = srcfmt->BytesPerPixel;
 
-    if (map == NULL) {
-        while (height--) {
+    while (height--) {
 #ifdef USE_DUFFS_LOOP
-            /* *INDENT-OFF* */
-            DUFFS_LOOP(
-                DISEMBLE_RGB(src, srcbpp, srcfmt, Pixel,
-                                sR, sG, sB);
-                if ( 1 ) {
-                    /* Pack RGB into 8bit pixel */
-                    *dst = ((sR>>5)<<(3+2))|
-                            ((sG>>5)<<(2)) |
-                            ((sB>>6)<<(0)) ;
-                }
-                dst++;
-                src += srcbpp;
-            , width);
-            /* *INDENT-ON* */
+        /* *INDENT-OFF* */
+        DUFFS_LOOP(
+            DISEMBLE_RGB(src, srcbpp, srcfmt, Pixel,
+                            sR, sG, sB);
+            /* Look up the nearest palette entry */
+            *dst = map[SDL_COLORMAP_INDEX(sR, sG, sB)];
+            dst++;
+            src += srcbpp;
+        , width);
+        /* *INDENT-ON* */
 #else
-            for (c = width; c; --c) {
-                DISEMBLE_RGB(src, srcbpp, srcfmt, Pixel, sR, sG, sB);
-                if (1) {
-                    /* Pack RGB into 8bit pixel */
-                    *dst = ((sR >> 5) << (3 + 2)) |
-                        ((sG >> 5) << (2)) | ((sB >> 6) << (0));
-                }
-                dst++;
-                src += srcbpp;
-            }
-#endif
-            src += srcskip;
-            dst += dstskip;
+        for (c = width; c; --c) {
+            DISEMBLE_RGB(src, srcbpp, srcfmt, Pixel, sR, sG, sB);
+            /* Look up the nearest palette entry */
+            *dst = map[SDL_COLORMAP_INDEX(sR, sG, sB)];
+            dst++;
+            src += srcbpp;
         }
-    } else {
-        while (height--) {
-#ifdef USE_DUFFS_LOOP
-            /* *INDENT-OFF* */
-            DUFFS_LOOP(
-                DISEMBLE_RGB(src, srcbpp, srcfmt, Pixel,
-                                sR, sG, sB);
-                if ( 1 ) {
-                    /* Pack RGB into 8bit pixel */
-                    *dst = map[((sR>>5)<<(3+2))|
-                           ((sG>>5)<<(2))  |
-                           ((sB>>6)<<(0))  ];
-                }
-                dst++;
-                src += srcbpp;
-            , width);
-            /* *INDENT-ON* */
-#else
-            for (c = width; c; --c) {
-                DISEMBLE_RGB(src, srcbpp, srcfmt, Pixel, sR, sG, sB);
-                if (1) {
-                    /* Pack RGB into 8bit pixel */
-                    *dst = map[((sR >> 5) << (3 + 2)) |
-                               ((sG >> 5) << (2)) | ((sB >> 6) << (0))];
-                }
-                dst++;
-                src += srcbpp;
-            }
 #endif /* USE_DUFFS_LOOP */
-            src += srcskip;
-            dst += dstskip;
+        src += srcskip;
+        dst += dstskip;
+    }
+}
+
+/* 4x4 ordered dither matrix */
+static const Uint8 dither_matrix[4][4] = {
+    {  0,  8,  2, 10 },
+    { 12,  4, 14,  6 },
+    {  3, 11,  1,  9 },
+    { 15,  7, 13,  5 }
+};
+
+#define DITHER_CHANNEL(v, offset) \
+    (((v) + (offset) < 0) ? 0 : ((v) + (offset) > 255) ? 255 : ((v) + (offset)))
+
+static void
+BlitNto1Dither(SDL_BlitInfo * info)
+{
+    int width, height;
+    Uint8 *src;
+    const Uint8 *map;
+    Uint8 *dst;
+    int srcskip, dstskip;
+    int srcbpp;
+    Uint32 Pixel;
+    int sR, sG, sB;
+    SDL_PixelFormat *srcfmt;
+    int offsets[4][4];
+    int levels, spread, x, y;
+
+    /* Set up some basic variables */
+    width = info->dst_w;
+    height = info->dst_h;
+    src = info->src;
+    srcskip = info->src_skip;
+    dst = info->dst;
+    dstskip = info->dst_skip;
+    map = info->table;
+    srcfmt = info->src_fmt;
+    srcbpp = srcfmt->BytesPerPixel;
+
+    /* Spread the dither over the spacing of an even palette of this size */
+    levels = 2;
+    while ((levels + 1) * (levels + 1) * (levels + 1) <= info->dst_fmt->palette->ncolors) {
+        ++levels;
+    }
+    spread = 256 / (levels - 1);
+    for (y = 0; y < 4; ++y) {
+        for (x = 0; x < 4; ++x) {
+            offsets[y][x] = ((2 * dither_matrix[y][x] + 1) * spread) / 32 - spread / 2;
         }
     }
+
+    for (y = 0; y < height; ++y) {
+        const int *row = offsets[y & 3];
+
+        for (x = 0; x < width; ++x) {
+            const int offset = row[x & 3];
+
+            DISEMBLE_RGB(src, srcbpp, srcfmt, Pixel, sR, sG, sB);
+            sR = DITHER_CHANNEL(sR, offset);
+            sG = DITHER_CHANNEL(sG, offset);
+            sB = DITHER_CHANNEL(sB, offset);
+            *dst = map[SDL_COLORMAP_INDEX(sR, sG, sB)];
+            dst++;
+            src += srcbpp;
+        }
+        src += srcskip;
+        dst += dstskip;
+    }
 }
 
 /* blits 32 bit RGB<->RGBA with both surfaces having the same R,G,B fields */
@@ -2199,48 +2123,23 @@ BlitNto1Key(SDL_BlitInfo * info)
     srcbpp = srcfmt->BytesPerPixel;
     ckey &= rgbmask;
 
-    if (palmap == NULL) {
-        while (height--) {
-            /* *INDENT-OFF* */
-            DUFFS_LOOP(
-            {
-                DISEMBLE_RGB(src, srcbpp, srcfmt, Pixel,
-                                sR, sG, sB);
-                if ( (Pixel & rgbmask) != ckey ) {
-                    /* Pack RGB into 8bit pixel */
-                    *dst = (Uint8)(((sR>>5)<<(3+2))|
-                                   ((sG>>5)<<(2)) |
-                                   ((sB>>6)<<(0)));
-                }
-                dst++;
-                src += srcbpp;
-            },
-            width);
-            /* *INDENT-ON* */
-            src += srcskip;
-            dst += dstskip;
-        }
-    } else {
-        while (height--) {
-            /* *INDENT-OFF* */
-            DUFFS_LOOP(
-            {
-                DISEMBLE_RGB(src, srcbpp, srcfmt, Pixel,
-                                sR, sG, sB);
-                if ( (Pixel & rgbmask) != ckey ) {
-                    /* Pack RGB into 8bit pixel */
-                    *dst = (Uint8)palmap[((sR>>5)<<(3+2))|
-                                         ((sG>>5)<<(2))  |
-                                         ((sB>>6)<<(0))  ];
-                }
-                dst++;
-                src += srcbpp;
-            },
-            width);
-            /* *INDENT-ON* */
-            src += srcskip;
-            dst += dstskip;
-        }
+    while (height--) {
+        /* *INDENT-OFF* */
+        DUFFS_LOOP(
+        {
+            DISEMBLE_RGB(src, srcbpp, srcfmt, Pixel,
+                            sR, sG, sB);
+            if ( (Pixel & rgbmask) != ckey ) {
+                /* Look up the nearest palette entry */
+                *dst = palmap[SDL_COLORMAP_INDEX(sR, sG, sB)];
+            }
+            dst++;
+            src += srcbpp;
+        },
+        width);
+        /* *INDENT-ON* */
+        src += srcskip;
+        dst += dstskip;
     }
 }
 
@@ -2504,6 +2403,7 @@ SDL_CalculateBlitN(SDL_Surface * surface)
     const struct blit_table *table;
     int which;
     SDL_BlitFunc blitfun;
+    const char *hint;
 
     /* Set up data for choosing the blit */
     srcfmt = surface->format;
@@ -2531,6 +2431,10 @@ SDL_CalculateBlitN(SDL_Surface * surface)
             } else {
                 blitfun = BlitNto1;
             }
+            hint = SDL_GetHint(SDL_HINT_PALETTE_DITHER);
+            if (hint && *hint == '1' && dstfmt->palette) {
+                blitfun = BlitNto1Dither;
+            }
         } else {
             /* Now the meat, choose the blitter we want */
             int a_need = NO_ALPHA;
@@ -35,6 +35,7 @@
 #include "SDL_video.h"
 #include "SDL_endian.h"
 #include "SDL_pixels_c.h"
+#include "../file/SDL_rwops_c.h"
 
 #define SAVE_32BIT_BMP
 
@@ -76,24 +77,71 @@ static void CorrectAlphaChannel(SDL_Surface *surface)
     }
 }
 
-SDL_Surface *
-SDL_LoadBMP_RW(SDL_RWops * src, int freesrc)
+/* Check to see if a row of 32-bit pixels has any alpha channel data */
+static SDL_bool RowHasAlpha(const Uint8 *bits, int w)
+{
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+    const Uint8 *alpha = bits;
+#else
+    const Uint8 *alpha = bits + 3;
+#endif
+    const Uint8 *end = alpha + w * 4;
+
+    while (alpha < end) {
+        if (*alpha != 0) {
+            return SDL_TRUE;
+        }
+        alpha += 4;
+    }
+    return SDL_FALSE;
+}
+
+/* Make every pixel of a 16 or 32-bit surface opaque */
+static void SetOpaque(SDL_Surface *surface)
+{
+    const Uint32 Amask = surface->format->Amask;
+    int x, y;
+
+    for (y = 0; y < surface->h; ++y) {
+        Uint8 *bits = (Uint8 *)surface->pixels + y * surface->pitch;
+
+        switch (surface->format->BytesPerPixel) {
+        case 2:
+            for (x = 0; x < surface->w; ++x) {
+                ((Uint16 *)bits)[x] |= (Uint16)Amask;
+            }
+            break;
+        case 4:
+            for (x = 0; x < surface->w; ++x) {
+                ((Uint32 *)bits)[x] |= Amask;
+            }
+            break;
+        }
+    }
+}
+
+static SDL_Surface *
+SDL_LoadBMP_Internal(SDL_RWops * src, int freesrc, Uint32 pixel_format)
 {
     SDL_bool was_error;
     Sint64 fp_offset = 0;
     int bmpPitch;
-    int i, pad;
+    int i, y;
     SDL_Surface *surface;
+    SDL_Surface *image;
+    SDL_RWops *buffered;
     Uint32 Rmask;
     Uint32 Gmask;
     Uint32 Bmask;
     Uint32 Amask;
     SDL_Palette *palette;
+    Uint8 *raw;
     Uint8 *bits;
-    Uint8 *top, *end;
     SDL_bool topDown;
+    SDL_bool convert;
     int ExpandBMP;
     SDL_bool correctAlpha = SDL_FALSE;
+    SDL_bool hasAlpha = SDL_FALSE;
 
     /* The Win32 BMP file header (14 bytes) */
     char magic[2];
@@ -117,12 +165,21 @@ SDL_LoadBMP_RW(SDL_RWops * src, int freesrc)
 
     /* Make sure we are passed a valid data source */
     surface = NULL;
+    image = NULL;
+    raw = NULL;
     was_error = SDL_FALSE;
     if (src == NULL) {
         was_error = SDL_TRUE;
         goto done;
     }
 
+    /* Read through a buffer if the stream doesn't have one */
+    buffered = SDL_RWBufferIfNeeded(src, freesrc);
+    if (buffered) {
+        src = buffered;
+        freesrc = 1;
+    }
+
     /* Read in the BMP file header */
     fp_offset = SDL_RWtell(src);
     SDL_ClearError();
@@ -250,18 +307,53 @@ SDL_LoadBMP_RW(SDL_RWops * src, int freesrc)
         goto done;
     }
 
+    /* If the file isn't in the requested format, the pixels are read a row
+       at a time into a surface in the format of the file and blitted into
+       the surface that's returned. */
+    convert = SDL_FALSE;
+    if (pixel_format != SDL_PIXELFORMAT_UNKNOWN &&
+        pixel_format != SDL_MasksToPixelFormatEnum(biBitCount, Rmask, Gmask,
+                                                   Bmask, Amask)) {
+        int bpp;
+        Uint32 Rtarget, Gtarget, Btarget, Atarget;
+
+        if (SDL_ISPIXELFORMAT_INDEXED(pixel_format) ||
+            !SDL_PixelFormatEnumToMasks(pixel_format, &bpp, &Rtarget,
+                                        &Gtarget, &Btarget, &Atarget)) {
+            SDL_SetError("Can't load BMP file as %s",
+                         SDL_GetPixelFormatName(pixel_format));
+            was_error = SDL_TRUE;
+            goto done;
+        }
+        surface =
+            SDL_CreateRGBSurface(0, biWidth, biHeight, bpp, Rtarget, Gtarget,
+                                 Btarget, Atarget);
+        if (surface == NULL) {
+            was_error = SDL_TRUE;
+            goto done;
+        }
+        convert = SDL_TRUE;
+    }
+
     /* Create a compatible surface, note that the colors are RGB ordered */
-    surface =
-        SDL_CreateRGBSurface(0, biWidth, biHeight, biBitCount, Rmask, Gmask,
-                             Bmask, Amask);
-    if (surface == NULL) {
+    image =
+        SDL_CreateRGBSurface(0, biWidth, convert ? 1 : biHeight, biBitCount,
+                             Rmask, Gmask, Bmask, Amask);
+    if (image == NULL) {
         was_error = SDL_TRUE;
         goto done;
     }
+    if (convert) {
+        SDL_SetSurfaceBlendMode(image, SDL_BLENDMODE_NONE);
+    } else {
+        surface = image;
+    }
 
     /* Load the palette, if any */
-    palette = (surface->format)->palette;
+    palette = (image->format)->palette;
     if (palette) {
+        const int entrySize = (biSize == 12) ? 3 : 4;
+
         if (biClrUsed == 0) {
             biClrUsed = 1 << biBitCount;
         }
@@ -279,27 +371,31 @@ SDL_LoadBMP_RW(SDL_RWops * src, int freesrc)
         } else if ((int) biClrUsed < palette->ncolors) {
             palette->ncolors = biClrUsed;
         }
-        if (biSize == 12) {
-            for (i = 0; i < (int) biClrUsed; ++i) {
-                SDL_RWread(src, &palette->colors[i].b, 1, 1);
-                SDL_RWread(src, &palette->colors[i].g, 1, 1);
-                SDL_RWread(src, &palette->colors[i].r, 1, 1);
-                palette->colors[i].a = SDL_ALPHA_OPAQUE;
-            }
-        } else {
-            for (i = 0; i < (int) biClrUsed; ++i) {
-                SDL_RWread(src, &palette->colors[i].b, 1, 1);
-                SDL_RWread(src, &palette->colors[i].g, 1, 1);
-                SDL_RWread(src, &palette->colors[i].r, 1, 1);
-                SDL_RWread(src, &palette->colors[i].a, 1, 1);
-
-                /* According to Microsoft documentation, the fourth element
-                   is reserved and must be zero, so we shouldn't treat it as
-                   alpha.
-                */
-                palette->colors[i].a = SDL_ALPHA_OPAQUE;
-            }
+
+        raw = (Uint8 *) SDL_malloc(biClrUsed * entrySize);
+        if (!raw) {
+            SDL_OutOfMemory();
+            was_error = SDL_TRUE;
+            goto done;
         }
+        if (SDL_RWread(src, raw, entrySize, biClrUsed) != biClrUsed) {
+            SDL_Error(SDL_EFREAD);
+            was_error = SDL_TRUE;
+            goto done;
+        }
+        for (i = 0; i < (int) biClrUsed; ++i) {
+            palette->colors[i].b = raw[i * entrySize + 0];
+            palette->colors[i].g = raw[i * entrySize + 1];
+            palette->colors[i].r = raw[i * entrySize + 2];
+
+            /* According to Microsoft documentation, the fourth element
+               is reserved and must be zero, so we shouldn't treat it as
+               alpha.
+            */
+            palette->colors[i].a = SDL_ALPHA_OPAQUE;
+        }
+        SDL_free(raw);
+        raw = NULL;
     }
 
     /* Read the surface pixels.  Note that the bmp image is upside down */
@@ -308,49 +404,54 @@ SDL_LoadBMP_RW(SDL_RWops * src, int freesrc)
         was_error = SDL_TRUE;
         goto done;
     }
-    top = (Uint8 *)surface->pixels;
-    end = (Uint8 *)surface->pixels+(surface->h*surface->pitch);
     switch (ExpandBMP) {
     case 1:
-        bmpPitch = (biWidth + 7) >> 3;
-        pad = (((bmpPitch) % 4) ? (4 - ((bmpPitch) % 4)) : 0);
+        bmpPitch = (((biWidth + 7) >> 3) + 3) & ~3;
         break;
     case 4:
-        bmpPitch = (biWidth + 1) >> 1;
-        pad = (((bmpPitch) % 4) ? (4 - ((bmpPitch) % 4)) : 0);
+        bmpPitch = (((biWidth + 1) >> 1) + 3) & ~3;
         break;
     default:
-        pad = ((surface->pitch % 4) ? (4 - (surface->pitch % 4)) : 0);
+        /* Surface rows are padded to 4 bytes, just like BMP rows */
+        bmpPitch = image->pitch;
         break;
     }
-    if (topDown) {
-        bits = top;
-    } else {
-        bits = end - surface->pitch;
+    if (ExpandBMP) {
+        raw = (Uint8 *) SDL_malloc(bmpPitch);
+        if (!raw) {
+            SDL_OutOfMemory();
+            was_error = SDL_TRUE;
+            goto done;
+        }
     }
-    while (bits >= top && bits < end) {
-        switch (ExpandBMP) {
-        case 1:
-        case 4:{
-                Uint8 pixel = 0;
-                int shift = (8 - ExpandBMP);
-                for (i = 0; i < surface->w; ++i) {
-                    if (i % (8 / ExpandBMP) == 0) {
-                        if (!SDL_RWread(src, &pixel, 1, 1)) {
-                            SDL_SetError("Error reading from BMP");
-                            was_error = SDL_TRUE;
-                            goto done;
-                        }
-                    }
-                    *(bits + i) = (pixel >> shift);
-                    pixel <<= ExpandBMP;
+    for (i = 0; i < biHeight; ++i) {
+        y = topDown ? i : (biHeight - 1 - i);
+        if (convert) {
+            bits = (Uint8 *)image->pixels;
+        } else {
+            bits = (Uint8 *)image->pixels + y * image->pitch;
+        }
+
+        if (ExpandBMP) {
+            const int shift = (8 - ExpandBMP);
+            const Uint8 *in = raw;
+            Uint8 pixel = 0;
+            int x;
+
+            if (SDL_RWread(src, raw, 1, bmpPitch) != bmpPitch) {
+                SDL_Error(SDL_EFREAD);
+                was_error = SDL_TRUE;
+                goto done;
+            }
+            for (x = 0; x < image->w; ++x) {
+                if (x % (8 / ExpandBMP) == 0) {
+                    pixel = *in++;
                 }
+                *(bits + x) = (pixel >> shift);
+                pixel <<= ExpandBMP;
             }
-            break;
-
-        default:
-            if (SDL_RWread(src, bits, 1, surface->pitch)
-                != surface->pitch) {
+        } else {
+            if (SDL_RWread(src, bits, 1, bmpPitch) != bmpPitch) {
                 SDL_Error(SDL_EFREAD);
                 was_error = SDL_TRUE;
                 goto done;
@@ -362,38 +463,53 @@ SDL_LoadBMP_RW(SDL_RWops * src, int freesrc)
             case 15:
             case 16:{
                     Uint16 *pix = (Uint16 *) bits;
-                    for (i = 0; i < surface->w; i++)
-                        pix[i] = SDL_Swap16(pix[i]);
+                    int x;
+                    for (x = 0; x < image->w; x++)
+                        pix[x] = SDL_Swap16(pix[x]);
                     break;
                 }
 
             case 32:{
                     Uint32 *pix = (Uint32 *) bits;
-                    for (i = 0; i < surface->w; i++)
-                        pix[i] = SDL_Swap32(pix[i]);
+                    int x;
+                    for (x = 0; x < image->w; x++)
+                        pix[x] = SDL_Swap32(pix[x]);
                     break;
                 }
             }
 #endif
-            break;
         }
-        /* Skip padding bytes, ugh */
-        if (pad) {
-            Uint8 padbyte;
-            for (i = 0; i < pad; ++i) {
-                SDL_RWread(src, &padbyte, 1, 1);
+
+        if (convert) {
+            SDL_Rect srcrect, dstrect;
+
+            if (correctAlpha && !hasAlpha) {
+                hasAlpha = RowHasAlpha(bits, image->w);
+            }
+            srcrect.x = 0;
+            srcrect.y = 0;
+            srcrect.w = image->w;
+            srcrect.h = 1;
+            dstrect = srcrect;
+            dstrect.y = y;
+            if (SDL_LowerBlit(image, &srcrect, surface, &dstrect) < 0) {
+                was_error = SDL_TRUE;
+                goto done;
             }
-        }
-        if (topDown) {
-            bits += surface->pitch;
-        } else {
-            bits -= surface->pitch;
         }
     }
     if (correctAlpha) {
-        CorrectAlphaChannel(surface);
+        if (!convert) {
+            CorrectAlphaChannel(surface);
+        } else if (!hasAlpha && surface->format->Amask) {
+            SetOpaque(surface);
+        }
     }
   done:
+    SDL_free(raw);
+    if (image && image != surface) {
+        SDL_FreeSurface(image);
+    }
     if (was_error) {
         if (src) {
             SDL_RWseek(src, fp_offset, RW_SEEK_SET);
@@ -407,13 +523,32 @@ SDL_LoadBMP_RW(SDL_RWops * src, int freesrc)
     return (surface);
 }
 
+SDL_Surface *
+SDL_LoadBMP_RW(SDL_RWops * src, int freesrc)
+{
+    return SDL_LoadBMP_Internal(src, freesrc, SDL_PIXELFORMAT_UNKNOWN);
+}
+
+SDL_Surface *
+SDL_LoadBMPFormat_RW(SDL_RWops * src, int freesrc, Uint32 pixel_format)
+{
+    return SDL_LoadBMP_Internal(src, freesrc, pixel_format);
+}
+
 int
 SDL_SaveBMP_RW(SDL_Surface * saveme, SDL_RWops * dst, int freedst)
 {
     Sint64 fp_offset;
-    int i, pad;
+    int i, y, pad;
     SDL_Surface *surface;
+    SDL_Surface *row;
+    SDL_PixelFormat *format;
+    SDL_RWops *buffered;
     Uint8 *bits;
+    Uint32 copy_flags = 0;
+    Uint32 colorkey = 0;
+    SDL_bool keyed = SDL_FALSE;
+    SDL_Color copy_color = { 0, 0, 0, 0 };
 
     /* The Win32 BMP file header (14 bytes) */
     char magic[2] = { 'B', 'M' };
@@ -437,6 +572,7 @@ SDL_SaveBMP_RW(SDL_Surface * saveme, SDL_RWops * dst, int freedst)
 
     /* Make sure we have somewhere to save */
     surface = NULL;
+    row = NULL;
     if (dst) {
         SDL_bool save32bit = SDL_FALSE;
 #ifdef SAVE_32BIT_BMP
@@ -467,31 +603,43 @@ SDL_SaveBMP_RW(SDL_Surface * saveme, SDL_RWops * dst, int freedst)
             ) {
             surface = saveme;
         } else {
-            SDL_PixelFormat format;
+            Uint32 pixel_format;
+            int bpp;
+            Uint32 Rmask, Gmask, Bmask, Amask;
 
             /* If the surface has a colorkey or alpha channel we'll save a
-               32-bit BMP with alpha channel, otherwise save a 24-bit BMP. */
+               32-bit BMP with alpha channel, otherwise save a 24-bit BMP.
+               The surface is converted a row at a time as it's written. */
             if (save32bit) {
-                SDL_InitFormat(&format,
 #if SDL_BYTEORDER == SDL_LIL_ENDIAN
-                               SDL_PIXELFORMAT_ARGB8888
+                pixel_format = SDL_PIXELFORMAT_ARGB8888;
 #else
-                               SDL_PIXELFORMAT_BGRA8888
+                pixel_format = SDL_PIXELFORMAT_BGRA8888;
 #endif
-                               );
             } else {
-                SDL_InitFormat(&format, SDL_PIXELFORMAT_BGR24);
+                pixel_format = SDL_PIXELFORMAT_BGR24;
             }
-            surface = SDL_ConvertSurface(saveme, &format, 0);
-            if (!surface) {
-                SDL_SetError("Couldn't convert image to %d bpp",
-                             format.BitsPerPixel);
+            SDL_PixelFormatEnumToMasks(pixel_format, &bpp,
+                                       &Rmask, &Gmask, &Bmask, &Amask);
+            row = SDL_CreateRGBSurface(0, saveme->w, 1, bpp,
+                                       Rmask, Gmask, Bmask, Amask);
+            if (row) {
+                surface = saveme;
+            } else {
+                SDL_SetError("Couldn't convert image to %d bpp", bpp);
             }
         }
     }
 
-    if (surface && (SDL_LockSurface(surface) == 0)) {
-        const int bw = surface->w * surface->format->BytesPerPixel;
+    if (surface && (row || SDL_LockSurface(surface) == 0)) {
+        format = row ? row->format : surface->format;
+
+        /* Write through a buffer if the stream doesn't have one */
+        buffered = SDL_RWBufferIfNeeded(dst, freedst);
+        if (buffered) {
+            dst = buffered;
+            freedst = 1;
+        }
 
         /* Set the BMP file header values */
         bfSize = 0;             /* We'll write this when we're done */
@@ -513,13 +661,13 @@ SDL_SaveBMP_RW(SDL_Surface * saveme, SDL_RWops * dst, int freedst)
         biWidth = surface->w;
         biHeight = surface->h;
         biPlanes = 1;
-        biBitCount = surface->format->BitsPerPixel;
+        biBitCount = format->BitsPerPixel;
         biCompression = BI_RGB;
-        biSizeImage = surface->h * surface->pitch;
+        biSizeImage = surface->h * (row ? row->pitch : surface->pitch);
         biXPelsPerMeter = 0;
         biYPelsPerMeter = 0;
-        if (surface->format->palette) {
-            biClrUsed = surface->format->palette->ncolors;
+        if (format->palette) {
+            biClrUsed = format->palette->ncolors;
         } else {
             biClrUsed = 0;
         }
@@ -539,18 +687,20 @@ SDL_SaveBMP_RW(SDL_Surface * saveme, SDL_RWops * dst, int freedst)
         SDL_WriteLE32(dst, biClrImportant);
 
         /* Write the palette (in BGR color order) */
-        if (surface->format->palette) {
+        if (format->palette) {
             SDL_Color *colors;
             int ncolors;
+            Uint8 entries[256 * 4];
 
-            colors = surface->format->palette->colors;
-            ncolors = surface->format->palette->ncolors;
+            colors = format->palette->colors;
+            ncolors = SDL_min(format->palette->ncolors, 256);
             for (i = 0; i < ncolors; ++i) {
-                SDL_RWwrite(dst, &colors[i].b, 1, 1);
-                SDL_RWwrite(dst, &colors[i].g, 1, 1);
-                SDL_RWwrite(dst, &colors[i].r, 1, 1);
-                SDL_RWwrite(dst, &colors[i].a, 1, 1);
+                entries[i * 4 + 0] = colors[i].b;
+                entries[i * 4 + 1] = colors[i].g;
+                entries[i * 4 + 2] = colors[i].r;
+                entries[i * 4 + 3] = colors[i].a;
             }
+            SDL_RWwrite(dst, entries, 4, ncolors);
         }
 
         /* Write the bitmap offset */
@@ -563,23 +713,88 @@ SDL_SaveBMP_RW(SDL_Surface * saveme, SDL_RWops * dst, int freedst)
             SDL_Error(SDL_EFSEEK);
         }
 
+        if (row) {
+            /* Blit the rows without any of the surface's blending, like
+               SDL_ConvertSurface() does */
+            copy_flags = surface->map->info.flags;
+            copy_color.r = surface->map->info.r;
+            copy_color.g = surface->map->info.g;
+            copy_color.b = surface->map->info.b;
+            copy_color.a = surface->map->info.a;
+            surface->map->info.r = 0xFF;
+            surface->map->info.g = 0xFF;
+            surface->map->info.b = 0xFF;
+            surface->map->info.a = 0xFF;
+            surface->map->info.flags = 0;
+            SDL_InvalidateMap(surface->map);
+
+            /* Pixels matching the colorkey are saved as transparent */
+            if ((copy_flags & SDL_COPY_COLORKEY) && !surface->format->palette) {
+                Uint8 keyR, keyG, keyB, keyA;
+
+                SDL_GetRGBA(surface->map->info.colorkey, surface->format,
+                            &keyR, &keyG, &keyB, &keyA);
+                colorkey = SDL_MapRGBA(row->format, keyR, keyG, keyB, keyA) &
+                           ~row->format->Amask;
+                keyed = SDL_TRUE;
+            }
+        }
+
         /* Write the bitmap image upside down */
-        bits = (Uint8 *) surface->pixels + (surface->h * surface->pitch);
-        pad = ((bw % 4) ? (4 - (bw % 4)) : 0);
-        while (bits > (Uint8 *) surface->pixels) {
-            bits -= surface->pitch;
+        for (y = surface->h - 1; y >= 0; --y) {
+            int bw;
+
+            if (row) {
+                SDL_Rect srcrect, dstrect;
+
+                srcrect.x = 0;
+                srcrect.y = y;
+                srcrect.w = surface->w;
+                srcrect.h = 1;
+                dstrect.x = 0;
+                dstrect.y = 0;
+                dstrect.w = surface->w;
+                dstrect.h = 1;
+                if (SDL_LowerBlit(surface, &srcrect, row, &dstrect) < 0) {
+                    break;
+                }
+                if (keyed) {
+                    Uint32 *pix = (Uint32 *) row->pixels;
+                    const Uint32 mask = ~row->format->Amask;
+
+                    for (i = 0; i < row->w; ++i) {
+                        if ((pix[i] & mask) == colorkey) {
+                            pix[i] &= mask;
+                        }
+                    }
+                }
+                bits = (Uint8 *) row->pixels;
+                bw = row->pitch;
+                pad = 0;
+            } else {
+                bits = (Uint8 *) surface->pixels + y * surface->pitch;
+                bw = surface->w * surface->format->BytesPerPixel;
+                pad = ((bw % 4) ? (4 - (bw % 4)) : 0);
+            }
             if (SDL_RWwrite(dst, bits, 1, bw) != bw) {
                 SDL_Error(SDL_EFWRITE);
                 break;
             }
             if (pad) {
-                const Uint8 padbyte = 0;
-                for (i = 0; i < pad; ++i) {
-                    SDL_RWwrite(dst, &padbyte, 1, 1);
-                }
+                static const Uint8 padbytes[3] = { 0, 0, 0 };
+                SDL_RWwrite(dst, padbytes, 1, pad);
             }
         }
 
+        if (row) {
+            surface->map->info.r = copy_color.r;
+            surface->map->info.g = copy_color.g;
+            surface->map->info.b = copy_color.b;
+            surface->map->info.a = copy_color.a;
+            surface->map->info.flags = copy_flags;
+            SDL_InvalidateMap(surface->map);
+        }
+
         /* Write the BMP file size */
         bfSize = (Uint32)(SDL_RWtell(dst) - fp_offset);
         if (SDL_RWseek(dst, fp_offset + 2, RW_SEEK_SET) < 0) {
@@ -591,9 +806,10 @@ SDL_SaveBMP_RW(SDL_Surface * saveme, SDL_RWops * dst, int freedst)
         }
 
         /* Close it up.. */
-        SDL_UnlockSurface(surface);
-        if (surface != saveme) {
-            SDL_FreeSurface(surface);
+        if (row) {
+            SDL_FreeSurface(row);
+        } else {
+            SDL_UnlockSurface(surface);
         }
     }
 
@@ -354,6 +354,18 @@ SDL_FillRect(SDL_Surface * dst, const SDL_Rect * rect, Uint32 color)
         rect = &dst->clip_rect;
     }
 
+    /* The RLE encoding of the surface has to be dropped when it changes */
+    if ((dst->flags & SDL_RLEACCEL) && !dst->locked) {
+        int retval;
+
+        if (SDL_LockSurface(dst) < 0) {
+            return -1;
+        }
+        retval = SDL_FillRect(dst, rect, color);
+        SDL_UnlockSurface(dst);
+        return retval;
+    }
+
     /* Perform software fill */
     if (!dst->pixels) {
         return SDL_SetError("SDL_FillRect(): You must lock the surface");
@@ -23,6 +23,7 @@
 /* General (mostly internal) pixel/color manipulation routines for SDL */
 
 #include "SDL_endian.h"
+#include "SDL_atomic.h"
 #include "SDL_video.h"
 #include "SDL_sysvideo.h"
 #include "SDL_blit.h"
@@ -611,6 +612,77 @@ SDL_FreeFormat(SDL_PixelFormat *format)
     SDL_free(format);
 }
 
+/*
+ * Palettes that are searched often get a lookup structure, rebuilt when the
+ * palette version changes. The RGB cube is split into 8x8x8 cells, and each
+ * cell lists the only palette entries that can be nearest to a color in it:
+ * those no further from the cell than the furthest point of the cell is
+ * from the entry that is closest to all of it. Searching just those entries
+ * gives exactly the same result as searching the whole palette.
+ *
+ * The 32x32x32 inverse colormap used to blit RGB surfaces onto palettized
+ * surfaces is built from the cells the first time it's needed.
+ */
+#define PALETTE_CELL_BITS       3
+#define PALETTE_CELLS           (1 << (3 * PALETTE_CELL_BITS))
+#define PALETTE_LOOKUP_SEARCHES 32  /* searches before building a lookup */
+#define PALETTE_LOOKUP_COUNT    4   /* palettes with a lookup at once */
+
+typedef struct
+{
+    const SDL_Palette *palette;
+    Uint32 version;
+    int searches;
+    int *cells;                 /* PALETTE_CELLS+1 offsets into candidates */
+    Uint8 *candidates;
+    Uint8 *colormap;            /* SDL_COLORMAP_SIZE entries, or NULL */
+} SDL_PaletteLookup;
+
+static SDL_PaletteLookup palette_lookups[PALETTE_LOOKUP_COUNT];
+static SDL_SpinLock palette_lookup_lock;
+
+static void
+SDL_ResetPaletteLookup(SDL_PaletteLookup * lookup, const SDL_Palette * pal)
+{
+    SDL_free(lookup->cells);
+    SDL_free(lookup->candidates);
+    SDL_free(lookup->colormap);
+    lookup->palette = pal;
+    lookup->version = pal ? pal->version : 0;
+    lookup->searches = 0;
+    lookup->cells = NULL;
+    lookup->candidates = NULL;
+    lookup->colormap = NULL;
+}
+
+/* Find the lookup for a palette, or a slot for it. Call with the lock held. */
+static SDL_PaletteLookup *
+SDL_GetPaletteLookup(const SDL_Palette * pal)
+{
+    SDL_PaletteLookup *lookup = NULL;
+    int i;
+
+    for (i = 0; i < PALETTE_LOOKUP_COUNT; ++i) {
+        if (palette_lookups[i].palette == pal) {
+            lookup = &palette_lookups[i];
+            if (lookup->version != pal->version) {
+                SDL_ResetPaletteLookup(lookup, pal);
+            }
+            return lookup;
+        }
+    }
+
+    /* Replace the palette that has been searched least */
+    lookup = &palette_lookups[0];
+    for (i = 1; i < PALETTE_LOOKUP_COUNT; ++i) {
+        if (palette_lookups[i].searches < lookup->searches) {
+            lookup = &palette_lookups[i];
+        }
+    }
+    SDL_ResetPaletteLookup(lookup, pal);
+    return lookup;
+}
+
 SDL_Palette *
 SDL_AllocPalette(int ncolors)
 {
@@ -697,9 +769,13 @@ SDL_SetPaletteColors(SDL_Palette * palette, const SDL_Color * colors,
     return status;
 }
 
+static void SDL_ForgetBlitTables(SDL_Palette * palette);
+
 void
 SDL_FreePalette(SDL_Palette * palette)
 {
+    int i;
+
     if (!palette) {
         SDL_InvalidParamError("palette");
         return;
@@ -707,6 +783,18 @@ SDL_FreePalette(SDL_Palette * palette)
     if (--palette->refcount > 0) {
         return;
     }
+
+    /* A new palette could be allocated at the same address */
+    SDL_AtomicLock(&palette_lookup_lock);
+    for (i = 0; i < PALETTE_LOOKUP_COUNT; ++i) {
+        if (palette_lookups[i].palette == palette) {
+            SDL_ResetPaletteLookup(&palette_lookups[i], NULL);
+        }
+    }
+    SDL_AtomicUnlock(&palette_lookup_lock);
+
+    SDL_ForgetBlitTables(palette);
+
     SDL_free(palette->colors);
     SDL_free(palette);
 }
@@ -763,6 +851,115 @@ SDL_CalculatePitch(SDL_Surface * surface)
     return (pitch);
 }
 
+/* Distance from a channel value to the nearest and furthest end of a cell */
+#define CELL_DISTANCES(v, lo, hi, near, far) \
+    do {                                        \
+        int n = ((v) < (lo)) ? ((lo) - (v)) :   \
+                ((v) > (hi)) ? ((v) - (hi)) : 0;\
+        int f = SDL_max((v) - (lo), (hi) - (v));\
+        near += n * n;                          \
+        far += f * f;                           \
+    } while (0)
+
+static int
+SDL_BuildPaletteCells(SDL_PaletteLookup * lookup)
+{
+    const SDL_Palette *pal = lookup->palette;
+    const int size = 256 >> PALETTE_CELL_BITS;
+    unsigned int nearest[256];
+    int *cells;
+    Uint8 *candidates;
+    int pass, cell, total, i;
+
+    cells = (int *) SDL_malloc((PALETTE_CELLS + 1) * sizeof(*cells));
+    if (!cells) {
+        return SDL_OutOfMemory();
+    }
+
+    /* Count the candidates on the first pass and fill them in on the second */
+    candidates = NULL;
+    for (pass = 0; pass < 2; ++pass) {
+        total = 0;
+        for (cell = 0; cell < PALETTE_CELLS; ++cell) {
+            const int rlo = (cell >> (2 * PALETTE_CELL_BITS)) * size;
+            const int glo = ((cell >> PALETTE_CELL_BITS) & ((1 << PALETTE_CELL_BITS) - 1)) * size;
+            const int blo = (cell & ((1 << PALETTE_CELL_BITS) - 1)) * size;
+            unsigned int limit = ~0;
+
+            for (i = 0; i < pal->ncolors; ++i) {
+                const SDL_Color *c = &pal->colors[i];
+                const int ad = c->a - SDL_ALPHA_OPAQUE;
+                unsigned int near = ad * ad;
+                unsigned int far = ad * ad;
+
+                CELL_DISTANCES(c->r, rlo, rlo + size - 1, near, far);
+                CELL_DISTANCES(c->g, glo, glo + size - 1, near, far);
+                CELL_DISTANCES(c->b, blo, blo + size - 1, near, far);
+                nearest[i] = near;
+                if (far < limit) {
+                    limit = far;
+                }
+            }
+
+            cells[cell] = total;
+            for (i = 0; i < pal->ncolors; ++i) {
+                if (nearest[i] <= limit) {
+                    if (candidates) {
+                        candidates[total] = (Uint8) i;
+                    }
+                    ++total;
+                }
+            }
+        }
+        cells[PALETTE_CELLS] = total;
+
+        if (pass == 0) {
+            candidates = (Uint8 *) SDL_malloc(total);
+            if (!candidates) {
+                SDL_free(cells);
+                return SDL_OutOfMemory();
+            }
+        }
+    }
+
+    lookup->cells = cells;
+    lookup->candidates = candidates;
+    return 0;
+}
+
+static Uint8
+SDL_FindColorInCell(const SDL_PaletteLookup * lookup, Uint8 r, Uint8 g, Uint8 b)
+{
+    const SDL_Color *colors = lookup->palette->colors;
+    const int cell = ((r >> (8 - PALETTE_CELL_BITS)) << (2 * PALETTE_CELL_BITS)) |
+                     ((g >> (8 - PALETTE_CELL_BITS)) << PALETTE_CELL_BITS) |
+                     (b >> (8 - PALETTE_CELL_BITS));
+    const Uint8 *candidate = &lookup->candidates[lookup->cells[cell]];
+    const Uint8 *end = &lookup->candidates[lookup->cells[cell + 1]];
+    unsigned int smallest = ~0;
+    unsigned int distance;
+    int rd, gd, bd, ad;
+    Uint8 pixel = 0;
+
+    /* The candidates are in palette order, so ties resolve the same way */
+    for (; candidate < end; ++candidate) {
+        const SDL_Color *c = &colors[*candidate];
+        rd = c->r - r;
+        gd = c->g - g;
+        bd = c->b - b;
+        ad = c->a - SDL_ALPHA_OPAQUE;
+        distance = (rd * rd) + (gd * gd) + (bd * bd) + (ad * ad);
+        if (distance < smallest) {
+            pixel = *candidate;
+            if (distance == 0) {        /* Perfect match! */
+                break;
+            }
+            smallest = distance;
+        }
+    }
+    return (pixel);
+}
+
 /*
  * Match an RGB value to a particular palette index
  */
@@ -776,6 +973,23 @@ SDL_FindColor(SDL_Palette * pal, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
     int i;
     Uint8 pixel = 0;
 
+    /* Opaque colors are searched for most, use a lookup if we have one */
+    if (a == SDL_ALPHA_OPAQUE && pal->ncolors <= 256) {
+        SDL_PaletteLookup *lookup;
+
+        SDL_AtomicLock(&palette_lookup_lock);
+        lookup = SDL_GetPaletteLookup(pal);
+        if (!lookup->cells && ++lookup->searches >= PALETTE_LOOKUP_SEARCHES) {
+            SDL_BuildPaletteCells(lookup);
+        }
+        if (lookup->cells) {
+            pixel = SDL_FindColorInCell(lookup, r, g, b);
+            SDL_AtomicUnlock(&palette_lookup_lock);
+            return (pixel);
+        }
+        SDL_AtomicUnlock(&palette_lookup_lock);
+    }
+
     smallest = ~0;
     for (i = 0; i < pal->ncolors; ++i) {
         rd = pal->colors[i].r - r;
@@ -794,6 +1008,48 @@ SDL_FindColor(SDL_Palette * pal, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
     return (pixel);
 }
 
+int
+SDL_GetPaletteColormap(SDL_Palette * pal, Uint8 * colormap)
+{
+    SDL_PaletteLookup *lookup;
+    int r, g, b;
+    Uint8 *entry;
+
+    if (pal->ncolors > 256) {
+        return SDL_SetError("Palette has too many colors for a colormap");
+    }
+
+    SDL_AtomicLock(&palette_lookup_lock);
+    lookup = SDL_GetPaletteLookup(pal);
+    if (!lookup->cells && SDL_BuildPaletteCells(lookup) < 0) {
+        SDL_AtomicUnlock(&palette_lookup_lock);
+        return -1;
+    }
+    if (!lookup->colormap) {
+        lookup->colormap = (Uint8 *) SDL_malloc(SDL_COLORMAP_SIZE);
+        if (!lookup->colormap) {
+            SDL_AtomicUnlock(&palette_lookup_lock);
+            return SDL_OutOfMemory();
+        }
+
+        /* Each entry is the nearest color to the middle of its cube */
+        entry = lookup->colormap;
+        for (r = 0; r < 32; ++r) {
+            for (g = 0; g < 32; ++g) {
+                for (b = 0; b < 32; ++b) {
+                    *entry++ = SDL_FindColorInCell(lookup, (Uint8) ((r << 3) | 4),
+                                                   (Uint8) ((g << 3) | 4),
+                                                   (Uint8) ((b << 3) | 4));
+                }
+            }
+        }
+    }
+    SDL_memcpy(colormap, lookup->colormap, SDL_COLORMAP_SIZE);
+    SDL_AtomicUnlock(&palette_lookup_lock);
+
+    return 0;
+}
+
 /* Find the opaque pixel value corresponding to an RGB triple */
 Uint32
 SDL_MapRGB(const SDL_PixelFormat * format, Uint8 r, Uint8 g, Uint8 b)
@@ -933,19 +1189,273 @@ Map1toN(SDL_PixelFormat * src, Uint8 Rmod, Uint8 Gmod, Uint8 Bmod, Uint8 Amod,
     return (map);
 }
 
-/* Map from BitField to Dithered-Palette to Palette */
+/* Map from BitField to Palette, through an inverse colormap */
 static Uint8 *
 MapNto1(SDL_PixelFormat * src, SDL_PixelFormat * dst, int *identical)
 {
-    /* Generate a 256 color dither palette */
-    SDL_Palette dithered;
-    SDL_Color colors[256];
-    SDL_Palette *pal = dst->palette;
-
-    dithered.ncolors = 256;
-    SDL_DitherColors(colors, 8);
-    dithered.colors = colors;
-    return (Map1to1(&dithered, pal, identical));
+    Uint8 *map;
+
+    *identical = 0;
+    map = (Uint8 *) SDL_malloc(SDL_COLORMAP_SIZE);
+    if (map == NULL) {
+        SDL_OutOfMemory();
+        return (NULL);
+    }
+    if (SDL_GetPaletteColormap(dst->palette, map) < 0) {
+        SDL_free(map);
+        return (NULL);
+    }
+    return (map);
+}
+
+/* Map from BitField to an 8-bit BitField, through the same colormap */
+static Uint8 *
+MapNto8(SDL_PixelFormat * dst)
+{
+    Uint8 *map;
+    Uint8 *entry;
+    int r, g, b;
+
+    map = (Uint8 *) SDL_malloc(SDL_COLORMAP_SIZE);
+    if (map == NULL) {
+        SDL_OutOfMemory();
+        return (NULL);
+    }
+    entry = map;
+    for (r = 0; r < 32; ++r) {
+        for (g = 0; g < 32; ++g) {
+            for (b = 0; b < 32; ++b) {
+                *entry++ = (Uint8) SDL_MapRGB(dst, (Uint8) (r << 3),
+                                              (Uint8) (g << 3),
+                                              (Uint8) (b << 3));
+            }
+        }
+    }
+    return (map);
+}
+
+/* Lookup tables are shared between blit maps that map the same palettes and
+   formats, and the most recently released ones are kept for a while, so
+   surfaces mapped to alternating destinations don't keep rebuilding them. */
+#define BLIT_TABLES_RELEASED_MAX    16
+
+enum
+{
+    BLIT_TABLE_1TO1,
+    BLIT_TABLE_1TON,
+    BLIT_TABLE_NTO1,
+    BLIT_TABLE_NTO8,
+    BLIT_TABLE_DEAD
+};
+
+struct SDL_BlitTable
+{
+    int refcount;
+    int kind;
+    SDL_Palette *src_palette;
+    Uint32 src_version;
+    SDL_Palette *dst_palette;
+    Uint32 dst_version;
+    Uint32 dst_format;
+    Uint32 modulate;            /* r, g, b, a modulation of 1 to N tables */
+    int identity;
+    Uint8 *data;
+    struct SDL_BlitTable *next;
+};
+
+static SDL_BlitTable *blit_tables = NULL;  /* most recently used first */
+static int blit_tables_released = 0;
+static Uint32 blit_table_hits = 0;
+static Uint32 blit_table_misses = 0;
+static SDL_SpinLock blit_table_lock = 0;
+
+static SDL_bool
+SDL_MatchBlitTable(const SDL_BlitTable * table, const SDL_BlitTable * key)
+{
+    return (table->kind == key->kind &&
+            table->src_palette == key->src_palette &&
+            table->src_version == key->src_version &&
+            table->dst_palette == key->dst_palette &&
+            table->dst_version == key->dst_version &&
+            table->dst_format == key->dst_format &&
+            table->modulate == key->modulate);
+}
+
+static void
+SDL_FreeBlitTable(SDL_BlitTable * table)
+{
+    SDL_free(table->data);
+    SDL_free(table);
+}
+
+/* Unlink and free released tables beyond the ones we keep, or all of them.
+   The caller holds blit_table_lock. */
+static void
+SDL_TrimBlitTables(int keep, SDL_Palette * palette)
+{
+    SDL_BlitTable *table, *prev, *next;
+    int released = 0;
+
+    prev = NULL;
+    for (table = blit_tables; table; table = next) {
+        next = table->next;
+        if (palette &&
+            (table->src_palette == palette || table->dst_palette == palette)) {
+            /* A new palette could be allocated at the same address */
+            if (table->refcount > 0) {
+                table->kind = BLIT_TABLE_DEAD;
+            } else {
+                --blit_tables_released;
+                if (prev) {
+                    prev->next = next;
+                } else {
+                    blit_tables = next;
+                }
+                SDL_FreeBlitTable(table);
+                continue;
+            }
+        } else if (table->refcount == 0 && ++released > keep) {
+            --blit_tables_released;
+            if (prev) {
+                prev->next = next;
+            } else {
+                blit_tables = next;
+            }
+            SDL_FreeBlitTable(table);
+            continue;
+        }
+        prev = table;
+    }
+}
+
+static void
+SDL_ForgetBlitTables(SDL_Palette * palette)
+{
+    SDL_AtomicLock(&blit_table_lock);
+    SDL_TrimBlitTables(BLIT_TABLES_RELEASED_MAX, palette);
+    SDL_AtomicUnlock(&blit_table_lock);
+}
+
+static void
+SDL_ReleaseBlitTable(SDL_BlitTable * table)
+{
+    SDL_BlitTable *prev;
+
+    SDL_AtomicLock(&blit_table_lock);
+    if (--table->refcount == 0) {
+        if (table->kind == BLIT_TABLE_DEAD) {
+            if (blit_tables == table) {
+                blit_tables = table->next;
+            } else {
+                for (prev = blit_tables; prev->next != table; prev = prev->next) {
+                }
+                prev->next = table->next;
+            }
+            SDL_FreeBlitTable(table);
+        } else if (++blit_tables_released > BLIT_TABLES_RELEASED_MAX) {
+            SDL_TrimBlitTables(BLIT_TABLES_RELEASED_MAX, NULL);
+        }
+    }
+    SDL_AtomicUnlock(&blit_table_lock);
+}
+
+/* Find or build the lookup table for mapping src to dst */
+static SDL_BlitTable *
+SDL_GetBlitTable(int kind, SDL_Surface * src, SDL_Surface * dst)
+{
+    SDL_PixelFormat *srcfmt = src->format;
+    SDL_PixelFormat *dstfmt = dst->format;
+    const SDL_BlitInfo *info = &src->map->info;
+    SDL_BlitTable key;
+    SDL_BlitTable *table, *prev;
+
+    SDL_zero(key);
+    key.kind = kind;
+    switch (kind) {
+    case BLIT_TABLE_1TO1:
+        key.src_palette = srcfmt->palette;
+        key.src_version = srcfmt->palette->version;
+        key.dst_palette = dstfmt->palette;
+        key.dst_version = dstfmt->palette->version;
+        break;
+    case BLIT_TABLE_1TON:
+        key.src_palette = srcfmt->palette;
+        key.src_version = srcfmt->palette->version;
+        key.dst_format = dstfmt->format;
+        key.modulate = ((Uint32) info->r << 24) | ((Uint32) info->g << 16) |
+                       ((Uint32) info->b << 8) | info->a;
+        break;
+    case BLIT_TABLE_NTO1:
+        key.dst_palette = dstfmt->palette;
+        key.dst_version = dstfmt->palette->version;
+        break;
+    case BLIT_TABLE_NTO8:
+        key.dst_format = dstfmt->format;
+        break;
+    }
+
+    SDL_AtomicLock(&blit_table_lock);
+    prev = NULL;
+    for (table = blit_tables; table; prev = table, table = table->next) {
+        if (SDL_MatchBlitTable(table, &key)) {
+            if (prev) {
+                prev->next = table->next;
+                table->next = blit_tables;
+                blit_tables = table;
+            }
+            if (table->refcount++ == 0) {
+                --blit_tables_released;
+            }
+            ++blit_table_hits;
+            SDL_AtomicUnlock(&blit_table_lock);
+            return table;
+        }
+    }
+    ++blit_table_misses;
+    SDL_AtomicUnlock(&blit_table_lock);
+
+    /* Build the table outside the lock, it can take a while */
+    table = (SDL_BlitTable *) SDL_malloc(sizeof(*table));
+    if (table == NULL) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    *table = key;
+    switch (kind) {
+    case BLIT_TABLE_1TO1:
+        table->data = Map1to1(srcfmt->palette, dstfmt->palette, &table->identity);
+        break;
+    case BLIT_TABLE_1TON:
+        table->data = Map1toN(srcfmt, info->r, info->g, info->b, info->a, dstfmt);
+        break;
+    case BLIT_TABLE_NTO1:
+        table->data = MapNto1(srcfmt, dstfmt, &table->identity);
+        break;
+    case BLIT_TABLE_NTO8:
+        table->data = MapNto8(dstfmt);
+        break;
+    }
+    if (table->data == NULL && !table->identity) {
+        SDL_free(table);
+        return NULL;
+    }
+    table->refcount = 1;
+
+    SDL_AtomicLock(&blit_table_lock);
+    table->next = blit_tables;
+    blit_tables = table;
+    SDL_AtomicUnlock(&blit_table_lock);
+
+    return table;
+}
+
+void
+SDL_GetBlitTableStats(Uint32 * hits, Uint32 * misses)
+{
+    SDL_AtomicLock(&blit_table_lock);
+    *hits = blit_table_hits;
+    *misses = blit_table_misses;
+    SDL_AtomicUnlock(&blit_table_lock);
 }
 
 SDL_BlitMap *
@@ -983,7 +1493,10 @@ SDL_InvalidateMap(SDL_BlitMap * map)
     map->dst = NULL;
     map->src_palette_version = 0;
     map->dst_palette_version = 0;
-    SDL_free(map->info.table);
+    if (map->table) {
+        SDL_ReleaseBlitTable(map->table);
+        map->table = NULL;
+    }
     map->info.table = NULL;
 }
 
@@ -1008,41 +1521,43 @@ SDL_MapSurface(SDL_Surface * src, SDL_Surface * dst)
     if (SDL_ISPIXELFORMAT_INDEXED(srcfmt->format)) {
         if (SDL_ISPIXELFORMAT_INDEXED(dstfmt->format)) {
             /* Palette --> Palette */
-            map->info.table =
-                Map1to1(srcfmt->palette, dstfmt->palette, &map->identity);
-            if (!map->identity) {
-                if (map->info.table == NULL) {
-                    return (-1);
-                }
+            map->table = SDL_GetBlitTable(BLIT_TABLE_1TO1, src, dst);
+            if (map->table == NULL) {
+                return (-1);
             }
+            map->identity = map->table->identity;
             if (srcfmt->BitsPerPixel != dstfmt->BitsPerPixel)
                 map->identity = 0;
         } else {
             /* Palette --> BitField */
-            map->info.table =
-                Map1toN(srcfmt, src->map->info.r, src->map->info.g,
-                        src->map->info.b, src->map->info.a, dstfmt);
-            if (map->info.table == NULL) {
+            map->table = SDL_GetBlitTable(BLIT_TABLE_1TON, src, dst);
+            if (map->table == NULL) {
                 return (-1);
             }
         }
     } else {
         if (SDL_ISPIXELFORMAT_INDEXED(dstfmt->format)) {
             /* BitField --> Palette */
-            map->info.table = MapNto1(srcfmt, dstfmt, &map->identity);
-            if (!map->identity) {
-                if (map->info.table == NULL) {
-                    return (-1);
-                }
+            map->table = SDL_GetBlitTable(BLIT_TABLE_NTO1, src, dst);
+            if (map->table == NULL) {
+                return (-1);
             }
             map->identity = 0;  /* Don't optimize to copy */
         } else {
             /* BitField --> BitField */
             if (srcfmt == dstfmt) {
                 map->identity = 1;
+            } else if (dstfmt->BytesPerPixel == 1) {
+                map->table = SDL_GetBlitTable(BLIT_TABLE_NTO8, src, dst);
+                if (map->table == NULL) {
+                    return (-1);
+                }
             }
         }
     }
+    if (map->table) {
+        map->info.table = map->table->data;
+    }
 
     map->dst = dst;
 
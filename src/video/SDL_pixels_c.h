@@ -32,10 +32,15 @@ extern SDL_BlitMap *SDL_AllocBlitMap(void);
 extern void SDL_InvalidateMap(SDL_BlitMap * map);
 extern int SDL_MapSurface(SDL_Surface * src, SDL_Surface * dst);
 extern void SDL_FreeBlitMap(SDL_BlitMap * map);
+extern void SDL_GetBlitTableStats(Uint32 * hits, Uint32 * misses);
 
 /* Miscellaneous functions */
 extern int SDL_CalculatePitch(SDL_Surface * surface);
 extern void SDL_DitherColors(SDL_Color * colors, int bpp);
 extern Uint8 SDL_FindColor(SDL_Palette * pal, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
 
+/* Fill in a 32x32x32 inverse colormap, SDL_COLORMAP_INDEX() gives the palette
+   index of the nearest color for an RGB value. */
+extern int SDL_GetPaletteColormap(SDL_Palette * pal, Uint8 * colormap);
+
 /* vi: set ts=4 sw=4 expandtab: */
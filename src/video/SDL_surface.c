@@ -21,27 +21,219 @@
 #include "SDL_config.h"
 
 #include "SDL_video.h"
+#include "SDL_atomic.h"
+#include "SDL_hints.h"
 #include "SDL_sysvideo.h"
 #include "SDL_blit.h"
 #include "SDL_RLEaccel_c.h"
 #include "SDL_pixels_c.h"
+#include "SDL_surface_c.h"
+#include "../stdlib/SDL_malloc_c.h"
 
 
-/* Public routines */
+/* Pixel memory pool
+
+   Surface pixels are allocated in size classes, four to each power of two
+   from 256 bytes up, and aligned to SDL_SURFACE_ALIGNMENT bytes.  Freed
+   pixels are kept in a list for their class, up to SDL_SURFACE_POOL_SIZE
+   bytes in all, so surfaces created and freed every frame keep reusing the
+   same memory instead of going through the allocator.
+ */
+#define SDL_POOL_MIN_SHIFT  8
+#define SDL_POOL_CLASSES    96
+#define SDL_POOL_DEFAULT_SIZE   (16 * 1024 * 1024)
+
+typedef struct SDL_PixelBlock
+{
+    void *memory;                   /* The allocation holding the block */
+    size_t size;                    /* The size requested for the pixels */
+    size_t capacity;                /* The size of the class */
+    int sizeclass;                  /* The class, or -1 if it's too big */
+    struct SDL_PixelBlock *next;    /* The next free block of the class */
+} SDL_PixelBlock;
+
+static SDL_SpinLock SDL_pool_lock;
+static SDL_PixelBlock *SDL_pool_free[SDL_POOL_CLASSES];
+static SDL_SurfacePoolStats SDL_pool_stats;
+
+static int
+SDL_GetPixelClass(size_t size, size_t * capacity)
+{
+    int shift = SDL_POOL_MIN_SHIFT;
+    int sizeclass;
+    size_t step;
+    size_t steps;
+
+    if (size <= ((size_t) 1 << shift)) {
+        *capacity = (size_t) 1 << shift;
+        return 0;
+    }
+
+    /* Find the power of two below the size, and the quarter step above it */
+    while (((size - 1) >> shift) > 1) {
+        ++shift;
+    }
+    step = (size_t) 1 << (shift - 2);
+    steps = (size - ((size_t) 1 << shift) + step - 1) / step;
+    sizeclass = 1 + (shift - SDL_POOL_MIN_SHIFT) * 4 + (int) (steps - 1);
+    if (sizeclass >= SDL_POOL_CLASSES) {
+        *capacity = size;
+        return -1;
+    }
+    *capacity = ((size_t) 1 << shift) + steps * step;
+    return sizeclass;
+}
+
+/* Get the most memory the pool may keep.  Call with the pool lock held,
+   which also protects the parsed value. */
+static size_t
+SDL_GetSurfacePoolLimit(void)
+{
+    static SDL_HintHandle *handle = NULL;
+    static Uint32 generation = 0;
+    static size_t limit = SDL_POOL_DEFAULT_SIZE;
+
+    if (generation != SDL_GetHintGeneration()) {
+        const char *hint;
+
+        if (!handle) {
+            handle = SDL_RegisterHint(SDL_HINT_SURFACE_POOL_SIZE);
+        }
+        hint = SDL_GetHintValue(handle);
+        if (hint && *hint) {
+            limit = (size_t) SDL_strtoull(hint, NULL, 0);
+        } else {
+            limit = SDL_POOL_DEFAULT_SIZE;
+        }
+        generation = SDL_GetHintGeneration();
+    }
+    return limit;
+}
+
+static void *
+SDL_AllocPixels(size_t size, SDL_bool clear)
+{
+    SDL_PixelBlock *block = NULL;
+    size_t capacity;
+    int sizeclass;
+
+    sizeclass = SDL_GetPixelClass(size, &capacity);
+
+    SDL_AtomicLock(&SDL_pool_lock);
+    if (sizeclass >= 0 && SDL_pool_free[sizeclass]) {
+        block = SDL_pool_free[sizeclass];
+        SDL_pool_free[sizeclass] = block->next;
+        --SDL_pool_stats.free_buffers;
+        SDL_pool_stats.free_bytes -= capacity;
+        ++SDL_pool_stats.hits;
+    } else {
+        ++SDL_pool_stats.misses;
+    }
+    if (!clear) {
+        ++SDL_pool_stats.uncleared;
+    }
+    SDL_AtomicUnlock(&SDL_pool_lock);
+
+    if (!block) {
+        void *memory;
+        uintptr_t pixels;
+
+        memory = SDL_malloc(capacity + sizeof(*block) + SDL_SURFACE_ALIGNMENT - 1);
+        if (!memory) {
+            return NULL;
+        }
+        pixels = ((uintptr_t) memory + sizeof(*block) + SDL_SURFACE_ALIGNMENT - 1) &
+                 ~(uintptr_t) (SDL_SURFACE_ALIGNMENT - 1);
+        block = (SDL_PixelBlock *) pixels - 1;
+        block->memory = memory;
+        block->capacity = capacity;
+        block->sizeclass = sizeclass;
+    }
+    block->size = size;
+    block->next = NULL;
+
+    if (clear) {
+        SDL_memset(block + 1, 0, size);
+    }
+    SDL_TrackAllocation(SDL_MEMORY_VIDEO_SURFACES, size);
+    return block + 1;
+}
+
+static void
+SDL_FreePixels(void *pixels)
+{
+    SDL_PixelBlock *block = (SDL_PixelBlock *) pixels - 1;
+
+    SDL_TrackFree(SDL_MEMORY_VIDEO_SURFACES, block->size);
+
+    if (block->sizeclass >= 0) {
+        SDL_AtomicLock(&SDL_pool_lock);
+        if (SDL_pool_stats.free_bytes + block->capacity <= SDL_GetSurfacePoolLimit()) {
+            block->next = SDL_pool_free[block->sizeclass];
+            SDL_pool_free[block->sizeclass] = block;
+            ++SDL_pool_stats.free_buffers;
+            SDL_pool_stats.free_bytes += block->capacity;
+            block = NULL;
+        }
+        SDL_AtomicUnlock(&SDL_pool_lock);
+    }
+    if (block) {
+        SDL_free(block->memory);
+    }
+}
+
+int
+SDL_GetSurfacePoolStats(SDL_SurfacePoolStats * stats)
+{
+    if (!stats) {
+        return SDL_InvalidParamError("stats");
+    }
+    SDL_AtomicLock(&SDL_pool_lock);
+    *stats = SDL_pool_stats;
+    SDL_AtomicUnlock(&SDL_pool_lock);
+    return 0;
+}
+
+void
+SDL_FlushSurfacePool(void)
+{
+    SDL_PixelBlock *blocks = NULL;
+    SDL_PixelBlock *block;
+    int i;
+
+    SDL_AtomicLock(&SDL_pool_lock);
+    for (i = 0; i < SDL_POOL_CLASSES; ++i) {
+        while (SDL_pool_free[i]) {
+            block = SDL_pool_free[i];
+            SDL_pool_free[i] = block->next;
+            block->next = blocks;
+            blocks = block;
+        }
+    }
+    SDL_pool_stats.free_buffers = 0;
+    SDL_pool_stats.free_bytes = 0;
+    SDL_AtomicUnlock(&SDL_pool_lock);
+
+    while (blocks) {
+        block = blocks;
+        blocks = block->next;
+        SDL_free(block->memory);
+    }
+}
+
 /*
- * Create an empty RGB surface of the appropriate depth
+ * Create an empty RGB surface, with the pixels set up as asked by the
+ * SDL_SURFACE_* flags
  */
 SDL_Surface *
-SDL_CreateRGBSurface(Uint32 flags,
-                     int width, int height, int depth,
-                     Uint32 Rmask, Uint32 Gmask, Uint32 Bmask, Uint32 Amask)
+SDL_CreateSurfaceInternal(Uint32 flags,
+                          int width, int height, int depth,
+                          Uint32 Rmask, Uint32 Gmask, Uint32 Bmask,
+                          Uint32 Amask)
 {
     SDL_Surface *surface;
     Uint32 format;
 
-    /* The flags are no longer used, make the compiler happy */
-    (void)flags;
-
     /* Get the pixel format */
     format = SDL_MasksToPixelFormatEnum(depth, Rmask, Gmask, Bmask, Amask);
     if (format == SDL_PIXELFORMAT_UNKNOWN) {
@@ -55,6 +247,7 @@ SDL_CreateRGBSurface(Uint32 flags,
         SDL_OutOfMemory();
         return NULL;
     }
+    SDL_TrackAllocation(SDL_MEMORY_VIDEO_SURFACES, sizeof(*surface));
 
     surface->format = SDL_AllocFormat(format);
     if (!surface->format) {
@@ -64,6 +257,10 @@ SDL_CreateRGBSurface(Uint32 flags,
     surface->w = width;
     surface->h = height;
     surface->pitch = SDL_CalculatePitch(surface);
+    if (flags & SDL_SURFACE_ALIGNED) {
+        surface->pitch = (surface->pitch + SDL_SURFACE_ALIGNMENT - 1) &
+                         ~(SDL_SURFACE_ALIGNMENT - 1);
+    }
     SDL_SetClipRect(surface, NULL);
 
     if (SDL_ISPIXELFORMAT_INDEXED(surface->format->format)) {
@@ -88,14 +285,14 @@ SDL_CreateRGBSurface(Uint32 flags,
 
     /* Get the pixels */
     if (surface->w && surface->h) {
-        surface->pixels = SDL_malloc(surface->h * surface->pitch);
+        /* Clearing is important for bitmaps */
+        surface->pixels = SDL_AllocPixels((size_t) surface->h * surface->pitch,
+                                          !(flags & SDL_SURFACE_NOCLEAR));
         if (!surface->pixels) {
             SDL_FreeSurface(surface);
             SDL_OutOfMemory();
             return NULL;
         }
-        /* This is important for bitmaps */
-        SDL_memset(surface->pixels, 0, surface->h * surface->pitch);
     }
 
     /* Allocate an empty mapping */
@@ -115,6 +312,22 @@ SDL_CreateRGBSurface(Uint32 flags,
     return surface;
 }
 
+/* Public routines */
+/*
+ * Create an empty RGB surface of the appropriate depth
+ */
+SDL_Surface *
+SDL_CreateRGBSurface(Uint32 flags,
+                     int width, int height, int depth,
+                     Uint32 Rmask, Uint32 Gmask, Uint32 Bmask, Uint32 Amask)
+{
+    /* The flags are no longer used, make the compiler happy */
+    (void)flags;
+
+    return SDL_CreateSurfaceInternal(0, width, height, depth,
+                                     Rmask, Gmask, Bmask, Amask);
+}
+
 /*
  * Create an RGB surface from an existing memory buffer
  */
@@ -774,7 +987,7 @@ int
 SDL_LockSurface(SDL_Surface * surface)
 {
     if (!surface->locked) {
-        /* Perform the lock */
+        /* Perform the lock, the pixels are kept while RLE encoded */
         if (surface->flags & SDL_RLEACCEL) {
             SDL_UnRLESurface(surface, 1);
             surface->flags |= SDL_RLEACCEL;     /* save accel'd state */
@@ -799,10 +1012,11 @@ SDL_UnlockSurface(SDL_Surface * surface)
         return;
     }
 
-    /* Update RLE encoded surface with new data */
+    /* The pixels may have changed, so encode them again the next time
+       the surface is blitted, in case it's locked again before that */
     if ((surface->flags & SDL_RLEACCEL) == SDL_RLEACCEL) {
         surface->flags &= ~SDL_RLEACCEL;        /* stop lying */
-        SDL_RLESurface(surface);
+        SDL_InvalidateMap(surface->map);
     }
 }
 
@@ -833,11 +1047,13 @@ SDL_ConvertSurface(SDL_Surface * surface, const SDL_PixelFormat * format,
         }
     }
 
-    /* Create a new surface with the desired format */
-    convert = SDL_CreateRGBSurface(flags, surface->w, surface->h,
-                                   format->BitsPerPixel, format->Rmask,
-                                   format->Gmask, format->Bmask,
-                                   format->Amask);
+    /* Create a new surface with the desired format, the blit below
+       overwrites all of its pixels */
+    convert = SDL_CreateSurfaceInternal(SDL_SURFACE_NOCLEAR,
+                                        surface->w, surface->h,
+                                        format->BitsPerPixel, format->Rmask,
+                                        format->Gmask, format->Bmask,
+                                        format->Amask);
     if (convert == NULL) {
         return (NULL);
     }
@@ -868,7 +1084,10 @@ SDL_ConvertSurface(SDL_Surface * surface, const SDL_PixelFormat * format,
     bounds.y = 0;
     bounds.w = surface->w;
     bounds.h = surface->h;
-    SDL_LowerBlit(surface, &bounds, convert, &bounds);
+    if (SDL_LowerBlit(surface, &bounds, convert, &bounds) < 0 &&
+        convert->pixels) {
+        SDL_memset(convert->pixels, 0, convert->h * convert->pitch);
+    }
 
     /* Clean up the original surface, and update converted surface */
     convert->map->info.r = copy_color.r;
@@ -999,6 +1218,7 @@ int SDL_ConvertPixels(int width, int height,
     SDL_BlitMap src_blitmap, dst_blitmap;
     SDL_Rect rect;
     void *nonconst_src = (void *) src;
+    int ret;
 
     /* Check to make sure we are bliting somewhere, so we don't crash */
     if (!dst) {
@@ -1052,7 +1272,11 @@ int SDL_ConvertPixels(int width, int height,
     rect.y = 0;
     rect.w = width;
     rect.h = height;
-    return SDL_LowerBlit(&src_surface, &rect, &dst_surface, &rect);
+    ret = SDL_LowerBlit(&src_surface, &rect, &dst_surface, &rect);
+
+    /* Release any lookup table the mapping is holding */
+    SDL_InvalidateMap(src_surface.map);
+    return ret;
 }
 
 /*
@@ -1085,9 +1309,10 @@ SDL_FreeSurface(SDL_Surface * surface)
         SDL_FreeBlitMap(surface->map);
         surface->map = NULL;
     }
-    if (!(surface->flags & SDL_PREALLOC)) {
-        SDL_free(surface->pixels);
+    if (!(surface->flags & SDL_PREALLOC) && surface->pixels) {
+        SDL_FreePixels(surface->pixels);
     }
+    SDL_TrackFree(SDL_MEMORY_VIDEO_SURFACES, sizeof(*surface));
     SDL_free(surface);
 }
 
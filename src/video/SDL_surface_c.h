@@ -0,0 +1,49 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2013 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "SDL_config.h"
+
+#ifndef _SDL_surface_c_h
+#define _SDL_surface_c_h
+
+/* Useful functions and variables from SDL_surface.c */
+
+#include "SDL_surface.h"
+
+/* The alignment of pooled surface pixels, and of SDL_SURFACE_ALIGNED rows */
+#define SDL_SURFACE_ALIGNMENT   64
+
+/* Flags for SDL_CreateSurfaceInternal() */
+#define SDL_SURFACE_NOCLEAR     0x00000001  /* Leave the pixels uninitialized */
+#define SDL_SURFACE_ALIGNED     0x00000002  /* Align every row for SIMD */
+
+/* Create a surface like SDL_CreateRGBSurface(), for surfaces that SDL
+   fills in itself.  Uninitialized pixels are only safe when every pixel
+   is about to be written, for example by an opaque blit.
+ */
+extern SDL_Surface *SDL_CreateSurfaceInternal(Uint32 flags,
+                                              int width, int height,
+                                              int depth, Uint32 Rmask,
+                                              Uint32 Gmask, Uint32 Bmask,
+                                              Uint32 Amask);
+
+#endif /* _SDL_surface_c_h */
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -33,6 +33,7 @@ typedef struct SDL_WindowShaper SDL_WindowShaper;
 typedef struct SDL_ShapeDriver SDL_ShapeDriver;
 typedef struct SDL_VideoDisplay SDL_VideoDisplay;
 typedef struct SDL_VideoDevice SDL_VideoDevice;
+typedef struct SDL_WindowBuffers SDL_WindowBuffers;
 
 /* Define the SDL window-shaper structure */
 struct SDL_WindowShaper
@@ -92,6 +93,8 @@ struct SDL_Window
     SDL_Surface *surface;
     SDL_bool surface_valid;
 
+    SDL_WindowBuffers *buffers;     /* back buffers for the window surface */
+
     SDL_WindowShaper *shaper;
 
     SDL_WindowUserData *data;
@@ -396,6 +399,11 @@ extern SDL_Window * SDL_GetFocusWindow(void);
 
 extern SDL_bool SDL_ShouldAllowTopmost(void);
 
+extern SDL_bool SDL_CanUpdateWindowFramebufferAsync(void);
+extern void SDL_LockWindowFramebuffer(SDL_Window * window);
+extern void SDL_UnlockWindowFramebuffer(SDL_Window * window);
+extern void SDL_DestroyWindowBuffers(SDL_Window * window);
+
 #endif /* _SDL_sysvideo_h */
 
 /* vi: set ts=4 sw=4 expandtab: */
@@ -30,6 +30,7 @@
 #include "SDL_rect_c.h"
 #include "../events/SDL_events_c.h"
 #include "../timer/SDL_timer_c.h"
+#include "../render/SDL_sysrender.h"
 
 #if SDL_VIDEO_OPENGL
 #include "SDL_opengl.h"
@@ -125,6 +126,7 @@ typedef struct {
     void *pixels;
     int pitch;
     int bytes_per_pixel;
+    SDL_bool locked;    /* The pixels are the texture's locked buffer */
 } SDL_WindowTextureData;
 
 static SDL_bool
@@ -269,8 +271,11 @@ SDL_CreateWindowTexture(_THIS, SDL_Window * window, Uint32 * format, void ** pix
         SDL_DestroyTexture(data->texture);
         data->texture = NULL;
     }
-    SDL_free(data->pixels);
+    if (!data->locked) {
+        SDL_free(data->pixels);
+    }
     data->pixels = NULL;
+    data->locked = SDL_FALSE;
 
     if (SDL_GetRendererInfo(data->renderer, &info) < 0) {
         return -1;
@@ -295,10 +300,18 @@ SDL_CreateWindowTexture(_THIS, SDL_Window * window, Uint32 * format, void ** pix
 
     /* Create framebuffer data */
     data->bytes_per_pixel = SDL_BYTESPERPIXEL(*format);
-    data->pitch = (((window->w * data->bytes_per_pixel) + 3) & ~3);
-    data->pixels = SDL_malloc(window->h * data->pitch);
-    if (!data->pixels) {
-        return SDL_OutOfMemory();
+    if (data->renderer->persistent_locks &&
+        SDL_LockTexture(data->texture, NULL, &data->pixels, &data->pitch) == 0) {
+        /* Draw straight into the texture's own copy of its pixels, and
+           just unlock the parts that change when the window is updated.
+         */
+        data->locked = SDL_TRUE;
+    } else {
+        data->pitch = (((window->w * data->bytes_per_pixel) + 3) & ~3);
+        data->pixels = SDL_malloc(window->h * data->pitch);
+        if (!data->pixels) {
+            return SDL_OutOfMemory();
+        }
     }
 
     *pixels = data->pixels;
@@ -322,6 +335,41 @@ SDL_UpdateWindowTexture(_THIS, SDL_Window * window, const SDL_Rect * rects, int
         return SDL_SetError("No window texture data");
     }
 
+    if (data->locked) {
+        /* Unlocking each rect uploads just that rect.  Renderers that can't
+           upload a rect narrower than the texture in place (OpenGL ES)
+           repack it into a temporary buffer first.
+         */
+        SDL_Rect full_rect;
+        SDL_bool updated = SDL_FALSE;
+        int pitch, i;
+
+        full_rect.x = 0;
+        full_rect.y = 0;
+        full_rect.w = window->w;
+        full_rect.h = window->h;
+        for (i = 0; i < numrects; ++i) {
+            if (!SDL_IntersectRect(&rects[i], &full_rect, &rect)) {
+                continue;
+            }
+            if (SDL_LockTexture(data->texture, &rect, &src, &pitch) < 0) {
+                return -1;
+            }
+            SDL_UnlockTexture(data->texture);
+            updated = SDL_TRUE;
+        }
+        if (!updated) {
+            return 0;
+        }
+
+        if (SDL_RenderCopy(data->renderer, data->texture, NULL, NULL) < 0) {
+            return -1;
+        }
+
+        SDL_RenderPresent(data->renderer);
+        return 0;
+    }
+
     /* Update a single rect that contains subrects for best DMA performance */
     if (SDL_GetSpanEnclosingRect(window->w, window->h, numrects, rects, &rect)) {
         src = (void *)((Uint8 *)data->pixels +
@@ -355,7 +403,9 @@ SDL_DestroyWindowTexture(_THIS, SDL_Window * window)
     if (data->renderer) {
         SDL_DestroyRenderer(data->renderer);
     }
-    SDL_free(data->pixels);
+    if (!data->locked) {
+        SDL_free(data->pixels);
+    }
     SDL_free(data);
 }
 
@@ -1341,6 +1391,7 @@ SDL_RecreateWindow(SDL_Window * window, Uint32 flags)
     SDL_HideWindow(window);
 
     /* Tear down the old native window */
+    SDL_DestroyWindowBuffers(window);
     if (window->surface) {
         window->surface->flags &= ~SDL_DONTFREE;
         SDL_FreeSurface(window->surface);
@@ -1874,6 +1925,8 @@ SDL_GetWindowSurface(SDL_Window * window)
     CHECK_WINDOW_MAGIC(window, NULL);
 
     if (!window->surface_valid) {
+        /* The back buffer thread may be copying into the old surface */
+        SDL_LockWindowFramebuffer(window);
         if (window->surface) {
             window->surface->flags &= ~SDL_DONTFREE;
             SDL_FreeSurface(window->surface);
@@ -1883,6 +1936,7 @@ SDL_GetWindowSurface(SDL_Window * window)
             window->surface_valid = SDL_TRUE;
             window->surface->flags |= SDL_DONTFREE;
         }
+        SDL_UnlockWindowFramebuffer(window);
     }
     return window->surface;
 }
@@ -1905,13 +1959,18 @@ int
 SDL_UpdateWindowSurfaceRects(SDL_Window * window, const SDL_Rect * rects,
                              int numrects)
 {
+    int retval;
+
     CHECK_WINDOW_MAGIC(window, -1);
 
     if (!window->surface_valid) {
         return SDL_SetError("Window surface is invalid, please call SDL_GetWindowSurface() to get a new surface");
     }
 
-    return _this->UpdateWindowFramebuffer(_this, window, rects, numrects);
+    SDL_LockWindowFramebuffer(window);
+    retval = _this->UpdateWindowFramebuffer(_this, window, rects, numrects);
+    SDL_UnlockWindowFramebuffer(window);
+    return retval;
 }
 
 int
@@ -2189,6 +2248,7 @@ SDL_DestroyWindow(SDL_Window * window)
         }
     }
 
+    SDL_DestroyWindowBuffers(window);
     if (window->surface) {
         window->surface->flags &= ~SDL_DONTFREE;
         SDL_FreeSurface(window->surface);
@@ -3243,4 +3303,11 @@ SDL_ShouldAllowTopmost(void)
     return SDL_TRUE;
 }
 
+SDL_bool
+SDL_CanUpdateWindowFramebufferAsync(void)
+{
+    /* The texture framebuffer needs the renderer's thread */
+    return (_this && _this->UpdateWindowFramebuffer != SDL_UpdateWindowTexture);
+}
+
 /* vi: set ts=4 sw=4 expandtab: */
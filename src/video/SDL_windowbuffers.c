@@ -0,0 +1,610 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2013 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "SDL_config.h"
+
+/* Back buffers for the window surface, shown by a separate thread.
+
+   Frames move from FREE to DRAWING (SDL_AcquireWindowSurface), QUEUED
+   (SDL_PresentWindowSurface) and PRESENTING (being copied into the window
+   framebuffer) and back to FREE.  Only the newest queued frame is ever
+   shown; older ones are dropped and their changed areas are carried over
+   to the frame that replaces them.
+*/
+
+#include "SDL_video.h"
+#include "SDL_timer.h"
+#include "SDL_sysvideo.h"
+
+#define SDL_MAX_WINDOW_BUFFERS  3
+
+/* Past this many rectangles a frame just copies everything */
+#define SDL_MAX_DAMAGE_RECTS    16
+
+typedef enum
+{
+    SDL_BUFFER_FREE,
+    SDL_BUFFER_DRAWING,
+    SDL_BUFFER_QUEUED,
+    SDL_BUFFER_PRESENTING
+} SDL_WindowBufferState;
+
+typedef struct
+{
+    SDL_bool all;
+    int numrects;
+    SDL_Rect rects[SDL_MAX_DAMAGE_RECTS];
+} SDL_WindowDamage;
+
+typedef struct
+{
+    SDL_Surface *surface;
+    SDL_WindowBufferState state;
+    Uint32 sequence;
+    SDL_WindowDamage damage;
+} SDL_WindowBuffer;
+
+struct SDL_WindowBuffers
+{
+    SDL_Window *window;
+    int num_buffers;
+    SDL_WindowBuffer buffers[SDL_MAX_WINDOW_BUFFERS];
+    SDL_WindowDamage carry;     /* changes from dropped frames with nothing newer queued */
+    Uint32 sequence;
+    Uint32 interval;
+    Uint32 next_present;
+
+    SDL_mutex *lock;            /* protects everything above and the stats */
+    SDL_cond *cond;
+    SDL_mutex *framebuffer_lock;    /* held while the window framebuffer is in use */
+    SDL_Thread *thread;
+    SDL_bool quit;
+
+    SDL_WindowSurfaceStats stats;
+};
+
+
+static void
+SDL_AddDamage(SDL_WindowDamage *damage, const SDL_Rect *rect)
+{
+    if (damage->all) {
+        return;
+    }
+    if (damage->numrects == SDL_MAX_DAMAGE_RECTS) {
+        damage->all = SDL_TRUE;
+        return;
+    }
+    damage->rects[damage->numrects++] = *rect;
+}
+
+static void
+SDL_MergeDamage(SDL_WindowDamage *damage, const SDL_WindowDamage *from)
+{
+    int i;
+
+    if (from->all) {
+        damage->all = SDL_TRUE;
+        return;
+    }
+    for (i = 0; i < from->numrects; ++i) {
+        SDL_AddDamage(damage, &from->rects[i]);
+    }
+}
+
+static void
+SDL_CopyWindowBufferRect(SDL_Surface *dst, SDL_Surface *src, const SDL_Rect *rect)
+{
+    const int bpp = src->format->BytesPerPixel;
+    const size_t length = (size_t)rect->w * bpp;
+    const Uint8 *srcp = (const Uint8 *)src->pixels + rect->y * src->pitch + rect->x * bpp;
+    Uint8 *dstp = (Uint8 *)dst->pixels + rect->y * dst->pitch + rect->x * bpp;
+    int h = rect->h;
+
+    while (h--) {
+        SDL_memcpy(dstp, srcp, length);
+        srcp += src->pitch;
+        dstp += dst->pitch;
+    }
+}
+
+/* Copy a frame into the window framebuffer and show it, with the
+   framebuffer lock held and the buffer lock released.
+ */
+static void
+SDL_ShowWindowBuffer(SDL_WindowBuffers *buffers, SDL_WindowBuffer *buffer,
+                     const SDL_WindowDamage *damage)
+{
+    SDL_VideoDevice *_this = SDL_GetVideoDevice();
+    SDL_Window *window = buffers->window;
+    SDL_Surface *framebuffer = window->surface;
+    SDL_Rect bounds, rects[SDL_MAX_DAMAGE_RECTS];
+    int i, numrects = 0;
+
+    if (!framebuffer || framebuffer->format->format != buffer->surface->format->format) {
+        return;
+    }
+
+    /* The framebuffer may have been resized after this frame was drawn */
+    bounds.x = 0;
+    bounds.y = 0;
+    bounds.w = SDL_min(framebuffer->w, buffer->surface->w);
+    bounds.h = SDL_min(framebuffer->h, buffer->surface->h);
+
+    if (damage->all) {
+        rects[numrects++] = bounds;
+    } else {
+        for (i = 0; i < damage->numrects; ++i) {
+            if (SDL_IntersectRect(&damage->rects[i], &bounds, &rects[numrects])) {
+                ++numrects;
+            }
+        }
+    }
+    if (numrects == 0) {
+        return;
+    }
+
+    for (i = 0; i < numrects; ++i) {
+        SDL_CopyWindowBufferRect(framebuffer, buffer->surface, &rects[i]);
+    }
+    _this->UpdateWindowFramebuffer(_this, window, rects, numrects);
+}
+
+static SDL_bool
+SDL_HasQueuedFrame(SDL_WindowBuffers *buffers)
+{
+    int i;
+
+    for (i = 0; i < buffers->num_buffers; ++i) {
+        if (buffers->buffers[i].state == SDL_BUFFER_QUEUED) {
+            return SDL_TRUE;
+        }
+    }
+    return SDL_FALSE;
+}
+
+/* Show the newest queued frame and drop the rest, called with the buffer
+   lock held.  The lock is released while the frame is being copied.
+ */
+static void
+SDL_PresentNewestFrame(SDL_WindowBuffers *buffers)
+{
+    SDL_WindowBuffer *newest = NULL;
+    SDL_WindowDamage damage;
+    Uint32 start;
+    int i;
+
+    for (i = 0; i < buffers->num_buffers; ++i) {
+        SDL_WindowBuffer *buffer = &buffers->buffers[i];
+        if (buffer->state == SDL_BUFFER_QUEUED &&
+            (!newest || (Sint32)(buffer->sequence - newest->sequence) > 0)) {
+            newest = buffer;
+        }
+    }
+    if (!newest) {
+        return;
+    }
+    for (i = 0; i < buffers->num_buffers; ++i) {
+        SDL_WindowBuffer *buffer = &buffers->buffers[i];
+        if (buffer->state == SDL_BUFFER_QUEUED && buffer != newest) {
+            SDL_MergeDamage(&newest->damage, &buffer->damage);
+            buffer->state = SDL_BUFFER_FREE;
+            ++buffers->stats.frames_dropped;
+        }
+    }
+    newest->state = SDL_BUFFER_PRESENTING;
+    damage = newest->damage;
+    SDL_UnlockMutex(buffers->lock);
+
+    start = SDL_GetTicks();
+    SDL_LockMutex(buffers->framebuffer_lock);
+    SDL_ShowWindowBuffer(buffers, newest, &damage);
+    SDL_UnlockMutex(buffers->framebuffer_lock);
+
+    SDL_LockMutex(buffers->lock);
+    newest->state = SDL_BUFFER_FREE;
+    ++buffers->stats.frames_presented;
+    buffers->stats.present_time = SDL_GetTicks() - start;
+    buffers->next_present = start + buffers->interval;
+    SDL_CondBroadcast(buffers->cond);
+}
+
+/* Without a present thread, frames are shown when the application calls in */
+static void
+SDL_PresentDueFrame(SDL_WindowBuffers *buffers)
+{
+    if (buffers->interval &&
+        !SDL_TICKS_PASSED(SDL_GetTicks(), buffers->next_present)) {
+        return;
+    }
+    SDL_PresentNewestFrame(buffers);
+}
+
+static int
+SDL_WindowBuffersThread(void *data)
+{
+    SDL_WindowBuffers *buffers = (SDL_WindowBuffers *)data;
+
+    SDL_LockMutex(buffers->lock);
+    for ( ; ; ) {
+        if (!SDL_HasQueuedFrame(buffers)) {
+            if (buffers->quit) {
+                break;
+            }
+            SDL_CondWait(buffers->cond, buffers->lock);
+            continue;
+        }
+
+        /* Wait out the frame interval, picking up newer frames meanwhile */
+        if (buffers->interval && !buffers->quit) {
+            Uint32 now = SDL_GetTicks();
+            if (!SDL_TICKS_PASSED(now, buffers->next_present)) {
+                SDL_CondWaitTimeout(buffers->cond, buffers->lock,
+                                    buffers->next_present - now);
+                continue;
+            }
+        }
+        SDL_PresentNewestFrame(buffers);
+    }
+    SDL_UnlockMutex(buffers->lock);
+
+    return 0;
+}
+
+static void
+SDL_FreeWindowBufferSurfaces(SDL_WindowBuffers *buffers)
+{
+    int i;
+
+    for (i = 0; i < buffers->num_buffers; ++i) {
+        SDL_Surface *surface = buffers->buffers[i].surface;
+        if (surface) {
+            surface->flags &= ~SDL_DONTFREE;
+            SDL_FreeSurface(surface);
+            buffers->buffers[i].surface = NULL;
+        }
+    }
+}
+
+/* Create back buffers matching the window framebuffer, starting out with
+   what is on the screen.
+ */
+static int
+SDL_CreateWindowBufferSurfaces(SDL_WindowBuffers *buffers)
+{
+    SDL_Surface *framebuffer = SDL_GetWindowSurface(buffers->window);
+    SDL_PixelFormat *format;
+    SDL_Rect rect;
+    int i;
+
+    if (!framebuffer) {
+        return -1;
+    }
+    format = framebuffer->format;
+
+    rect.x = 0;
+    rect.y = 0;
+    rect.w = framebuffer->w;
+    rect.h = framebuffer->h;
+
+    SDL_FreeWindowBufferSurfaces(buffers);
+    for (i = 0; i < buffers->num_buffers; ++i) {
+        SDL_WindowBuffer *buffer = &buffers->buffers[i];
+
+        buffer->surface = SDL_CreateRGBSurface(0, framebuffer->w, framebuffer->h,
+                                               format->BitsPerPixel,
+                                               format->Rmask, format->Gmask,
+                                               format->Bmask, format->Amask);
+        if (!buffer->surface) {
+            SDL_FreeWindowBufferSurfaces(buffers);
+            return -1;
+        }
+        buffer->surface->flags |= SDL_DONTFREE;
+        if (format->palette) {
+            SDL_SetSurfacePalette(buffer->surface, format->palette);
+        }
+        SDL_CopyWindowBufferRect(buffer->surface, framebuffer, &rect);
+        buffer->state = SDL_BUFFER_FREE;
+    }
+    SDL_zero(buffers->carry);
+    return 0;
+}
+
+static void
+SDL_FreeWindowBuffers(SDL_WindowBuffers *buffers)
+{
+    SDL_FreeWindowBufferSurfaces(buffers);
+    if (buffers->cond) {
+        SDL_DestroyCond(buffers->cond);
+    }
+    if (buffers->lock) {
+        SDL_DestroyMutex(buffers->lock);
+    }
+    if (buffers->framebuffer_lock) {
+        SDL_DestroyMutex(buffers->framebuffer_lock);
+    }
+    SDL_free(buffers);
+}
+
+void
+SDL_DestroyWindowBuffers(SDL_Window * window)
+{
+    SDL_WindowBuffers *buffers = window->buffers;
+
+    if (!buffers) {
+        return;
+    }
+
+    /* Show the last frame, if it is still waiting */
+    SDL_LockMutex(buffers->lock);
+    buffers->quit = SDL_TRUE;
+    if (buffers->thread) {
+        SDL_CondSignal(buffers->cond);
+    } else {
+        SDL_PresentNewestFrame(buffers);
+    }
+    SDL_UnlockMutex(buffers->lock);
+    if (buffers->thread) {
+        SDL_WaitThread(buffers->thread, NULL);
+    }
+
+    window->buffers = NULL;
+    SDL_FreeWindowBuffers(buffers);
+}
+
+void
+SDL_LockWindowFramebuffer(SDL_Window * window)
+{
+    if (window->buffers) {
+        SDL_LockMutex(window->buffers->framebuffer_lock);
+    }
+}
+
+void
+SDL_UnlockWindowFramebuffer(SDL_Window * window)
+{
+    if (window->buffers) {
+        SDL_UnlockMutex(window->buffers->framebuffer_lock);
+    }
+}
+
+int
+SDL_SetWindowSurfaceBuffers(SDL_Window * window, int num_buffers, Uint32 interval)
+{
+    SDL_WindowBuffers *buffers;
+
+    if (!window) {
+        return SDL_InvalidParamError("window");
+    }
+    if (num_buffers != 0 &&
+        (num_buffers < 2 || num_buffers > SDL_MAX_WINDOW_BUFFERS)) {
+        return SDL_InvalidParamError("num_buffers");
+    }
+
+    SDL_DestroyWindowBuffers(window);
+    if (num_buffers == 0) {
+        return 0;
+    }
+
+    buffers = (SDL_WindowBuffers *)SDL_calloc(1, sizeof(*buffers));
+    if (!buffers) {
+        return SDL_OutOfMemory();
+    }
+    buffers->window = window;
+    buffers->num_buffers = num_buffers;
+    buffers->interval = interval;
+    buffers->next_present = SDL_GetTicks();
+
+    buffers->lock = SDL_CreateMutex();
+    buffers->framebuffer_lock = SDL_CreateMutex();
+    buffers->cond = SDL_CreateCond();
+    if (!buffers->lock || !buffers->framebuffer_lock || !buffers->cond ||
+        SDL_CreateWindowBufferSurfaces(buffers) < 0) {
+        SDL_FreeWindowBuffers(buffers);
+        return -1;
+    }
+
+    window->buffers = buffers;
+    if (SDL_CanUpdateWindowFramebufferAsync()) {
+        buffers->thread = SDL_CreateThread(SDL_WindowBuffersThread, "SDLWindowBuffers", buffers);
+        if (!buffers->thread) {
+            window->buffers = NULL;
+            SDL_FreeWindowBuffers(buffers);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+SDL_Surface *
+SDL_AcquireWindowSurface(SDL_Window * window)
+{
+    SDL_WindowBuffers *buffers;
+    SDL_WindowBuffer *buffer = NULL;
+    int i;
+
+    if (!window) {
+        SDL_InvalidParamError("window");
+        return NULL;
+    }
+    buffers = window->buffers;
+    if (!buffers) {
+        SDL_SetError("Window surface buffers are not enabled");
+        return NULL;
+    }
+
+    SDL_LockMutex(buffers->lock);
+    if (!buffers->thread) {
+        SDL_PresentDueFrame(buffers);
+    }
+
+    /* Still drawing the last one */
+    for (i = 0; i < buffers->num_buffers; ++i) {
+        if (buffers->buffers[i].state == SDL_BUFFER_DRAWING) {
+            SDL_UnlockMutex(buffers->lock);
+            return buffers->buffers[i].surface;
+        }
+    }
+
+    /* Start over at the new size if the window has been resized */
+    if (!window->surface_valid || !buffers->buffers[0].surface ||
+        buffers->buffers[0].surface->w != window->w ||
+        buffers->buffers[0].surface->h != window->h) {
+        SDL_bool presenting;
+
+        do {
+            presenting = SDL_FALSE;
+            for (i = 0; i < buffers->num_buffers; ++i) {
+                if (buffers->buffers[i].state == SDL_BUFFER_QUEUED) {
+                    buffers->buffers[i].state = SDL_BUFFER_FREE;
+                    ++buffers->stats.frames_dropped;
+                } else if (buffers->buffers[i].state == SDL_BUFFER_PRESENTING) {
+                    presenting = SDL_TRUE;
+                }
+            }
+            if (presenting) {
+                SDL_CondWait(buffers->cond, buffers->lock);
+            }
+        } while (presenting);
+
+        if (SDL_CreateWindowBufferSurfaces(buffers) < 0) {
+            SDL_UnlockMutex(buffers->lock);
+            return NULL;
+        }
+    }
+
+    for ( ; ; ) {
+        SDL_WindowBuffer *oldest = NULL;
+
+        for (i = 0; i < buffers->num_buffers; ++i) {
+            SDL_WindowBuffer *candidate = &buffers->buffers[i];
+            if (candidate->state == SDL_BUFFER_FREE) {
+                buffer = candidate;
+                break;
+            }
+            if (candidate->state == SDL_BUFFER_QUEUED &&
+                (!oldest || (Sint32)(candidate->sequence - oldest->sequence) < 0)) {
+                oldest = candidate;
+            }
+        }
+        if (buffer) {
+            break;
+        }
+
+        /* Drop the oldest frame that hasn't been shown yet */
+        if (oldest) {
+            SDL_WindowBuffer *next = NULL;
+
+            for (i = 0; i < buffers->num_buffers; ++i) {
+                SDL_WindowBuffer *candidate = &buffers->buffers[i];
+                if (candidate->state == SDL_BUFFER_QUEUED && candidate != oldest &&
+                    (!next || (Sint32)(candidate->sequence - next->sequence) < 0)) {
+                    next = candidate;
+                }
+            }
+            SDL_MergeDamage(next ? &next->damage : &buffers->carry, &oldest->damage);
+            ++buffers->stats.frames_dropped;
+            buffer = oldest;
+            break;
+        }
+
+        /* Everything else is on its way to the screen */
+        SDL_CondWait(buffers->cond, buffers->lock);
+    }
+
+    buffer->state = SDL_BUFFER_DRAWING;
+    SDL_zero(buffer->damage);
+    SDL_UnlockMutex(buffers->lock);
+
+    return buffer->surface;
+}
+
+int
+SDL_PresentWindowSurface(SDL_Window * window, const SDL_Rect * rects, int numrects)
+{
+    SDL_WindowBuffers *buffers;
+    SDL_WindowBuffer *buffer = NULL;
+    int i;
+
+    if (!window) {
+        return SDL_InvalidParamError("window");
+    }
+    buffers = window->buffers;
+    if (!buffers) {
+        return SDL_SetError("Window surface buffers are not enabled");
+    }
+
+    SDL_LockMutex(buffers->lock);
+    for (i = 0; i < buffers->num_buffers; ++i) {
+        if (buffers->buffers[i].state == SDL_BUFFER_DRAWING) {
+            buffer = &buffers->buffers[i];
+            break;
+        }
+    }
+    if (!buffer) {
+        SDL_UnlockMutex(buffers->lock);
+        return SDL_SetError("SDL_AcquireWindowSurface() hasn't been called");
+    }
+
+    if (rects) {
+        for (i = 0; i < numrects; ++i) {
+            SDL_AddDamage(&buffer->damage, &rects[i]);
+        }
+    } else {
+        buffer->damage.all = SDL_TRUE;
+    }
+    SDL_MergeDamage(&buffer->damage, &buffers->carry);
+    SDL_zero(buffers->carry);
+
+    buffer->sequence = buffers->sequence++;
+    buffer->state = SDL_BUFFER_QUEUED;
+    if (buffers->thread) {
+        SDL_CondSignal(buffers->cond);
+    } else {
+        SDL_PresentDueFrame(buffers);
+    }
+    SDL_UnlockMutex(buffers->lock);
+
+    return 0;
+}
+
+int
+SDL_GetWindowSurfaceStats(SDL_Window * window, SDL_WindowSurfaceStats * stats)
+{
+    SDL_WindowBuffers *buffers;
+
+    if (!window) {
+        return SDL_InvalidParamError("window");
+    }
+    if (!stats) {
+        return SDL_InvalidParamError("stats");
+    }
+    buffers = window->buffers;
+    if (!buffers) {
+        return SDL_SetError("Window surface buffers are not enabled");
+    }
+
+    SDL_LockMutex(buffers->lock);
+    *stats = buffers->stats;
+    SDL_UnlockMutex(buffers->lock);
+
+    return 0;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
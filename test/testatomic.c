@@ -15,6 +15,7 @@
 #include "SDL_atomic.h"
 #include "SDL_assert.h"
 #include "SDL_cpuinfo.h"
+#include "SDL_lockfree.h"
 
 /*
   Absolutely basic tests just to see if we get the expected value
@@ -243,6 +244,78 @@ void RunEpicTest()
 /* End atomic operation test */
 /**************************************************************************/
 
+/**************************************************************************/
+/* Lock contention test */
+
+static SDL_mutex *statsMutex;
+static SDL_SpinLock statsSpinLock;
+static SDL_atomic_t statsWaiting;
+
+static int SDLCALL LockStatsWaiter(void *data)
+{
+    SDL_AtomicSet(&statsWaiting, 1);
+    if (data) {
+        SDL_AtomicLock(&statsSpinLock);
+        SDL_AtomicUnlock(&statsSpinLock);
+    } else {
+        SDL_LockMutex(statsMutex);
+        SDL_UnlockMutex(statsMutex);
+    }
+    return 0;
+}
+
+static void RunLockStatsTest(void)
+{
+    SDL_Thread *thread;
+    SDL_LockStats before, after;
+
+    SDL_Log("\nlock stats--------------------------------------\n\n");
+
+    /* Hold the mutex long enough that the waiter has to wait for it */
+    statsMutex = SDL_CreateMutex();
+    SDL_AtomicSet(&statsWaiting, 0);
+    SDL_LockMutex(statsMutex);
+    thread = SDL_CreateThread(LockStatsWaiter, "LockStatsWaiter", NULL);
+    while (!SDL_AtomicGet(&statsWaiting)) {
+        SDL_Delay(1);
+    }
+    SDL_Delay(100);
+    SDL_UnlockMutex(statsMutex);
+    SDL_WaitThread(thread, NULL);
+
+    SDL_GetMutexStats(statsMutex, &after);
+    SDL_DestroyMutex(statsMutex);
+    SDL_Log("Mutex stats: %u locks, %u contended, %u spins, %u sleeps\n",
+            after.locks, after.contended, after.spins, after.sleeps);
+    SDL_assert(after.locks == 2);
+    SDL_assert(after.contended == 1);
+
+    /* Same again for the spinlock, whose counters are global */
+    SDL_GetSpinLockStats(&before);
+    SDL_AtomicSet(&statsWaiting, 0);
+    SDL_AtomicLock(&statsSpinLock);
+    thread = SDL_CreateThread(LockStatsWaiter, "LockStatsWaiter", &statsSpinLock);
+    while (!SDL_AtomicGet(&statsWaiting)) {
+        SDL_Delay(1);
+    }
+    SDL_Delay(100);
+    SDL_AtomicUnlock(&statsSpinLock);
+    SDL_WaitThread(thread, NULL);
+
+    SDL_GetSpinLockStats(&after);
+    SDL_Log("Spinlock stats: %u contended, %u spins, %u sleeps\n",
+            after.contended - before.contended, after.spins - before.spins,
+            after.sleeps - before.sleeps);
+    /* The counters stay at zero where they aren't maintained */
+    if (after.contended != 0) {
+        SDL_assert(after.contended == before.contended + 1);
+        SDL_assert(after.sleeps > before.sleeps);
+    }
+}
+
+/* End lock contention test */
+/**************************************************************************/
+
 /**************************************************************************/
 /* Lock-free FIFO test */
 
@@ -596,6 +669,7 @@ static void RunFIFOTest(SDL_bool lock_free)
     WriterData writerData[NUM_WRITERS];
     ReaderData readerData[NUM_READERS];
     Uint32 start, end;
+    SDL_LockStats stats;
     int i, j;
     int grand_total;
 	char textBuffer[1024];
@@ -666,11 +740,16 @@ static void RunFIFOTest(SDL_bool lock_free)
     SDL_DestroySemaphore(readersDone);
     SDL_DestroySemaphore(writersDone);
 
-    if (!lock_free) {
+    if (lock_free) {
+        SDL_GetSpinLockStats(&stats);
+    } else {
+        SDL_GetMutexStats(queue.mutex, &stats);
         SDL_DestroyMutex(queue.mutex);
     }
 
     SDL_Log("Finished in %f sec\n", (end - start) / 1000.f);
+    SDL_Log("Lock stats: %u locks, %u contended, %u spins, %u sleeps\n",
+            stats.locks, stats.contended, stats.spins, stats.sleeps);
 
     SDL_Log("\n");
     for (i = 0; i < NUM_WRITERS; ++i) {
@@ -707,6 +786,303 @@ static void RunFIFOTest(SDL_bool lock_free)
 /* End FIFO test */
 /**************************************************************************/
 
+/**************************************************************************/
+/* 64-bit atomic tests */
+
+#define NUM_ADDERS_64       4
+#define ADDS_PER_ADDER_64   1000000
+
+static SDL_atomic64_t total64;
+
+static int SDLCALL Adder64(void *data)
+{
+    Sint64 increment = (Sint64)(size_t)data << 32;
+    int i;
+
+    for (i = 0; i < ADDS_PER_ADDER_64; ++i) {
+        SDL_AtomicAdd64Explicit(&total64, increment + 1, SDL_MEMORY_ORDER_RELAXED);
+    }
+    return 0;
+}
+
+static void RunAtomic64Test(void)
+{
+    SDL_Thread *threads[NUM_ADDERS_64];
+    SDL_atomic64_t v;
+    Sint64 expected = 0;
+    Uint64 start, end;
+    SDL_bool tfret;
+    int i;
+
+    SDL_Log("\n64-bit atomic-----------------------------------\n\n");
+
+    SDL_AtomicSet64(&v, 0);
+    tfret = (SDL_AtomicSet64(&v, 0x100000000LL) == 0);
+    SDL_Log("AtomicSet64          tfret=%s\n", tf(tfret));
+    SDL_assert(tfret);
+    tfret = (SDL_AtomicAdd64(&v, 0x100000001LL) == 0x100000000LL && SDL_AtomicGet64(&v) == 0x200000001LL);
+    SDL_Log("AtomicAdd64          tfret=%s\n", tf(tfret));
+    SDL_assert(tfret);
+    tfret = SDL_AtomicCAS64(&v, 0x200000001LL, -1) && !SDL_AtomicCAS64(&v, 0x200000001LL, 0);
+    SDL_Log("AtomicCAS64          tfret=%s\n", tf(tfret));
+    SDL_assert(tfret);
+    SDL_AtomicStore64(&v, 42, SDL_MEMORY_ORDER_RELEASE);
+    tfret = (SDL_AtomicLoad64(&v, SDL_MEMORY_ORDER_ACQUIRE) == 42);
+    SDL_Log("AtomicLoad/Store64   tfret=%s\n", tf(tfret));
+    SDL_assert(tfret);
+
+    /* Each thread adds to both halves, so a torn update shows up */
+    SDL_AtomicSet64(&total64, 0);
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < NUM_ADDERS_64; ++i) {
+        threads[i] = SDL_CreateThread(Adder64, "Adder64", (void *)(size_t)(i + 1));
+        expected += ((Sint64)(i + 1) << 32) * ADDS_PER_ADDER_64 + ADDS_PER_ADDER_64;
+    }
+    for (i = 0; i < NUM_ADDERS_64; ++i) {
+        SDL_WaitThread(threads[i], NULL);
+    }
+    end = SDL_GetPerformanceCounter();
+
+    tfret = (SDL_AtomicGet64(&total64) == expected);
+    SDL_Log("Threaded AtomicAdd64 tfret=%s in %f sec\n", tf(tfret),
+            (double)(end - start) / SDL_GetPerformanceFrequency());
+    SDL_assert(tfret);
+}
+
+/* End 64-bit atomic tests */
+/**************************************************************************/
+
+/**************************************************************************/
+/* Ring buffer test */
+
+#define RING_BUFFER_SIZE    4096
+#define RING_BUFFER_BYTES   (64 * 1024 * 1024)
+
+static SDL_RingBuffer *ringBuffer;
+
+static int SDLCALL RingBufferWriter(void *data)
+{
+    Uint8 chunk[RING_BUFFER_SIZE];
+    Uint32 written = 0;
+    Uint32 chunk_size = 1;
+
+    while (written < RING_BUFFER_BYTES) {
+        Uint32 i, len;
+
+        /* Vary the chunk size so the writes wrap at different offsets */
+        chunk_size = (chunk_size * 7 + 3) % sizeof(chunk) + 1;
+        len = SDL_min(chunk_size, RING_BUFFER_BYTES - written);
+        for (i = 0; i < len; ++i) {
+            chunk[i] = (Uint8)(written + i);
+        }
+        i = 0;
+        while (i < len) {
+            Uint32 amount = SDL_RingBufferWrite(ringBuffer, chunk + i, len - i);
+            if (!amount) {
+                SDL_Delay(0);
+            }
+            i += amount;
+        }
+        written += len;
+    }
+    return 0;
+}
+
+static void RunRingBufferTest(void)
+{
+    Uint8 chunk[RING_BUFFER_SIZE];
+    SDL_Thread *writer;
+    Uint32 read = 0, errors = 0;
+    Uint64 start, end;
+    double seconds;
+
+    SDL_Log("\nring buffer-------------------------------------\n\n");
+
+    ringBuffer = SDL_CreateRingBuffer(RING_BUFFER_SIZE);
+    start = SDL_GetPerformanceCounter();
+    writer = SDL_CreateThread(RingBufferWriter, "RingBufferWriter", NULL);
+    while (read < RING_BUFFER_BYTES) {
+        Uint32 i, len = SDL_RingBufferRead(ringBuffer, chunk, sizeof(chunk));
+        if (!len) {
+            SDL_Delay(0);
+            continue;
+        }
+        for (i = 0; i < len; ++i) {
+            if (chunk[i] != (Uint8)(read + i)) {
+                ++errors;
+            }
+        }
+        read += len;
+    }
+    SDL_WaitThread(writer, NULL);
+    end = SDL_GetPerformanceCounter();
+    SDL_DestroyRingBuffer(ringBuffer);
+
+    seconds = (double)(end - start) / SDL_GetPerformanceFrequency();
+    SDL_Log("Transferred %u bytes with %u errors in %f sec, %.1f MB/sec\n",
+            read, errors, seconds, read / seconds / (1024 * 1024));
+    SDL_assert(errors == 0);
+}
+
+/* End ring buffer test */
+/**************************************************************************/
+
+/**************************************************************************/
+/* Lock-free queue and stack tests */
+
+#define NUM_PRODUCERS       4
+#define NUM_CONSUMERS       4
+#define ITEMS_PER_PRODUCER  1000000
+
+typedef struct
+{
+    SDL_bool use_stack;
+    SDL_LockFreeQueue *queue;
+    SDL_LockFreeStack *stack;
+    SDL_atomic_t producersRunning;
+    SDL_atomic_t consumed;
+    SDL_atomic_t errors;
+    SDL_atomic64_t sum;
+} LockFreeTestData;
+
+typedef struct
+{
+    LockFreeTestData *test;
+    int index;
+} LockFreeThreadData;
+
+static SDL_bool LockFreePush(LockFreeTestData *test, const Uint32 *item)
+{
+    if (test->use_stack) {
+        return SDL_LockFreeStackPush(test->stack, item);
+    }
+    return SDL_LockFreeQueuePush(test->queue, item);
+}
+
+static SDL_bool LockFreePop(LockFreeTestData *test, Uint32 *item)
+{
+    if (test->use_stack) {
+        return SDL_LockFreeStackPop(test->stack, item);
+    }
+    return SDL_LockFreeQueuePop(test->queue, item);
+}
+
+static int SDLCALL LockFreeProducer(void *_data)
+{
+    LockFreeThreadData *data = (LockFreeThreadData *)_data;
+    Uint32 item;
+    int i;
+
+    for (i = 0; i < ITEMS_PER_PRODUCER; ++i) {
+        item = ((Uint32)data->index << 24) | i;
+        while (!LockFreePush(data->test, &item)) {
+            SDL_Delay(0);
+        }
+    }
+    SDL_AtomicAdd(&data->test->producersRunning, -1);
+    return 0;
+}
+
+static int SDLCALL LockFreeConsumer(void *_data)
+{
+    LockFreeThreadData *data = (LockFreeThreadData *)_data;
+    LockFreeTestData *test = data->test;
+    int last[NUM_PRODUCERS];
+    Uint32 item;
+    Sint64 sum = 0;
+    int consumed = 0, errors = 0;
+    int i;
+
+    for (i = 0; i < NUM_PRODUCERS; ++i) {
+        last[i] = -1;
+    }
+
+    for ( ; ; ) {
+        /* Check this first, so an empty pop afterwards means we're done */
+        SDL_bool done = (SDL_AtomicGet(&test->producersRunning) == 0);
+
+        if (LockFreePop(test, &item)) {
+            int producer = (int)(item >> 24);
+            int sequence = (int)(item & 0xFFFFFF);
+
+            /* A queue hands out each producer's items in order */
+            if (producer >= NUM_PRODUCERS || (!test->use_stack && sequence <= last[producer])) {
+                ++errors;
+            } else {
+                last[producer] = sequence;
+            }
+            sum += sequence;
+            ++consumed;
+        } else if (done) {
+            break;
+        } else {
+            SDL_Delay(0);
+        }
+    }
+
+    SDL_AtomicAdd(&test->consumed, consumed);
+    SDL_AtomicAdd(&test->errors, errors);
+    SDL_AtomicAdd64(&test->sum, sum);
+    return 0;
+}
+
+static void RunLockFreeContainerTest(SDL_bool use_stack)
+{
+    LockFreeTestData test;
+    LockFreeThreadData producers[NUM_PRODUCERS];
+    LockFreeThreadData consumers[NUM_CONSUMERS];
+    SDL_Thread *threads[NUM_PRODUCERS + NUM_CONSUMERS];
+    Sint64 expected_sum;
+    Uint64 start, end;
+    double seconds;
+    int i;
+
+    SDL_Log("\nlock-free %s-------------------------------\n\n", use_stack ? "stack" : "queue");
+
+    SDL_zero(test);
+    test.use_stack = use_stack;
+    if (use_stack) {
+        test.stack = SDL_CreateLockFreeStack(1024, sizeof(Uint32));
+    } else {
+        test.queue = SDL_CreateLockFreeQueue(1024, sizeof(Uint32));
+    }
+    SDL_AtomicSet(&test.producersRunning, NUM_PRODUCERS);
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < NUM_CONSUMERS; ++i) {
+        consumers[i].test = &test;
+        consumers[i].index = i;
+        threads[i] = SDL_CreateThread(LockFreeConsumer, "LockFreeConsumer", &consumers[i]);
+    }
+    for (i = 0; i < NUM_PRODUCERS; ++i) {
+        producers[i].test = &test;
+        producers[i].index = i;
+        threads[NUM_CONSUMERS + i] = SDL_CreateThread(LockFreeProducer, "LockFreeProducer", &producers[i]);
+    }
+    for (i = 0; i < NUM_PRODUCERS + NUM_CONSUMERS; ++i) {
+        SDL_WaitThread(threads[i], NULL);
+    }
+    end = SDL_GetPerformanceCounter();
+
+    if (use_stack) {
+        SDL_DestroyLockFreeStack(test.stack);
+    } else {
+        SDL_DestroyLockFreeQueue(test.queue);
+    }
+
+    expected_sum = (Sint64)NUM_PRODUCERS * ITEMS_PER_PRODUCER * (ITEMS_PER_PRODUCER - 1) / 2;
+    seconds = (double)(end - start) / SDL_GetPerformanceFrequency();
+    SDL_Log("Consumed %d of %d items with %d errors in %f sec, %.0f items/sec\n",
+            SDL_AtomicGet(&test.consumed), NUM_PRODUCERS * ITEMS_PER_PRODUCER,
+            SDL_AtomicGet(&test.errors), seconds, SDL_AtomicGet(&test.consumed) / seconds);
+    SDL_assert(SDL_AtomicGet(&test.consumed) == NUM_PRODUCERS * ITEMS_PER_PRODUCER);
+    SDL_assert(SDL_AtomicGet(&test.errors) == 0);
+    SDL_assert(SDL_AtomicGet64(&test.sum) == expected_sum);
+}
+
+/* End lock-free queue and stack tests */
+/**************************************************************************/
+
 int
 main(int argc, char *argv[])
 {
@@ -715,11 +1091,16 @@ main(int argc, char *argv[])
 
     RunBasicTest();
     RunEpicTest();
+    RunAtomic64Test();
+    RunRingBufferTest();
+    RunLockFreeContainerTest(SDL_FALSE);
+    RunLockFreeContainerTest(SDL_TRUE);
 /* This test is really slow, so don't run it by default */
 #if 0
     RunFIFOTest(SDL_FALSE);
 #endif
     RunFIFOTest(SDL_TRUE);
+    RunLockStatsTest();
     return 0;
 }
 
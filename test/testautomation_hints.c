@@ -0,0 +1,175 @@
+/**
+ * Hints test suite
+ */
+
+#include <stdio.h>
+
+#include "SDL.h"
+#include "SDL_test.h"
+
+/* Hints nobody else uses, so the tests own their values */
+#define HINTS_TEST_HINT     "SDL_AUTOMATION_TEST_HINT"
+#define HINTS_NORMAL_HINT   "SDL_AUTOMATION_NORMAL_HINT"
+#define HINTS_ENV_HINT      "SDL_AUTOMATION_ENV_HINT"
+
+/* Test case functions */
+
+/**
+ * @brief Call to SDL_RegisterHint and SDL_GetHintValue
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_RegisterHint
+ * http://wiki.libsdl.org/moin.cgi/SDL_GetHintValue
+ */
+int
+hints_registerHint(void *arg)
+{
+  SDL_HintHandle *handle, *again;
+  const char *value;
+
+  handle = SDL_RegisterHint(HINTS_TEST_HINT);
+  SDLTest_AssertPass("Call to SDL_RegisterHint(\"%s\")", HINTS_TEST_HINT);
+  SDLTest_AssertCheck(handle != NULL, "Check result value, expected: not NULL");
+  if (handle == NULL) {
+    return TEST_ABORTED;
+  }
+  again = SDL_RegisterHint(HINTS_TEST_HINT);
+  SDLTest_AssertCheck(again == handle, "Check registering the same hint again returns the same handle");
+
+  SDL_SetHintWithPriority(HINTS_TEST_HINT, "1", SDL_HINT_OVERRIDE);
+  SDLTest_AssertPass("Call to SDL_SetHintWithPriority(\"%s\", \"1\", SDL_HINT_OVERRIDE)", HINTS_TEST_HINT);
+  value = SDL_GetHintValue(handle);
+  SDLTest_AssertCheck(value != NULL && SDL_strcmp(value, "1") == 0, "Check SDL_GetHintValue(), expected: 1, got: %s", value ? value : "NULL");
+  SDLTest_AssertCheck(value == SDL_GetHint(HINTS_TEST_HINT), "Check SDL_GetHintValue() matches SDL_GetHint()");
+
+  /* Negative cases */
+  handle = SDL_RegisterHint(NULL);
+  SDLTest_AssertCheck(handle == NULL, "Check SDL_RegisterHint(NULL) result, expected: NULL");
+  handle = SDL_RegisterHint("");
+  SDLTest_AssertCheck(handle == NULL, "Check SDL_RegisterHint(\"\") result, expected: NULL");
+  value = SDL_GetHintValue(NULL);
+  SDLTest_AssertCheck(value == NULL, "Check SDL_GetHintValue(NULL) result, expected: NULL");
+
+  return TEST_COMPLETED;
+}
+
+/**
+ * @brief Check that setting a hint changes the hint generation only when its value changes
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_GetHintGeneration
+ * http://wiki.libsdl.org/moin.cgi/SDL_SetHint
+ * http://wiki.libsdl.org/moin.cgi/SDL_SetHintWithPriority
+ */
+int
+hints_generation(void *arg)
+{
+  SDL_HintHandle *handle;
+  Uint32 generation, previous;
+  const char *value;
+  SDL_bool result;
+
+  handle = SDL_RegisterHint(HINTS_TEST_HINT);
+  SDLTest_AssertCheck(handle != NULL, "Check SDL_RegisterHint() result, expected: not NULL");
+  if (handle == NULL) {
+    return TEST_ABORTED;
+  }
+  /* SDL_SetHint() bumps the generation when the value changes */
+  SDL_SetHint(HINTS_NORMAL_HINT, "0");
+  previous = SDL_GetHintGeneration();
+  result = SDL_SetHint(HINTS_NORMAL_HINT, "1");
+  SDLTest_AssertCheck(result == SDL_TRUE, "Check SDL_SetHint() result, expected: %d, got: %d", SDL_TRUE, result);
+  generation = SDL_GetHintGeneration();
+  SDLTest_AssertCheck(generation != previous, "Check generation changed after SDL_SetHint(), previous: %u, got: %u", previous, generation);
+
+  /* Hints set at override priority can always be changed again */
+  SDL_SetHintWithPriority(HINTS_TEST_HINT, "first", SDL_HINT_OVERRIDE);
+
+  previous = SDL_GetHintGeneration();
+  SDLTest_AssertPass("Call to SDL_GetHintGeneration()");
+  SDLTest_AssertCheck(previous != 0, "Check generation, expected: not 0, got: %u", previous);
+
+  /* A new value bumps the generation */
+  result = SDL_SetHintWithPriority(HINTS_TEST_HINT, "second", SDL_HINT_OVERRIDE);
+  SDLTest_AssertCheck(result == SDL_TRUE, "Check SDL_SetHintWithPriority() result, expected: %d, got: %d", SDL_TRUE, result);
+  generation = SDL_GetHintGeneration();
+  SDLTest_AssertCheck(generation != previous, "Check generation changed, previous: %u, got: %u", previous, generation);
+  value = SDL_GetHintValue(handle);
+  SDLTest_AssertCheck(value != NULL && SDL_strcmp(value, "second") == 0, "Check SDL_GetHintValue(), expected: second, got: %s", value ? value : "NULL");
+
+  /* The same value doesn't */
+  previous = generation;
+  SDL_SetHintWithPriority(HINTS_TEST_HINT, "second", SDL_HINT_OVERRIDE);
+  generation = SDL_GetHintGeneration();
+  SDLTest_AssertCheck(generation == previous, "Check generation is unchanged after setting the same value, expected: %u, got: %u", previous, generation);
+
+  /* Nor does a value that loses to the override */
+  result = SDL_SetHint(HINTS_TEST_HINT, "third");
+  SDLTest_AssertCheck(result == SDL_FALSE, "Check SDL_SetHint() result under an override, expected: %d, got: %d", SDL_FALSE, result);
+  generation = SDL_GetHintGeneration();
+  SDLTest_AssertCheck(generation == previous, "Check generation is unchanged after a rejected value, expected: %u, got: %u", previous, generation);
+  value = SDL_GetHintValue(handle);
+  SDLTest_AssertCheck(value != NULL && SDL_strcmp(value, "second") == 0, "Check SDL_GetHintValue(), expected: second, got: %s", value ? value : "NULL");
+
+  return TEST_COMPLETED;
+}
+
+/**
+ * @brief Check that raising the priority of a hint over the environment changes the hint generation
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_GetHintGeneration
+ * http://wiki.libsdl.org/moin.cgi/SDL_SetHintWithPriority
+ * http://wiki.libsdl.org/moin.cgi/SDL_GetHint
+ */
+int
+hints_priorityOverEnvironment(void *arg)
+{
+  Uint32 generation, previous;
+  const char *value;
+  SDL_bool result;
+
+  /* Set before the environment variable, so it's kept at normal priority */
+  result = SDL_SetHint(HINTS_ENV_HINT, "hint");
+  SDLTest_AssertCheck(result == SDL_TRUE, "Check SDL_SetHint() result, expected: %d, got: %d", SDL_TRUE, result);
+  SDL_setenv(HINTS_ENV_HINT, "environment", 1);
+  SDLTest_AssertPass("Call to SDL_setenv(\"%s\", \"environment\", 1)", HINTS_ENV_HINT);
+  value = SDL_GetHint(HINTS_ENV_HINT);
+  SDLTest_AssertCheck(value != NULL && SDL_strcmp(value, "environment") == 0, "Check SDL_GetHint(), expected: environment, got: %s", value ? value : "NULL");
+
+  /* The same value at override priority replaces the environment variable */
+  previous = SDL_GetHintGeneration();
+  result = SDL_SetHintWithPriority(HINTS_ENV_HINT, "hint", SDL_HINT_OVERRIDE);
+  SDLTest_AssertCheck(result == SDL_TRUE, "Check SDL_SetHintWithPriority() result, expected: %d, got: %d", SDL_TRUE, result);
+  generation = SDL_GetHintGeneration();
+  SDLTest_AssertCheck(generation != previous, "Check generation changed after raising the priority, previous: %u, got: %u", previous, generation);
+  value = SDL_GetHint(HINTS_ENV_HINT);
+  SDLTest_AssertCheck(value != NULL && SDL_strcmp(value, "hint") == 0, "Check SDL_GetHint(), expected: hint, got: %s", value ? value : "NULL");
+
+  return TEST_COMPLETED;
+}
+
+/* ================= Test References ================== */
+
+/* Hints test cases */
+static const SDLTest_TestCaseReference hintsTest1 =
+        { (SDLTest_TestCaseFp)hints_registerHint, "hints_registerHint", "Call to SDL_RegisterHint and SDL_GetHintValue", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference hintsTest2 =
+        { (SDLTest_TestCaseFp)hints_generation, "hints_generation", "Check the hint generation changes when a hint does", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference hintsTest3 =
+        { (SDLTest_TestCaseFp)hints_priorityOverEnvironment, "hints_priorityOverEnvironment", "Check raising the priority of a hint over the environment changes the hint generation", TEST_ENABLED };
+
+/* Sequence of Hints test cases */
+static const SDLTest_TestCaseReference *hintsTests[] =  {
+    &hintsTest1, &hintsTest2, &hintsTest3, NULL
+};
+
+/* Hints test suite (global) */
+SDLTest_TestSuiteReference hintsTestSuite = {
+    "Hints",
+    NULL,
+    hintsTests,
+    NULL
+};
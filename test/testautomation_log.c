@@ -0,0 +1,132 @@
+/**
+ * Log test suite
+ */
+
+#include <stdio.h>
+
+#include "SDL.h"
+#include "SDL_test.h"
+
+/* Test case functions */
+
+#define LOG_THREADS     4
+#define LOG_MESSAGES    500
+
+/* What the output function saw while log_asyncThreads was running */
+static SDL_LogOutputFunction _originalOutput;
+static void *_originalUserdata;
+static SDL_atomic_t _logReceived;
+static SDL_atomic_t _logReportedDropped;
+
+static void SDLCALL
+_logOutput(void *userdata, int category, SDL_LogPriority priority, const char *message)
+{
+  int dropped;
+
+  if (category == SDL_LOG_CATEGORY_CUSTOM) {
+    SDL_AtomicIncRef(&_logReceived);
+  } else if (category == SDL_LOG_CATEGORY_SYSTEM && SDL_sscanf(message, "%d log messages were dropped", &dropped) == 1) {
+    SDL_AtomicAdd(&_logReportedDropped, dropped);
+  } else if (_originalOutput) {
+    /* Messages from the test harness */
+    _originalOutput(_originalUserdata, category, priority, message);
+  }
+}
+
+static int
+_logThread(void *arg)
+{
+  int i;
+
+  for (i = 0; i < LOG_MESSAGES; ++i) {
+    SDL_LogInfo(SDL_LOG_CATEGORY_CUSTOM, "Thread %d message %d", (int)(size_t)arg, i);
+  }
+  return 0;
+}
+
+/**
+ * @brief Log from several threads with asynchronous logging on
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_LogSetAsync
+ * http://wiki.libsdl.org/moin.cgi/SDL_LogFlush
+ * http://wiki.libsdl.org/moin.cgi/SDL_LogGetDropped
+ */
+int
+log_asyncThreads(void *arg)
+{
+  SDL_Thread *threads[LOG_THREADS];
+  SDL_LogPriority priority;
+  int i, result, created = 0;
+  int dropped, received;
+
+  SDL_LogGetOutputFunction(&_originalOutput, &_originalUserdata);
+  priority = SDL_LogGetPriority(SDL_LOG_CATEGORY_CUSTOM);
+  SDL_LogSetPriority(SDL_LOG_CATEGORY_CUSTOM, SDL_LOG_PRIORITY_INFO);
+  SDL_LogSetOutputFunction(_logOutput, NULL);
+  SDL_AtomicSet(&_logReceived, 0);
+  SDL_AtomicSet(&_logReportedDropped, 0);
+  dropped = SDL_LogGetDropped();
+
+  result = SDL_LogSetAsync(SDL_TRUE);
+  SDLTest_AssertPass("Call to SDL_LogSetAsync(SDL_TRUE)");
+  SDLTest_AssertCheck(result == 0, "Check result value, expected: 0, got: %d", result);
+
+  /* A few messages fit in the queue, so none are dropped */
+  for (i = 0; i < 32; ++i) {
+    SDL_LogInfo(SDL_LOG_CATEGORY_CUSTOM, "Message %d", i);
+  }
+  SDL_LogFlush();
+  SDLTest_AssertCheck(SDL_AtomicGet(&_logReceived) == 32, "Check messages output after SDL_LogFlush(), expected: 32, got: %d", SDL_AtomicGet(&_logReceived));
+  SDLTest_AssertCheck(SDL_LogGetDropped() == dropped, "Check no messages were dropped, expected: %d, got: %d", dropped, SDL_LogGetDropped());
+  SDL_AtomicSet(&_logReceived, 0);
+
+  /* Several threads overflow it; the test logs nothing itself until the
+     flush, so only their messages can be dropped */
+  for (i = 0; i < LOG_THREADS; ++i) {
+    threads[created] = SDL_CreateThread(_logThread, "LogThread", (void *)(size_t)i);
+    if (threads[created]) {
+      ++created;
+    }
+  }
+  for (i = 0; i < created; ++i) {
+    SDL_WaitThread(threads[i], NULL);
+  }
+
+  /* Everything that wasn't dropped is output by the time SDL_LogFlush() returns */
+  SDL_LogFlush();
+  SDLTest_AssertPass("Call to SDL_LogFlush()");
+  SDLTest_AssertCheck(created == LOG_THREADS, "Check threads were created, expected: %d, got: %d", LOG_THREADS, created);
+  received = SDL_AtomicGet(&_logReceived);
+  dropped = SDL_LogGetDropped() - dropped;
+  SDLTest_AssertCheck(received + dropped == created * LOG_MESSAGES, "Check every message was output or dropped, expected: %d, got: %d output + %d dropped", created * LOG_MESSAGES, received, dropped);
+  SDLTest_AssertCheck(SDL_AtomicGet(&_logReportedDropped) == dropped, "Check the dropped messages were reported, expected: %d, got: %d", dropped, SDL_AtomicGet(&_logReportedDropped));
+
+  SDL_LogSetAsync(SDL_FALSE);
+  SDL_LogSetOutputFunction(_originalOutput, _originalUserdata);
+  SDL_LogSetPriority(SDL_LOG_CATEGORY_CUSTOM, priority);
+
+  /* Nothing is left behind after SDL_LogFlush() */
+  SDLTest_AssertCheck(SDL_AtomicGet(&_logReceived) == received, "Check no messages were output after the flush, expected: %d, got: %d", received, SDL_AtomicGet(&_logReceived));
+
+  return TEST_COMPLETED;
+}
+
+/* ================= Test References ================== */
+
+/* Log test cases */
+static const SDLTest_TestCaseReference logTest1 =
+        { (SDLTest_TestCaseFp)log_asyncThreads, "log_asyncThreads", "Log from several threads with asynchronous logging on", TEST_ENABLED };
+
+/* Sequence of Log test cases */
+static const SDLTest_TestCaseReference *logTests[] =  {
+    &logTest1, NULL
+};
+
+/* Log test suite (global) */
+SDLTest_TestSuiteReference logTestSuite = {
+    "Log",
+    NULL,
+    logTests,
+    NULL
+};
@@ -496,6 +496,109 @@ pixels_calcGammaRamp(void *arg)
   return TEST_COMPLETED;
 }
 
+/* Nearest palette entry by searching every color, the first one on ties */
+static Uint8
+_nearestPaletteColor(const SDL_Palette *palette, Uint8 r, Uint8 g, Uint8 b)
+{
+  unsigned int smallest = ~0u;
+  unsigned int distance;
+  int rd, gd, bd;
+  int i;
+  Uint8 pixel = 0;
+
+  for (i = 0; i < palette->ncolors; i++) {
+    rd = palette->colors[i].r - r;
+    gd = palette->colors[i].g - g;
+    bd = palette->colors[i].b - b;
+    distance = (rd * rd) + (gd * gd) + (bd * bd);
+    if (distance < smallest) {
+      pixel = (Uint8)i;
+      smallest = distance;
+    }
+  }
+  return pixel;
+}
+
+/**
+ * @brief Call to SDL_MapRGB with a palette that isn't an even color cube
+ *
+ * SDL_MapRGB searches the whole palette at first, then builds a lookup once
+ * the palette has been searched often; both must find the same entries.
+ *
+ * @sa http://wiki.libsdl.org/moin.fcg/SDL_MapRGB
+ */
+int
+pixels_mapRGBPalette(void *arg)
+{
+  SDL_PixelFormat *format;
+  SDL_Palette *palette;
+  SDL_Color colors[256];
+  Uint8 r, g, b;
+  Uint32 pixel;
+  int i, result, mismatches = 0;
+
+  format = SDL_AllocFormat(SDL_PIXELFORMAT_INDEX8);
+  SDLTest_AssertPass("Call to SDL_AllocFormat(SDL_PIXELFORMAT_INDEX8)");
+  SDLTest_AssertCheck(format != NULL, "Verify result is not NULL");
+  if (format == NULL) return TEST_ABORTED;
+  palette = SDL_AllocPalette(SDL_arraysize(colors));
+  SDLTest_AssertCheck(palette != NULL, "Verify palette is not NULL");
+  if (palette == NULL) {
+    SDL_FreeFormat(format);
+    return TEST_ABORTED;
+  }
+
+  /* Random colors, with a few repeated so there are ties */
+  for (i = 0; i < SDL_arraysize(colors); i++) {
+    if (i >= 10 && i % 10 == 0) {
+      colors[i] = colors[i - 10];
+    } else {
+      colors[i].r = SDLTest_RandomUint8();
+      colors[i].g = SDLTest_RandomUint8();
+      colors[i].b = SDLTest_RandomUint8();
+    }
+    colors[i].a = SDL_ALPHA_OPAQUE;
+  }
+  SDL_SetPaletteColors(palette, colors, 0, SDL_arraysize(colors));
+  result = SDL_SetPixelFormatPalette(format, palette);
+  SDLTest_AssertPass("Call to SDL_SetPixelFormatPalette()");
+  SDLTest_AssertCheck(result == 0, "Verify result value; expected: 0, got: %d", result);
+
+  /* The first calls search the palette, the later ones use the lookup */
+  for (i = 0; i < 4096; i++) {
+    if (i % 2 == 0) {
+      /* Exactly on a palette color */
+      const SDL_Color *color = &colors[SDLTest_RandomIntegerInRange(0, SDL_arraysize(colors) - 1)];
+      r = color->r;
+      g = color->g;
+      b = color->b;
+    } else {
+      r = SDLTest_RandomUint8();
+      g = SDLTest_RandomUint8();
+      b = SDLTest_RandomUint8();
+    }
+    pixel = SDL_MapRGB(format, r, g, b);
+    if (pixel != _nearestPaletteColor(palette, r, g, b)) {
+      if (mismatches++ == 0) {
+        SDLTest_LogError("SDL_MapRGB(%d, %d, %d) call %d returned %d, expected %d", r, g, b, i, pixel, _nearestPaletteColor(palette, r, g, b));
+      }
+    }
+  }
+  SDLTest_AssertPass("Call to SDL_MapRGB() 4096 times");
+  SDLTest_AssertCheck(mismatches == 0, "Verify SDL_MapRGB() found the nearest palette entry; expected: 0 mismatches, got: %d", mismatches);
+
+  /* A changed palette is searched again */
+  colors[0].r = colors[0].g = colors[0].b = 0x42;
+  SDL_SetPaletteColors(palette, colors, 0, 1);
+  pixel = SDL_MapRGB(format, 0x42, 0x42, 0x42);
+  SDLTest_AssertCheck(pixel == _nearestPaletteColor(palette, 0x42, 0x42, 0x42), "Verify SDL_MapRGB() after changing the palette; expected: %d, got: %d", _nearestPaletteColor(palette, 0x42, 0x42, 0x42), pixel);
+
+  SDL_FreePalette(palette);
+  SDL_FreeFormat(format);
+
+  return TEST_COMPLETED;
+}
+
 /* ================= Test References ================== */
 
 /* Pixels test cases */
@@ -511,9 +614,12 @@ static const SDLTest_TestCaseReference pixelsTest3 =
 static const SDLTest_TestCaseReference pixelsTest4 =
         { (SDLTest_TestCaseFp)pixels_getPixelFormatName, "pixels_getPixelFormatName", "Call to SDL_GetPixelFormatName", TEST_ENABLED };
 
+static const SDLTest_TestCaseReference pixelsTest5 =
+        { (SDLTest_TestCaseFp)pixels_mapRGBPalette, "pixels_mapRGBPalette", "Call to SDL_MapRGB with an uneven palette, with and without the palette lookup", TEST_ENABLED };
+
 /* Sequence of Pixels test cases */
 static const SDLTest_TestCaseReference *pixelsTests[] =  {
-    &pixelsTest1, &pixelsTest2, &pixelsTest3, &pixelsTest4, NULL
+    &pixelsTest1, &pixelsTest2, &pixelsTest3, &pixelsTest4, &pixelsTest5, NULL
 };
 
 /* Pixels test suite (global) */
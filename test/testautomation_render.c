@@ -721,6 +721,203 @@ render_testBlitBlend (void *arg)
    return TEST_COMPLETED;
 }
 
+/**
+ * @brief Tests updating a texture that stays locked, as framebuffer emulation does.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_CreateSoftwareRenderer
+ * http://wiki.libsdl.org/moin.cgi/SDL_LockTexture
+ * http://wiki.libsdl.org/moin.cgi/SDL_UnlockTexture
+ */
+int
+render_testPersistentLock (void *arg)
+{
+   int ret;
+   int i, x, y;
+   int pitch, rectPitch, checkFailCount1;
+   SDL_Surface *target;
+   SDL_Renderer *softRenderer;
+   SDL_Texture *texture;
+   SDL_Rect rects[2];
+   Uint32 colors[2];
+   Uint32 expected;
+   Uint8 *base;
+   void *rectPixels;
+   Uint32 *pixels;
+
+   /* The software renderer keeps a system memory copy of streaming textures. */
+   target = SDL_CreateRGBSurface(0, TESTRENDER_SCREEN_W, TESTRENDER_SCREEN_H, 32,
+                                 RENDER_COMPARE_RMASK, RENDER_COMPARE_GMASK, RENDER_COMPARE_BMASK, RENDER_COMPARE_AMASK);
+   SDLTest_AssertCheck(target != NULL, "Verify result from SDL_CreateRGBSurface is not NULL");
+   if (target == NULL) {
+      return TEST_ABORTED;
+   }
+   softRenderer = SDL_CreateSoftwareRenderer(target);
+   SDLTest_AssertCheck(softRenderer != NULL, "Verify result from SDL_CreateSoftwareRenderer is not NULL");
+   if (softRenderer == NULL) {
+      SDL_FreeSurface(target);
+      return TEST_ABORTED;
+   }
+   texture = SDL_CreateTexture(softRenderer, RENDER_COMPARE_FORMAT, SDL_TEXTUREACCESS_STREAMING,
+                               TESTRENDER_SCREEN_W, TESTRENDER_SCREEN_H);
+   SDLTest_AssertCheck(texture != NULL, "Verify result from SDL_CreateTexture is not NULL");
+   if (texture == NULL) {
+      SDL_DestroyRenderer(softRenderer);
+      SDL_FreeSurface(target);
+      return TEST_ABORTED;
+   }
+
+   /* Lock the whole texture once and draw into it from then on. */
+   ret = SDL_LockTexture(texture, NULL, (void **)&base, &pitch);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_LockTexture, expected: 0, got: %i", ret);
+   if (ret != 0) {
+      SDL_DestroyTexture(texture);
+      SDL_DestroyRenderer(softRenderer);
+      SDL_FreeSurface(target);
+      return TEST_ABORTED;
+   }
+   for (y = 0; y < TESTRENDER_SCREEN_H; ++y) {
+      SDL_memset4(base + y * pitch, RENDER_COMPARE_AMASK, TESTRENDER_SCREEN_W);
+   }
+   SDL_UnlockTexture(texture);
+
+   rects[0].x = 10;
+   rects[0].y = 5;
+   rects[0].w = 20;
+   rects[0].h = 15;
+   colors[0] = RENDER_COMPARE_AMASK | RENDER_COMPARE_RMASK;
+   rects[1].x = 50;
+   rects[1].y = 30;
+   rects[1].w = 10;
+   rects[1].h = 25;
+   colors[1] = RENDER_COMPARE_AMASK | RENDER_COMPARE_GMASK;
+   for (i = 0; i < 2; ++i) {
+      for (y = rects[i].y; y < rects[i].y + rects[i].h; ++y) {
+         SDL_memset4(base + y * pitch + rects[i].x * 4, colors[i], rects[i].w);
+      }
+   }
+
+   /* Locking a rect hands back the same memory, so unlocking it updates just that rect. */
+   for (i = 0; i < 2; ++i) {
+      ret = SDL_LockTexture(texture, &rects[i], &rectPixels, &rectPitch);
+      SDLTest_AssertCheck(ret == 0, "Validate result from SDL_LockTexture, expected: 0, got: %i", ret);
+      SDLTest_AssertCheck(rectPixels == base + rects[i].y * pitch + rects[i].x * 4, "Validate locked rect %i points into the locked texture", i);
+      SDLTest_AssertCheck(rectPitch == pitch, "Validate locked rect pitch, expected: %i, got: %i", pitch, rectPitch);
+      SDL_UnlockTexture(texture);
+   }
+
+   ret = SDL_RenderCopy(softRenderer, texture, NULL, NULL);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderCopy, expected: 0, got: %i", ret);
+
+   /* Only the drawn rects changed. */
+   pixels = (Uint32 *)target->pixels;
+   checkFailCount1 = 0;
+   for (y = 0; y < TESTRENDER_SCREEN_H; ++y) {
+      for (x = 0; x < TESTRENDER_SCREEN_W; ++x) {
+         expected = RENDER_COMPARE_AMASK;
+         for (i = 0; i < 2; ++i) {
+            if (x >= rects[i].x && x < rects[i].x + rects[i].w &&
+                y >= rects[i].y && y < rects[i].y + rects[i].h) {
+               expected = colors[i];
+            }
+         }
+         if (pixels[y * (target->pitch / 4) + x] != expected) checkFailCount1++;
+      }
+   }
+   SDLTest_AssertCheck(checkFailCount1 == 0, "Validate rendered pixels, expected: 0 mismatches, got: %i", checkFailCount1);
+
+   /* Clean up. */
+   SDL_DestroyTexture(texture);
+   SDL_DestroyRenderer(softRenderer);
+   SDL_FreeSurface(target);
+
+   return TEST_COMPLETED;
+}
+
+
+/**
+ * @brief Tests wide and anti-aliased line drawing.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_SetRenderDrawLineStyle
+ * http://wiki.libsdl.org/moin.cgi/SDL_GetRenderDrawLineStyle
+ */
+int
+render_testLineStyle (void *arg)
+{
+   int ret;
+   int i;
+   float width;
+   SDL_bool antialias;
+   SDL_Rect rect;
+   Uint32 pixels[5];
+   Uint8 value;
+
+   /* Check the defaults. */
+   ret = SDL_GetRenderDrawLineStyle(renderer, &width, &antialias);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_GetRenderDrawLineStyle, expected: 0, got: %i", ret);
+   SDLTest_AssertCheck(width == 1.0f, "Validate default width, expected: 1.0, got: %f", width);
+   SDLTest_AssertCheck(antialias == SDL_FALSE, "Validate default antialias, expected: SDL_FALSE, got: %i", antialias);
+
+   /* Invalid widths are rejected. */
+   ret = SDL_SetRenderDrawLineStyle(renderer, 0.0f, SDL_FALSE);
+   SDLTest_AssertCheck(ret == -1, "Validate result from SDL_SetRenderDrawLineStyle with width 0, expected: -1, got: %i", ret);
+   ret = SDL_SetRenderDrawLineStyle(renderer, -2.0f, SDL_TRUE);
+   SDLTest_AssertCheck(ret == -1, "Validate result from SDL_SetRenderDrawLineStyle with width -2, expected: -1, got: %i", ret);
+
+   /* A 3 pixel line with hard edges covers 3 rows. */
+   ret = SDL_SetRenderDrawLineStyle(renderer, 3.0f, SDL_FALSE);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_SetRenderDrawLineStyle, expected: 0, got: %i", ret);
+   ret = SDL_GetRenderDrawLineStyle(renderer, &width, &antialias);
+   SDLTest_AssertCheck(width == 3.0f && antialias == SDL_FALSE, "Validate line style, expected: 3.0 and SDL_FALSE, got: %f and %i", width, antialias);
+
+   _clearScreen();
+   ret = SDL_SetRenderDrawColor(renderer, 255, 255, 255, SDL_ALPHA_OPAQUE);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_SetRenderDrawColor, expected: 0, got: %i", ret);
+   ret = SDL_RenderDrawLine(renderer, 10, 10, 30, 10);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderDrawLine, expected: 0, got: %i", ret);
+
+   rect.x = 20;
+   rect.y = 8;
+   rect.w = 1;
+   rect.h = 5;
+   ret = SDL_RenderReadPixels(renderer, &rect, RENDER_COMPARE_FORMAT, pixels, 4);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderReadPixels, expected: 0, got: %i", ret);
+   for (i = 0; i < 5; ++i) {
+      value = (Uint8)((pixels[i] & RENDER_COMPARE_GMASK) >> 8);
+      if (i == 0 || i == 4) {
+         SDLTest_AssertCheck(value == 0, "Validate pixel outside the line at row %i, expected: 0, got: %i", rect.y + i, value);
+      } else {
+         SDLTest_AssertCheck(value == 255, "Validate pixel inside the line at row %i, expected: 255, got: %i", rect.y + i, value);
+      }
+   }
+
+   /* A 2 pixel anti-aliased line half covers the rows beside it. */
+   ret = SDL_SetRenderDrawLineStyle(renderer, 2.0f, SDL_TRUE);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_SetRenderDrawLineStyle, expected: 0, got: %i", ret);
+
+   _clearScreen();
+   ret = SDL_SetRenderDrawColor(renderer, 255, 255, 255, SDL_ALPHA_OPAQUE);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_SetRenderDrawColor, expected: 0, got: %i", ret);
+   ret = SDL_RenderDrawLine(renderer, 10, 10, 30, 10);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderDrawLine, expected: 0, got: %i", ret);
+
+   ret = SDL_RenderReadPixels(renderer, &rect, RENDER_COMPARE_FORMAT, pixels, 4);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderReadPixels, expected: 0, got: %i", ret);
+   value = (Uint8)((pixels[2] & RENDER_COMPARE_GMASK) >> 8);
+   SDLTest_AssertCheck(value == 255, "Validate pixel in the middle of the line, expected: 255, got: %i", value);
+   for (i = 1; i <= 3; i += 2) {
+      value = (Uint8)((pixels[i] & RENDER_COMPARE_GMASK) >> 8);
+      SDLTest_AssertCheck(value > 64 && value < 192, "Validate pixel on the edge of the line at row %i, expected: about 128, got: %i", rect.y + i, value);
+   }
+
+   /* Restore the default style. */
+   ret = SDL_SetRenderDrawLineStyle(renderer, 1.0f, SDL_FALSE);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_SetRenderDrawLineStyle, expected: 0, got: %i", ret);
+
+   return TEST_COMPLETED;
+}
+
 
 /**
  * @brief Checks to see if functionality is supported. Helper function.
@@ -1037,9 +1234,15 @@ static const SDLTest_TestCaseReference renderTest6 =
 static const SDLTest_TestCaseReference renderTest7 =
         {  (SDLTest_TestCaseFp)render_testBlitBlend, "render_testBlitBlend", "Tests blitting with blending", TEST_DISABLED };
 
+static const SDLTest_TestCaseReference renderTest8 =
+        { (SDLTest_TestCaseFp)render_testPersistentLock, "render_testPersistentLock", "Tests updating a texture that stays locked", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest9 =
+        { (SDLTest_TestCaseFp)render_testLineStyle, "render_testLineStyle", "Tests wide and anti-aliased lines", TEST_ENABLED };
+
 /* Sequence of Render test cases */
 static const SDLTest_TestCaseReference *renderTests[] =  {
-    &renderTest1, &renderTest2, &renderTest3, &renderTest4, &renderTest5, &renderTest6, &renderTest7, NULL
+    &renderTest1, &renderTest2, &renderTest3, &renderTest4, &renderTest5, &renderTest6, &renderTest7, &renderTest8, &renderTest9, NULL
 };
 
 /* Render test suite (global) */
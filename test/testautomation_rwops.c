@@ -334,6 +334,444 @@ rwops_testFileRead(void)
    return TEST_COMPLETED;
 }
 
+/**
+ * @brief Tests reading from a memory mapped file and direct pointer access.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_RWFromFile
+ * http://wiki.libsdl.org/moin.cgi/SDL_RWGetPointer
+ */
+int
+rwops_testFileMapped(void)
+{
+   SDL_RWops *rw;
+   const char *ptr;
+   size_t available;
+   Sint64 i;
+   int result;
+
+   /* Read test with the mapping flag. */
+   rw = SDL_RWFromFile(RWopsReadTestFilename, "rbm");
+   SDLTest_AssertPass("Call to SDL_RWFromFile(..,\"rbm\") succeeded");
+   SDLTest_AssertCheck(rw != NULL, "Verify opening file with SDL_RWFromFile in mapped read mode does not return NULL");
+
+   /* Bail out if NULL */
+   if (rw == NULL) return TEST_ABORTED;
+
+   /* Mapping is optional, so only check the pointer if it worked */
+   if (rw->type == SDL_RWOPS_MAPPED) {
+      ptr = (const char *)SDL_RWGetPointer(rw, &available);
+      SDLTest_AssertPass("Call to SDL_RWGetPointer() succeeded");
+      SDLTest_AssertCheck(ptr != NULL, "Verify pointer into mapped file is not NULL");
+      SDLTest_AssertCheck(available == sizeof(RWopsHelloWorldTestString)-1, "Verify available bytes; expected: %d, got: %d", (int)sizeof(RWopsHelloWorldTestString)-1, (int)available);
+      if (ptr != NULL) {
+         SDLTest_AssertCheck(SDL_memcmp(ptr, RWopsHelloWorldTestString, available) == 0, "Verify mapped file contents");
+      }
+
+      i = SDL_RWseek(rw, 6, RW_SEEK_SET);
+      SDLTest_AssertCheck(i == (Sint64)6, "Verify seek to 6 with SDL_RWseek (RW_SEEK_SET), expected 6, got %i", i);
+      ptr = (const char *)SDL_RWGetPointer(rw, &available);
+      SDLTest_AssertCheck(ptr != NULL && *ptr == 'W', "Verify pointer follows the stream position");
+      SDLTest_AssertCheck(available == sizeof(RWopsHelloWorldTestString)-7, "Verify available bytes after seek; expected: %d, got: %d", (int)sizeof(RWopsHelloWorldTestString)-7, (int)available);
+   } else {
+      SDLTest_Log("File wasn't memory mapped (type %d)", rw->type);
+      ptr = (const char *)SDL_RWGetPointer(rw, &available);
+      SDLTest_AssertCheck(ptr == NULL, "Verify SDL_RWGetPointer returns NULL for streams not in memory");
+      SDLTest_AssertCheck(available == 0, "Verify available bytes is 0; got: %d", (int)available);
+   }
+
+   /* Run generic tests */
+   _testGenericRWopsValidations( rw, 0 );
+
+   /* Close handle */
+   result = SDL_RWclose(rw);
+   SDLTest_AssertPass("Call to SDL_RWclose() succeeded");
+   SDLTest_AssertCheck(result == 0, "Verify result value is 0; got: %d", result);
+
+   /* Writable files are never mapped */
+   rw = SDL_RWFromFile(RWopsWriteTestFilename, "w+m");
+   SDLTest_AssertCheck(rw != NULL, "Verify opening file with SDL_RWFromFile in write mode does not return NULL");
+   if (rw == NULL) return TEST_ABORTED;
+   SDLTest_AssertCheck(rw->type != SDL_RWOPS_MAPPED, "Verify RWops type is not SDL_RWOPS_MAPPED; got: %d", rw->type);
+   SDL_RWclose(rw);
+
+   /* Pointer access into constant memory */
+   rw = SDL_RWFromConstMem(RWopsAlphabetString, sizeof(RWopsAlphabetString)-1);
+   SDLTest_AssertCheck(rw != NULL, "Verify opening memory with SDL_RWFromConstMem does not return NULL");
+   if (rw == NULL) return TEST_ABORTED;
+   SDL_RWseek(rw, 3, RW_SEEK_SET);
+   ptr = (const char *)SDL_RWGetPointer(rw, NULL);
+   SDLTest_AssertCheck(ptr == RWopsAlphabetString + 3, "Verify SDL_RWGetPointer points into the original memory");
+   SDL_RWclose(rw);
+
+   return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests reading and writing through a buffered stream.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_RWFromBuffered
+ */
+int
+rwops_testBuffered(void)
+{
+   char mem[sizeof(RWopsHelloWorldTestString)];
+   char alphabet[sizeof(RWopsAlphabetString)];
+   char buf[32];
+   SDL_RWops *src, *rw;
+   Sint64 i;
+   size_t s;
+   int result;
+
+   /* Negative cases */
+   rw = SDL_RWFromBuffered(NULL, 0, SDL_FALSE);
+   SDLTest_AssertCheck(rw == NULL, "Verify SDL_RWFromBuffered rejects a NULL stream");
+
+   /* Generic tests, with a buffer smaller than the data */
+   SDL_zero(mem);
+   src = SDL_RWFromMem(mem, sizeof(RWopsHelloWorldTestString)-1);
+   SDLTest_AssertCheck(src != NULL, "Verify opening memory with SDL_RWFromMem does not return NULL");
+   if (src == NULL) return TEST_ABORTED;
+   rw = SDL_RWFromBuffered(src, 5, SDL_TRUE);
+   SDLTest_AssertPass("Call to SDL_RWFromBuffered() succeeded");
+   SDLTest_AssertCheck(rw != NULL, "Verify SDL_RWFromBuffered does not return NULL");
+   if (rw == NULL) return TEST_ABORTED;
+   SDLTest_AssertCheck(rw->type == SDL_RWOPS_BUFFERED, "Verify RWops type is SDL_RWOPS_BUFFERED; expected: %d, got: %d", SDL_RWOPS_BUFFERED, rw->type);
+   _testGenericRWopsValidations( rw, 1 );
+   result = SDL_RWclose(rw);
+   SDLTest_AssertCheck(result == 0, "Verify result value is 0; got: %d", result);
+   SDLTest_AssertCheck(SDL_memcmp(mem, RWopsHelloWorldTestString, sizeof(RWopsHelloWorldTestString)-1) == 0, "Verify buffered writes reached memory");
+
+   /* Reads and seeks within the buffer leave the source where the reader stopped */
+   SDL_memcpy(alphabet, RWopsAlphabetString, sizeof(alphabet));
+   src = SDL_RWFromMem(alphabet, sizeof(RWopsAlphabetString)-1);
+   if (src == NULL) return TEST_ABORTED;
+   rw = SDL_RWFromBuffered(src, 8, SDL_FALSE);
+   if (rw == NULL) return TEST_ABORTED;
+   s = SDL_RWread(rw, buf, 1, 3);
+   SDLTest_AssertCheck(s == 3 && SDL_strncmp(buf, "ABC", 3) == 0, "Verify buffered read of 3 bytes");
+   i = SDL_RWseek(rw, -2, RW_SEEK_CUR);
+   SDLTest_AssertCheck(i == 1, "Verify seek within buffer; expected: 1, got: %i", i);
+   s = SDL_RWread(rw, buf, 1, 20);
+   SDLTest_AssertCheck(s == 20 && SDL_strncmp(buf, RWopsAlphabetString + 1, 20) == 0, "Verify read across the buffer boundary");
+   i = SDL_RWseek(rw, 10, RW_SEEK_SET);
+   SDLTest_AssertCheck(i == 10, "Verify seek outside buffer; expected: 10, got: %i", i);
+   SDL_ReadU8(rw);
+   result = SDL_RWclose(rw);
+   SDLTest_AssertCheck(result == 0, "Verify result value is 0; got: %d", result);
+   i = SDL_RWtell(src);
+   SDLTest_AssertCheck(i == 11, "Verify source position after close; expected: 11, got: %i", i);
+
+   /* Small writes are held back until the buffer is flushed */
+   rw = SDL_RWFromBuffered(src, 8, SDL_FALSE);
+   if (rw == NULL) return TEST_ABORTED;
+   SDL_WriteU8(rw, 'x');
+   SDL_WriteU8(rw, 'y');
+   SDLTest_AssertCheck(alphabet[11] == 'L', "Verify small writes are buffered");
+   i = SDL_RWtell(rw);
+   SDLTest_AssertCheck(i == 13, "Verify position after buffered writes; expected: 13, got: %i", i);
+   i = SDL_RWsize(rw);
+   SDLTest_AssertCheck(i == 26, "Verify size of buffered stream; expected: 26, got: %i", i);
+   SDLTest_AssertCheck(alphabet[11] == 'x' && alphabet[12] == 'y', "Verify writes flushed for size");
+   SDL_WriteU8(rw, 'z');
+   result = SDL_RWclose(rw);
+   SDLTest_AssertCheck(result == 0, "Verify result value is 0; got: %d", result);
+   SDLTest_AssertCheck(alphabet[13] == 'z' && alphabet[14] == 'O', "Verify writes flushed on close");
+   SDL_RWclose(src);
+
+   return TEST_COMPLETED;
+}
+
+/* Files packed into the archives in rwops_testArchive */
+static const char *_archiveNames[] = { "hello.txt", "data/alphabet.txt", "empty" };
+static const char *_archiveData[] = { RWopsHelloWorldTestString, RWopsAlphabetString, "" };
+
+/* Write a zip file with stored entries, plus a directory and a compressed entry */
+static void
+_writeTestZip(SDL_RWops *rw)
+{
+   Sint64 offsets[4], dir_start, dir_end;
+   const char *names[4];
+   Uint16 methods[4] = { 0, 0, 0, 8 };
+   Uint32 sizes[4];
+   int i;
+
+   for (i = 0; i < 3; i++) {
+      names[i] = _archiveNames[i];
+      sizes[i] = (Uint32)SDL_strlen(_archiveData[i]);
+   }
+   names[3] = "compressed.bin";
+   sizes[3] = 4;
+
+   for (i = 0; i < 4; i++) {
+      offsets[i] = SDL_RWtell(rw);
+      SDL_WriteLE32(rw, 0x04034b50);
+      SDL_WriteLE16(rw, 10);
+      SDL_WriteLE16(rw, 0);
+      SDL_WriteLE16(rw, methods[i]);
+      SDL_WriteLE32(rw, 0);
+      SDL_WriteLE32(rw, 0);
+      SDL_WriteLE32(rw, sizes[i]);
+      SDL_WriteLE32(rw, sizes[i]);
+      SDL_WriteLE16(rw, (Uint16)SDL_strlen(names[i]));
+      SDL_WriteLE16(rw, 3);
+      SDL_RWwrite(rw, names[i], 1, SDL_strlen(names[i]));
+      SDL_RWwrite(rw, "xyz", 1, 3);
+      SDL_RWwrite(rw, i < 3 ? _archiveData[i] : "abcd", 1, sizes[i]);
+   }
+
+   dir_start = SDL_RWtell(rw);
+   for (i = 0; i < 5; i++) {
+      const char *name = (i < 4) ? names[i] : "data/";
+      SDL_WriteLE32(rw, 0x02014b50);
+      SDL_WriteLE16(rw, 10);
+      SDL_WriteLE16(rw, 10);
+      SDL_WriteLE16(rw, 0);
+      SDL_WriteLE16(rw, (i < 4) ? methods[i] : 0);
+      SDL_WriteLE32(rw, 0);
+      SDL_WriteLE32(rw, 0);
+      SDL_WriteLE32(rw, (i < 4) ? sizes[i] : 0);
+      SDL_WriteLE32(rw, (i < 4) ? sizes[i] : 0);
+      SDL_WriteLE16(rw, (Uint16)SDL_strlen(name));
+      SDL_WriteLE16(rw, 0);
+      SDL_WriteLE16(rw, 0);
+      SDL_WriteLE16(rw, 0);
+      SDL_WriteLE16(rw, 0);
+      SDL_WriteLE32(rw, 0);
+      SDL_WriteLE32(rw, (i < 4) ? (Uint32)offsets[i] : 0);
+      SDL_RWwrite(rw, name, 1, SDL_strlen(name));
+   }
+   dir_end = SDL_RWtell(rw);
+
+   SDL_WriteLE32(rw, 0x06054b50);
+   SDL_WriteLE16(rw, 0);
+   SDL_WriteLE16(rw, 0);
+   SDL_WriteLE16(rw, 5);
+   SDL_WriteLE16(rw, 5);
+   SDL_WriteLE32(rw, (Uint32)(dir_end - dir_start));
+   SDL_WriteLE32(rw, (Uint32)dir_start);
+   SDL_WriteLE16(rw, 4);
+   SDL_RWwrite(rw, "note", 1, 4);
+}
+
+/* Write an SDL pack file */
+static void
+_writeTestPack(SDL_RWops *rw)
+{
+   Uint64 offset;
+   int i;
+
+   offset = 12;
+   for (i = 0; i < 3; i++) {
+      offset += 18 + SDL_strlen(_archiveNames[i]);
+   }
+   SDL_RWwrite(rw, "SDLPACK1", 1, 8);
+   SDL_WriteLE32(rw, 3);
+   for (i = 0; i < 3; i++) {
+      SDL_WriteLE64(rw, offset);
+      SDL_WriteLE64(rw, SDL_strlen(_archiveData[i]));
+      SDL_WriteLE16(rw, (Uint16)SDL_strlen(_archiveNames[i]));
+      SDL_RWwrite(rw, _archiveNames[i], 1, SDL_strlen(_archiveNames[i]));
+      offset += SDL_strlen(_archiveData[i]);
+   }
+   for (i = 0; i < 3; i++) {
+      SDL_RWwrite(rw, _archiveData[i], 1, SDL_strlen(_archiveData[i]));
+   }
+}
+
+/* Check the files in an archive written by _writeTestZip or _writeTestPack */
+static void
+_testArchiveContents(SDL_Archive *archive, int expected_type)
+{
+   SDL_RWops *rw;
+   char buf[64];
+   size_t s;
+   Sint64 i;
+   int n;
+
+   n = SDL_GetNumArchiveFiles(archive);
+   SDLTest_AssertCheck(n >= 3, "Verify number of files in archive; expected: >= 3, got: %d", n);
+   SDLTest_AssertCheck(SDL_GetArchiveFileName(archive, n) == NULL, "Verify SDL_GetArchiveFileName rejects an invalid index");
+   for (n = 0; n < 3; n++) {
+      i = SDL_GetArchiveFileSize(archive, _archiveNames[n]);
+      SDLTest_AssertCheck(i == (Sint64)SDL_strlen(_archiveData[n]), "Verify size of '%s'; expected: %d, got: %d", _archiveNames[n], (int)SDL_strlen(_archiveData[n]), (int)i);
+   }
+   SDLTest_AssertCheck(SDL_GetArchiveFileSize(archive, "missing") == -1, "Verify size of a missing file is -1");
+   SDLTest_AssertCheck(SDL_RWFromArchive(archive, "missing") == NULL, "Verify SDL_RWFromArchive returns NULL for a missing file");
+   SDLTest_AssertCheck(SDL_RWFromArchive(archive, "data/") == NULL, "Verify directories aren't listed");
+
+   rw = SDL_RWFromArchive(archive, "data/alphabet.txt");
+   SDLTest_AssertCheck(rw != NULL, "Verify SDL_RWFromArchive does not return NULL");
+   if (rw == NULL) return;
+   SDLTest_AssertCheck(rw->type == expected_type, "Verify RWops type; expected: %d, got: %d", expected_type, rw->type);
+   i = SDL_RWsize(rw);
+   SDLTest_AssertCheck(i == 26, "Verify size of stream; expected: 26, got: %d", (int)i);
+   SDL_zero(buf);
+   s = SDL_RWread(rw, buf, 1, sizeof(buf));
+   SDLTest_AssertCheck(s == 26 && SDL_strcmp(buf, RWopsAlphabetString) == 0, "Verify file contents; expected: %s, got: %s", RWopsAlphabetString, buf);
+   i = SDL_RWseek(rw, -3, RW_SEEK_END);
+   SDLTest_AssertCheck(i == 23, "Verify seek from end; expected: 23, got: %d", (int)i);
+   s = SDL_RWread(rw, buf, 1, sizeof(buf));
+   SDLTest_AssertCheck(s == 3 && SDL_strncmp(buf, "XYZ", 3) == 0, "Verify read stops at the end of the file");
+   SDLTest_AssertCheck(SDL_RWwrite(rw, "a", 1, 1) == 0, "Verify files in an archive are read-only");
+   SDL_RWclose(rw);
+
+   rw = SDL_RWFromArchive(archive, "empty");
+   SDLTest_AssertCheck(rw != NULL, "Verify empty files can be opened");
+   if (rw == NULL) return;
+   SDLTest_AssertCheck(SDL_RWread(rw, buf, 1, 1) == 0, "Verify empty file has no data");
+   SDL_RWclose(rw);
+}
+
+/**
+ * @brief Tests reading files from zip and pack archives.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_OpenArchiveRW
+ * http://wiki.libsdl.org/moin.cgi/SDL_RWFromArchive
+ */
+int
+rwops_testArchive(void)
+{
+   static Uint8 mem[2048];
+   SDL_Archive *archive;
+   SDL_RWops *rw;
+   Sint64 size;
+
+   SDLTest_AssertCheck(SDL_OpenArchiveRW(NULL, 0) == NULL, "Verify SDL_OpenArchiveRW rejects a NULL stream");
+   rw = SDL_RWFromConstMem(RWopsAlphabetString, sizeof(RWopsAlphabetString)-1);
+   SDLTest_AssertCheck(SDL_OpenArchiveRW(rw, 1) == NULL, "Verify SDL_OpenArchiveRW rejects a file that isn't an archive");
+
+   /* Zip file in memory, read without copying */
+   rw = SDL_RWFromMem(mem, sizeof(mem));
+   if (rw == NULL) return TEST_ABORTED;
+   _writeTestZip(rw);
+   size = SDL_RWtell(rw);
+   SDL_RWclose(rw);
+   archive = SDL_OpenArchiveRW(SDL_RWFromConstMem(mem, (int)size), 1);
+   SDLTest_AssertCheck(archive != NULL, "Verify opening a zip file with SDL_OpenArchiveRW does not return NULL");
+   if (archive == NULL) return TEST_ABORTED;
+   _testArchiveContents(archive, SDL_RWOPS_MEMORY_RO);
+   rw = SDL_RWFromArchive(archive, "compressed.bin");
+   SDLTest_AssertCheck(rw == NULL, "Verify compressed files are rejected");
+   SDL_CloseArchive(archive);
+
+   /* Pack file, read through a shared file stream */
+   rw = SDL_RWFromFile(RWopsWriteTestFilename, "wb");
+   if (rw == NULL) return TEST_ABORTED;
+   _writeTestPack(rw);
+   SDL_RWclose(rw);
+   archive = SDL_OpenArchiveRW(SDL_RWFromFile(RWopsWriteTestFilename, "rb"), 1);
+   SDLTest_AssertCheck(archive != NULL, "Verify opening a pack file with SDL_OpenArchiveRW does not return NULL");
+   if (archive == NULL) return TEST_ABORTED;
+   _testArchiveContents(archive, SDL_RWOPS_ARCHIVE);
+   SDL_CloseArchive(archive);
+
+   /* The same pack file mapped into memory */
+   archive = SDL_OpenArchive(RWopsWriteTestFilename);
+   SDLTest_AssertCheck(archive != NULL, "Verify opening a pack file with SDL_OpenArchive does not return NULL");
+   if (archive == NULL) return TEST_ABORTED;
+   SDLTest_AssertCheck(SDL_GetNumArchiveFiles(archive) == 3, "Verify number of files in pack; expected: 3, got: %d", SDL_GetNumArchiveFiles(archive));
+   SDL_CloseArchive(archive);
+
+   return TEST_COMPLETED;
+}
+
+/* Counts the finished requests in rwops_testAsyncRead, and the ones whose
+   status hadn't been stored yet when their callback ran */
+static SDL_atomic_t _asyncCallbacks;
+static SDL_atomic_t _asyncStale;
+
+static void SDLCALL
+_asyncCallback(void *userdata, SDL_AsyncIO *request, SDL_AsyncIOStatus status, size_t bytes)
+{
+   size_t stored = 0;
+
+   if (SDL_GetAsyncIOStatus(request, &stored) != status || stored != bytes) {
+      SDL_AtomicIncRef(&_asyncStale);
+   }
+   SDL_AtomicIncRef(&_asyncCallbacks);
+}
+
+/**
+ * @brief Tests asynchronous reads from a file.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_ReadAsync
+ * http://wiki.libsdl.org/moin.cgi/SDL_WaitAsyncIO
+ * http://wiki.libsdl.org/moin.cgi/SDL_CancelAsyncIO
+ */
+int
+rwops_testAsyncRead(void)
+{
+   SDL_RWops *rw;
+   SDL_AsyncIO *requests[5];
+   SDL_AsyncIOStatus status;
+   char buf[32];
+   size_t bytes;
+   int i, result;
+
+   rw = SDL_RWFromFile(RWopsAlphabetFilename, "rb");
+   SDLTest_AssertCheck(rw != NULL, "Verify opening file with SDL_RWFromFile in read mode does not return NULL");
+   if (rw == NULL) return TEST_ABORTED;
+
+   /* Negative cases */
+   SDLTest_AssertCheck(SDL_ReadAsync(NULL, 0, buf, 1, 0, NULL, NULL) == NULL, "Verify SDL_ReadAsync rejects a NULL stream");
+   SDLTest_AssertCheck(SDL_ReadAsync(rw, -1, buf, 1, 0, NULL, NULL) == NULL, "Verify SDL_ReadAsync rejects a negative offset");
+
+   /* Adjacent reads, out of order and with mixed priorities, plus a short read at the end */
+   SDL_AtomicSet(&_asyncCallbacks, 0);
+   SDL_AtomicSet(&_asyncStale, 0);
+   SDL_memset(buf, '.', sizeof(buf));
+   requests[0] = SDL_ReadAsync(rw, 10, &buf[10], 10, 0, _asyncCallback, NULL);
+   requests[1] = SDL_ReadAsync(rw, 0, &buf[0], 5, 1, _asyncCallback, NULL);
+   requests[2] = SDL_ReadAsync(rw, 5, &buf[5], 5, 0, _asyncCallback, NULL);
+   requests[3] = SDL_ReadAsync(rw, 20, &buf[20], 10, -1, _asyncCallback, NULL);
+   requests[4] = SDL_ReadAsync(rw, 100, &buf[30], 1, 0, _asyncCallback, NULL);
+   SDLTest_AssertPass("Call to SDL_ReadAsync() succeeded");
+   for (i = 0; i < SDL_arraysize(requests); i++) {
+      SDLTest_AssertCheck(requests[i] != NULL, "Verify request %d is not NULL", i);
+      if (requests[i] == NULL) return TEST_ABORTED;
+   }
+
+   for (i = 0; i < 4; i++) {
+      status = SDL_WaitAsyncIO(requests[i], &bytes);
+      SDLTest_AssertCheck(status == SDL_ASYNCIO_COMPLETE, "Verify request %d completed; expected: %d, got: %d", i, SDL_ASYNCIO_COMPLETE, status);
+   }
+   SDL_GetAsyncIOStatus(requests[3], &bytes);
+   SDLTest_AssertCheck(bytes == 6, "Verify short read at end of file; expected: 6, got: %d", (int)bytes);
+   status = SDL_WaitAsyncIO(requests[4], &bytes);
+   SDLTest_AssertCheck(status == SDL_ASYNCIO_FAILED, "Verify read past end of file failed; expected: %d, got: %d", SDL_ASYNCIO_FAILED, status);
+   SDLTest_AssertCheck(SDL_strncmp(buf, RWopsAlphabetString, 26) == 0, "Verify data read asynchronously matches the file");
+   SDLTest_AssertCheck(SDL_AtomicGet(&_asyncCallbacks) == 5, "Verify callback count; expected: 5, got: %d", SDL_AtomicGet(&_asyncCallbacks));
+   for (i = 0; i < SDL_arraysize(requests); i++) {
+      SDL_FreeAsyncIO(requests[i]);
+   }
+
+   /* Cancellation either wins or the request completes normally */
+   SDL_AtomicSet(&_asyncCallbacks, 0);
+   requests[0] = SDL_ReadAsync(rw, 0, buf, 26, 0, _asyncCallback, NULL);
+   SDLTest_AssertCheck(requests[0] != NULL, "Verify request is not NULL");
+   if (requests[0] == NULL) return TEST_ABORTED;
+   result = SDL_CancelAsyncIO(requests[0]);
+   status = SDL_WaitAsyncIO(requests[0], NULL);
+   if (result == 0) {
+      SDLTest_AssertCheck(status == SDL_ASYNCIO_CANCELED, "Verify canceled request status; expected: %d, got: %d", SDL_ASYNCIO_CANCELED, status);
+   } else {
+      SDLTest_AssertCheck(status == SDL_ASYNCIO_COMPLETE, "Verify started request completed; expected: %d, got: %d", SDL_ASYNCIO_COMPLETE, status);
+   }
+   SDLTest_AssertCheck(SDL_AtomicGet(&_asyncCallbacks) == 1, "Verify callback count; expected: 1, got: %d", SDL_AtomicGet(&_asyncCallbacks));
+   SDLTest_AssertCheck(SDL_AtomicGet(&_asyncStale) == 0, "Verify status was stored before each callback; expected: 0 stale, got: %d", SDL_AtomicGet(&_asyncStale));
+   SDL_FreeAsyncIO(requests[0]);
+
+   result = SDL_RWclose(rw);
+   SDLTest_AssertPass("Call to SDL_RWclose() succeeded");
+   SDLTest_AssertCheck(result == 0, "Verify result value is 0; got: %d", result);
+
+   return TEST_COMPLETED;
+}
+
 /**
  * @brief Tests writing from file.
  *
@@ -733,10 +1171,23 @@ static const SDLTest_TestCaseReference rwopsTest9 =
 static const SDLTest_TestCaseReference rwopsTest10 =
         { (SDLTest_TestCaseFp)rwops_testCompareRWFromMemWithRWFromFile, "rwops_testCompareRWFromMemWithRWFromFile", "Compare RWFromMem and RWFromFile RWops for read and seek", TEST_ENABLED };
 
+static const SDLTest_TestCaseReference rwopsTest11 =
+        { (SDLTest_TestCaseFp)rwops_testFileMapped, "rwops_testFileMapped", "Tests reading from a memory mapped file", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference rwopsTest12 =
+        { (SDLTest_TestCaseFp)rwops_testAsyncRead, "rwops_testAsyncRead", "Tests asynchronous reads from a file", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference rwopsTest13 =
+        { (SDLTest_TestCaseFp)rwops_testBuffered, "rwops_testBuffered", "Tests reading and writing through a buffered stream", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference rwopsTest14 =
+        { (SDLTest_TestCaseFp)rwops_testArchive, "rwops_testArchive", "Tests reading files from zip and pack archives", TEST_ENABLED };
+
 /* Sequence of RWops test cases */
 static const SDLTest_TestCaseReference *rwopsTests[] =  {
     &rwopsTest1, &rwopsTest2, &rwopsTest3, &rwopsTest4, &rwopsTest5, &rwopsTest6,
-    &rwopsTest7, &rwopsTest8, &rwopsTest9, &rwopsTest10, NULL
+    &rwopsTest7, &rwopsTest8, &rwopsTest9, &rwopsTest10, &rwopsTest11,
+    &rwopsTest12, &rwopsTest13, &rwopsTest14, NULL
 };
 
 /* RWops test suite (global) */
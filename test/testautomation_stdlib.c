@@ -7,6 +7,13 @@
 #include "SDL.h"
 #include "SDL_test.h"
 
+/* Threads that SDL didn't create are made with pthreads directly */
+#if defined(__LINUX__) || defined(__MACOSX__) || defined(__FREEBSD__) || \
+    defined(__NETBSD__) || defined(__OPENBSD__) || defined(__SOLARIS__)
+#define HAVE_PTHREADS
+#include <pthread.h>
+#endif
+
 
 /* Test case functions */
 
@@ -36,6 +43,200 @@ stdlib_strlcpy(void *arg)
   return TEST_COMPLETED;
 }
 
+/**
+ * @brief Call to SDL_utf8strlen and SDL_utf8valid
+ */
+int
+stdlib_utf8(void *arg)
+{
+  const char *text = "Gr\xC3\xBC\xC3\x9F Gott, \xE2\x82\xAC \xF0\x9F\x98\x80 and a string long enough for a few blocks";
+  const char *invalid[] = {
+    "\xC0\x80",           /* Overlong NUL */
+    "\xE0\x9F\xBF",       /* Overlong 3 byte sequence */
+    "\xED\xA0\x80",       /* Surrogate */
+    "\xF4\x90\x80\x80",   /* Above U+10FFFF */
+    "\xE2\x82",           /* Truncated */
+    "0123456789abcdef\x80" /* Stray trailing byte after a block of ASCII */
+  };
+  size_t result;
+  int i;
+
+  result = SDL_utf8strlen(text);
+  SDLTest_AssertPass("Call to SDL_utf8strlen()");
+  SDLTest_AssertCheck(result == SDL_strlen(text) - 7, "Check result value, expected: %d, got: %d", (int)(SDL_strlen(text) - 7), (int)result);
+
+  result = SDL_utf8strlen(text + 3);
+  SDLTest_AssertPass("Call to SDL_utf8strlen() on an unaligned string");
+  SDLTest_AssertCheck(result == SDL_strlen(text) - 10, "Check result value, expected: %d, got: %d", (int)(SDL_strlen(text) - 10), (int)result);
+
+  SDLTest_AssertCheck(SDL_utf8valid(text, SDL_strlen(text)), "Check that SDL_utf8valid() accepts valid text");
+  for (i = 0; i < SDL_arraysize(invalid); ++i) {
+    SDLTest_AssertCheck(!SDL_utf8valid(invalid[i], SDL_strlen(invalid[i])), "Check that SDL_utf8valid() rejects invalid sequence %d", i);
+  }
+  SDLTest_AssertCheck(SDL_utf8valid(text, 2), "Check that SDL_utf8valid() accepts text ending before a sequence");
+  SDLTest_AssertCheck(!SDL_utf8valid(text, 3), "Check that SDL_utf8valid() rejects text ending inside a sequence");
+
+  return TEST_COMPLETED;
+}
+
+/* Convert with SDL_iconv(), giving it at most 'chunk' bytes of output at a time */
+static size_t
+_iconvConvert(const char *tocode, const char *fromcode, const char *in, size_t inlen, char *out, size_t outlen, size_t chunk)
+{
+  SDL_iconv_t cd = SDL_iconv_open(tocode, fromcode);
+  char *dst = out;
+
+  if (cd == (SDL_iconv_t)-1) {
+    return 0;
+  }
+  while (inlen > 0 && dst < out + outlen) {
+    size_t left = SDL_min(chunk, (size_t)(out + outlen - dst));
+    char *start = dst;
+    size_t result = SDL_iconv(cd, &in, &inlen, &dst, &left);
+    if (result != SDL_ICONV_E2BIG || dst == start) {
+      break;
+    }
+  }
+  SDL_iconv_close(cd);
+  return (size_t)(dst - out);
+}
+
+/**
+ * @brief Call to SDL_iconv, comparing the direct conversions with ones through UCS-2
+ */
+int
+stdlib_iconv(void *arg)
+{
+  /* Text in the Basic Multilingual Plane with some invalid sequences,
+     which UCS-2 and UTF-16 represent the same way */
+  const char *text = "A run of ASCII text long enough for a few blocks, Gr\xC3\xBC\xC3\x9F Gott, "
+                     "\xE2\x82\xAC 5, \xE4\xB8\xAD\xE6\x96\x87, \xC0\x80 \xED\xA0\x80 \xEF\xBF\xBE \xE2\x82 \x80 "
+                     "and another run of ASCII text at the end";
+  const size_t textlen = SDL_strlen(text);
+  char utf16[512], ucs2[512], expected[512], result[512];
+  size_t utf16len, ucs2len, expectedlen, resultlen;
+
+  utf16len = _iconvConvert("UTF-16LE", "UTF-8", text, textlen, utf16, sizeof(utf16), sizeof(utf16));
+  ucs2len = _iconvConvert("UCS-2LE", "UTF-8", text, textlen, ucs2, sizeof(ucs2), sizeof(ucs2));
+  SDLTest_AssertPass("Call to SDL_iconv() from UTF-8");
+  SDLTest_AssertCheck(utf16len > 0 && utf16len == ucs2len && SDL_memcmp(utf16, ucs2, utf16len) == 0, "Check UTF-8 to UTF-16LE matches UTF-8 to UCS-2LE, got %d and %d bytes", (int)utf16len, (int)ucs2len);
+
+  resultlen = _iconvConvert("UTF-16LE", "UTF-8", text, textlen, result, sizeof(result), 5);
+  SDLTest_AssertCheck(resultlen == utf16len && SDL_memcmp(result, utf16, utf16len) == 0, "Check UTF-8 to UTF-16LE with a small output buffer, got %d bytes", (int)resultlen);
+
+  expectedlen = _iconvConvert("UTF-8", "UCS-2LE", ucs2, ucs2len, expected, sizeof(expected), sizeof(expected));
+  resultlen = _iconvConvert("UTF-8", "UTF-16LE", utf16, utf16len, result, sizeof(result), sizeof(result));
+  SDLTest_AssertPass("Call to SDL_iconv() to UTF-8");
+  SDLTest_AssertCheck(resultlen > 0 && resultlen == expectedlen && SDL_memcmp(result, expected, resultlen) == 0, "Check UTF-16LE to UTF-8 matches UCS-2LE to UTF-8, got %d and %d bytes", (int)resultlen, (int)expectedlen);
+
+  expectedlen = _iconvConvert("ISO-8859-1", "UCS-2LE", ucs2, ucs2len, expected, sizeof(expected), sizeof(expected));
+  resultlen = _iconvConvert("ISO-8859-1", "UTF-8", text, textlen, result, sizeof(result), sizeof(result));
+  SDLTest_AssertPass("Call to SDL_iconv() to Latin-1");
+  SDLTest_AssertCheck(resultlen > 0 && resultlen == expectedlen && SDL_memcmp(result, expected, resultlen) == 0, "Check UTF-8 to ISO-8859-1 matches UCS-2LE to ISO-8859-1, got %d and %d bytes", (int)resultlen, (int)expectedlen);
+
+  /* Characters outside of the BMP need surrogate pairs */
+  resultlen = _iconvConvert("UTF-16LE", "UTF-8", "a\xF0\x9F\x98\x80", 5, result, sizeof(result), sizeof(result));
+  SDLTest_AssertCheck(resultlen == 6 && SDL_memcmp(result, "a\0\x3D\xD8\x00\xDE", 6) == 0, "Check UTF-8 to UTF-16LE surrogate pair, got %d bytes", (int)resultlen);
+  resultlen = _iconvConvert("UTF-8", "UTF-16LE", "a\0\x3D\xD8\x00\xDE", 6, result, sizeof(result), sizeof(result));
+  SDLTest_AssertCheck(resultlen == 5 && SDL_memcmp(result, "a\xF0\x9F\x98\x80", 5) == 0, "Check UTF-16LE surrogate pair to UTF-8, got %d bytes", (int)resultlen);
+
+  return TEST_COMPLETED;
+}
+
+static int
+_compareInts(const void *a, const void *b)
+{
+  const int x = *(const int *)a;
+  const int y = *(const int *)b;
+  return (x < y) ? -1 : (x > y);
+}
+
+typedef struct
+{
+  Sint32 s32;
+  float f;
+  Sint64 s64;
+  double d;
+  Uint32 u32;
+  int order;
+} _SortElement;
+
+/**
+ * @brief Call to SDL_qsort and SDL_SortByKey
+ */
+int
+stdlib_sort(void *arg)
+{
+  const int count = 5000;
+  int *values = (int *)SDL_malloc(count * sizeof(int));
+  _SortElement *elements = (_SortElement *)SDL_malloc(count * sizeof(_SortElement));
+  int pattern, i;
+  SDL_bool sorted, stable;
+
+  SDLTest_AssertCheck(values != NULL && elements != NULL, "Check that memory was allocated");
+  if (!values || !elements) {
+    SDL_free(values);
+    SDL_free(elements);
+    return TEST_ABORTED;
+  }
+
+  /* Random, sorted, reversed, constant and organ pipe input */
+  for (pattern = 0; pattern < 5; ++pattern) {
+    for (i = 0; i < count; ++i) {
+      switch (pattern) {
+      case 0: values[i] = SDLTest_RandomSint32(); break;
+      case 1: values[i] = i; break;
+      case 2: values[i] = count - i; break;
+      case 3: values[i] = 42; break;
+      default: values[i] = (i < count / 2) ? i : (count - i); break;
+      }
+    }
+    SDL_qsort(values, count, sizeof(int), _compareInts);
+    sorted = SDL_TRUE;
+    for (i = 1; i < count; ++i) {
+      if (values[i - 1] > values[i]) {
+        sorted = SDL_FALSE;
+      }
+    }
+    SDLTest_AssertCheck(sorted, "Check that SDL_qsort() sorted input pattern %d", pattern);
+  }
+
+  /* Keys with few distinct values, so stability is visible */
+  for (i = 0; i < count; ++i) {
+    const int key = SDLTest_RandomIntegerInRange(-100, 100);
+    elements[i].s32 = key;
+    elements[i].f = key * 0.25f;
+    elements[i].s64 = (Sint64)key << 40;
+    elements[i].d = key * -1.5;
+    elements[i].u32 = (Uint32)SDLTest_RandomIntegerInRange(0, 300);
+    elements[i].order = i;
+  }
+
+#define CHECK_SORT(type, field, cmp) \
+  SDLTest_AssertCheck(SDL_SortByKey(elements, count, sizeof(*elements), offsetof(_SortElement, field), type) == 0, "Call to SDL_SortByKey() with " #type); \
+  sorted = stable = SDL_TRUE; \
+  for (i = 1; i < count; ++i) { \
+    if (elements[i - 1].field cmp elements[i].field) sorted = SDL_FALSE; \
+    else if (elements[i - 1].field == elements[i].field && elements[i - 1].order > elements[i].order) stable = SDL_FALSE; \
+  } \
+  SDLTest_AssertCheck(sorted && stable, "Check that the elements are sorted stably by " #field); \
+  for (i = 0; i < count; ++i) elements[i].order = i;
+
+  CHECK_SORT(SDL_SORTKEY_SINT32, s32, >)
+  CHECK_SORT(SDL_SORTKEY_UINT32, u32, >)
+  CHECK_SORT(SDL_SORTKEY_FLOAT, f, >)
+  CHECK_SORT(SDL_SORTKEY_SINT64, s64, >)
+  CHECK_SORT(SDL_SORTKEY_DOUBLE, d, >)
+#undef CHECK_SORT
+
+  SDLTest_AssertCheck(SDL_SortByKey(elements, count, sizeof(*elements), sizeof(*elements) - 2, SDL_SORTKEY_UINT32) < 0, "Check that SDL_SortByKey() rejects a key past the end of the element");
+  SDLTest_AssertCheck(SDL_SortByKey(elements, (~(size_t)0) / 8, sizeof(*elements), offsetof(_SortElement, u32), SDL_SORTKEY_UINT32) < 0, "Check that SDL_SortByKey() rejects a count too big to allocate");
+
+  SDL_free(values);
+  SDL_free(elements);
+  return TEST_COMPLETED;
+}
+
 /**
  * @brief Call to SDL_snprintf
  */
@@ -119,6 +320,239 @@ stdlib_snprintf(void *arg)
   return TEST_COMPLETED;
 }
 
+/**
+ * @brief Call to SDL_malloc, SDL_realloc, SDL_free and SDL_GetMallocStats
+ */
+int
+stdlib_malloc(void *arg)
+{
+  SDL_MallocStats stats;
+  Uint8 *mem;
+  size_t size, i;
+  int result;
+
+  /* Grow a block through every small size class and out into a large one */
+  mem = (Uint8 *)SDL_malloc(1);
+  SDLTest_AssertPass("Call to SDL_malloc(1)");
+  SDLTest_AssertCheck(mem != NULL, "Check result value, expected: non-NULL, got: %p", mem);
+  if (mem == NULL) {
+    return TEST_ABORTED;
+  }
+  mem[0] = 0;
+  for (size = 2; size <= 1024; size *= 2) {
+    mem = (Uint8 *)SDL_realloc(mem, size);
+    SDLTest_AssertCheck(mem != NULL, "Check SDL_realloc(%d) result, expected: non-NULL, got: %p", (int)size, mem);
+    if (mem == NULL) {
+      return TEST_ABORTED;
+    }
+    for (i = size / 2; i < size; ++i) {
+      mem[i] = (Uint8)i;
+    }
+  }
+  for (i = 1; i < 1024; ++i) {
+    if (mem[i] != (Uint8)i) {
+      break;
+    }
+  }
+  SDLTest_AssertCheck(i == 1024, "Check contents preserved across SDL_realloc, expected: 1024 bytes, got: %d", (int)i);
+
+  /* And shrink it back down again */
+  mem = (Uint8 *)SDL_realloc(mem, 8);
+  SDLTest_AssertPass("Call to SDL_realloc(8)");
+  SDLTest_AssertCheck(mem != NULL && mem[7] == 7, "Check contents preserved after shrinking");
+  SDL_free(mem);
+  SDLTest_AssertPass("Call to SDL_free()");
+
+  mem = (Uint8 *)SDL_calloc(100, 2);
+  SDLTest_AssertPass("Call to SDL_calloc(100, 2)");
+  SDLTest_AssertCheck(mem != NULL, "Check result value, expected: non-NULL, got: %p", mem);
+  if (mem) {
+    for (i = 0; i < 200 && mem[i] == 0; ++i) {
+    }
+    SDLTest_AssertCheck(i == 200, "Check memory is zeroed, expected: 200 zero bytes, got: %d", (int)i);
+    SDL_free(mem);
+  }
+
+  result = SDL_GetMallocStats(&stats);
+  SDLTest_AssertPass("Call to SDL_GetMallocStats()");
+  if (result == 0) {
+    SDLTest_AssertCheck(stats.peak_bytes_in_use >= stats.bytes_in_use,
+      "Check peak_bytes_in_use >= bytes_in_use, got: %d, %d",
+      (int)stats.peak_bytes_in_use, (int)stats.bytes_in_use);
+  } else {
+    SDLTest_AssertCheck(result == -1, "Check result value, expected: -1, got: %d", result);
+  }
+  result = SDL_GetMallocStats(NULL);
+  SDLTest_AssertCheck(result == -1, "Check SDL_GetMallocStats(NULL), expected: -1, got: %d", result);
+
+  return TEST_COMPLETED;
+}
+
+#ifdef HAVE_PTHREADS
+#define MALLOC_THREADS      4
+#define MALLOC_SLOTS        1024
+#define MALLOC_ITERATIONS   20000
+
+static SDL_atomic_t malloc_failures;
+static void *malloc_slots[MALLOC_SLOTS];
+
+/* Allocate into random slots, freeing whatever another thread left there */
+static void *
+malloc_thread(void *arg)
+{
+  Uint32 seed = (Uint32)(size_t)arg * 7919 + 1;
+  void *mem;
+  int i;
+
+  for (i = 0; i < MALLOC_ITERATIONS; ++i) {
+    seed = seed * 1103515245 + 12345;
+    mem = SDL_AtomicSetPtr(&malloc_slots[(seed >> 8) % MALLOC_SLOTS], NULL);
+    if (mem) {
+      SDL_free(mem);
+      continue;
+    }
+    mem = SDL_malloc(1 + (seed >> 20) % 300);
+    if (!mem) {
+      SDL_AtomicIncRef(&malloc_failures);
+      continue;
+    }
+    SDL_free(SDL_AtomicSetPtr(&malloc_slots[(seed >> 8) % MALLOC_SLOTS], mem));
+  }
+  return NULL;
+}
+#endif /* HAVE_PTHREADS */
+
+/**
+ * @brief Call to SDL_malloc and SDL_free from threads that SDL didn't create
+ */
+int
+stdlib_mallocThreads(void *arg)
+{
+#ifdef HAVE_PTHREADS
+  SDL_MallocStats before, after;
+  pthread_t threads[MALLOC_THREADS];
+  int i, created = 0;
+  int result;
+
+  result = SDL_GetMallocStats(&before);
+  SDL_AtomicSet(&malloc_failures, 0);
+  for (i = 0; i < MALLOC_THREADS; ++i) {
+    if (pthread_create(&threads[created], NULL, malloc_thread, (void *)(size_t)i) == 0) {
+      ++created;
+    }
+  }
+  SDLTest_AssertCheck(created == MALLOC_THREADS, "Check threads were created, expected: %d, got: %d", MALLOC_THREADS, created);
+  for (i = 0; i < created; ++i) {
+    pthread_join(threads[i], NULL);
+  }
+  SDLTest_AssertPass("Joined threads calling SDL_malloc() and SDL_free()");
+  for (i = 0; i < MALLOC_SLOTS; ++i) {
+    SDL_free(malloc_slots[i]);
+    malloc_slots[i] = NULL;
+  }
+  SDLTest_AssertCheck(SDL_AtomicGet(&malloc_failures) == 0, "Check allocations succeeded, expected: 0 failures, got: %d", SDL_AtomicGet(&malloc_failures));
+
+  /* Threads return their cached blocks as they exit, so everything is counted */
+  if (result == 0) {
+    SDL_GetMallocStats(&after);
+    SDLTest_AssertCheck(after.bytes_in_use == before.bytes_in_use,
+      "Check bytes_in_use is back where it was, expected: %d, got: %d",
+      (int)before.bytes_in_use, (int)after.bytes_in_use);
+    for (i = 0; i < SDL_MALLOC_SIZE_CLASSES; ++i) {
+      if (after.class_in_use[i] != before.class_in_use[i]) {
+        break;
+      }
+    }
+    SDLTest_AssertCheck(i == SDL_MALLOC_SIZE_CLASSES, "Check class_in_use is back where it was for every size class");
+  }
+  return TEST_COMPLETED;
+#else
+  SDLTest_Log("Threads not created through SDL can't be tested on this platform");
+  return TEST_SKIPPED;
+#endif
+}
+
+static SDL_malloc_func original_malloc;
+static SDL_calloc_func original_calloc;
+static SDL_realloc_func original_realloc;
+static SDL_free_func original_free;
+static int counted_allocations;
+
+static void * SDLCALL
+counting_malloc(size_t size)
+{
+  ++counted_allocations;
+  return original_malloc(size);
+}
+
+static void * SDLCALL
+counting_calloc(size_t nmemb, size_t size)
+{
+  ++counted_allocations;
+  return original_calloc(nmemb, size);
+}
+
+static void * SDLCALL
+counting_realloc(void *mem, size_t size)
+{
+  ++counted_allocations;
+  return original_realloc(mem, size);
+}
+
+static void SDLCALL
+counting_free(void *mem)
+{
+  original_free(mem);
+}
+
+/**
+ * @brief Call to SDL_SetMemoryFunctions and SDL_GetMemoryUsage
+ */
+int
+stdlib_memoryFunctions(void *arg)
+{
+  SDL_MemoryUsage before, during, after;
+  SDL_Surface *surface;
+  int result;
+
+  SDL_GetMemoryFunctions(&original_malloc, &original_calloc, &original_realloc, &original_free);
+  SDLTest_AssertPass("Call to SDL_GetMemoryFunctions()");
+  SDLTest_AssertCheck(original_malloc && original_calloc && original_realloc && original_free,
+    "Check that all memory functions are set");
+
+  result = SDL_SetMemoryFunctions(NULL, counting_calloc, counting_realloc, counting_free);
+  SDLTest_AssertCheck(result == -1, "Check SDL_SetMemoryFunctions() with NULL malloc, expected: -1, got: %d", result);
+
+  /* The counting functions pass through, so memory can move between them */
+  counted_allocations = 0;
+  result = SDL_SetMemoryFunctions(counting_malloc, counting_calloc, counting_realloc, counting_free);
+  SDLTest_AssertCheck(result == 0, "Check SDL_SetMemoryFunctions(), expected: 0, got: %d", result);
+
+  SDL_GetMemoryUsage(SDL_MEMORY_VIDEO_SURFACES, &before);
+  surface = SDL_CreateRGBSurface(0, 64, 64, 32, 0, 0, 0, 0);
+  SDLTest_AssertCheck(surface != NULL, "Check SDL_CreateRGBSurface(), expected: non-NULL, got: %p", surface);
+  SDLTest_AssertCheck(counted_allocations > 0, "Check custom allocator was used, expected: >0, got: %d", counted_allocations);
+
+  SDL_GetMemoryUsage(SDL_MEMORY_VIDEO_SURFACES, &during);
+  SDLTest_AssertCheck(during.bytes >= before.bytes + 64 * 64 * 4,
+    "Check surface bytes grew by at least %d, got: %d", 64 * 64 * 4, (int)(during.bytes - before.bytes));
+  SDLTest_AssertCheck(during.allocations > before.allocations,
+    "Check surface allocations grew, expected: >%d, got: %d", before.allocations, during.allocations);
+
+  SDL_FreeSurface(surface);
+  SDL_GetMemoryUsage(SDL_MEMORY_VIDEO_SURFACES, &after);
+  SDLTest_AssertCheck(after.bytes == before.bytes && after.allocations == before.allocations,
+    "Check surface memory released, expected: %d bytes, got: %d", (int)before.bytes, (int)after.bytes);
+
+  result = SDL_SetMemoryFunctions(original_malloc, original_calloc, original_realloc, original_free);
+  SDLTest_AssertCheck(result == 0, "Check restoring memory functions, expected: 0, got: %d", result);
+
+  result = SDL_GetMemoryUsage(SDL_NUM_MEMORY_CATEGORIES, &after);
+  SDLTest_AssertCheck(result == -1, "Check SDL_GetMemoryUsage() with invalid category, expected: -1, got: %d", result);
+
+  return TEST_COMPLETED;
+}
+
 /* ================= Test References ================== */
 
 /* Standard C routine test cases */
@@ -128,9 +562,27 @@ static const SDLTest_TestCaseReference stdlibTest1 =
 static const SDLTest_TestCaseReference stdlibTest2 =
         { (SDLTest_TestCaseFp)stdlib_snprintf, "stdlib_snprintf", "Call to SDL_snprintf", TEST_ENABLED };
 
+static const SDLTest_TestCaseReference stdlibTest3 =
+        { (SDLTest_TestCaseFp)stdlib_malloc, "stdlib_malloc", "Call to SDL_malloc, SDL_realloc and SDL_GetMallocStats", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference stdlibTest4 =
+        { (SDLTest_TestCaseFp)stdlib_mallocThreads, "stdlib_mallocThreads", "Call to SDL_malloc and SDL_free from threads SDL didn't create", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference stdlibTest5 =
+        { (SDLTest_TestCaseFp)stdlib_memoryFunctions, "stdlib_memoryFunctions", "Call to SDL_SetMemoryFunctions and SDL_GetMemoryUsage", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference stdlibTest6 =
+        { (SDLTest_TestCaseFp)stdlib_utf8, "stdlib_utf8", "Call to SDL_utf8strlen and SDL_utf8valid", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference stdlibTest7 =
+        { (SDLTest_TestCaseFp)stdlib_iconv, "stdlib_iconv", "Call to SDL_iconv with direct and generic conversions", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference stdlibTest8 =
+        { (SDLTest_TestCaseFp)stdlib_sort, "stdlib_sort", "Call to SDL_qsort and SDL_SortByKey", TEST_ENABLED };
+
 /* Sequence of Standard C routine test cases */
 static const SDLTest_TestCaseReference *stdlibTests[] =  {
-    &stdlibTest1, &stdlibTest2, NULL
+    &stdlibTest1, &stdlibTest2, &stdlibTest3, &stdlibTest4, &stdlibTest5, &stdlibTest6, &stdlibTest7, &stdlibTest8, NULL
 };
 
 /* Timer test suite (global) */
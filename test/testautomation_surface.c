@@ -252,6 +252,69 @@ surface_testSaveLoadBitmap(void *arg)
     return TEST_COMPLETED;
 }
 
+/* !
+ *  Tests loading a bitmap directly into another pixel format.
+ */
+int
+surface_testLoadBitmapFormat(void *arg)
+{
+    const Uint32 formats[] = {
+        SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_ABGR8888,
+        SDL_PIXELFORMAT_RGB565, SDL_PIXELFORMAT_RGB24
+    };
+    const char *sampleFilename = "testLoadBitmapFormat.bmp";
+    SDL_Surface *face;
+    SDL_Surface *rface;
+    SDL_Surface *cface;
+    int i, ret;
+
+    /* Create sample surface, saved as a 24-bit bitmap */
+    face = SDLTest_ImageFace();
+    SDLTest_AssertCheck(face != NULL, "Verify face surface is not NULL");
+    if (face == NULL) return TEST_ABORTED;
+    cface = SDL_ConvertSurfaceFormat(face, SDL_PIXELFORMAT_RGB888, 0);
+    SDL_FreeSurface(face);
+    face = cface;
+    SDLTest_AssertCheck(face != NULL, "Verify converted face surface is not NULL");
+    if (face == NULL) return TEST_ABORTED;
+
+    unlink(sampleFilename);
+    ret = SDL_SaveBMP(face, sampleFilename);
+    SDLTest_AssertPass("Call to SDL_SaveBMP()");
+    SDLTest_AssertCheck(ret == 0, "Verify result from SDL_SaveBMP, expected: 0, got: %i", ret);
+    SDL_FreeSurface(face);
+
+    face = SDL_LoadBMP(sampleFilename);
+    SDLTest_AssertCheck(face != NULL, "Verify result from SDL_LoadBMP is not NULL");
+    if (face == NULL) return TEST_ABORTED;
+
+    /* Loading into a format must match loading and converting */
+    for (i = 0; i < SDL_arraysize(formats); ++i) {
+        rface = SDL_LoadBMPFormat(sampleFilename, formats[i]);
+        SDLTest_AssertPass("Call to SDL_LoadBMPFormat(%s)", SDL_GetPixelFormatName(formats[i]));
+        SDLTest_AssertCheck(rface != NULL, "Verify result from SDL_LoadBMPFormat is not NULL");
+        cface = SDL_ConvertSurfaceFormat(face, formats[i], 0);
+        if (rface != NULL && cface != NULL) {
+            SDLTest_AssertCheck(rface->format->format == formats[i], "Verify format of loaded surface, expected: %s, got: %s",
+                                SDL_GetPixelFormatName(formats[i]), SDL_GetPixelFormatName(rface->format->format));
+            ret = SDLTest_CompareSurfaces(rface, cface, 0);
+            SDLTest_AssertCheck(ret == 0, "Validate result from SDLTest_CompareSurfaces, expected: 0, got: %i", ret);
+        }
+        SDL_FreeSurface(rface);
+        SDL_FreeSurface(cface);
+    }
+
+    /* Indexed formats can't be converted to */
+    rface = SDL_LoadBMPFormat(sampleFilename, SDL_PIXELFORMAT_INDEX8);
+    SDLTest_AssertPass("Call to SDL_LoadBMPFormat(SDL_PIXELFORMAT_INDEX8)");
+    SDLTest_AssertCheck(rface == NULL, "Verify result from SDL_LoadBMPFormat is NULL");
+
+    unlink(sampleFilename);
+    SDL_FreeSurface(face);
+
+    return TEST_COMPLETED;
+}
+
 /* !
  *  Tests surface conversion.
  */
@@ -581,6 +644,289 @@ surface_testBlitBlendLoop(void *arg) {
 
 }
 
+/* Blit a flat gray between two levels of a 6x6x6 color cube onto a palette */
+static SDL_Surface *
+_blitGrayToCube(const char *dither)
+{
+    SDL_Surface *src, *dst;
+    SDL_Color colors[256];
+    int i;
+
+    if (!SDL_SetHint(SDL_HINT_PALETTE_DITHER, dither)) {
+        return NULL;
+    }
+    src = SDL_CreateRGBSurface(0, 16, 16, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0);
+    dst = SDL_CreateRGBSurface(0, 16, 16, 8, 0, 0, 0, 0);
+    if (src == NULL || dst == NULL) {
+        SDL_FreeSurface(src);
+        SDL_FreeSurface(dst);
+        return NULL;
+    }
+    for (i = 0; i < 216; ++i) {
+        colors[i].r = (Uint8) ((i / 36) * 51);
+        colors[i].g = (Uint8) (((i / 6) % 6) * 51);
+        colors[i].b = (Uint8) ((i % 6) * 51);
+        colors[i].a = SDL_ALPHA_OPAQUE;
+    }
+    for (; i < 256; ++i) {
+        colors[i] = colors[0];
+    }
+    SDL_SetPaletteColors(dst->format->palette, colors, 0, 256);
+    SDL_FillRect(src, NULL, SDL_MapRGB(src->format, 128, 128, 128));
+    SDL_BlitSurface(src, NULL, dst, NULL);
+    SDL_FreeSurface(src);
+    return dst;
+}
+
+/**
+ * @brief Tests blitting onto a palette with and without SDL_HINT_PALETTE_DITHER.
+ */
+int
+surface_testPaletteDither(void *arg)
+{
+    const Uint8 dark = 2 * 36 + 2 * 6 + 2;      /* Gray 102 in the cube */
+    const Uint8 light = 3 * 36 + 3 * 6 + 3;     /* Gray 153 in the cube */
+    SDL_Surface *surface;
+    const Uint8 *pixels;
+    int x, y, others, darks, lights, same;
+
+    /* Without dithering every pixel gets the same nearest color */
+    surface = _blitGrayToCube("0");
+    SDLTest_AssertCheck(surface != NULL, "Verify undithered blit was done");
+    if (surface == NULL) {
+        return TEST_ABORTED;
+    }
+    pixels = (const Uint8 *) surface->pixels;
+    same = 1;
+    for (y = 0; y < surface->h; ++y) {
+        for (x = 0; x < surface->w; ++x) {
+            same &= (pixels[y * surface->pitch + x] == pixels[0]);
+        }
+    }
+    SDLTest_AssertCheck(same, "Verify undithered pixels are all the same");
+    SDLTest_AssertCheck(pixels[0] == dark || pixels[0] == light, "Verify undithered pixel is a neighboring gray, got: %d", pixels[0]);
+    SDL_FreeSurface(surface);
+
+    /* With dithering the two neighboring grays are mixed */
+    surface = _blitGrayToCube("1");
+    SDLTest_AssertCheck(surface != NULL, "Verify dithered blit was done");
+    if (surface == NULL) {
+        SDL_SetHint(SDL_HINT_PALETTE_DITHER, "0");
+        return TEST_ABORTED;
+    }
+    pixels = (const Uint8 *) surface->pixels;
+    darks = lights = others = 0;
+    for (y = 0; y < surface->h; ++y) {
+        for (x = 0; x < surface->w; ++x) {
+            const Uint8 pixel = pixels[y * surface->pitch + x];
+            if (pixel == dark) {
+                ++darks;
+            } else if (pixel == light) {
+                ++lights;
+            } else {
+                ++others;
+            }
+        }
+    }
+    SDLTest_AssertCheck(others == 0, "Verify dithered pixels are neighboring grays, expected: 0 others, got: %d", others);
+    SDLTest_AssertCheck(darks > 0 && lights > 0, "Verify both grays were used, got: %d dark and %d light", darks, lights);
+    SDLTest_AssertCheck(SDL_abs(darks - lights) <= 64, "Verify the mix averages out near the source, got: %d dark and %d light", darks, lights);
+    SDL_FreeSurface(surface);
+
+    SDL_SetHint(SDL_HINT_PALETTE_DITHER, "0");
+
+    return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests that blitting to alternating surfaces reuses the cached blit setup.
+ */
+int
+surface_testBlitCache(void *arg)
+{
+    SDL_Surface *face, *target1, *target2, *compare1, *compare2;
+    SDL_BlitCacheStats before, after;
+    SDL_Color colors[2];
+    int i, ret;
+
+    face = SDL_CreateRGBSurface(0, 8, 8, 8, 0, 0, 0, 0);
+    target1 = SDL_CreateRGBSurface(0, 8, 8, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0);
+    target2 = SDL_CreateRGBSurface(0, 8, 8, 16, 0xF800, 0x07E0, 0x001F, 0);
+    SDLTest_AssertCheck(face && target1 && target2, "Verify surfaces are not NULL");
+    if (!face || !target1 || !target2) {
+        SDL_FreeSurface(face);
+        SDL_FreeSurface(target1);
+        SDL_FreeSurface(target2);
+        return TEST_ABORTED;
+    }
+    colors[0].r = 255; colors[0].g = 0; colors[0].b = 0; colors[0].a = 255;
+    colors[1].r = 0; colors[1].g = 0; colors[1].b = 255; colors[1].a = 255;
+    SDL_SetPaletteColors(face->format->palette, colors, 0, 2);
+    for (i = 0; i < 64; ++i) {
+        ((Uint8 *) face->pixels)[(i / 8) * face->pitch + (i % 8)] = (Uint8) (i & 1);
+    }
+    compare1 = SDL_ConvertSurface(face, target1->format, 0);
+    compare2 = SDL_ConvertSurface(face, target2->format, 0);
+
+    /* Each switch of target sets the blit up again */
+    SDL_BlitSurface(face, NULL, target1, NULL);
+    SDL_BlitSurface(face, NULL, target2, NULL);
+    ret = SDL_GetBlitCacheStats(&before);
+    SDLTest_AssertCheck(ret == 0, "Verify result from SDL_GetBlitCacheStats, expected: 0, got: %i", ret);
+    for (i = 0; i < 10; ++i) {
+        SDL_BlitSurface(face, NULL, target1, NULL);
+        SDL_BlitSurface(face, NULL, target2, NULL);
+    }
+    SDL_GetBlitCacheStats(&after);
+    SDLTest_AssertCheck(after.hits - before.hits >= 20, "Verify blit functions were cached, expected: >= 20, got: %u", after.hits - before.hits);
+    SDLTest_AssertCheck(after.table_hits - before.table_hits >= 20, "Verify lookup tables were cached, expected: >= 20, got: %u", after.table_hits - before.table_hits);
+
+    ret = SDLTest_CompareSurfaces(target1, compare1, 0);
+    SDLTest_AssertCheck(ret == 0, "Validate result from SDLTest_CompareSurfaces, expected: 0, got: %i", ret);
+    ret = SDLTest_CompareSurfaces(target2, compare2, 0);
+    SDLTest_AssertCheck(ret == 0, "Validate result from SDLTest_CompareSurfaces, expected: 0, got: %i", ret);
+
+    /* Changing the palette must not reuse the old lookup table */
+    colors[1].r = 0; colors[1].g = 255; colors[1].b = 0;
+    SDL_SetPaletteColors(face->format->palette, colors, 0, 2);
+    SDL_BlitSurface(face, NULL, target1, NULL);
+    SDLTest_AssertCheck(*(Uint32 *) ((Uint8 *) target1->pixels + 1 * 4) == 0x0000FF00,
+                        "Verify changed palette color was blitted, expected: 0x0000FF00, got: 0x%08x",
+                        *(Uint32 *) ((Uint8 *) target1->pixels + 1 * 4));
+
+    SDLTest_AssertCheck(SDL_GetBlitCacheStats(NULL) < 0, "Verify SDL_GetBlitCacheStats(NULL) fails");
+
+    SDL_FreeSurface(compare1);
+    SDL_FreeSurface(compare2);
+    SDL_FreeSurface(face);
+    SDL_FreeSurface(target1);
+    SDL_FreeSurface(target2);
+
+    return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests keeping pixels of RLE encoded surfaces and clipped RLE blits.
+ */
+int
+surface_testRLEPixels(void *arg)
+{
+    SDL_Surface *face, *target1, *target2;
+    SDL_Rect srcrect, dstrect;
+    Uint32 *pixels;
+    int x, y, ret;
+
+    face = SDL_CreateRGBSurface(0, 32, 32, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0);
+    target1 = SDL_CreateRGBSurface(0, 32, 32, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0);
+    target2 = SDL_CreateRGBSurface(0, 32, 32, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0);
+    SDLTest_AssertCheck(face && target1 && target2, "Verify surfaces are not NULL");
+    if (!face || !target1 || !target2) {
+        SDL_FreeSurface(face);
+        SDL_FreeSurface(target1);
+        SDL_FreeSurface(target2);
+        return TEST_ABORTED;
+    }
+    for (y = 0; y < 32; ++y) {
+        pixels = (Uint32 *) ((Uint8 *) face->pixels + y * face->pitch);
+        for (x = 0; x < 32; ++x) {
+            pixels[x] = ((x + y) % 5 == 0) ? 0x00FF00FF : (Uint32) (x * 8 << 16 | y * 8);
+        }
+    }
+
+    /* Blit without RLE encoding first to have something to compare to */
+    SDL_SetColorKey(face, SDL_TRUE, 0x00FF00FF);
+    srcrect.x = 3; srcrect.y = 11; srcrect.w = 20; srcrect.h = 17;
+    dstrect.x = 5; dstrect.y = 2;
+    SDL_BlitSurface(face, &srcrect, target1, &dstrect);
+
+    SDL_SetSurfaceRLE(face, 1);
+    ret = SDL_BlitSurface(face, &srcrect, target2, &dstrect);
+    SDLTest_AssertCheck(ret == 0, "Verify result from SDL_BlitSurface, expected: 0, got: %i", ret);
+    SDLTest_AssertCheck((face->flags & SDL_RLEACCEL) != 0, "Verify surface is RLE encoded");
+    ret = SDLTest_CompareSurfaces(target2, target1, 0);
+    SDLTest_AssertCheck(ret == 0, "Validate result from SDLTest_CompareSurfaces, expected: 0, got: %i", ret);
+
+    /* The pixels are still there while the surface is encoded */
+    SDLTest_AssertCheck(face->pixels != NULL, "Verify pixels of RLE encoded surface are not NULL");
+    pixels = (Uint32 *) ((Uint8 *) face->pixels + 7 * face->pitch);
+    SDLTest_AssertCheck(pixels[9] == (9 * 8 << 16 | 7 * 8),
+                        "Verify pixel of RLE encoded surface, expected: 0x%08x, got: 0x%08x",
+                        9 * 8 << 16 | 7 * 8, pixels[9]);
+
+    /* Changing the pixels must be picked up by the next blit */
+    SDL_LockSurface(face);
+    pixels = (Uint32 *) ((Uint8 *) face->pixels + 20 * face->pitch);
+    pixels[10] = 0x00123456;
+    SDL_UnlockSurface(face);
+    SDL_FillRect(target2, NULL, 0);
+    SDL_BlitSurface(face, &srcrect, target2, &dstrect);
+    pixels = (Uint32 *) ((Uint8 *) target2->pixels + (20 - 11 + 2) * target2->pitch);
+    SDLTest_AssertCheck(pixels[10 - 3 + 5] == 0x00123456,
+                        "Verify changed pixel was blitted, expected: 0x00123456, got: 0x%08x",
+                        pixels[10 - 3 + 5]);
+
+    SDL_FreeSurface(face);
+    SDL_FreeSurface(target1);
+    SDL_FreeSurface(target2);
+
+    return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests reusing the pixels of freed surfaces.
+ */
+int
+surface_testSurfacePool(void *arg)
+{
+    SDL_Surface *surface;
+    SDL_SurfacePoolStats before, after;
+    Uint8 *pixels;
+    int i, ret, dirty;
+
+    /* Make sure the pool has room */
+    SDL_FlushSurfacePool();
+
+    surface = SDL_CreateRGBSurface(0, 100, 50, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0);
+    SDLTest_AssertCheck(surface != NULL, "Verify surface is not NULL");
+    if (surface == NULL) {
+        return TEST_ABORTED;
+    }
+    SDLTest_AssertCheck((((size_t) surface->pixels) & 63) == 0, "Verify new pixels are aligned to 64 bytes");
+    SDL_memset(surface->pixels, 0xAA, surface->h * surface->pitch);
+    SDL_FreeSurface(surface);
+
+    ret = SDL_GetSurfacePoolStats(&before);
+    SDLTest_AssertCheck(ret == 0, "Verify result from SDL_GetSurfacePoolStats, expected: 0, got: %i", ret);
+    SDLTest_AssertCheck(before.free_buffers >= 1, "Verify freed pixels were kept, expected: >= 1, got: %u", before.free_buffers);
+
+    surface = SDL_CreateRGBSurface(0, 100, 50, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0);
+    SDLTest_AssertCheck(surface != NULL, "Verify surface is not NULL");
+    if (surface == NULL) {
+        return TEST_ABORTED;
+    }
+    SDL_GetSurfacePoolStats(&after);
+    SDLTest_AssertCheck(after.hits - before.hits == 1, "Verify pixels were reused, expected: 1, got: %u", after.hits - before.hits);
+
+    /* Reused pixels are cleared, and aligned */
+    pixels = (Uint8 *) surface->pixels;
+    dirty = 0;
+    for (i = 0; i < surface->h * surface->pitch; ++i) {
+        dirty |= pixels[i];
+    }
+    SDLTest_AssertCheck(dirty == 0, "Verify reused pixels are cleared");
+    SDLTest_AssertCheck((((size_t) surface->pixels) & 63) == 0, "Verify pixels are aligned to 64 bytes");
+    SDL_FreeSurface(surface);
+
+    SDL_FlushSurfacePool();
+    SDL_GetSurfacePoolStats(&after);
+    SDLTest_AssertCheck(after.free_buffers == 0, "Verify pool was flushed, expected: 0, got: %u", after.free_buffers);
+    SDLTest_AssertCheck(after.free_bytes == 0, "Verify pool memory was freed");
+
+    SDLTest_AssertCheck(SDL_GetSurfacePoolStats(NULL) < 0, "Verify SDL_GetSurfacePoolStats(NULL) fails");
+
+    return TEST_COMPLETED;
+}
+
 /* ================= Test References ================== */
 
 /* Surface test cases */
@@ -623,11 +969,27 @@ static const SDLTest_TestCaseReference surfaceTest11 =
 static const SDLTest_TestCaseReference surfaceTest12 =
         { (SDLTest_TestCaseFp)surface_testBlitBlendMod, "surface_testBlitBlendMod", "Tests blitting routines with mod blending mode.", TEST_ENABLED};
 
+static const SDLTest_TestCaseReference surfaceTest13 =
+        { (SDLTest_TestCaseFp)surface_testLoadBitmapFormat, "surface_testLoadBitmapFormat", "Tests loading a bitmap into another pixel format.", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTest14 =
+        { (SDLTest_TestCaseFp)surface_testPaletteDither, "surface_testPaletteDither", "Tests blitting onto a palette with SDL_HINT_PALETTE_DITHER.", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTest15 =
+        { (SDLTest_TestCaseFp)surface_testBlitCache, "surface_testBlitCache", "Tests reusing the blit setup between surfaces.", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTest16 =
+        { (SDLTest_TestCaseFp)surface_testRLEPixels, "surface_testRLEPixels", "Tests keeping the pixels of RLE encoded surfaces.", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTest17 =
+        { (SDLTest_TestCaseFp)surface_testSurfacePool, "surface_testSurfacePool", "Tests reusing the pixels of freed surfaces.", TEST_ENABLED};
+
 /* Sequence of Surface test cases */
 static const SDLTest_TestCaseReference *surfaceTests[] =  {
     &surfaceTest1, &surfaceTest2, &surfaceTest3, &surfaceTest4, &surfaceTest5,
     &surfaceTest6, &surfaceTest7, &surfaceTest8, &surfaceTest9, &surfaceTest10,
-    &surfaceTest11, &surfaceTest12, NULL
+    &surfaceTest11, &surfaceTest12, &surfaceTest13, &surfaceTest14, &surfaceTest15,
+    &surfaceTest16, &surfaceTest17, NULL
 };
 
 /* Surface test suite (global) */
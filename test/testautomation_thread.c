@@ -0,0 +1,312 @@
+/**
+ * Thread test suite
+ */
+
+#include <stdio.h>
+
+#include "SDL.h"
+#include "SDL_test.h"
+
+/* Test case functions */
+
+#define RWLOCK_READERS      4
+#define RWLOCK_WRITERS      2
+#define RWLOCK_ITERATIONS   50
+
+/* Shared state for thread_rwlockExclusion; writers keep both values equal */
+static SDL_rwlock *_rwlock;
+static int _rwlockFirst;
+static int _rwlockSecond;
+static SDL_atomic_t _rwlockReaders;
+static SDL_atomic_t _rwlockWriters;
+static SDL_atomic_t _rwlockErrors;
+
+static int
+_rwlockReader(void *arg)
+{
+  int i;
+
+  for (i = 0; i < RWLOCK_ITERATIONS; ++i) {
+    if (SDL_LockRWLockForReading(_rwlock) < 0) {
+      SDL_AtomicIncRef(&_rwlockErrors);
+      continue;
+    }
+    SDL_AtomicIncRef(&_rwlockReaders);
+    if (SDL_AtomicGet(&_rwlockWriters) != 0 || _rwlockFirst != _rwlockSecond) {
+      SDL_AtomicIncRef(&_rwlockErrors);
+    }
+    SDL_Delay(1);
+    SDL_AtomicAdd(&_rwlockReaders, -1);
+    SDL_UnlockRWLock(_rwlock);
+  }
+  return 0;
+}
+
+static int
+_rwlockWriter(void *arg)
+{
+  int i;
+
+  for (i = 0; i < RWLOCK_ITERATIONS; ++i) {
+    if (SDL_LockRWLockForWriting(_rwlock) < 0) {
+      SDL_AtomicIncRef(&_rwlockErrors);
+      continue;
+    }
+    if (SDL_AtomicIncRef(&_rwlockWriters) != 0 || SDL_AtomicGet(&_rwlockReaders) != 0) {
+      SDL_AtomicIncRef(&_rwlockErrors);
+    }
+    ++_rwlockFirst;
+    SDL_Delay(1);
+    ++_rwlockSecond;
+    SDL_AtomicAdd(&_rwlockWriters, -1);
+    SDL_UnlockRWLock(_rwlock);
+  }
+  return 0;
+}
+
+static int
+_rwlockTryWrite(void *arg)
+{
+  return SDL_TryLockRWLockForWriting(_rwlock);
+}
+
+/**
+ * @brief Check that writers exclude readers and each other
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_CreateRWLock
+ * http://wiki.libsdl.org/moin.cgi/SDL_LockRWLockForReading
+ * http://wiki.libsdl.org/moin.cgi/SDL_LockRWLockForWriting
+ * http://wiki.libsdl.org/moin.cgi/SDL_TryLockRWLockForWriting
+ */
+int
+thread_rwlockExclusion(void *arg)
+{
+  SDL_Thread *threads[RWLOCK_READERS + RWLOCK_WRITERS];
+  SDL_Thread *thread;
+  int i, result;
+
+  _rwlock = SDL_CreateRWLock();
+  SDLTest_AssertPass("Call to SDL_CreateRWLock()");
+  SDLTest_AssertCheck(_rwlock != NULL, "Check result value, expected: not NULL");
+  if (_rwlock == NULL) {
+    return TEST_ABORTED;
+  }
+
+  /* A writer can't get in while a reader holds the lock */
+  result = SDL_LockRWLockForReading(_rwlock);
+  SDLTest_AssertCheck(result == 0, "Check SDL_LockRWLockForReading() result, expected: 0, got: %d", result);
+  result = SDL_TryLockRWLockForReading(_rwlock);
+  SDLTest_AssertCheck(result == 0, "Check SDL_TryLockRWLockForReading() result with another reader, expected: 0, got: %d", result);
+  if (result == 0) {
+    SDL_UnlockRWLock(_rwlock);
+  }
+  thread = SDL_CreateThread(_rwlockTryWrite, "RWLockTryWrite", NULL);
+  SDLTest_AssertCheck(thread != NULL, "Check thread was created");
+  if (thread) {
+    SDL_WaitThread(thread, &result);
+    SDLTest_AssertCheck(result == SDL_MUTEX_TIMEDOUT, "Check SDL_TryLockRWLockForWriting() result while read locked, expected: %d, got: %d", SDL_MUTEX_TIMEDOUT, result);
+  }
+  SDL_UnlockRWLock(_rwlock);
+
+  /* Nor can a reader while a writer holds it */
+  result = SDL_LockRWLockForWriting(_rwlock);
+  SDLTest_AssertCheck(result == 0, "Check SDL_LockRWLockForWriting() result, expected: 0, got: %d", result);
+  thread = SDL_CreateThread(_rwlockTryWrite, "RWLockTryWrite", NULL);
+  if (thread) {
+    SDL_WaitThread(thread, &result);
+    SDLTest_AssertCheck(result == SDL_MUTEX_TIMEDOUT, "Check SDL_TryLockRWLockForWriting() result while write locked, expected: %d, got: %d", SDL_MUTEX_TIMEDOUT, result);
+  }
+  SDL_UnlockRWLock(_rwlock);
+
+  /* Readers and writers contending for the lock */
+  _rwlockFirst = _rwlockSecond = 0;
+  SDL_AtomicSet(&_rwlockReaders, 0);
+  SDL_AtomicSet(&_rwlockWriters, 0);
+  SDL_AtomicSet(&_rwlockErrors, 0);
+  for (i = 0; i < SDL_arraysize(threads); ++i) {
+    if (i < RWLOCK_WRITERS) {
+      threads[i] = SDL_CreateThread(_rwlockWriter, "RWLockWriter", NULL);
+    } else {
+      threads[i] = SDL_CreateThread(_rwlockReader, "RWLockReader", NULL);
+    }
+    SDLTest_AssertCheck(threads[i] != NULL, "Check thread %d was created", i);
+  }
+  for (i = 0; i < SDL_arraysize(threads); ++i) {
+    if (threads[i]) {
+      SDL_WaitThread(threads[i], NULL);
+    }
+  }
+  SDLTest_AssertPass("Joined reader and writer threads");
+  SDLTest_AssertCheck(SDL_AtomicGet(&_rwlockErrors) == 0, "Check no reader saw a writer and no writer saw anyone else, expected: 0, got: %d", SDL_AtomicGet(&_rwlockErrors));
+  SDLTest_AssertCheck(_rwlockFirst == RWLOCK_WRITERS * RWLOCK_ITERATIONS, "Check every write happened, expected: %d, got: %d", RWLOCK_WRITERS * RWLOCK_ITERATIONS, _rwlockFirst);
+  SDLTest_AssertCheck(_rwlockFirst == _rwlockSecond, "Check writes weren't torn, expected: %d, got: %d", _rwlockFirst, _rwlockSecond);
+
+  SDL_DestroyRWLock(_rwlock);
+  _rwlock = NULL;
+
+  return TEST_COMPLETED;
+}
+
+/* Holds _affinityThread until thread_affinity is done with it */
+static SDL_sem *_affinitySem;
+
+static int
+_affinityThread(void *arg)
+{
+  SDL_SemWait(_affinitySem);
+  return 0;
+}
+
+/* Returns the lowest core in the mask, so the test works on any machine */
+static Uint64
+_lowestCore(Uint64 mask)
+{
+  return mask & (~mask + 1);
+}
+
+/**
+ * @brief Call to SDL_SetThreadAffinity and SDL_GetThreadAffinity
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_SetThreadAffinity
+ * http://wiki.libsdl.org/moin.cgi/SDL_GetThreadAffinity
+ */
+int
+thread_affinity(void *arg)
+{
+  SDL_Thread *thread;
+  Uint64 original, mask;
+  int result;
+
+  result = SDL_GetThreadAffinity(NULL, &original);
+  SDLTest_AssertPass("Call to SDL_GetThreadAffinity(NULL, ...)");
+  if (result < 0) {
+    SDLTest_Log("Thread affinity isn't supported on this platform: %s", SDL_GetError());
+    return TEST_SKIPPED;
+  }
+  SDLTest_AssertCheck(original != 0, "Check current thread may run somewhere, got mask: 0x%llx", (unsigned long long)original);
+
+  /* The current thread */
+  result = SDL_SetThreadAffinity(NULL, _lowestCore(original));
+  SDLTest_AssertCheck(result == 0, "Check SDL_SetThreadAffinity(NULL, ...) result, expected: 0, got: %d", result);
+  mask = 0;
+  SDL_GetThreadAffinity(NULL, &mask);
+  SDLTest_AssertCheck(mask == _lowestCore(original), "Check mask read back, expected: 0x%llx, got: 0x%llx", (unsigned long long)_lowestCore(original), (unsigned long long)mask);
+  result = SDL_SetThreadAffinity(NULL, original);
+  SDLTest_AssertCheck(result == 0, "Check restoring the original mask, expected: 0, got: %d", result);
+  mask = 0;
+  SDL_GetThreadAffinity(NULL, &mask);
+  SDLTest_AssertCheck(mask == original, "Check original mask read back, expected: 0x%llx, got: 0x%llx", (unsigned long long)original, (unsigned long long)mask);
+
+  /* Another thread */
+  _affinitySem = SDL_CreateSemaphore(0);
+  thread = SDL_CreateThread(_affinityThread, "AffinityThread", NULL);
+  SDLTest_AssertCheck(thread != NULL, "Check thread was created");
+  if (thread) {
+    /* Some platforms can only pin the current thread */
+    mask = 0;
+    result = SDL_SetThreadAffinity(thread, _lowestCore(original));
+    if (result == 0) {
+      result = SDL_GetThreadAffinity(thread, &mask);
+    }
+    if (result < 0) {
+      SDLTest_Log("Another thread's affinity isn't supported on this platform: %s", SDL_GetError());
+    } else {
+      SDLTest_AssertCheck(mask == _lowestCore(original), "Check mask read back from thread, expected: 0x%llx, got: 0x%llx", (unsigned long long)_lowestCore(original), (unsigned long long)mask);
+    }
+    SDL_SemPost(_affinitySem);
+    SDL_WaitThread(thread, NULL);
+  }
+  SDL_DestroySemaphore(_affinitySem);
+  _affinitySem = NULL;
+
+  /* Negative case */
+  result = SDL_GetThreadAffinity(NULL, NULL);
+  SDLTest_AssertCheck(result == -1, "Check SDL_GetThreadAffinity(NULL, NULL) result, expected: -1, got: %d", result);
+
+  return TEST_COMPLETED;
+}
+
+/* What the TLS destructor was called with in thread_tlsDestructor */
+static SDL_TLSID _tlsID;
+static SDL_atomic_t _tlsDestructorCalls;
+static void *_tlsDestructorValue;
+
+static void
+_tlsDestructor(void *value)
+{
+  SDL_AtomicIncRef(&_tlsDestructorCalls);
+  _tlsDestructorValue = value;
+}
+
+static int
+_tlsThread(void *arg)
+{
+  if (SDL_TLSSet(_tlsID, arg, _tlsDestructor) < 0) {
+    return -1;
+  }
+  return (SDL_TLSGet(_tlsID) == arg) ? 0 : -1;
+}
+
+/**
+ * @brief Check that TLS destructors run with the thread's value when it exits
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_TLSCreate
+ * http://wiki.libsdl.org/moin.cgi/SDL_TLSSet
+ * http://wiki.libsdl.org/moin.cgi/SDL_TLSGet
+ */
+int
+thread_tlsDestructor(void *arg)
+{
+  static int value;
+  SDL_Thread *thread;
+  int result = -1;
+
+  _tlsID = SDL_TLSCreate();
+  SDLTest_AssertPass("Call to SDL_TLSCreate()");
+  SDLTest_AssertCheck(_tlsID != 0, "Check result value, expected: not 0, got: %u", _tlsID);
+
+  SDL_AtomicSet(&_tlsDestructorCalls, 0);
+  _tlsDestructorValue = NULL;
+  thread = SDL_CreateThread(_tlsThread, "TLSThread", &value);
+  SDLTest_AssertCheck(thread != NULL, "Check thread was created");
+  if (thread == NULL) {
+    return TEST_ABORTED;
+  }
+  SDL_WaitThread(thread, &result);
+  SDLTest_AssertCheck(result == 0, "Check thread read back its own value, expected: 0, got: %d", result);
+  SDLTest_AssertCheck(SDL_AtomicGet(&_tlsDestructorCalls) == 1, "Check destructor calls, expected: 1, got: %d", SDL_AtomicGet(&_tlsDestructorCalls));
+  SDLTest_AssertCheck(_tlsDestructorValue == &value, "Check destructor was called with the thread's value");
+
+  /* The value belonged to the other thread */
+  SDLTest_AssertCheck(SDL_TLSGet(_tlsID) == NULL, "Check value isn't visible from this thread");
+
+  return TEST_COMPLETED;
+}
+
+/* ================= Test References ================== */
+
+/* Thread test cases */
+static const SDLTest_TestCaseReference threadTest1 =
+        { (SDLTest_TestCaseFp)thread_rwlockExclusion, "thread_rwlockExclusion", "Check read/write lock exclusion", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference threadTest2 =
+        { (SDLTest_TestCaseFp)thread_affinity, "thread_affinity", "Call to SDL_SetThreadAffinity and SDL_GetThreadAffinity", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference threadTest3 =
+        { (SDLTest_TestCaseFp)thread_tlsDestructor, "thread_tlsDestructor", "Check TLS destructors run when a thread exits", TEST_ENABLED };
+
+/* Sequence of Thread test cases */
+static const SDLTest_TestCaseReference *threadTests[] =  {
+    &threadTest1, &threadTest2, &threadTest3, NULL
+};
+
+/* Thread test suite (global) */
+SDLTest_TestSuiteReference threadTestSuite = {
+    "Thread",
+    NULL,
+    threadTests,
+    NULL
+};
@@ -1723,6 +1723,125 @@ video_getSetWindowData(void *arg)
 }
 
 
+/**
+ * @brief Tests the window surface back buffers
+ *
+ * @sa SDL_SetWindowSurfaceBuffers
+ * @sa SDL_AcquireWindowSurface
+ * @sa SDL_PresentWindowSurface
+ * @sa SDL_GetWindowSurfaceStats
+ */
+int
+video_windowSurfaceBuffers(void *arg)
+{
+  const char* title = "video_windowSurfaceBuffers Test Window";
+  const int frames = 20;
+  SDL_Window* window;
+  SDL_Surface *surface;
+  SDL_Surface *again;
+  SDL_WindowSurfaceStats stats;
+  SDL_Rect rect;
+  Uint32 pixel;
+  int num_buffers;
+  int result;
+  int i;
+
+  /* Invalid input */
+  result = SDL_SetWindowSurfaceBuffers(NULL, 2, 0);
+  SDLTest_AssertPass("Call to SDL_SetWindowSurfaceBuffers(window=NULL)");
+  SDLTest_AssertCheck(result == -1, "Validate result value; expected: -1, got: %d", result);
+  surface = SDL_AcquireWindowSurface(NULL);
+  SDLTest_AssertPass("Call to SDL_AcquireWindowSurface(window=NULL)");
+  SDLTest_AssertCheck(surface == NULL, "Validate that result is NULL");
+
+  window = _createVideoSuiteTestWindow(title);
+  if (window == NULL) return TEST_ABORTED;
+
+  if (SDL_GetWindowSurface(window) == NULL) {
+    SDLTest_Log("Window surface not supported by the video driver, skipping: %s", SDL_GetError());
+    _destroyVideoSuiteTestWindow(window);
+    return TEST_SKIPPED;
+  }
+
+  result = SDL_SetWindowSurfaceBuffers(window, 1, 0);
+  SDLTest_AssertPass("Call to SDL_SetWindowSurfaceBuffers(num_buffers=1)");
+  SDLTest_AssertCheck(result == -1, "Validate result value; expected: -1, got: %d", result);
+  surface = SDL_AcquireWindowSurface(window);
+  SDLTest_AssertPass("Call to SDL_AcquireWindowSurface() without buffers");
+  SDLTest_AssertCheck(surface == NULL, "Validate that result is NULL");
+
+  for (num_buffers = 2; num_buffers <= 3; ++num_buffers) {
+    result = SDL_SetWindowSurfaceBuffers(window, num_buffers, 0);
+    SDLTest_AssertPass("Call to SDL_SetWindowSurfaceBuffers(num_buffers=%d)", num_buffers);
+    SDLTest_AssertCheck(result == 0, "Validate result value; expected: 0, got: %d", result);
+
+    result = SDL_PresentWindowSurface(window, NULL, 0);
+    SDLTest_AssertPass("Call to SDL_PresentWindowSurface() before acquiring");
+    SDLTest_AssertCheck(result == -1, "Validate result value; expected: -1, got: %d", result);
+
+    /* Draw a run of solid frames, the last one should end up on the screen */
+    pixel = 0;
+    for (i = 0; i < frames; ++i) {
+      surface = SDL_AcquireWindowSurface(window);
+      if (surface == NULL) break;
+      again = SDL_AcquireWindowSurface(window);
+      if (again != surface) break;
+
+      pixel = SDL_MapRGB(surface->format, (Uint8)(i * 12), 0x40, 0xFF - i);
+      if (i % 2) {
+        SDL_FillRect(surface, NULL, pixel);
+        result = SDL_PresentWindowSurface(window, NULL, 0);
+      } else {
+        rect.x = 0;
+        rect.y = 0;
+        rect.w = surface->w;
+        rect.h = surface->h;
+        SDL_FillRect(surface, &rect, pixel);
+        result = SDL_PresentWindowSurface(window, &rect, 1);
+      }
+      if (result != 0) break;
+    }
+    SDLTest_AssertCheck(i == frames, "Validate that %d frames were acquired and presented, got: %d", frames, i);
+
+    result = SDL_GetWindowSurfaceStats(window, &stats);
+    SDLTest_AssertPass("Call to SDL_GetWindowSurfaceStats()");
+    SDLTest_AssertCheck(result == 0, "Validate result value; expected: 0, got: %d", result);
+    SDLTest_AssertCheck((int)(stats.frames_presented + stats.frames_dropped) <= frames &&
+                        (int)(stats.frames_presented + stats.frames_dropped) >= frames - num_buffers,
+                        "Validate frame counts; presented: %d, dropped: %d",
+                        (int)stats.frames_presented, (int)stats.frames_dropped);
+
+    /* Turning the buffers off shows the last frame */
+    result = SDL_SetWindowSurfaceBuffers(window, 0, 0);
+    SDLTest_AssertPass("Call to SDL_SetWindowSurfaceBuffers(num_buffers=0)");
+    SDLTest_AssertCheck(result == 0, "Validate result value; expected: 0, got: %d", result);
+    surface = SDL_GetWindowSurface(window);
+    SDLTest_AssertCheck(surface != NULL, "Validate that the window surface is not NULL");
+    if (surface != NULL) {
+      Uint32 shown = 0;
+      SDL_memcpy(&shown, surface->pixels, surface->format->BytesPerPixel);
+      SDLTest_AssertCheck(shown == pixel, "Validate the last frame is shown; expected: 0x%.8x, got: 0x%.8x", pixel, shown);
+    }
+  }
+
+  /* Back buffers follow the window size */
+  result = SDL_SetWindowSurfaceBuffers(window, 2, 1);
+  SDLTest_AssertCheck(result == 0, "Validate result value; expected: 0, got: %d", result);
+  SDL_SetWindowSize(window, 200, 150);
+  SDLTest_AssertPass("Call to SDL_SetWindowSize(200, 150)");
+  surface = SDL_AcquireWindowSurface(window);
+  SDLTest_AssertPass("Call to SDL_AcquireWindowSurface() after resizing");
+  SDLTest_AssertCheck(surface != NULL && surface->w == 200 && surface->h == 150, "Validate back buffer size is 200x150");
+  result = SDL_PresentWindowSurface(window, NULL, 0);
+  SDLTest_AssertCheck(result == 0, "Validate result value; expected: 0, got: %d", result);
+
+  /* Destroying the window cleans up the buffers */
+  _destroyVideoSuiteTestWindow(window);
+
+  return TEST_COMPLETED;
+}
+
+
 /* ================= Test References ================== */
 
 /* Video test cases */
@@ -1795,13 +1914,16 @@ static const SDLTest_TestCaseReference videoTest22 =
 static const SDLTest_TestCaseReference videoTest23 =
         { (SDLTest_TestCaseFp)video_getSetWindowData, "video_getSetWindowData",  "Checks SDL_SetWindowData and SDL_GetWindowData positive and negative cases", TEST_ENABLED };
 
+static const SDLTest_TestCaseReference videoTest24 =
+        { (SDLTest_TestCaseFp)video_windowSurfaceBuffers, "video_windowSurfaceBuffers",  "Checks window surface back buffers and frame statistics", TEST_ENABLED };
+
 /* Sequence of Video test cases */
 static const SDLTest_TestCaseReference *videoTests[] =  {
     &videoTest1, &videoTest2, &videoTest3, &videoTest4, &videoTest5, &videoTest6,
     &videoTest7, &videoTest8, &videoTest9, &videoTest10, &videoTest11, &videoTest12,
     &videoTest13, &videoTest14, &videoTest15, &videoTest16, &videoTest17,
     &videoTest18, &videoTest19, &videoTest20, &videoTest21, &videoTest22,
-    &videoTest23, NULL
+    &videoTest23, &videoTest24, NULL
 };
 
 /* Video test suite (global) */
@@ -0,0 +1,159 @@
+/*
+  Copyright (C) 1997-2013 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Benchmark for blended rectangles and lines in the software renderer */
+
+#include <stdlib.h>
+
+#include "SDL.h"
+
+#define WIDTH       640
+#define HEIGHT      480
+#define NUM_SHAPES  100000
+
+static SDL_Rect rects[NUM_SHAPES];
+static SDL_Point lines[NUM_SHAPES][2];
+
+static const char *
+BlendModeName(SDL_BlendMode blendMode)
+{
+    switch (blendMode) {
+    case SDL_BLENDMODE_NONE:
+        return "none";
+    case SDL_BLENDMODE_BLEND:
+        return "blend";
+    case SDL_BLENDMODE_ADD:
+        return "add";
+    case SDL_BLENDMODE_MOD:
+        return "mod";
+    default:
+        return "unknown";
+    }
+}
+
+static double
+Seconds(Uint64 start, Uint64 end)
+{
+    return (double)(end - start) / SDL_GetPerformanceFrequency();
+}
+
+static void
+RunTest(Uint32 format, SDL_BlendMode blendMode)
+{
+    SDL_Surface *surface;
+    SDL_Renderer *renderer;
+    int bpp;
+    Uint32 Rmask, Gmask, Bmask, Amask;
+    Uint64 start, end;
+    int i;
+
+    SDL_PixelFormatEnumToMasks(format, &bpp, &Rmask, &Gmask, &Bmask, &Amask);
+    surface = SDL_CreateRGBSurface(0, WIDTH, HEIGHT, bpp, Rmask, Gmask, Bmask, Amask);
+    if (!surface) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create surface: %s\n", SDL_GetError());
+        return;
+    }
+    renderer = SDL_CreateSoftwareRenderer(surface);
+    if (!renderer) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create renderer: %s\n", SDL_GetError());
+        SDL_FreeSurface(surface);
+        return;
+    }
+    SDL_SetRenderDrawBlendMode(renderer, blendMode);
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < NUM_SHAPES; ++i) {
+        SDL_SetRenderDrawColor(renderer, (Uint8)i, (Uint8)(i >> 3), 0x80, 0x60);
+        SDL_RenderFillRect(renderer, &rects[i]);
+    }
+    end = SDL_GetPerformanceCounter();
+    SDL_Log("%-12s %-6s %6d rects: %8.2f ms\n", SDL_GetPixelFormatName(format) + 16,
+            BlendModeName(blendMode), NUM_SHAPES, Seconds(start, end) * 1000.0);
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < NUM_SHAPES; ++i) {
+        SDL_SetRenderDrawColor(renderer, (Uint8)i, (Uint8)(i >> 3), 0x80, 0x60);
+        SDL_RenderDrawLine(renderer, lines[i][0].x, lines[i][0].y, lines[i][1].x, lines[i][1].y);
+    }
+    end = SDL_GetPerformanceCounter();
+    SDL_Log("%-12s %-6s %6d lines: %8.2f ms\n", SDL_GetPixelFormatName(format) + 16,
+            BlendModeName(blendMode), NUM_SHAPES, Seconds(start, end) * 1000.0);
+
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(surface);
+}
+
+int
+main(int argc, char *argv[])
+{
+    static const Uint32 formats[] = {
+        SDL_PIXELFORMAT_ARGB8888,
+        SDL_PIXELFORMAT_RGB888,
+        SDL_PIXELFORMAT_ABGR8888,
+        SDL_PIXELFORMAT_RGB565,
+        SDL_PIXELFORMAT_RGB555
+    };
+    static const SDL_BlendMode modes[] = {
+        SDL_BLENDMODE_NONE,
+        SDL_BLENDMODE_BLEND,
+        SDL_BLENDMODE_ADD,
+        SDL_BLENDMODE_MOD
+    };
+    int i, j;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    if (SDL_Init(0) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    /* Chart-like shapes: bars, and mostly horizontal and vertical lines */
+    srand(42);
+    for (i = 0; i < NUM_SHAPES; ++i) {
+        rects[i].x = rand() % WIDTH;
+        rects[i].y = rand() % HEIGHT;
+        rects[i].w = 1 + rand() % 64;
+        rects[i].h = 1 + rand() % 64;
+
+        lines[i][0].x = rand() % WIDTH;
+        lines[i][0].y = rand() % HEIGHT;
+        switch (i % 3) {
+        case 0:
+            lines[i][1].x = rand() % WIDTH;
+            lines[i][1].y = lines[i][0].y;
+            break;
+        case 1:
+            lines[i][1].x = lines[i][0].x;
+            lines[i][1].y = rand() % HEIGHT;
+            break;
+        default:
+            lines[i][1].x = rand() % WIDTH;
+            lines[i][1].y = rand() % HEIGHT;
+            break;
+        }
+    }
+
+    SDL_Log("SSE2: %s\n", SDL_HasSSE2() ? "yes" : "no");
+    for (i = 0; i < SDL_arraysize(formats); ++i) {
+        for (j = 0; j < SDL_arraysize(modes); ++j) {
+            RunTest(formats[i], modes[j]);
+        }
+        SDL_Log("\n");
+    }
+
+    SDL_Quit();
+    return 0;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -0,0 +1,276 @@
+/*
+  Copyright (C) 1997-2013 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Throughput benchmark for the SDL job system */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+
+#define NUM_TINY_JOBS   1000000
+#define TREE_DEPTH      16
+#define ARRAY_SIZE      (16 * 1024 * 1024)
+
+static SDL_atomic_t counter;
+static SDL_JobPool *pool;
+
+static double
+Seconds(Uint64 start, Uint64 end)
+{
+    return (double)(end - start) / SDL_GetPerformanceFrequency();
+}
+
+static void SDLCALL
+TinyJob(void *data)
+{
+    SDL_AtomicIncRef(&counter);
+}
+
+static void
+RunTinyJobTest(void)
+{
+    SDL_JobGroup *group;
+    Uint64 start, end;
+    int i;
+
+    SDL_Log("\ntiny jobs--------------------------------------\n\n");
+
+    SDL_AtomicSet(&counter, 0);
+    group = SDL_CreateJobGroup(pool);
+    if (!group) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create job group: %s\n", SDL_GetError());
+        exit(1);
+    }
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < NUM_TINY_JOBS; ++i) {
+        SDL_SubmitJob(group, TinyJob, NULL);
+    }
+    SDL_WaitJobGroup(group);
+    end = SDL_GetPerformanceCounter();
+
+    SDL_DestroyJobGroup(group);
+
+    SDL_Log("Ran %d jobs in %f sec, %.0f jobs/sec\n", SDL_AtomicGet(&counter),
+            Seconds(start, end), NUM_TINY_JOBS / Seconds(start, end));
+    if (SDL_AtomicGet(&counter) != NUM_TINY_JOBS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Expected %d jobs to run!\n", NUM_TINY_JOBS);
+        exit(1);
+    }
+}
+
+/* Each job splits itself in two until it reaches the bottom of the tree,
+   which exercises stealing and waiting on a group from inside a job.
+ */
+static void SDLCALL
+TreeJob(void *data)
+{
+    int depth = (int)(size_t)data;
+    SDL_JobGroup *group;
+
+    if (depth == 0) {
+        SDL_AtomicIncRef(&counter);
+        return;
+    }
+
+    group = SDL_CreateJobGroup(pool);
+    SDL_SubmitJob(group, TreeJob, (void *)(size_t)(depth - 1));
+    SDL_SubmitJob(group, TreeJob, (void *)(size_t)(depth - 1));
+    SDL_DestroyJobGroup(group);
+}
+
+static void
+RunTreeTest(void)
+{
+    SDL_JobGroup *group;
+    Uint64 start, end;
+
+    SDL_Log("\nnested jobs------------------------------------\n\n");
+
+    SDL_AtomicSet(&counter, 0);
+    group = SDL_CreateJobGroup(pool);
+
+    start = SDL_GetPerformanceCounter();
+    SDL_SubmitJob(group, TreeJob, (void *)(size_t)TREE_DEPTH);
+    SDL_DestroyJobGroup(group);
+    end = SDL_GetPerformanceCounter();
+
+    SDL_Log("Ran %d leaf jobs in %f sec\n", SDL_AtomicGet(&counter), Seconds(start, end));
+    if (SDL_AtomicGet(&counter) != (1 << TREE_DEPTH)) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Expected %d leaf jobs to run!\n", 1 << TREE_DEPTH);
+        exit(1);
+    }
+}
+
+typedef struct
+{
+    Uint32 *values;
+    SDL_atomic_t checksum;
+} ArrayData;
+
+static void SDLCALL
+ScrambleRange(void *data, int start, int end)
+{
+    ArrayData *array = (ArrayData *) data;
+    Uint32 checksum = 0;
+    int i;
+
+    for (i = start; i < end; ++i) {
+        Uint32 value = array->values[i];
+        value ^= value << 13;
+        value ^= value >> 17;
+        value ^= value << 5;
+        array->values[i] = value;
+        checksum += value;
+    }
+    SDL_AtomicAdd(&array->checksum, (int)checksum);
+}
+
+static void
+RunParallelForTest(void)
+{
+    ArrayData array;
+    Uint64 start, end;
+    double serial, parallel;
+    int serial_checksum;
+    int i;
+
+    SDL_Log("\nparallel for-----------------------------------\n\n");
+
+    array.values = (Uint32 *) SDL_malloc(ARRAY_SIZE * sizeof(Uint32));
+    if (!array.values) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Out of memory!\n");
+        exit(1);
+    }
+
+    for (i = 0; i < ARRAY_SIZE; ++i) {
+        array.values[i] = i + 1;
+    }
+    SDL_AtomicSet(&array.checksum, 0);
+    start = SDL_GetPerformanceCounter();
+    ScrambleRange(&array, 0, ARRAY_SIZE);
+    end = SDL_GetPerformanceCounter();
+    serial = Seconds(start, end);
+    serial_checksum = SDL_AtomicGet(&array.checksum);
+
+    for (i = 0; i < ARRAY_SIZE; ++i) {
+        array.values[i] = i + 1;
+    }
+    SDL_AtomicSet(&array.checksum, 0);
+    start = SDL_GetPerformanceCounter();
+    SDL_ParallelFor(pool, 0, ARRAY_SIZE, 0, ScrambleRange, &array);
+    end = SDL_GetPerformanceCounter();
+    parallel = Seconds(start, end);
+
+    SDL_free(array.values);
+
+    SDL_Log("Serial:   %f sec\n", serial);
+    SDL_Log("Parallel: %f sec, %.2fx speedup\n", parallel, serial / parallel);
+    if (SDL_AtomicGet(&array.checksum) != serial_checksum) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Parallel checksum doesn't match serial checksum!\n");
+        exit(1);
+    }
+}
+
+static int
+CompareValues(const void *a, const void *b)
+{
+    const Uint32 x = *(const Uint32 *) a;
+    const Uint32 y = *(const Uint32 *) b;
+
+    return (x < y) ? -1 : (x > y);
+}
+
+static void
+RunParallelSortTest(void)
+{
+    Uint32 *serial_values, *parallel_values;
+    Uint64 start, end;
+    double serial, parallel;
+    int i;
+
+    SDL_Log("\nparallel sort----------------------------------\n\n");
+
+    serial_values = (Uint32 *) SDL_malloc(ARRAY_SIZE * sizeof(Uint32));
+    parallel_values = (Uint32 *) SDL_malloc(ARRAY_SIZE * sizeof(Uint32));
+    if (!serial_values || !parallel_values) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Out of memory!\n");
+        exit(1);
+    }
+
+    for (i = 0; i < ARRAY_SIZE; ++i) {
+        Uint32 value = i + 1;
+        value ^= value << 13;
+        value ^= value >> 17;
+        value ^= value << 5;
+        serial_values[i] = parallel_values[i] = value;
+    }
+
+    start = SDL_GetPerformanceCounter();
+    SDL_qsort(serial_values, ARRAY_SIZE, sizeof(Uint32), CompareValues);
+    end = SDL_GetPerformanceCounter();
+    serial = Seconds(start, end);
+
+    start = SDL_GetPerformanceCounter();
+    SDL_ParallelSort(pool, parallel_values, ARRAY_SIZE, sizeof(Uint32), CompareValues);
+    end = SDL_GetPerformanceCounter();
+    parallel = Seconds(start, end);
+
+    SDL_Log("Serial:   %f sec\n", serial);
+    SDL_Log("Parallel: %f sec, %.2fx speedup\n", parallel, serial / parallel);
+    if (SDL_memcmp(serial_values, parallel_values, ARRAY_SIZE * sizeof(Uint32)) != 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Parallel sort doesn't match serial sort!\n");
+        exit(1);
+    }
+
+    SDL_free(serial_values);
+    SDL_free(parallel_values);
+}
+
+int
+main(int argc, char *argv[])
+{
+    int num_threads = 0;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    if (argc > 1) {
+        num_threads = SDL_atoi(argv[1]);
+    }
+
+    if (SDL_Init(0) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return (1);
+    }
+
+    pool = SDL_CreateJobPool(num_threads);
+    if (!pool) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create job pool: %s\n", SDL_GetError());
+        SDL_Quit();
+        return (1);
+    }
+    SDL_Log("Running with %d worker threads on %d CPUs\n",
+            SDL_GetJobPoolThreadCount(pool), SDL_GetCPUCount());
+
+    RunTinyJobTest();
+    RunTreeTest();
+    RunParallelForTest();
+    RunParallelSortTest();
+
+    SDL_DestroyJobPool(pool);
+    SDL_Quit();
+    return (0);
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
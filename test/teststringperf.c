@@ -0,0 +1,210 @@
+/*
+  Copyright (C) 1997-2013 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Microbenchmark for the SDL memory and string functions, against libc */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SDL.h"
+
+#define BUFFER_SIZE     (1024 * 1024)
+#define BYTES_PER_TEST  (256 * 1024 * 1024)
+
+static char *src;
+static char *dst;
+static volatile size_t sink;
+
+static double
+Seconds(Uint64 start, Uint64 end)
+{
+    return (double)(end - start) / SDL_GetPerformanceFrequency();
+}
+
+/* Byte at a time reference implementations */
+static size_t
+ByteUTF8Length(const char *text)
+{
+    size_t count = 0;
+
+    while (*text) {
+        if ((*text++ & 0xC0) != 0x80) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+static SDL_bool
+ByteUTF8Valid(const char *text, size_t len)
+{
+    const Uint8 *p = (const Uint8 *)text;
+    const Uint8 *end = p + len;
+
+    while (p < end) {
+        size_t i, n;
+
+        if (*p < 0x80) {
+            ++p;
+            continue;
+        } else if (*p >= 0xC2 && *p <= 0xDF) {
+            n = 2;
+        } else if (*p >= 0xE0 && *p <= 0xEF) {
+            n = 3;
+        } else if (*p >= 0xF0 && *p <= 0xF4) {
+            n = 4;
+        } else {
+            return SDL_FALSE;
+        }
+        if ((size_t)(end - p) < n) {
+            return SDL_FALSE;
+        }
+        for (i = 1; i < n; ++i) {
+            if ((p[i] & 0xC0) != 0x80) {
+                return SDL_FALSE;
+            }
+        }
+        p += n;
+    }
+    return SDL_TRUE;
+}
+
+enum
+{
+    TEST_SDL_MEMSET,
+    TEST_LIBC_MEMSET,
+    TEST_SDL_MEMCPY,
+    TEST_LIBC_MEMCPY,
+    TEST_SDL_STRLEN,
+    TEST_LIBC_STRLEN,
+    TEST_SDL_UTF8STRLEN,
+    TEST_BYTE_UTF8STRLEN,
+    TEST_SDL_UTF8VALID,
+    TEST_BYTE_UTF8VALID,
+    NUM_TESTS
+};
+
+static const char *test_names[NUM_TESTS] = {
+    "SDL_memset",
+    "memset",
+    "SDL_memcpy",
+    "memcpy",
+    "SDL_strlen",
+    "strlen",
+    "SDL_utf8strlen",
+    "byte utf8strlen",
+    "SDL_utf8valid",
+    "byte utf8valid"
+};
+
+static void
+RunTest(int test, size_t size)
+{
+    const size_t iterations = BYTES_PER_TEST / size;
+    Uint64 start, end;
+    double seconds;
+    size_t i;
+
+    /* Strings end at the size being tested */
+    src[size - 1] = '\0';
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < iterations; ++i) {
+        switch (test) {
+        case TEST_SDL_MEMSET:
+            SDL_memset(dst, (int)i, size);
+            break;
+        case TEST_LIBC_MEMSET:
+            memset(dst, (int)i, size);
+            break;
+        case TEST_SDL_MEMCPY:
+            SDL_memcpy(dst, src, size);
+            break;
+        case TEST_LIBC_MEMCPY:
+            memcpy(dst, src, size);
+            break;
+        case TEST_SDL_STRLEN:
+            sink += SDL_strlen(src);
+            break;
+        case TEST_LIBC_STRLEN:
+            sink += strlen(src);
+            break;
+        case TEST_SDL_UTF8STRLEN:
+            sink += SDL_utf8strlen(src);
+            break;
+        case TEST_BYTE_UTF8STRLEN:
+            sink += ByteUTF8Length(src);
+            break;
+        case TEST_SDL_UTF8VALID:
+            sink += SDL_utf8valid(src, size - 1);
+            break;
+        case TEST_BYTE_UTF8VALID:
+            sink += ByteUTF8Valid(src, size - 1);
+            break;
+        }
+    }
+    end = SDL_GetPerformanceCounter();
+
+    src[size - 1] = 'x';
+
+    seconds = Seconds(start, end);
+    SDL_Log("%-16s %8u bytes: %8.2f MB/s\n", test_names[test], (unsigned int)size,
+            ((double)iterations * size) / (1024.0 * 1024.0) / seconds);
+}
+
+int
+main(int argc, char *argv[])
+{
+    static const size_t sizes[] = { 16, 256, 4096, 65536, BUFFER_SIZE };
+    int test;
+    int i;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    if (SDL_Init(0) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    src = (char *)SDL_malloc(BUFFER_SIZE);
+    dst = (char *)SDL_malloc(BUFFER_SIZE);
+    if (!src || !dst) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Out of memory\n");
+        return 1;
+    }
+
+    /* Mostly ASCII text with a two byte character every 64 bytes */
+    for (i = 0; i < BUFFER_SIZE; ++i) {
+        src[i] = 'a' + (i % 26);
+    }
+    for (i = 0; i < BUFFER_SIZE - 2; i += 64) {
+        src[i] = (char)0xC3;
+        src[i + 1] = (char)0xA9;
+    }
+
+    SDL_Log("SSE2: %s\n", SDL_HasSSE2() ? "yes" : "no");
+    for (test = 0; test < NUM_TESTS; ++test) {
+        for (i = 0; i < SDL_arraysize(sizes); ++i) {
+            RunTest(test, sizes[i]);
+        }
+        SDL_Log("\n");
+    }
+
+    SDL_free(src);
+    SDL_free(dst);
+    SDL_Quit();
+    return 0;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */